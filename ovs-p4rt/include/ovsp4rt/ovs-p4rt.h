@@ -23,6 +23,7 @@
 
 #include <netinet/in.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -65,6 +66,14 @@ enum ovs_tunnel_type {
   OVS_TUNNEL_GENEVE
 };
 
+// Severity of a log message.
+enum ovsp4rt_log_level {
+  OVSP4RT_LEVEL_DEBUG,
+  OVSP4RT_LEVEL_INFO,
+  OVSP4RT_LEVEL_WARN,
+  OVSP4RT_LEVEL_ERROR,
+};
+
 struct p4_ipaddr {
   uint8_t family;
   uint8_t prefix_len;
@@ -123,6 +132,80 @@ struct ip_mac_map_info {
   struct p4_ipaddr dst_ip_addr;
 };
 
+// Statistics for asynchronous mode.
+struct ovsp4rt_async_stats {
+  uint64_t enqueued;          // requests queued
+  uint64_t completed;         // requests processed by the writer thread
+  uint64_t dropped;           // inserts dropped because the queue was full
+  uint64_t coalesced;         // FDB requests elided by coalescing
+  uint64_t batches;           // batches processed by the writer thread
+  uint32_t queue_depth;       // requests currently in the queue
+  uint32_t max_queue_depth;   // largest queue depth seen
+  uint64_t total_latency_us;  // sum of the queue-to-completion latencies
+  uint64_t max_latency_us;    // largest queue-to-completion latency
+};
+
+// Statistics for resynchronization after infrap4d restarts.
+struct ovsp4rt_resync_stats {
+  uint64_t resyncs;           // times the intended state was replayed
+  uint64_t entries_replayed;  // requests replayed
+  uint64_t entries_failed;    // replayed requests that failed
+  uint64_t last_duration_us;  // duration of the most recent replay
+  uint64_t max_duration_us;   // longest replay
+};
+
+// An FDB entry that the switch has aged out.
+struct ovsp4rt_aged_mac {
+  uint8_t bridge_id;    // zero if the target does not match on it
+  uint8_t mac_addr[6];
+};
+
+// Receives a batch of aged-out FDB entries.
+typedef void (*ovsp4rt_fdb_aged_cb)(const struct ovsp4rt_aged_mac* macs,
+                                    size_t num_macs, void* aux);
+
+// Receives a log message, without a trailing newline.
+typedef void (*ovsp4rt_log_sink_cb)(enum ovsp4rt_log_level level,
+                                    const char* message, void* aux);
+
+// Operations whose latency is measured.
+enum ovsp4rt_latency_type {
+  OVSP4RT_LATENCY_SESSION_CREATE,  // connecting and arbitrating
+  OVSP4RT_LATENCY_PIPELINE_FETCH,  // fetching the P4Info
+  OVSP4RT_LATENCY_READ_RPC,        // a Read RPC, to the last entity
+  OVSP4RT_LATENCY_WRITE_RPC,       // a Write RPC
+  OVSP4RT_LATENCY_API,             // an API call, from entry to return
+  OVSP4RT_NUM_LATENCY_TYPES
+};
+
+// Latency distribution of an operation. The percentiles are accurate
+// to within 12.5%.
+struct ovsp4rt_latency_stats {
+  uint64_t count;     // operations measured
+  uint64_t total_ns;  // sum of their latencies
+  uint64_t max_ns;    // largest latency
+  uint64_t p50_ns;    // median
+  uint64_t p90_ns;
+  uint64_t p99_ns;
+  uint64_t p999_ns;
+};
+
+// Number of elements in ovsp4rt_stats.tables.
+#define OVSP4RT_NUM_TABLE_STATS 16
+
+// Outcomes of the updates to a table.
+struct ovsp4rt_table_stats {
+  uint64_t succeeded;
+  uint64_t failed;
+};
+
+// Statistics of the library since it was loaded.
+struct ovsp4rt_stats {
+  struct ovsp4rt_latency_stats latency[OVSP4RT_NUM_LATENCY_TYPES];
+  // Indexed by table; see ovsp4rt_stats_table_name().
+  struct ovsp4rt_table_stats tables[OVSP4RT_NUM_TABLE_STATS];
+};
+
 //----------------------------------------------------------------------
 // Function prototypes
 //----------------------------------------------------------------------
@@ -130,6 +213,16 @@ struct ip_mac_map_info {
 extern void ovsp4rt_config_fdb_entry(struct mac_learning_info learn_info,
                                      bool insert_entry, const char* grpc_addr);
 
+// Programs the FDB entries for an array of learn events, batching the
+// updates into as few WriteRequests as possible. The call is always
+// synchronous. If status is not NULL, status[i] receives the gRPC
+// status code of entry i (0 if it succeeded). Returns the number of
+// entries that failed; an entry that was already in place
+// (ALREADY_EXISTS) is not counted.
+extern int ovsp4rt_config_fdb_entries(
+    const struct mac_learning_info* learn_info, size_t num_entries,
+    bool insert_entry, const char* grpc_addr, int* status);
+
 extern void ovsp4rt_config_ip_mac_map_entry(struct ip_mac_map_info learn_info,
                                             bool insert_entry,
                                             const char* grpc_addr);
@@ -155,6 +248,171 @@ extern void ovsp4rt_config_vlan_entry(uint16_t vlan_id, bool insert_entry,
 
 extern enum ovs_tunnel_type ovsp4rt_str_to_tunnel_type(const char* tnl_type);
 
+//----------------------------------------------------------------------
+// Asynchronous mode
+//
+// In asynchronous mode, the ovsp4rt_config_* functions queue the
+// request and return immediately. A writer thread sends the queued
+// requests to the switch, in order, batching the FDB updates.
+//
+// The --async_shards flag divides the work among several writer
+// threads (shards), each with its own queue. The FDB requests for a
+// bridge go to the shard for its bridge ID and stay in order; the
+// other requests go to shard 0. Bridges on different shards are
+// programmed concurrently.
+//----------------------------------------------------------------------
+
+// Enables asynchronous mode. Inserts are dropped if the queue of their
+// shard already holds queue_limit requests; a delete then waits for the
+// queue to drain and is made synchronously. Zero selects the default
+// limit.
+extern void ovsp4rt_async_enable(uint32_t queue_limit);
+
+// Disables asynchronous mode and waits for the queue to drain.
+extern void ovsp4rt_async_disable(void);
+
+// Waits until the requests queued before the call have been processed.
+extern void ovsp4rt_async_flush(void);
+
+// Returns the statistics of all shards combined.
+extern void ovsp4rt_async_get_stats(struct ovsp4rt_async_stats* stats);
+
+// Returns the number of shards.
+extern uint32_t ovsp4rt_async_num_shards(void);
+
+// Returns the statistics of a shard. Sampling the completed count
+// gives the throughput of the shard. Returns false if there is no such
+// shard.
+extern bool ovsp4rt_async_get_shard_stats(uint32_t shard,
+                                          struct ovsp4rt_async_stats* stats);
+
+//----------------------------------------------------------------------
+// Resynchronization
+//
+// The sidecar remembers the entries OVS has asked it to program. If
+// infrap4d restarts or its pipeline changes, it programs them again,
+// without waiting for OVS to repeat its requests.
+//----------------------------------------------------------------------
+
+extern void ovsp4rt_resync_get_stats(struct ovsp4rt_resync_stats* stats);
+
+//----------------------------------------------------------------------
+// Audit after OVS restarts
+//
+// When OVS restarts, the switch may hold entries that OVS no longer
+// wants. OVS begins an epoch before it reconciles its state, programs
+// the entries it wants as usual, and then ends the epoch. Ending the
+// epoch deletes the entries in the tables the sidecar owns that were
+// neither programmed nor found during the epoch.
+//
+// The functions return 0 or a gRPC status code.
+//----------------------------------------------------------------------
+
+// Begins an audit epoch. Requests already queued in asynchronous mode
+// are processed first.
+extern int ovsp4rt_audit_begin_epoch(const char* grpc_addr);
+
+// Ends the audit epoch and deletes the stale entries. If num_deleted
+// is not NULL, it receives the number of entries deleted.
+extern int ovsp4rt_audit_end_epoch(const char* grpc_addr,
+                                   uint64_t* num_deleted);
+
+//----------------------------------------------------------------------
+// FDB aging
+//
+// The switch can age the FDB entries in place of OVS. While aging is
+// enabled, the FDB entries are programmed with an idle timeout, and the
+// switch reports the entries that have not been hit within it. The
+// sidecar passes them to the callback, and OVS then removes them with
+// ovsp4rt_config_fdb_entry() as before.
+//
+// The callback runs on the thread that reads the P4Runtime stream
+// channel, so it should queue the work rather than do it.
+//----------------------------------------------------------------------
+
+// Enables FDB aging. The FDB entries programmed afterward age out after
+// idle_timeout_ms without a hit; enable aging before programming them.
+extern void ovsp4rt_fdb_aging_enable(uint32_t idle_timeout_ms,
+                                     ovsp4rt_fdb_aged_cb callback, void* aux);
+
+// Disables FDB aging. When it returns, the callback is no longer
+// running and will not be called again.
+extern void ovsp4rt_fdb_aging_disable(void);
+
+// Returns true if the pipeline supports idle timeouts on the table
+// used for aging. If it does not, OVS must age the entries itself.
+extern bool ovsp4rt_fdb_aging_supported(const char* grpc_addr);
+
+//----------------------------------------------------------------------
+// Journal
+//
+// The library can record each call to the functions that program the
+// switch in a journal file: its input, the WriteRequests it sent, and
+// its status. The file is a ring; when it is full, the oldest entries
+// are overwritten. ovsp4rt_journal_dump converts it to JSON.
+//
+// A request queued in asynchronous mode is recorded without the
+// WriteRequests, which a writer thread sends later.
+//----------------------------------------------------------------------
+
+// Opens or creates a journal file and starts recording. An existing
+// journal of the same capacity is appended to. Zero selects the default
+// capacity (64 MiB). Returns 0 or a gRPC status code.
+extern int ovsp4rt_journal_open(const char* path, uint64_t capacity);
+
+// Stops recording and closes the journal file.
+extern void ovsp4rt_journal_close(void);
+
+//----------------------------------------------------------------------
+// Statistics
+//
+// The library measures the latency of its operations and counts the
+// updates to each table, whether or not anyone asks for them. The cost
+// is a few nanoseconds per operation.
+//----------------------------------------------------------------------
+
+extern void ovsp4rt_get_stats(struct ovsp4rt_stats* stats);
+
+// Returns the name of a latency type, or NULL if there is no such type.
+extern const char* ovsp4rt_stats_latency_name(enum ovsp4rt_latency_type type);
+
+// Returns the name of the table with the given index in
+// ovsp4rt_stats.tables, or NULL if the index is not in use.
+extern const char* ovsp4rt_stats_table_name(uint32_t table);
+
+//----------------------------------------------------------------------
+// Logging
+//
+// Messages are formatted on the calling thread into a buffer of its
+// own and written by a background thread, so logging does not block
+// on the output. If a thread logs faster than the background thread
+// writes, its excess messages are dropped, and the number dropped is
+// logged later.
+//
+// Each call site logs at most a limited number of messages per
+// second. Its next message after that reports how many were
+// suppressed.
+//----------------------------------------------------------------------
+
+// Logs only messages at or above the level. The default is
+// OVSP4RT_LEVEL_DEBUG. Messages below OVSP4RT_LOG_MIN_LEVEL, if it is
+// defined when the library is compiled, are not compiled in at all.
+extern void ovsp4rt_log_set_level(enum ovsp4rt_log_level level);
+
+extern enum ovsp4rt_log_level ovsp4rt_log_get_level(void);
+
+// Sets the number of messages each call site may log per second. Zero
+// removes the limit.
+extern void ovsp4rt_log_set_rate_limit(uint32_t messages_per_second);
+
+// Sends the messages to a sink, such as the OVS vlog module, instead of
+// stdout. The sink is called on the background thread. A NULL sink
+// restores stdout. Messages logged before the call go to the old sink.
+extern void ovsp4rt_log_set_sink(ovsp4rt_log_sink_cb sink, void* aux);
+
+// Waits until the messages logged before the call have been written.
+extern void ovsp4rt_log_flush(void);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
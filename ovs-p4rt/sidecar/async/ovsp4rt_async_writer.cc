@@ -0,0 +1,345 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ovsp4rt_async_writer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include "absl/time/clock.h"
+#include "logging/ovsp4rt_logging.h"
+#include "ovsp4rt_dependency_scheduler.h"
+#include "ovsp4rt_fdb_coalescer.h"
+#include "ovsp4rt_private.h"
+
+namespace ovsp4rt {
+
+namespace {
+
+// Returns true if a request removes an entry that FDB entries refer
+// to.
+bool RemovesPrerequisite(const AsyncOp& op) {
+  return !op.insert_entry && (op.type == AsyncOp::CONFIG_TUNNEL_ENTRY ||
+                              op.type == AsyncOp::CONFIG_VLAN_ENTRY);
+}
+
+}  // namespace
+
+thread_local const AsyncWriter* AsyncWriter::current_writer_ = nullptr;
+
+AsyncWriter::~AsyncWriter() {
+  enabled_.store(false, std::memory_order_release);
+  if (writer_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(wakeup_mutex_);
+      stopping_.store(true, std::memory_order_release);
+    }
+    wakeup_.notify_one();
+    writer_.join();
+  }
+}
+
+void AsyncWriter::Enable(uint32_t queue_limit) {
+  queue_limit_.store(queue_limit ? queue_limit : kDefaultQueueLimit,
+                     std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> lock(start_mutex_);
+    if (!writer_.joinable()) {
+      writer_ = std::thread(&AsyncWriter::Run, this);
+    }
+  }
+  enabled_.store(true, std::memory_order_release);
+}
+
+void AsyncWriter::Disable() {
+  enabled_.store(false, std::memory_order_release);
+  Flush();
+}
+
+void AsyncWriter::Flush() {
+  if (current_writer_ == this) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(start_mutex_);
+    if (!writer_.joinable()) {
+      return;
+    }
+  }
+  std::promise<void> done;
+  AsyncOp op;
+  op.type = AsyncOp::BARRIER;
+  op.barrier = &done;
+  Push(std::move(op));
+  done.get_future().wait();
+}
+
+bool AsyncWriter::Submit(AsyncOp op) {
+  // The limit is approximate: concurrent callers may overshoot it by
+  // the number of threads.
+  uint32_t depth = queue_depth_.load(std::memory_order_relaxed);
+  if (depth >= queue_limit_.load(std::memory_order_relaxed)) {
+    if (!op.insert_entry) {
+      // Dropping a delete would leave a stale entry in the switch.
+      // Let the caller make it once the queued requests are done.
+      Flush();
+      return false;
+    }
+    uint64_t dropped = dropped_.fetch_add(1, std::memory_order_relaxed) + 1;
+    ovsp4rt_log_warn("Async queue full (%u requests), insert dropped (%lu "
+                     "dropped in total)",
+                     depth, (unsigned long)dropped);
+    return true;
+  }
+  op.enqueue_ns = absl::GetCurrentTimeNanos();
+  enqueued_.fetch_add(1, std::memory_order_relaxed);
+
+  depth = queue_depth_.fetch_add(1, std::memory_order_relaxed) + 1;
+  uint32_t max_depth = max_queue_depth_.load(std::memory_order_relaxed);
+  while (depth > max_depth &&
+         !max_queue_depth_.compare_exchange_weak(max_depth, depth,
+                                                 std::memory_order_relaxed)) {
+  }
+
+  Push(std::move(op));
+  return true;
+}
+
+void AsyncWriter::Push(AsyncOp op) {
+  pending_.fetch_add(1);
+  queue_.Push(std::move(op));
+
+  // The writer sets sleeping_ before it checks pending_ for the last
+  // time, so either it sees our request or we see that it is asleep.
+  if (sleeping_.load()) {
+    std::lock_guard<std::mutex> lock(wakeup_mutex_);
+    wakeup_.notify_one();
+  }
+}
+
+void AsyncWriter::WaitForWork() {
+  std::unique_lock<std::mutex> lock(wakeup_mutex_);
+  sleeping_.store(true);
+  auto has_work = [this]() {
+    return pending_.load() != 0 || stopping_.load(std::memory_order_acquire);
+  };
+  if (holding_) {
+    wakeup_.wait_for(lock, std::chrono::milliseconds(kHeldPollMs), has_work);
+  } else {
+    wakeup_.wait(lock, has_work);
+  }
+  sleeping_.store(false);
+}
+
+void AsyncWriter::Run() {
+  current_writer_ = this;
+
+  std::vector<AsyncOp> ops;
+  ops.reserve(kMaxBatchSize);
+
+  while (!stopping_.load(std::memory_order_acquire)) {
+    WaitForWork();
+
+    AsyncOp op;
+    while (ops.size() < kMaxBatchSize && queue_.Pop(&op)) {
+      pending_.fetch_sub(1);
+      if (op.type == AsyncOp::BARRIER) {
+        ops.push_back(std::move(op));
+        break;
+      }
+      queue_depth_.fetch_sub(1, std::memory_order_relaxed);
+      ops.push_back(std::move(op));
+    }
+
+    if (ops.empty()) {
+      if (holding_) {
+        holding_ = release_held_(false);
+      } else {
+        // A producer is still linking in its request.
+        std::this_thread::yield();
+      }
+      continue;
+    }
+
+    Process(ops);
+    ops.clear();
+  }
+}
+
+void AsyncWriter::Process(std::vector<AsyncOp>& ops) {
+  // A barrier can only be the last request in the batch.
+  std::promise<void>* barrier = nullptr;
+  if (ops.back().type == AsyncOp::BARRIER) {
+    barrier = ops.back().barrier;
+    ops.pop_back();
+  }
+
+  size_t num_ops = ops.size();
+  if (num_ops) {
+    coalesced_.fetch_add(CoalesceFdbOps(ops), std::memory_order_relaxed);
+  }
+
+  if (!ops.empty()) {
+    if (removal_hook_ &&
+        std::any_of(ops.begin(), ops.end(), RemovesPrerequisite)) {
+      removal_hook_();
+    }
+    executor_(ops);
+
+    int64_t now = absl::GetCurrentTimeNanos();
+    uint64_t total_latency = 0;
+    uint64_t max_latency = max_latency_ns_.load(std::memory_order_relaxed);
+    for (const auto& op : ops) {
+      uint64_t latency = std::max<int64_t>(now - op.enqueue_ns, 0);
+      total_latency += latency;
+      max_latency = std::max(max_latency, latency);
+    }
+    total_latency_ns_.fetch_add(total_latency, std::memory_order_relaxed);
+    max_latency_ns_.store(max_latency, std::memory_order_relaxed);
+    batches_.fetch_add(1, std::memory_order_relaxed);
+  }
+  completed_.fetch_add(num_ops, std::memory_order_relaxed);
+
+  // Requests queued before a barrier are not held past it.
+  if (release_held_) {
+    holding_ = release_held_(barrier != nullptr);
+  }
+
+  if (barrier) {
+    barrier->set_value();
+  }
+}
+
+void AsyncWriter::GetStats(struct ovsp4rt_async_stats* stats) const {
+  stats->enqueued = enqueued_.load(std::memory_order_relaxed);
+  stats->completed = completed_.load(std::memory_order_relaxed);
+  stats->dropped = dropped_.load(std::memory_order_relaxed);
+  stats->coalesced = coalesced_.load(std::memory_order_relaxed);
+  stats->batches = batches_.load(std::memory_order_relaxed);
+  stats->queue_depth = queue_depth_.load(std::memory_order_relaxed);
+  stats->max_queue_depth = max_queue_depth_.load(std::memory_order_relaxed);
+  stats->total_latency_us =
+      total_latency_ns_.load(std::memory_order_relaxed) / 1000;
+  stats->max_latency_us =
+      max_latency_ns_.load(std::memory_order_relaxed) / 1000;
+}
+
+namespace {
+
+// Programs the FDB entries for a series of requests. Consecutive
+// requests for the same server share WriteRequests.
+void ConfigFdbOps(const std::vector<AsyncOp>& ops) {
+  std::vector<FdbLearnEvent> events;
+  const std::string* events_addr = nullptr;
+
+  for (const auto& op : ops) {
+    if (!events.empty() && *events_addr != op.grpc_addr) {
+      ConfigFdbEntries(events.data(), events.size(), events_addr->c_str());
+      events.clear();
+    }
+    events.push_back({op.learn_info, op.insert_entry});
+    events_addr = &op.grpc_addr;
+  }
+
+  if (!events.empty()) {
+    ConfigFdbEntries(events.data(), events.size(), events_addr->c_str());
+  }
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------
+// ExecuteAsyncOp
+//----------------------------------------------------------------------
+absl::Status ExecuteAsyncOp(const AsyncOp& op) {
+  const char* grpc_addr = op.grpc_addr.c_str();
+  switch (op.type) {
+    case AsyncOp::CONFIG_FDB_ENTRY: {
+      FdbLearnEvent event = {op.learn_info, op.insert_entry};
+      absl::Status status;
+      ConfigFdbEntries(&event, 1, grpc_addr, &status);
+      return status;
+    }
+    case AsyncOp::CONFIG_TUNNEL_ENTRY:
+      return ConfigTunnelEntry(op.tnl_info, op.insert_entry, grpc_addr);
+#if defined(ES2K_TARGET)
+    case AsyncOp::CONFIG_IP_MAC_MAP_ENTRY:
+      return ConfigIpMacMapEntry(op.ip_info, op.insert_entry, grpc_addr);
+    case AsyncOp::CONFIG_RX_TUNNEL_SRC_ENTRY:
+      return ConfigRxTunnelSrcEntry(op.tnl_info, op.insert_entry, grpc_addr);
+    case AsyncOp::CONFIG_SRC_PORT_ENTRY:
+      return ConfigSrcPortEntry(op.sp_info, op.insert_entry, grpc_addr);
+    case AsyncOp::CONFIG_TUNNEL_SRC_PORT_ENTRY:
+      return ConfigTunnelSrcPortEntry(op.sp_info, op.insert_entry, grpc_addr);
+    case AsyncOp::CONFIG_VLAN_ENTRY:
+      return ConfigVlanEntry(op.vlan_id, op.insert_entry, grpc_addr);
+#endif
+    default:
+      // Not implemented for this target.
+      return absl::OkStatus();
+  }
+}
+
+//----------------------------------------------------------------------
+// ExecuteAsyncOps
+//
+// The batch is processed in segments, each of which ends with a request
+// that removes a tunnel or VLAN, or with the end of the batch. In each
+// segment:
+//
+//  1. Requests other than FDB requests are processed in order, by the
+//     API function itself. The tunnel and VLAN entries they add are
+//     then in place.
+//  2. The FDB requests whose prerequisites are in place, preceded by
+//     any held requests that are now ready, are programmed together,
+//     so their updates share WriteRequests and several can be in
+//     flight at once. The others are held.
+//  3. The removal is processed, after the FDB entries that referred to
+//     what it removes.
+//----------------------------------------------------------------------
+void ExecuteAsyncOps(std::vector<AsyncOp>& ops, const AsyncOpFilter& select) {
+  auto& scheduler = DependencyScheduler::Instance();
+
+  // FDB requests in the current segment.
+  std::vector<AsyncOp*> fdb_ops;
+
+  auto end_segment = [&](const AsyncOp* removal) {
+    int64_t now = absl::GetCurrentTimeNanos();
+    auto ready = scheduler.Release(now, false, select);
+    for (auto* op : fdb_ops) {
+      if (scheduler.Admit(*op, now)) {
+        ready.push_back(std::move(*op));
+      }
+    }
+    fdb_ops.clear();
+    ConfigFdbOps(ready);
+
+    if (removal) {
+      ExecuteAsyncOp(*removal).IgnoreError();
+    }
+  };
+
+  for (auto& op : ops) {
+    if (op.type == AsyncOp::CONFIG_FDB_ENTRY) {
+      fdb_ops.push_back(&op);
+    } else if (RemovesPrerequisite(op)) {
+      end_segment(&op);
+    } else {
+      ExecuteAsyncOp(op).IgnoreError();
+    }
+  }
+
+  end_segment(nullptr);
+}
+
+//----------------------------------------------------------------------
+// ReleaseHeldAsyncOps
+//----------------------------------------------------------------------
+bool ReleaseHeldAsyncOps(bool all, const AsyncOpFilter& select) {
+  auto& scheduler = DependencyScheduler::Instance();
+  ConfigFdbOps(scheduler.Release(absl::GetCurrentTimeNanos(), all, select));
+  return scheduler.held() != 0;
+}
+
+}  // namespace ovsp4rt
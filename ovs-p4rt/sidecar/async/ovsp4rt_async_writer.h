@@ -0,0 +1,240 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_ASYNC_WRITER_H_
+#define OVSP4RT_ASYNC_WRITER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "async/ovsp4rt_mpsc_queue.h"
+#include "ovsp4rt/ovs-p4rt.h"
+
+namespace ovsp4rt {
+
+// A queued API request. Holds a copy of the caller's input, so the
+// caller can return as soon as the request has been queued.
+struct AsyncOp {
+  enum Type {
+    BARRIER = 0,
+    CONFIG_FDB_ENTRY,
+    CONFIG_IP_MAC_MAP_ENTRY,
+    CONFIG_RX_TUNNEL_SRC_ENTRY,
+    CONFIG_SRC_PORT_ENTRY,
+    CONFIG_TUNNEL_SRC_PORT_ENTRY,
+    CONFIG_TUNNEL_ENTRY,
+    CONFIG_VLAN_ENTRY,
+  };
+
+  AsyncOp() : learn_info() {}
+
+  void SetInput(const struct mac_learning_info& info) { learn_info = info; }
+  void SetInput(const struct ip_mac_map_info& info) { ip_info = info; }
+  void SetInput(const struct tunnel_info& info) { tnl_info = info; }
+  void SetInput(const struct src_port_info& info) { sp_info = info; }
+  void SetInput(uint16_t info) { vlan_id = info; }
+
+  Type type = BARRIER;
+  bool insert_entry = false;
+  std::string grpc_addr;
+
+  // Time (in nanoseconds) at which the request was queued.
+  int64_t enqueue_ns = 0;
+
+  // Signaled when a BARRIER is reached.
+  std::promise<void>* barrier = nullptr;
+
+  union {
+    struct mac_learning_info learn_info;
+    struct ip_mac_map_info ip_info;
+    struct tunnel_info tnl_info;
+    struct src_port_info sp_info;
+    uint16_t vlan_id;
+  };
+};
+
+// Runs the ovsp4rt_config_* requests on a dedicated writer thread, so
+// the OVS threads that make the requests never block on gRPC.
+//
+// Asynchronous mode is opt-in. While it is enabled, the API functions
+// copy their input into a lock-free queue and return immediately. The
+// writer thread drains the queue in batches, and the FDB learn events
+// in a batch are combined into as few WriteRequests as possible.
+//
+// Requests are processed in the order they were queued, except that
+// FDB requests that are overtaken by or repeat a pending request are
+// removed (see CoalesceFdbOps), and the executor may hold requests
+// back until the entries they depend on are in place (see
+// DependencyScheduler). If the queue is full, new inserts are dropped,
+// counted and logged. A delete is never dropped: the caller waits until
+// the queue has been processed, then makes the request itself, so it
+// stays in order with the requests queued before it.
+class AsyncWriter {
+ public:
+  // Processes a batch of requests on the writer thread.
+  using Executor = std::function<void(std::vector<AsyncOp>& ops)>;
+
+  // Processes the requests the executor has held back: all of them,
+  // or only the ones that are now ready. Returns true if requests are
+  // still held.
+  using Releaser = std::function<bool(bool all)>;
+
+  // Default maximum number of queued requests.
+  static constexpr uint32_t kDefaultQueueLimit = 4096;
+
+  // Maximum number of requests the writer thread takes from the queue
+  // at a time.
+  static constexpr size_t kMaxBatchSize = 128;
+
+  // Interval at which the writer thread checks the held requests while
+  // the queue is empty.
+  static constexpr int kHeldPollMs = 10;
+
+  explicit AsyncWriter(Executor executor, Releaser release_held = nullptr)
+      : executor_(std::move(executor)),
+        release_held_(std::move(release_held)) {}
+
+  // Stops the writer thread. Requests still in the queue are discarded.
+  ~AsyncWriter();
+
+  // Disable copy semantics.
+  AsyncWriter(const AsyncWriter&) = delete;
+  AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+  // Enables asynchronous mode, starting the writer thread if needed.
+  // A queue_limit of zero selects the default.
+  void Enable(uint32_t queue_limit);
+
+  // Disables asynchronous mode and waits for the queued requests to
+  // be processed.
+  void Disable();
+
+  // Sets a function that the writer thread calls before it processes a
+  // batch with a request that removes a tunnel or VLAN. Must be called
+  // before Enable().
+  void SetRemovalHook(std::function<void()> hook) {
+    removal_hook_ = std::move(hook);
+  }
+
+  bool enabled() const { return enabled_.load(std::memory_order_acquire); }
+
+  // Queues a request if asynchronous mode is enabled. Returns false if
+  // the caller should process the request itself.
+  template <typename Info>
+  bool Enqueue(AsyncOp::Type type, const Info& info, bool insert_entry,
+               const char* grpc_addr) {
+    if (!enabled() || current_writer_) {
+      return false;
+    }
+    AsyncOp op;
+    op.type = type;
+    op.SetInput(info);
+    op.insert_entry = insert_entry;
+    op.grpc_addr = grpc_addr;
+    return Submit(std::move(op));
+  }
+
+  // Waits until all requests queued before the call have been
+  // processed. Does nothing on the writer thread itself.
+  void Flush();
+
+  // Returns the writer statistics.
+  void GetStats(struct ovsp4rt_async_stats* stats) const;
+
+ private:
+  // Adds a request to the queue. If the queue is full, drops an insert,
+  // or flushes the queue and returns false for a delete.
+  bool Submit(AsyncOp op);
+
+  // Adds a request to the queue and wakes the writer thread.
+  void Push(AsyncOp op);
+
+  // Body of the writer thread.
+  void Run();
+
+  // Blocks until there is something in the queue, or until it is time
+  // to check the held requests.
+  void WaitForWork();
+
+  // Processes a batch of requests and updates the statistics.
+  void Process(std::vector<AsyncOp>& ops);
+
+  Executor executor_;
+  Releaser release_held_;
+
+  // True if the executor is holding requests. Used only on the writer
+  // thread.
+  bool holding_ = false;
+
+  MpscQueue<AsyncOp> queue_;
+
+  std::atomic<bool> enabled_{false};
+
+  std::atomic<uint32_t> queue_limit_{kDefaultQueueLimit};
+
+  // Protects the creation of the writer thread.
+  std::mutex start_mutex_;
+  std::thread writer_;
+
+  // Wakes the writer thread when it is idle.
+  std::mutex wakeup_mutex_;
+  std::condition_variable wakeup_;
+  std::atomic<bool> sleeping_{false};
+  std::atomic<bool> stopping_{false};
+
+  // Number of items in the queue, including barriers.
+  std::atomic<uint32_t> pending_{0};
+
+  // Number of requests in the queue.
+  std::atomic<uint32_t> queue_depth_{0};
+  std::atomic<uint32_t> max_queue_depth_{0};
+
+  std::atomic<uint64_t> enqueued_{0};
+  std::atomic<uint64_t> completed_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint64_t> coalesced_{0};
+  std::atomic<uint64_t> batches_{0};
+
+  // Queue-to-completion latency, in nanoseconds.
+  std::atomic<uint64_t> total_latency_ns_{0};
+  std::atomic<uint64_t> max_latency_ns_{0};
+
+  // Called before a batch that removes a tunnel or VLAN is processed.
+  std::function<void()> removal_hook_;
+
+  // The writer whose thread this is, if any. The API functions that a
+  // writer thread calls must not queue the request again.
+  static thread_local const AsyncWriter* current_writer_;
+};
+
+// Selects the queued requests that belong to a writer.
+using AsyncOpFilter = std::function<bool(const AsyncOp& op)>;
+
+// Processes a single API request and returns its status.
+extern absl::Status ExecuteAsyncOp(const AsyncOp& op);
+
+// Processes a batch of queued API requests. This is the executor used
+// by the shards of ShardedWriter::Instance(). If select is set, only
+// the held requests it selects are released with the batch.
+extern void ExecuteAsyncOps(std::vector<AsyncOp>& ops,
+                            const AsyncOpFilter& select = nullptr);
+
+// Processes the FDB requests held by the DependencyScheduler that
+// select selects, or all of them if it is not set. This is the
+// releaser used by the shards of ShardedWriter::Instance().
+extern bool ReleaseHeldAsyncOps(bool all,
+                                const AsyncOpFilter& select = nullptr);
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_ASYNC_WRITER_H_
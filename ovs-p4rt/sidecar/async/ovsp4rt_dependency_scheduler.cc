@@ -0,0 +1,152 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ovsp4rt_dependency_scheduler.h"
+
+#include <utility>
+
+#include "absl/flags/flag.h"
+#include "ovsp4rt_private.h"
+
+ABSL_FLAG(int32_t, fdb_hold_ms, 1000,
+          "Longest time, in milliseconds, that an FDB insert waits for the "
+          "tunnel or VLAN entries it refers to.");
+
+namespace ovsp4rt {
+
+std::vector<Prerequisite> FdbPrerequisites(
+    const struct mac_learning_info& learn_info) {
+  std::vector<Prerequisite> prerequisites;
+  if (learn_info.is_tunnel) {
+    // The l2_fwd_tx action points at the encap mod entry for the VNI.
+    prerequisites.push_back(TunnelPrerequisite(learn_info.tnl_info.vni));
+    return prerequisites;
+  }
+#if defined(ES2K_TARGET)
+  if (learn_info.is_vlan && learn_info.vlan_info.port_vlan_mode ==
+                                P4_PORT_VLAN_NATIVE_UNTAGGED) {
+    // remove_vlan_and_fwd points at the vlan_pop mod entry.
+    prerequisites.push_back(VlanPrerequisite(learn_info.vlan_info.port_vlan));
+  }
+#endif
+  return prerequisites;
+}
+
+DependencyScheduler& DependencyScheduler::Instance() {
+  static DependencyScheduler* instance = new DependencyScheduler(
+      absl::Milliseconds(absl::GetFlag(FLAGS_fdb_hold_ms)));
+  return *instance;
+}
+
+void DependencyScheduler::Record(absl::string_view grpc_addr,
+                                 Prerequisite prerequisite, bool insert_entry,
+                                 const absl::Status& status) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!insert_entry) {
+    auto iter = in_place_.find(grpc_addr);
+    if (iter != in_place_.end()) {
+      iter->second.erase(prerequisite);
+    }
+  } else if (status.ok() ||
+             status.code() == absl::StatusCode::kAlreadyExists) {
+    in_place_[grpc_addr].insert(prerequisite);
+  }
+}
+
+bool DependencyScheduler::IsInPlace(absl::string_view grpc_addr,
+                                    Prerequisite prerequisite) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = in_place_.find(grpc_addr);
+  return iter != in_place_.end() && iter->second.contains(prerequisite);
+}
+
+bool DependencyScheduler::MustWaitLocked(const AsyncOp& op) const {
+  // Removing an entry does not depend on anything.
+  if (!op.insert_entry) {
+    return false;
+  }
+  auto iter = in_place_.find(op.grpc_addr);
+  for (auto prerequisite : FdbPrerequisites(op.learn_info)) {
+    if (iter == in_place_.end() || !iter->second.contains(prerequisite)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool DependencyScheduler::Admit(AsyncOp& op, int64_t now_ns) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  MacKey key(op.grpc_addr, FdbKey(op.learn_info));
+  if (!held_macs_.contains(key) &&
+      (now_ns - op.enqueue_ns >= hold_ns_ || !MustWaitLocked(op))) {
+    return true;
+  }
+  held_macs_.insert(std::move(key));
+  held_.push_back(std::move(op));
+  ++num_held_;
+  return false;
+}
+
+std::vector<AsyncOp> DependencyScheduler::Release(
+    int64_t now_ns, bool all, const AsyncOpFilter& select) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<AsyncOp> ready;
+  if (held_.empty()) {
+    return ready;
+  }
+
+  // MAC addresses with a request that is still held.
+  absl::flat_hash_set<MacKey> blocked;
+  std::vector<AsyncOp> still_held;
+  for (auto& op : held_) {
+    if (select && !select(op)) {
+      still_held.push_back(std::move(op));
+      continue;
+    }
+    if (!all) {
+      MacKey key(op.grpc_addr, FdbKey(op.learn_info));
+      bool waiting = MustWaitLocked(op);
+      if (blocked.contains(key) ||
+          (waiting && now_ns - op.enqueue_ns < hold_ns_)) {
+        blocked.insert(std::move(key));
+        still_held.push_back(std::move(op));
+        continue;
+      }
+      if (waiting) {
+        ++num_expired_;
+      }
+    }
+    ready.push_back(std::move(op));
+  }
+
+  held_ = std::move(still_held);
+  held_macs_.clear();
+  for (const auto& op : held_) {
+    held_macs_.emplace(op.grpc_addr, FdbKey(op.learn_info));
+  }
+  return ready;
+}
+
+size_t DependencyScheduler::held() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return held_.size();
+}
+
+uint64_t DependencyScheduler::num_held() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_held_;
+}
+
+uint64_t DependencyScheduler::num_expired() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_expired_;
+}
+
+void DependencyScheduler::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  in_place_.clear();
+  held_.clear();
+  held_macs_.clear();
+}
+
+}  // namespace ovsp4rt
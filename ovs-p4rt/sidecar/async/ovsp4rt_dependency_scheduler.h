@@ -0,0 +1,123 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_DEPENDENCY_SCHEDULER_H_
+#define OVSP4RT_DEPENDENCY_SCHEDULER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "async/ovsp4rt_async_writer.h"
+#include "ovsp4rt/ovs-p4rt.h"
+
+namespace ovsp4rt {
+
+// Identifies an entry that FDB entries refer to: the tunnel (encap,
+// decap and tunnel_term entries) for a VNI, or the VLAN push/pop mod
+// entries for a VLAN.
+using Prerequisite = uint64_t;
+
+inline Prerequisite TunnelPrerequisite(uint32_t vni) {
+  return uint64_t{1} << 32 | vni;
+}
+
+inline Prerequisite VlanPrerequisite(uint32_t vlan_id) {
+  return uint64_t{2} << 32 | vlan_id;
+}
+
+// Returns the entries that the FDB entries for a learn event refer to.
+std::vector<Prerequisite> FdbPrerequisites(
+    const struct mac_learning_info& learn_info);
+
+// Holds back the FDB requests of the asynchronous writer until the
+// tunnel and VLAN entries they refer to have been programmed.
+//
+// The tunnel and VLAN API functions report each entry they program or
+// remove, whether they run on the writer thread or the caller's. An
+// FDB insert whose prerequisites are not known to be in place is held.
+// It is released when they are, or when it has waited for the hold
+// time, since an entry programmed before the process started is not
+// known to the scheduler. Every later request for the same MAC address
+// is held behind it, so the requests for an entry stay in order.
+class DependencyScheduler {
+ public:
+  // Returns the process-wide scheduler.
+  static DependencyScheduler& Instance();
+
+  explicit DependencyScheduler(absl::Duration hold_time)
+      : hold_ns_(absl::ToInt64Nanoseconds(hold_time)) {}
+
+  // Disable copy semantics.
+  DependencyScheduler(const DependencyScheduler&) = delete;
+  DependencyScheduler& operator=(const DependencyScheduler&) = delete;
+
+  // Records the result of a request that programs (insert_entry) or
+  // removes a prerequisite. An insert that succeeded, or found the
+  // entry already there, puts the prerequisite in place; a delete
+  // always removes it.
+  void Record(absl::string_view grpc_addr, Prerequisite prerequisite,
+              bool insert_entry, const absl::Status& status);
+
+  // Returns true if the prerequisite is known to be in place.
+  bool IsInPlace(absl::string_view grpc_addr,
+                 Prerequisite prerequisite) const;
+
+  // Returns true if an FDB request can run now. Otherwise takes it and
+  // holds it. now_ns is the current time.
+  bool Admit(AsyncOp& op, int64_t now_ns);
+
+  // Returns the held requests that can now run, in the order they were
+  // queued. If all is true, every held request is released. If select
+  // is set, only the requests it selects are considered (e.g., those of
+  // one shard of a ShardedWriter).
+  std::vector<AsyncOp> Release(int64_t now_ns, bool all,
+                               const AsyncOpFilter& select = nullptr);
+
+  // Returns the number of held requests.
+  size_t held() const;
+
+  // Returns the number of requests that were held, and the number that
+  // were released because their hold time expired.
+  uint64_t num_held() const;
+  uint64_t num_expired() const;
+
+  // Forgets the prerequisites and discards the held requests.
+  void Clear();
+
+ private:
+  using MacKey = std::pair<std::string, uint64_t>;
+
+  // Returns true if op must wait for a prerequisite.
+  bool MustWaitLocked(const AsyncOp& op) const;
+
+  const int64_t hold_ns_;
+
+  mutable std::mutex mutex_;
+
+  // Prerequisites in place, by server address.
+  absl::flat_hash_map<std::string, absl::flat_hash_set<Prerequisite>>
+      in_place_;
+
+  // Held requests, in the order they were queued.
+  std::vector<AsyncOp> held_;
+
+  // Server and MAC address of each held request.
+  absl::flat_hash_set<MacKey> held_macs_;
+
+  uint64_t num_held_ = 0;
+  uint64_t num_expired_ = 0;
+};
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_DEPENDENCY_SCHEDULER_H_
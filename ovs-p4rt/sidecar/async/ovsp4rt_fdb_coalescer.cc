@@ -0,0 +1,98 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ovsp4rt_fdb_coalescer.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "ovsp4rt_private.h"
+
+namespace ovsp4rt {
+
+namespace {
+
+// Returns true if two inserts would program the same entry. A bytewise
+// comparison may report a difference in padding; that only means the
+// second insert is kept.
+bool SameLearnInfo(const struct mac_learning_info& a,
+                   const struct mac_learning_info& b) {
+  return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+}  // namespace
+
+size_t CoalesceFdbOps(std::vector<AsyncOp>& ops) {
+  using EntryKey = std::pair<absl::string_view, uint64_t>;
+
+  // Indexes of the requests still pending for each entry, in order.
+  absl::flat_hash_map<EntryKey, std::vector<size_t>> pending;
+  std::vector<bool> elided(ops.size(), false);
+  size_t num_elided = 0;
+
+  for (size_t i = 0; i < ops.size(); i++) {
+    const AsyncOp& op = ops[i];
+    if (op.type != AsyncOp::CONFIG_FDB_ENTRY) {
+      continue;
+    }
+
+    auto& live = pending[EntryKey(op.grpc_addr, FdbKey(op.learn_info))];
+    if (live.empty()) {
+      live.push_back(i);
+      continue;
+    }
+
+    const AsyncOp& prev = ops[live.back()];
+    if (prev.insert_entry && !op.insert_entry &&
+        (live.size() == 1 || !ops[live[live.size() - 2]].insert_entry)) {
+      // Insert followed by delete. Not if the insert follows another
+      // insert, which it would have found in place.
+      //
+      // The entry may already have been in place before the insert
+      // (e.g., a MAC that flapped), so only the insert is removed. The
+      // delete succeeds even if the entry is not found.
+      elided[live.back()] = true;
+      num_elided++;
+      live.pop_back();
+      if (live.empty()) {
+        live.push_back(i);
+      } else {
+        // Now repeats the pending delete.
+        elided[i] = true;
+        num_elided++;
+      }
+    } else if (prev.insert_entry && op.insert_entry &&
+               SameLearnInfo(prev.learn_info, op.learn_info)) {
+      // Repeated insert.
+      elided[i] = true;
+      num_elided++;
+    } else if (!prev.insert_entry && !op.insert_entry) {
+      // Repeated delete.
+      elided[i] = true;
+      num_elided++;
+    } else {
+      live.push_back(i);
+    }
+  }
+
+  if (num_elided) {
+    size_t j = 0;
+    for (size_t i = 0; i < ops.size(); i++) {
+      if (!elided[i]) {
+        if (i != j) {
+          ops[j] = std::move(ops[i]);
+        }
+        j++;
+      }
+    }
+    ops.resize(j);
+  }
+
+  return num_elided;
+}
+
+}  // namespace ovsp4rt
@@ -0,0 +1,33 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_FDB_COALESCER_H_
+#define OVSP4RT_FDB_COALESCER_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "async/ovsp4rt_async_writer.h"
+
+namespace ovsp4rt {
+
+// Removes the FDB requests in a batch that would have no net effect,
+// and returns the number of requests removed.
+//
+// Requests are grouped by server and FDB entry (bridge ID and MAC
+// address). For each entry, only the latest pending intent is kept:
+//
+//  - An insert followed by a delete is removed, and the delete is kept,
+//    since the entry may have been in place before the insert.
+//  - An insert that repeats the pending insert is removed.
+//  - A delete that follows a pending delete is removed.
+//
+// A delete followed by an insert (e.g., a MAC that moved to another
+// port) is left alone. Other requests are never removed, and the
+// order of the remaining requests is preserved.
+extern size_t CoalesceFdbOps(std::vector<AsyncOp>& ops);
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_FDB_COALESCER_H_
@@ -0,0 +1,99 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_MPSC_QUEUE_H_
+#define OVSP4RT_MPSC_QUEUE_H_
+
+#include <atomic>
+#include <utility>
+
+namespace ovsp4rt {
+
+// Unbounded multi-producer, single-consumer FIFO queue.
+//
+// Push() is lock-free and wait-free: a producer swaps its node into the
+// head of the list with a single atomic exchange. Pop() may only be
+// called from one thread at a time. It returns false if the queue is
+// empty, or if the next item is still being linked in by a producer;
+// the caller should try again later in that case.
+//
+// This is D. Vyukov's intrusive MPSC queue, with a stub node so the
+// list is never empty.
+template <typename T>
+class MpscQueue {
+ public:
+  MpscQueue() : head_(&stub_), tail_(&stub_) {}
+
+  ~MpscQueue() {
+    T value;
+    while (Pop(&value)) {
+    }
+  }
+
+  // Disable copy semantics.
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  // Adds an item to the queue. May be called from any thread.
+  void Push(T value) { PushNode(new Node(std::move(value))); }
+
+  // Removes the item at the front of the queue. Returns false if there
+  // is no item available. Must only be called from the consumer thread.
+  bool Pop(T* value) {
+    Node* tail = tail_;
+    Node* next = tail->next.load(std::memory_order_acquire);
+
+    if (tail == &stub_) {
+      if (next == nullptr) {
+        return false;
+      }
+      tail_ = next;
+      tail = next;
+      next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next == nullptr) {
+      if (tail != head_.load(std::memory_order_acquire)) {
+        // A producer has swapped in a new head but not yet linked it.
+        return false;
+      }
+      // Put the stub back, so we can take the last real node.
+      PushNode(&stub_);
+      next = tail->next.load(std::memory_order_acquire);
+      if (next == nullptr) {
+        return false;
+      }
+    }
+
+    tail_ = next;
+    *value = std::move(tail->value);
+    delete tail;
+    return true;
+  }
+
+ private:
+  struct Node {
+    Node() = default;
+    explicit Node(T v) : value(std::move(v)) {}
+    std::atomic<Node*> next{nullptr};
+    T value;
+  };
+
+  void PushNode(Node* node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+  }
+
+  // Most recently pushed node. Updated by the producers.
+  std::atomic<Node*> head_;
+
+  // Oldest node. Only accessed by the consumer.
+  Node* tail_;
+
+  Node stub_;
+};
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_MPSC_QUEUE_H_
@@ -0,0 +1,105 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ovsp4rt_sharded_writer.h"
+
+#include <algorithm>
+
+#include "absl/flags/flag.h"
+
+ABSL_FLAG(uint32_t, async_shards, 1,
+          "Number of writer threads in asynchronous mode. FDB requests are "
+          "divided among them by bridge ID.");
+
+namespace ovsp4rt {
+
+AsyncOpFilter ShardFilter(uint32_t shard, uint32_t num_shards) {
+  if (num_shards <= 1) {
+    return nullptr;
+  }
+  return [shard, num_shards](const AsyncOp& op) {
+    return op.learn_info.bridge_id % num_shards == shard;
+  };
+}
+
+ShardedWriter& ShardedWriter::Instance() {
+  // Intentionally leaked: the writer threads may still be running
+  // when the process exits.
+  static ShardedWriter* instance = new ShardedWriter(
+      absl::GetFlag(FLAGS_async_shards),
+      [](uint32_t shard, uint32_t num_shards) {
+        auto select = ShardFilter(shard, num_shards);
+        return std::make_unique<AsyncWriter>(
+            [select](std::vector<AsyncOp>& ops) {
+              ExecuteAsyncOps(ops, select);
+            },
+            [select](bool all) { return ReleaseHeldAsyncOps(all, select); });
+      });
+  return *instance;
+}
+
+ShardedWriter::ShardedWriter(uint32_t num_shards,
+                             const WriterFactory& factory) {
+  num_shards = std::clamp<uint32_t>(num_shards, 1, kMaxShards);
+  shards_.reserve(num_shards);
+  for (uint32_t shard = 0; shard < num_shards; shard++) {
+    shards_.push_back(factory(shard, num_shards));
+  }
+  if (num_shards > 1) {
+    shards_[0]->SetRemovalHook([this]() { FlushOtherShards(); });
+  }
+}
+
+void ShardedWriter::Enable(uint32_t queue_limit) {
+  for (auto& shard : shards_) {
+    shard->Enable(queue_limit);
+  }
+}
+
+void ShardedWriter::Disable() {
+  for (auto& shard : shards_) {
+    shard->Disable();
+  }
+}
+
+void ShardedWriter::Flush() {
+  for (auto& shard : shards_) {
+    shard->Flush();
+  }
+}
+
+void ShardedWriter::FlushOtherShards() {
+  for (size_t i = 1; i < shards_.size(); i++) {
+    shards_[i]->Flush();
+  }
+}
+
+void ShardedWriter::GetStats(struct ovsp4rt_async_stats* stats) const {
+  *stats = {};
+  for (const auto& shard : shards_) {
+    struct ovsp4rt_async_stats shard_stats;
+    shard->GetStats(&shard_stats);
+    stats->enqueued += shard_stats.enqueued;
+    stats->completed += shard_stats.completed;
+    stats->dropped += shard_stats.dropped;
+    stats->coalesced += shard_stats.coalesced;
+    stats->batches += shard_stats.batches;
+    stats->queue_depth += shard_stats.queue_depth;
+    stats->max_queue_depth =
+        std::max(stats->max_queue_depth, shard_stats.max_queue_depth);
+    stats->total_latency_us += shard_stats.total_latency_us;
+    stats->max_latency_us =
+        std::max(stats->max_latency_us, shard_stats.max_latency_us);
+  }
+}
+
+bool ShardedWriter::GetShardStats(uint32_t shard,
+                                  struct ovsp4rt_async_stats* stats) const {
+  if (shard >= shards_.size()) {
+    return false;
+  }
+  shards_[shard]->GetStats(stats);
+  return true;
+}
+
+}  // namespace ovsp4rt
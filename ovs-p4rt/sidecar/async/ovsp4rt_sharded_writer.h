@@ -0,0 +1,113 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_SHARDED_WRITER_H_
+#define OVSP4RT_SHARDED_WRITER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "async/ovsp4rt_async_writer.h"
+#include "ovsp4rt/ovs-p4rt.h"
+
+namespace ovsp4rt {
+
+// Runs the asynchronous requests on several writers (shards), so that
+// the FDB entries of different bridges are programmed concurrently.
+//
+// An FDB request goes to the shard of its bridge, so the requests for
+// a bridge stay in order. The other requests (ports, tunnels, VLANs
+// and IP-MAC maps) go to shard 0. The DependencyScheduler holds an FDB
+// request until the tunnel and VLAN entries it refers to are in place,
+// whichever shard programs them. Before shard 0 processes a request
+// that removes a tunnel or VLAN, it waits until the other shards have
+// processed the requests queued before it, so that no FDB entry still
+// refers to what it removes. The caller does not wait.
+//
+// All shards write through the shared session for the server, each in
+// its own group of writes (see AsyncWriteChannel::Group).
+class ShardedWriter {
+ public:
+  // Creates the writer for a shard.
+  using WriterFactory = std::function<std::unique_ptr<AsyncWriter>(
+      uint32_t shard, uint32_t num_shards)>;
+
+  // Maximum number of shards: one per bridge.
+  static constexpr uint32_t kMaxShards = MAX_P4_BRIDGE_ID + 1;
+
+  // Returns the process-wide writer used by the API functions.
+  static ShardedWriter& Instance();
+
+  // Creates num_shards shards, limited to [1, kMaxShards].
+  ShardedWriter(uint32_t num_shards, const WriterFactory& factory);
+
+  // Disable copy semantics.
+  ShardedWriter(const ShardedWriter&) = delete;
+  ShardedWriter& operator=(const ShardedWriter&) = delete;
+
+  // Enables asynchronous mode on every shard. A queue_limit of zero
+  // selects the default. The limit applies to each shard.
+  void Enable(uint32_t queue_limit);
+
+  // Disables asynchronous mode and waits for the queued requests to
+  // be processed.
+  void Disable();
+
+  bool enabled() const { return shards_[0]->enabled(); }
+
+  // Queues a request on its shard if asynchronous mode is enabled.
+  // Returns false if the caller should process the request itself.
+  template <typename Info>
+  bool Enqueue(AsyncOp::Type type, const Info& info, bool insert_entry,
+               const char* grpc_addr) {
+    return shards_[ShardOf(info)]->Enqueue(type, info, insert_entry,
+                                           grpc_addr);
+  }
+
+  // Waits until all requests queued before the call have been
+  // processed, on every shard.
+  void Flush();
+
+  // Returns the statistics of all shards combined. The maximums are
+  // the largest of any shard.
+  void GetStats(struct ovsp4rt_async_stats* stats) const;
+
+  // Returns the statistics of a shard. Returns false if there is no
+  // such shard.
+  bool GetShardStats(uint32_t shard, struct ovsp4rt_async_stats* stats) const;
+
+  uint32_t num_shards() const { return shards_.size(); }
+
+  // Returns the shard that processes the requests for a bridge.
+  uint32_t ShardOfBridge(uint32_t bridge_id) const {
+    return bridge_id % shards_.size();
+  }
+
+ private:
+  uint32_t ShardOf(const struct mac_learning_info& info) const {
+    return ShardOfBridge(info.bridge_id);
+  }
+
+  template <typename Info>
+  uint32_t ShardOf(const Info& info) const {
+    return 0;
+  }
+
+  // Waits until shards other than shard 0 have processed their queued
+  // requests. The removal hook of shard 0.
+  void FlushOtherShards();
+
+  std::vector<std::unique_ptr<AsyncWriter>> shards_;
+};
+
+// Returns the filter that selects the FDB requests of a shard, or an
+// empty filter if there is only one shard.
+extern AsyncOpFilter ShardFilter(uint32_t shard, uint32_t num_shards);
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_SHARDED_WRITER_H_
@@ -0,0 +1,268 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ovsp4rt_journal.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "gtest/gtest.h"
+#include "ovsp4rt/ovs-p4rt.h"
+#include "ovsp4rt_journal_file.h"
+#include "ovsp4rt_journal_json.h"
+#include "p4/v1/p4runtime.pb.h"
+
+namespace ovsp4rt {
+
+class JournalTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char path[] = "/tmp/ovsp4rt_journal_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    path_ = path;
+  }
+
+  void TearDown() override {
+    JournalFile::Instance().Close();
+    unlink(path_.c_str());
+  }
+
+  // Returns the entries in the journal file, oldest first.
+  std::vector<uint64_t> Sequences(JournalFile& file) {
+    std::vector<uint64_t> sequences;
+    file.ForEach([&sequences](const JournalRecordHeader& record,
+                              absl::string_view payload) {
+      sequences.push_back(record.sequence);
+    });
+    return sequences;
+  }
+
+  uint64_t AppendString(JournalFile& file, const std::string& text) {
+    absl::string_view part(text);
+    return file.Append(&part, 1);
+  }
+
+  std::string path_;
+};
+
+TEST_F(JournalTest, append_and_read_back) {
+  JournalFile file;
+  ASSERT_TRUE(file.Open(path_, JournalFile::kMinCapacity).ok());
+
+  const absl::string_view parts[] = {"abc", "defg"};
+  EXPECT_EQ(file.Append(parts, 2), 1);
+  EXPECT_EQ(AppendString(file, "xyz"), 2);
+
+  std::vector<std::string> payloads;
+  file.ForEach([&payloads](const JournalRecordHeader& record,
+                           absl::string_view payload) {
+    payloads.emplace_back(payload);
+  });
+  EXPECT_EQ(payloads, (std::vector<std::string>{"abcdefg", "xyz"}));
+}
+
+TEST_F(JournalTest, full_ring_overwrites_oldest_entries) {
+  JournalFile file;
+  ASSERT_TRUE(file.Open(path_, JournalFile::kMinCapacity).ok());
+
+  // Enough entries to wrap around the ring several times.
+  const std::string text(1000, 'x');
+  constexpr uint64_t kNumEntries = 300;
+  for (uint64_t i = 1; i <= kNumEntries; i++) {
+    ASSERT_EQ(AppendString(file, text), i);
+  }
+
+  auto sequences = Sequences(file);
+  ASSERT_FALSE(sequences.empty());
+  EXPECT_LT(sequences.size(), kNumEntries);
+  EXPECT_EQ(sequences.back(), kNumEntries);
+  for (size_t i = 1; i < sequences.size(); i++) {
+    EXPECT_EQ(sequences[i], sequences[i - 1] + 1);
+  }
+}
+
+TEST_F(JournalTest, oversized_entry_is_rejected) {
+  JournalFile file;
+  ASSERT_TRUE(file.Open(path_, JournalFile::kMinCapacity).ok());
+  EXPECT_EQ(AppendString(file, std::string(JournalFile::kMinCapacity, 'x')),
+            0);
+  EXPECT_TRUE(Sequences(file).empty());
+}
+
+TEST_F(JournalTest, reopen_appends_to_existing_journal) {
+  {
+    JournalFile file;
+    ASSERT_TRUE(file.Open(path_, JournalFile::kMinCapacity).ok());
+    AppendString(file, "first");
+  }
+
+  JournalFile file;
+  ASSERT_TRUE(file.Open(path_, JournalFile::kMinCapacity).ok());
+  EXPECT_EQ(AppendString(file, "second"), 2);
+  EXPECT_EQ(Sequences(file), (std::vector<uint64_t>{1, 2}));
+}
+
+TEST_F(JournalTest, read_only_journal) {
+  {
+    JournalFile file;
+    ASSERT_TRUE(file.Open(path_, JournalFile::kMinCapacity).ok());
+    AppendString(file, "first");
+  }
+
+  JournalFile file;
+  ASSERT_TRUE(file.OpenReadOnly(path_).ok());
+  EXPECT_EQ(AppendString(file, "second"), 0);
+  EXPECT_EQ(Sequences(file), (std::vector<uint64_t>{1}));
+}
+
+TEST_F(JournalTest, read_only_rejects_other_files) {
+  ASSERT_EQ(truncate(path_.c_str(), 2 * JournalFile::kMinCapacity), 0);
+  JournalFile file;
+  EXPECT_EQ(file.OpenReadOnly(path_).code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST_F(JournalTest, journal_does_nothing_when_closed) {
+  {
+    Journal journal;
+    journal.recordInput("ovsp4rt_config_vlan_entry", uint16_t{10}, true);
+  }
+  ASSERT_TRUE(JournalFile::Instance().Open(path_, JournalFile::kMinCapacity)
+                  .ok());
+  EXPECT_TRUE(Sequences(JournalFile::Instance()).empty());
+}
+
+TEST_F(JournalTest, journal_entry_round_trip) {
+  ASSERT_TRUE(JournalFile::Instance().Open(path_, JournalFile::kMinCapacity)
+                  .ok());
+
+  struct mac_learning_info learn_info = {};
+  learn_info.bridge_id = 3;
+  learn_info.mac_addr[5] = 0x42;
+  learn_info.src_port = 17;
+
+  ::p4::v1::WriteRequest request;
+  request.set_device_id(1);
+  request.add_updates()->set_type(::p4::v1::Update::INSERT);
+
+  {
+    Journal journal;
+    journal.recordInput("ovsp4rt_config_fdb_entry", learn_info, true);
+    journal.recordOutput("ovsp4rt_config_fdb_entry", request);
+    journal.recordOutput("ovsp4rt_config_fdb_entry", request);
+    journal.recordStatus(absl::AlreadyExistsError("duplicate"));
+  }
+
+  std::vector<nlohmann::json> entries;
+  JournalFile::Instance().ForEach(
+      [&entries](const JournalRecordHeader& record, absl::string_view payload) {
+        JournalEntry entry;
+        ASSERT_TRUE(DecodeJournalEntry(record, payload, &entry));
+        EXPECT_EQ(entry.input_type, JOURNAL_INPUT_MAC_LEARNING_INFO);
+        EXPECT_LE(entry.start_ns, entry.end_ns);
+        entries.push_back(JournalEntryToJson(entry));
+      });
+
+  ASSERT_EQ(entries.size(), 1);
+  const auto& json = entries[0];
+  EXPECT_EQ(json["func_name"], "ovsp4rt_config_fdb_entry");
+  EXPECT_EQ(json["struct_name"], "mac_learning_info");
+  EXPECT_EQ(json["params"]["learn_info"]["bridge_id"], 3);
+  EXPECT_EQ(json["params"]["learn_info"]["src_port"], 17);
+  EXPECT_EQ(json["params"]["insert_entry"], true);
+  EXPECT_EQ(json["status"], "ALREADY_EXISTS");
+  ASSERT_EQ(json["output"].size(), 2);
+  EXPECT_EQ(json["output"][0]["deviceId"], "1");
+  EXPECT_EQ(json["output"][0]["updates"][0]["type"], "INSERT");
+}
+
+TEST_F(JournalTest, current_journal_is_innermost) {
+  {
+    Journal journal;
+    EXPECT_EQ(Journal::Current(), nullptr);
+  }
+
+  ASSERT_EQ(ovsp4rt_journal_open(path_.c_str(), JournalFile::kMinCapacity),
+            0);
+  {
+    Journal outer;
+    EXPECT_EQ(Journal::Current(), &outer);
+    {
+      Journal inner;
+      EXPECT_EQ(Journal::Current(), &inner);
+    }
+    EXPECT_EQ(Journal::Current(), &outer);
+  }
+  EXPECT_EQ(Journal::Current(), nullptr);
+}
+
+TEST_F(JournalTest, fdb_entries_are_journaled_as_array) {
+  ASSERT_EQ(ovsp4rt_journal_open(path_.c_str(), JournalFile::kMinCapacity),
+            0);
+
+  struct mac_learning_info learn_info[2] = {};
+  learn_info[0].src_port = 17;
+  learn_info[1].src_port = 18;
+  {
+    Journal journal;
+    journal.recordInputs("ovsp4rt_config_fdb_entries", learn_info, 2, true);
+  }
+
+  std::vector<nlohmann::json> entries;
+  JournalFile::Instance().ForEach(
+      [&entries](const JournalRecordHeader& record, absl::string_view payload) {
+        JournalEntry entry;
+        ASSERT_TRUE(DecodeJournalEntry(record, payload, &entry));
+        entries.push_back(JournalEntryToJson(entry));
+      });
+
+  ASSERT_EQ(entries.size(), 1);
+  const auto& json = entries[0];
+  EXPECT_EQ(json["func_name"], "ovsp4rt_config_fdb_entries");
+  ASSERT_EQ(json["inputs"].size(), 2);
+  EXPECT_EQ(json["inputs"][0]["params"]["learn_info"]["src_port"], 17);
+  EXPECT_EQ(json["inputs"][1]["params"]["learn_info"]["src_port"], 18);
+}
+
+TEST_F(JournalTest, close_while_appending) {
+  ASSERT_EQ(ovsp4rt_journal_open(path_.c_str(), JournalFile::kMinCapacity),
+            0);
+
+  std::atomic<bool> stop{false};
+  std::thread writer([&stop]() {
+    while (!stop.load()) {
+      Journal journal;
+      journal.recordInput("ovsp4rt_config_vlan_entry", uint16_t{10}, true);
+    }
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  ovsp4rt_journal_close();
+  EXPECT_FALSE(JournalFile::Instance().is_open());
+  stop.store(true);
+  writer.join();
+}
+
+TEST_F(JournalTest, malformed_entry_is_rejected) {
+  JournalRecordHeader record = {};
+  JournalEntry entry;
+  EXPECT_FALSE(DecodeJournalEntry(record, "short", &entry));
+
+  JournalEntryHeader header = {};
+  header.num_outputs = 1;
+  std::string payload(reinterpret_cast<const char*>(&header), sizeof(header));
+  EXPECT_FALSE(DecodeJournalEntry(record, payload, &entry));
+}
+
+}  // namespace ovsp4rt
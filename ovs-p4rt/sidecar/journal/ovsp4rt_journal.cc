@@ -3,47 +3,190 @@
 
 #include "ovsp4rt_journal.h"
 
-#include "ovsp4rt_encode.h"
+#include <string.h>
 
-namespace {
-constexpr uint32_t LEARN_INFO_SCHEMA = 1;
-constexpr uint32_t PORT_INFO_SCHEMA = 1;
-}  // namespace
+#include <algorithm>
+
+#include "absl/time/clock.h"
 
 namespace ovsp4rt {
 
+thread_local Journal* Journal::current_ = nullptr;
+
+Journal::Journal() : enabled_(JournalFile::Instance().is_open()) {
+  if (enabled_) {
+    header_.start_ns = absl::GetCurrentTimeNanos();
+    previous_ = current_;
+    current_ = this;
+  }
+}
+
+Journal::~Journal() {
+  saveEntry();
+  if (enabled_) {
+    current_ = previous_;
+  }
+}
+
+void Journal::setInput(const char* func_name, JournalInputType input_type,
+                       const void* input, size_t input_size,
+                       bool insert_entry) {
+  if (!enabled_) {
+    return;
+  }
+  func_name_ = func_name;
+  header_.input_type = input_type;
+  header_.insert_entry = insert_entry;
+  header_.input_size = input_size;
+  memcpy(&input_, input, input_size);
+  input_data_ = &input_;
+}
+
 // mac_learning_info
 void Journal::recordInput(const char* func_name,
                           const struct mac_learning_info& info,
                           bool insert_entry) {
-  input_ = EncodeMacLearningInfo(func_name, info, insert_entry);
+  setInput(func_name, JOURNAL_INPUT_MAC_LEARNING_INFO, &info, sizeof(info),
+           insert_entry);
+}
+
+// mac_learning_info array
+void Journal::recordInputs(const char* func_name,
+                           const struct mac_learning_info* info,
+                           size_t num_entries, bool insert_entry) {
+  if (!enabled_) {
+    return;
+  }
+  func_name_ = func_name;
+  header_.input_type = JOURNAL_INPUT_MAC_LEARNING_INFO;
+  header_.insert_entry = insert_entry;
+  header_.input_size = num_entries * sizeof(*info);
+  input_data_ = info;
 }
 
 // ip_mac_map_info
 void Journal::recordInput(const char* func_name, const ip_mac_map_info& info,
                           bool insert_entry) {
-  input_ = EncodeIpMacMapInfo(func_name, info, insert_entry);
+  setInput(func_name, JOURNAL_INPUT_IP_MAC_MAP_INFO, &info, sizeof(info),
+           insert_entry);
 }
 
 // tunnel_info
 void Journal::recordInput(const char* func_name, const tunnel_info& info,
                           bool insert_entry) {
-  input_ = EncodeTunnelInfo(func_name, info, insert_entry);
+  setInput(func_name, JOURNAL_INPUT_TUNNEL_INFO, &info, sizeof(info),
+           insert_entry);
 }
 
 // src_port_info
 void Journal::recordInput(const char* func_name, const src_port_info info,
                           bool insert_entry) {
-  input_ = EncodeSrcPortInfo(func_name, info, insert_entry);
+  setInput(func_name, JOURNAL_INPUT_SRC_PORT_INFO, &info, sizeof(info),
+           insert_entry);
 }
 
 // vlan_id
 void Journal::recordInput(const char* func_name, uint16_t vlan_id,
                           bool insert_entry) {
-  input_ = EncodeVlanId(func_name, vlan_id, insert_entry);
+  setInput(func_name, JOURNAL_INPUT_VLAN_ID, &vlan_id, sizeof(vlan_id),
+           insert_entry);
 }
 
 // ::p4::v1::WriteRequest
-void recordOutput(const char* func, ::p4::v1::WriteRequest& request) {}
+void Journal::recordOutput(const char* func,
+                           const ::p4::v1::WriteRequest& request) {
+  if (!enabled_) {
+    return;
+  }
+  // Serialize straight into the entry, after the length.
+  uint32_t size = request.ByteSizeLong();
+  size_t offset = outputs_.size();
+  outputs_.resize(offset + sizeof(size) + size);
+  memcpy(&outputs_[offset], &size, sizeof(size));
+  request.SerializeWithCachedSizesToArray(
+      reinterpret_cast<uint8_t*>(&outputs_[offset + sizeof(size)]));
+  header_.num_outputs++;
+}
+
+// absl::Status
+void Journal::recordStatus(const absl::Status& status) {
+  header_.status = static_cast<int32_t>(status.code());
+}
+
+void Journal::saveEntry() {
+  if (!enabled_ || saved_) {
+    return;
+  }
+  saved_ = true;
+
+  header_.end_ns = absl::GetCurrentTimeNanos();
+  size_t func_name_len = std::min<size_t>(strlen(func_name_), UINT8_MAX);
+  header_.func_name_len = func_name_len;
+
+  const absl::string_view parts[] = {
+      absl::string_view(reinterpret_cast<const char*>(&header_),
+                        sizeof(header_)),
+      absl::string_view(func_name_, func_name_len),
+      absl::string_view(static_cast<const char*>(input_data_),
+                        header_.input_size),
+      outputs_,
+  };
+  JournalFile::Instance().Append(parts, sizeof(parts) / sizeof(parts[0]));
+}
+
+bool DecodeJournalEntry(const JournalRecordHeader& record,
+                        absl::string_view payload, JournalEntry* entry) {
+  JournalEntryHeader header;
+  if (payload.size() < sizeof(header)) {
+    return false;
+  }
+  memcpy(&header, payload.data(), sizeof(header));
+  payload.remove_prefix(sizeof(header));
+
+  if (payload.size() < header.func_name_len + uint64_t{header.input_size}) {
+    return false;
+  }
+  entry->sequence = record.sequence;
+  entry->start_ns = header.start_ns;
+  entry->end_ns = header.end_ns;
+  entry->status = static_cast<absl::StatusCode>(header.status);
+  entry->input_type = static_cast<JournalInputType>(header.input_type);
+  entry->insert_entry = header.insert_entry;
+  entry->func_name = payload.substr(0, header.func_name_len);
+  payload.remove_prefix(header.func_name_len);
+  entry->input = payload.substr(0, header.input_size);
+  payload.remove_prefix(header.input_size);
+
+  entry->outputs.clear();
+  for (uint32_t i = 0; i < header.num_outputs; i++) {
+    uint32_t size;
+    if (payload.size() < sizeof(size)) {
+      return false;
+    }
+    memcpy(&size, payload.data(), sizeof(size));
+    payload.remove_prefix(sizeof(size));
+    if (payload.size() < size) {
+      return false;
+    }
+    entry->outputs.push_back(payload.substr(0, size));
+    payload.remove_prefix(size);
+  }
+  return payload.empty();
+}
 
 }  // namespace ovsp4rt
+
+//----------------------------------------------------------------------
+// ovsp4rt_journal_open
+//----------------------------------------------------------------------
+int ovsp4rt_journal_open(const char* path, uint64_t capacity) {
+  auto& journal_file = ovsp4rt::JournalFile::Instance();
+  auto status = capacity ? journal_file.Open(path, capacity)
+                         : journal_file.Open(path);
+  return static_cast<int>(status.code());
+}
+
+//----------------------------------------------------------------------
+// ovsp4rt_journal_close
+//----------------------------------------------------------------------
+void ovsp4rt_journal_close(void) { ovsp4rt::JournalFile::Instance().Close(); }
@@ -7,22 +7,85 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-#include <nlohmann/json.hpp>
+#include <string>
 #include <vector>
 
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
 #include "ovsp4rt/ovs-p4rt.h"
+#include "ovsp4rt_journal_file.h"
 #include "p4/v1/p4runtime.pb.h"
 
 namespace ovsp4rt {
 
-// Captures the inputs and outputs to an API function.
+// Type of the input to an API function.
+enum JournalInputType : uint16_t {
+  JOURNAL_INPUT_NONE = 0,
+  JOURNAL_INPUT_MAC_LEARNING_INFO = 1,
+  JOURNAL_INPUT_IP_MAC_MAP_INFO = 2,
+  JOURNAL_INPUT_TUNNEL_INFO = 3,
+  JOURNAL_INPUT_SRC_PORT_INFO = 4,
+  JOURNAL_INPUT_VLAN_ID = 5,
+};
+
+// Fixed part of the payload of a journal entry. It is followed by the
+// function name, the input structure, and the WriteRequests, each
+// serialized and preceded by its length as a uint32_t.
+struct JournalEntryHeader {
+  uint64_t start_ns;     // wall-clock time the call began
+  uint64_t end_ns;       // wall-clock time the entry was saved
+  int32_t status;        // absl::StatusCode
+  uint16_t input_type;   // JournalInputType
+  uint8_t insert_entry;  // bool
+  uint8_t func_name_len;
+  uint32_t input_size;
+  uint32_t num_outputs;
+};
+
+// A journal entry read from a journal file. The views refer to the
+// payload it was decoded from.
+struct JournalEntry {
+  uint64_t sequence;
+  uint64_t start_ns;
+  uint64_t end_ns;
+  absl::StatusCode status;
+  JournalInputType input_type;
+  bool insert_entry;
+  absl::string_view func_name;
+  absl::string_view input;
+  std::vector<absl::string_view> outputs;
+};
+
+// Decodes the payload of a journal record. Returns false if the payload
+// is malformed.
+extern bool DecodeJournalEntry(const JournalRecordHeader& record,
+                               absl::string_view payload, JournalEntry* entry);
+
+// Captures the inputs and outputs to an API function, and saves them in
+// the journal file when it goes out of scope. Does nothing if the
+// journal file is not open.
+//
+// While it is in scope, the journal is the current journal of its
+// thread, and the WriteRequests the thread sends are added to it (see
+// Current()). Requests sent by the asynchronous writer threads are not
+// captured.
 class Journal {
  public:
-  ~Journal() { saveEntry(); }
+  Journal();
+  ~Journal();
+
+  // Disable copy semantics.
+  Journal(const Journal&) = delete;
+  Journal& operator=(const Journal&) = delete;
 
   void recordInput(const char* func_name, const struct mac_learning_info& info,
                    bool insert_entry);
 
+  // Records an array of inputs, which must outlive the journal.
+  void recordInputs(const char* func_name,
+                    const struct mac_learning_info* info, size_t num_entries,
+                    bool insert_entry);
+
   void recordInput(const char* func_name, const ip_mac_map_info& info,
                    bool insert_entry);
 
@@ -34,13 +97,39 @@ class Journal {
 
   void recordInput(const char* func_name, uint16_t vlan_id, bool insert_entry);
 
-  void recordOutput(const char* func, ::p4::v1::WriteRequest& request) {}
+  void recordOutput(const char* func, const ::p4::v1::WriteRequest& request);
+
+  void recordStatus(const absl::Status& status);
+
+  // Writes the entry to the journal file. Only the first call has any
+  // effect.
+  void saveEntry();
 
-  void saveEntry() {}
+  // Returns the current journal of the calling thread, or nullptr if
+  // there is none or the journal file is not open.
+  static Journal* Current() { return current_; }
 
  private:
-  nlohmann::json input_;
-  std::vector<nlohmann::json> output_;
+  void setInput(const char* func_name, JournalInputType input_type,
+                const void* input, size_t input_size, bool insert_entry);
+
+  static thread_local Journal* current_;
+
+  bool enabled_;
+  bool saved_ = false;
+  Journal* previous_ = nullptr;
+  JournalEntryHeader header_ = {};
+  const char* func_name_ = "";
+  // The input: input_, or an array owned by the caller.
+  const void* input_data_ = &input_;
+  union {
+    struct mac_learning_info learn_info;
+    struct ip_mac_map_info ip_info;
+    struct tunnel_info tnl_info;
+    struct src_port_info sp_info;
+    uint16_t vlan_id;
+  } input_;
+  std::string outputs_;
 };
 
 }  // namespace ovsp4rt
@@ -0,0 +1,46 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+// Converts a binary journal file to JSON, one entry per line.
+
+#include <stdio.h>
+
+#include <iostream>
+#include <string>
+
+#include "ovsp4rt_journal.h"
+#include "ovsp4rt_journal_file.h"
+#include "ovsp4rt_journal_json.h"
+
+using namespace ovsp4rt;
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s JOURNAL_FILE\n", argv[0]);
+    return 2;
+  }
+
+  JournalFile file;
+  auto status = file.OpenReadOnly(argv[1]);
+  if (!status.ok()) {
+    fprintf(stderr, "%s\n", std::string(status.message()).c_str());
+    return 1;
+  }
+
+  int num_malformed = 0;
+  file.ForEach([&num_malformed](const JournalRecordHeader& record,
+                                absl::string_view payload) {
+    JournalEntry entry;
+    if (!DecodeJournalEntry(record, payload, &entry)) {
+      num_malformed++;
+      return;
+    }
+    std::cout << JournalEntryToJson(entry).dump() << '\n';
+  });
+
+  if (num_malformed) {
+    fprintf(stderr, "%d malformed entries skipped\n", num_malformed);
+    return 1;
+  }
+  return 0;
+}
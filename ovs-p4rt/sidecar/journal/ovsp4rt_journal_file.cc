@@ -0,0 +1,236 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ovsp4rt_journal_file.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "absl/strings/str_cat.h"
+
+namespace ovsp4rt {
+
+namespace {
+
+absl::Status ErrnoStatus(const char* action, const std::string& path) {
+  return absl::InternalError(
+      absl::StrCat("Error ", action, " ", path, ": ", strerror(errno)));
+}
+
+}  // namespace
+
+JournalFile& JournalFile::Instance() {
+  // Intentionally leaked, so that API calls made while the process
+  // exits can still append to the journal.
+  static JournalFile* instance = new JournalFile;
+  return *instance;
+}
+
+absl::Status JournalFile::Open(const std::string& path, uint64_t capacity) {
+  // Whole pages, so the ring ends on a page boundary.
+  capacity = std::max(capacity, kMinCapacity);
+  capacity = (capacity + kJournalDataOffset - 1) & ~(kJournalDataOffset - 1);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  return Map(path, true, capacity);
+}
+
+absl::Status JournalFile::OpenReadOnly(const std::string& path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return Map(path, false, 0);
+}
+
+absl::Status JournalFile::Map(const std::string& path, bool writable,
+                              uint64_t capacity) {
+  if (is_open()) {
+    return absl::FailedPreconditionError("Journal file is already open");
+  }
+
+  fd_ = open(path.c_str(), writable ? O_RDWR | O_CREAT | O_CLOEXEC
+                                    : O_RDONLY | O_CLOEXEC,
+             0644);
+  if (fd_ < 0) {
+    return ErrnoStatus("opening", path);
+  }
+
+  struct stat st;
+  if (fstat(fd_, &st) < 0) {
+    auto status = ErrnoStatus("reading", path);
+    close(fd_);
+    fd_ = -1;
+    return status;
+  }
+
+  bool initialize = false;
+  if (writable) {
+    map_size_ = kJournalDataOffset + capacity;
+    if (static_cast<uint64_t>(st.st_size) != map_size_) {
+      // Discard whatever the file held before.
+      if (ftruncate(fd_, 0) < 0 || ftruncate(fd_, map_size_) < 0) {
+        auto status = ErrnoStatus("resizing", path);
+        close(fd_);
+        fd_ = -1;
+        return status;
+      }
+      initialize = true;
+    }
+  } else {
+    map_size_ = st.st_size;
+    if (map_size_ < kJournalDataOffset + kMinCapacity) {
+      close(fd_);
+      fd_ = -1;
+      return absl::InvalidArgumentError(
+          absl::StrCat(path, " is not a journal file"));
+    }
+  }
+
+  map_ = mmap(nullptr, map_size_, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+              MAP_SHARED, fd_, 0);
+  if (map_ == MAP_FAILED) {
+    auto status = ErrnoStatus("mapping", path);
+    map_ = nullptr;
+    close(fd_);
+    fd_ = -1;
+    return status;
+  }
+  header_ = static_cast<JournalFileHeader*>(map_);
+  ring_ = static_cast<char*>(map_) + kJournalDataOffset;
+
+  if (!initialize &&
+      !HeaderIsValid(writable ? capacity : map_size_ - kJournalDataOffset)) {
+    if (!writable) {
+      CloseLocked();
+      return absl::InvalidArgumentError(
+          absl::StrCat(path, " is not a journal file"));
+    }
+    initialize = true;
+  }
+
+  if (initialize) {
+    memset(header_, 0, sizeof(*header_));
+    memcpy(header_->magic, kJournalMagic, sizeof(header_->magic));
+    header_->version = kJournalVersion;
+    header_->capacity = capacity;
+    header_->next_sequence = 1;
+  }
+
+  writable_ = writable;
+  is_open_.store(true, std::memory_order_release);
+  return absl::OkStatus();
+}
+
+bool JournalFile::HeaderIsValid(uint64_t capacity) const {
+  const auto& header = *header_;
+  return memcmp(header.magic, kJournalMagic, sizeof(header.magic)) == 0 &&
+         header.version == kJournalVersion && header.capacity == capacity &&
+         header.capacity % 16 == 0 && header.head <= header.tail &&
+         header.tail - header.head <= header.capacity &&
+         header.head % 16 == 0 && header.tail % 16 == 0;
+}
+
+void JournalFile::Close() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  CloseLocked();
+}
+
+void JournalFile::CloseLocked() {
+  is_open_.store(false, std::memory_order_release);
+  if (map_) {
+    munmap(map_, map_size_);
+    map_ = nullptr;
+    header_ = nullptr;
+    ring_ = nullptr;
+  }
+  if (fd_ >= 0) {
+    close(fd_);
+    fd_ = -1;
+  }
+}
+
+uint64_t JournalFile::ReserveLocked(uint64_t space) {
+  uint64_t capacity = header_->capacity;
+  uint64_t tail = header_->tail;
+  uint64_t pos = tail % capacity;
+  uint64_t padding = pos + space > capacity ? capacity - pos : 0;
+
+  // Overwrite the oldest records. Advancing the head before their
+  // space is reused keeps the file consistent if the process dies.
+  while (tail + padding + space - header_->head > capacity) {
+    header_->head += JournalRecordSpace(RecordAt(header_->head)->length);
+  }
+
+  if (padding) {
+    auto* record = RecordAt(tail);
+    record->length = padding;
+    record->type = JOURNAL_RECORD_PADDING;
+    record->sequence = 0;
+    tail += padding;
+    header_->tail = tail;
+  }
+  return tail;
+}
+
+uint64_t JournalFile::Append(const absl::string_view* parts,
+                             size_t num_parts) {
+  if (!is_open()) {
+    return 0;
+  }
+
+  uint64_t length = sizeof(JournalRecordHeader);
+  for (size_t i = 0; i < num_parts; i++) {
+    length += parts[i].size();
+  }
+  uint64_t space = JournalRecordSpace(length);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!header_ || !writable_ || space > header_->capacity / 4) {
+    return 0;
+  }
+
+  uint64_t offset = ReserveLocked(space);
+  auto* record = RecordAt(offset);
+  char* data = reinterpret_cast<char*>(record + 1);
+  for (size_t i = 0; i < num_parts; i++) {
+    memcpy(data, parts[i].data(), parts[i].size());
+    data += parts[i].size();
+  }
+  record->length = length;
+  record->type = JOURNAL_RECORD_ENTRY;
+  record->sequence = header_->next_sequence++;
+
+  // The record is complete before the tail moves past it.
+  std::atomic_thread_fence(std::memory_order_release);
+  header_->tail = offset + space;
+  return record->sequence;
+}
+
+void JournalFile::ForEach(const Visitor& visitor) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!header_) {
+    return;
+  }
+
+  for (uint64_t offset = header_->head; offset < header_->tail;) {
+    const auto* record = RecordAt(offset);
+    uint64_t space = JournalRecordSpace(record->length);
+    if (record->length < sizeof(JournalRecordHeader) ||
+        offset % header_->capacity + space > header_->capacity) {
+      // Damaged; nothing after it can be trusted.
+      break;
+    }
+    if (record->type == JOURNAL_RECORD_ENTRY) {
+      visitor(*record,
+              absl::string_view(reinterpret_cast<const char*>(record + 1),
+                                record->length - sizeof(*record)));
+    }
+    offset += space;
+  }
+}
+
+}  // namespace ovsp4rt
@@ -0,0 +1,148 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_JOURNAL_FILE_H_
+#define OVSP4RT_JOURNAL_FILE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+
+namespace ovsp4rt {
+
+//----------------------------------------------------------------------
+// Journal file format
+//
+// A journal file is a JournalFileHeader, padded to kJournalDataOffset,
+// followed by a ring of capacity bytes. The ring holds records, each a
+// JournalRecordHeader followed by its payload and padded to a multiple
+// of 16 bytes. A record never wraps: if it does not fit before the end
+// of the ring, a padding record fills the rest of the ring, and the
+// record begins at the start. When the ring is full, the oldest records
+// are overwritten.
+//
+// Offsets in the file header are logical: they increase without bound,
+// and the position in the ring is the offset modulo the capacity.
+//
+// Integers are stored in host byte order. The file is meant to be read
+// on the system that wrote it.
+//----------------------------------------------------------------------
+
+constexpr char kJournalMagic[8] = {'O', 'V', 'S', 'P', '4', 'R', 'T', 'J'};
+constexpr uint32_t kJournalVersion = 1;
+constexpr uint64_t kJournalDataOffset = 4096;
+
+struct JournalFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+  uint64_t capacity;       // size of the ring, in bytes
+  uint64_t head;           // offset of the oldest record
+  uint64_t tail;           // offset just past the newest record
+  uint64_t next_sequence;  // sequence number of the next entry
+};
+
+enum JournalRecordType : uint32_t {
+  JOURNAL_RECORD_PADDING = 0,
+  JOURNAL_RECORD_ENTRY = 1,
+};
+
+struct JournalRecordHeader {
+  uint32_t length;    // including this header, excluding padding
+  uint32_t type;      // JournalRecordType
+  uint64_t sequence;  // increases by one with each entry
+};
+
+// Returns the space a record of the specified length takes in the ring.
+inline uint64_t JournalRecordSpace(uint64_t length) {
+  return (length + 15) & ~uint64_t{15};
+}
+
+//----------------------------------------------------------------------
+// JournalFile
+//
+// A memory-mapped journal file. Appending a record copies it into the
+// mapping; the kernel writes it to the file. Records survive a crash of
+// the process, but not of the system.
+//----------------------------------------------------------------------
+class JournalFile {
+ public:
+  static constexpr uint64_t kDefaultCapacity = 64 << 20;
+  static constexpr uint64_t kMinCapacity = 64 << 10;
+
+  JournalFile() = default;
+  ~JournalFile() { Close(); }
+
+  // Disable copy semantics.
+  JournalFile(const JournalFile&) = delete;
+  JournalFile& operator=(const JournalFile&) = delete;
+
+  // Returns the journal file the API functions write to.
+  static JournalFile& Instance();
+
+  // Opens or creates a journal file. An existing journal with the same
+  // capacity is appended to; any other file is reinitialized.
+  absl::Status Open(const std::string& path,
+                    uint64_t capacity = kDefaultCapacity);
+
+  // Opens an existing journal file for ForEach() only.
+  absl::Status OpenReadOnly(const std::string& path);
+
+  // Unmaps and closes the file.
+  void Close();
+
+  bool is_open() const { return is_open_.load(std::memory_order_acquire); }
+
+  // Appends an entry whose payload is the concatenation of the parts,
+  // and returns its sequence number. Returns zero if the file is not
+  // open for writing, or the entry is larger than a quarter of the
+  // ring.
+  uint64_t Append(const absl::string_view* parts, size_t num_parts);
+
+  // Calls the visitor for each entry, oldest first.
+  using Visitor = std::function<void(const JournalRecordHeader& record,
+                                     absl::string_view payload)>;
+  void ForEach(const Visitor& visitor);
+
+ private:
+  // Returns the record at a logical offset in the ring.
+  JournalRecordHeader* RecordAt(uint64_t offset) {
+    return reinterpret_cast<JournalRecordHeader*>(
+        ring_ + offset % header_->capacity);
+  }
+
+  // Maps the file, and validates the header unless it is being
+  // initialized. Requires mutex_.
+  absl::Status Map(const std::string& path, bool writable, uint64_t capacity);
+
+  // Returns true if the header describes a consistent journal with the
+  // capacity.
+  bool HeaderIsValid(uint64_t capacity) const;
+
+  // Unmaps and closes the file. Requires mutex_.
+  void CloseLocked();
+
+  // Makes room for space bytes at the tail, and returns the offset of
+  // the space. Requires mutex_.
+  uint64_t ReserveLocked(uint64_t space);
+
+  std::mutex mutex_;
+  std::atomic<bool> is_open_{false};
+  bool writable_ = false;
+  int fd_ = -1;
+  size_t map_size_ = 0;
+  void* map_ = nullptr;
+  JournalFileHeader* header_ = nullptr;
+  char* ring_ = nullptr;
+};
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_JOURNAL_FILE_H_
@@ -0,0 +1,118 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ovsp4rt_journal_json.h"
+
+#include <string.h>
+
+#include <string>
+
+#include "absl/status/status.h"
+#include "google/protobuf/util/json_util.h"
+#include "ovsp4rt_encode.h"
+#include "p4/v1/p4runtime.pb.h"
+
+namespace ovsp4rt {
+
+namespace {
+
+// Copies the input of an entry into a structure. Returns false if the
+// sizes differ, as they do if the journal was written by a build with a
+// different definition of the structure.
+template <typename T>
+bool CopyInput(const JournalEntry& entry, T* input) {
+  if (entry.input.size() != sizeof(*input)) {
+    return false;
+  }
+  memcpy(input, entry.input.data(), sizeof(*input));
+  return true;
+}
+
+// Encodes the input of an entry, as the Encode functions do.
+bool EncodeInput(const JournalEntry& entry, nlohmann::json& json) {
+  std::string func_name(entry.func_name);
+  switch (entry.input_type) {
+    case JOURNAL_INPUT_MAC_LEARNING_INFO: {
+      struct mac_learning_info info;
+      if (CopyInput(entry, &info)) {
+        json = EncodeMacLearningInfo(func_name.c_str(), info,
+                                     entry.insert_entry);
+        return true;
+      }
+      // An array, from ovsp4rt_config_fdb_entries().
+      if (entry.input.empty() || entry.input.size() % sizeof(info) != 0) {
+        return false;
+      }
+      json["func_name"] = func_name;
+      auto& inputs = json["inputs"];
+      inputs = nlohmann::json::array();
+      for (size_t offset = 0; offset < entry.input.size();
+           offset += sizeof(info)) {
+        memcpy(&info, entry.input.data() + offset, sizeof(info));
+        inputs.push_back(EncodeMacLearningInfo(func_name.c_str(), info,
+                                               entry.insert_entry));
+      }
+      return true;
+    }
+    case JOURNAL_INPUT_IP_MAC_MAP_INFO: {
+      struct ip_mac_map_info info;
+      if (!CopyInput(entry, &info)) return false;
+      json = EncodeIpMacMapInfo(func_name.c_str(), info, entry.insert_entry);
+      return true;
+    }
+    case JOURNAL_INPUT_TUNNEL_INFO: {
+      struct tunnel_info info;
+      if (!CopyInput(entry, &info)) return false;
+      json = EncodeTunnelInfo(func_name.c_str(), info, entry.insert_entry);
+      return true;
+    }
+    case JOURNAL_INPUT_SRC_PORT_INFO: {
+      struct src_port_info info;
+      if (!CopyInput(entry, &info)) return false;
+      json = EncodeSrcPortInfo(func_name.c_str(), info, entry.insert_entry);
+      return true;
+    }
+    case JOURNAL_INPUT_VLAN_ID: {
+      uint16_t vlan_id;
+      if (!CopyInput(entry, &vlan_id)) return false;
+      json = EncodeVlanId(func_name.c_str(), vlan_id, entry.insert_entry);
+      return true;
+    }
+    case JOURNAL_INPUT_NONE:
+      json["func_name"] = func_name;
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+nlohmann::json JournalEntryToJson(const JournalEntry& entry) {
+  nlohmann::json json;
+  if (!EncodeInput(entry, json)) {
+    json = nlohmann::json::object();
+    json["error"] = "unrecognized input";
+  }
+
+  json["sequence"] = entry.sequence;
+  json["start_ns"] = entry.start_ns;
+  json["end_ns"] = entry.end_ns;
+  json["status"] = absl::StatusCodeToString(entry.status);
+
+  auto& output = json["output"];
+  output = nlohmann::json::array();
+  for (const auto& serialized : entry.outputs) {
+    ::p4::v1::WriteRequest request;
+    std::string text;
+    if (!request.ParseFromArray(serialized.data(), serialized.size()) ||
+        !google::protobuf::util::MessageToJsonString(request, &text).ok()) {
+      json["error"] = "unparseable WriteRequest";
+      continue;
+    }
+    output.push_back(nlohmann::json::parse(text));
+  }
+  return json;
+}
+
+}  // namespace ovsp4rt
@@ -0,0 +1,27 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_JOURNAL_JSON_H_
+#define OVSP4RT_JOURNAL_JSON_H_
+
+#include <nlohmann/json.hpp>
+
+#include "ovsp4rt_journal.h"
+
+namespace ovsp4rt {
+
+// Returns the JSON representation of a journal entry. The input is
+// encoded as the Encode functions encode it, with the following
+// members added:
+//
+//   "sequence", "start_ns", "end_ns": from the entry
+//   "status": name of the status code
+//   "output": the WriteRequests, in protobuf JSON form
+//
+// Returns a JSON object with an "error" member if the entry cannot be
+// converted.
+extern nlohmann::json JournalEntryToJson(const JournalEntry& entry);
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_JOURNAL_JSON_H_
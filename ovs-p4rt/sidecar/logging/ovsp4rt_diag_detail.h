@@ -16,6 +16,8 @@ enum LogTableId {
   LOG_L2_FWD_RX_WITH_TUNNEL_TABLE,
   LOG_DST_IP_MAC_MAP_TABLE,
   LOG_SRC_IP_MAC_MAP_TABLE,
+  // Number of table IDs. Must be last.
+  LOG_NUM_TABLES
 };
 
 // Parameter object to return diagnostic information from a low-level
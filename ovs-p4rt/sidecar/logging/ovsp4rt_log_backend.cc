@@ -0,0 +1,185 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ovsp4rt_log_backend.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <thread>
+
+namespace ovsp4rt {
+
+namespace {
+
+const char* get_level_name(int level) {
+  switch (level) {
+    case OVSP4RT_LEVEL_ERROR:
+      return "ERROR";
+    case OVSP4RT_LEVEL_WARN:
+      return "WARN";
+    case OVSP4RT_LEVEL_INFO:
+      return "INFO";
+    case OVSP4RT_LEVEL_DEBUG:
+      return "DEBUG";
+    default:
+      return "UNKNOWN";
+  }
+}
+
+void FlushAtExit() { LogBackend::Instance().Flush(); }
+
+}  // namespace
+
+// Owns a thread's claim on its ring. The ring itself belongs to the
+// backend, which frees it once the thread has exited and it is empty.
+struct LogBackend::RingSlot {
+  ~RingSlot() {
+    if (ring) {
+      ring->orphaned.store(true, std::memory_order_release);
+    }
+  }
+  LogRing* ring = nullptr;
+};
+
+LogBackend& LogBackend::Instance() {
+  // Intentionally leaked, so that messages logged from static
+  // destructors still have a backend.
+  static LogBackend* instance = new LogBackend;
+  return *instance;
+}
+
+LogRing* LogBackend::LocalRing() {
+  thread_local RingSlot slot;
+  if (!slot.ring) {
+    auto ring = std::make_unique<LogRing>();
+    slot.ring = ring.get();
+    std::lock_guard<std::mutex> lock(mutex_);
+    rings_.push_back(std::move(ring));
+  }
+  return slot.ring;
+}
+
+void LogBackend::Start() {
+  static std::once_flag once;
+  std::call_once(once, []() {
+    atexit(FlushAtExit);
+    // Only the forking thread survives in the child. Keep mutex_
+    // consistent across the fork, and start a new drain thread in the
+    // child when it next logs.
+    pthread_atfork([]() { Instance().mutex_.lock(); },
+                   []() { Instance().mutex_.unlock(); },
+                   []() {
+                     Instance().mutex_.unlock();
+                     Instance().started_.store(false);
+                   });
+  });
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!started_.load(std::memory_order_relaxed)) {
+    std::thread(&LogBackend::Run, this).detach();
+    started_.store(true, std::memory_order_release);
+  }
+}
+
+void LogBackend::Write(int level, uint32_t suppressed, const char* format,
+                       va_list args) {
+  if (!started_.load(std::memory_order_acquire)) {
+    Start();
+  }
+
+  LogRing* ring = LocalRing();
+  LogRecord* record = ring->Reserve();
+  if (!record) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  record->level = level;
+  int len = vsnprintf(record->text, sizeof(record->text), format, args);
+  if (suppressed && len >= 0 &&
+      static_cast<size_t>(len) < LogRecord::kMaxLength) {
+    snprintf(record->text + len, sizeof(record->text) - len,
+             " (%u similar messages suppressed)", suppressed);
+  }
+  ring->Commit();
+
+  // The drain thread sets sleeping_ before it checks pending_ for the
+  // last time, so either it sees our message or we see that it is
+  // asleep.
+  pending_.fetch_add(1);
+  if (sleeping_.load()) {
+    std::lock_guard<std::mutex> lock(wakeup_mutex_);
+    wakeup_.notify_one();
+  }
+}
+
+void LogBackend::SetSink(ovsp4rt_log_sink_cb sink, void* aux) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  DrainLocked();
+  sink_ = sink;
+  aux_ = aux;
+}
+
+void LogBackend::Flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  DrainLocked();
+  if (!sink_) {
+    fflush(stdout);
+  }
+}
+
+void LogBackend::WaitForWork() {
+  std::unique_lock<std::mutex> lock(wakeup_mutex_);
+  sleeping_.store(true);
+  wakeup_.wait(lock, [this]() { return pending_.load() != 0; });
+  sleeping_.store(false);
+}
+
+void LogBackend::Run() {
+  for (;;) {
+    WaitForWork();
+    std::lock_guard<std::mutex> lock(mutex_);
+    DrainLocked();
+  }
+}
+
+void LogBackend::DrainLocked() {
+  for (auto& ring : rings_) {
+    while (const LogRecord* record = ring->Front()) {
+      Emit(record->level, record->text);
+      ring->Pop();
+      pending_.fetch_sub(1);
+    }
+  }
+
+  // The ring of an exited thread can receive no more messages.
+  rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                              [](const std::unique_ptr<LogRing>& ring) {
+                                return ring->orphaned.load(
+                                           std::memory_order_acquire) &&
+                                       !ring->Front();
+                              }),
+               rings_.end());
+
+  uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+  if (dropped != dropped_reported_) {
+    char text[64];
+    snprintf(text, sizeof(text), "%llu log messages dropped",
+             static_cast<unsigned long long>(dropped - dropped_reported_));
+    Emit(OVSP4RT_LEVEL_WARN, text);
+    dropped_reported_ = dropped;
+  }
+}
+
+void LogBackend::Emit(int level, const char* text) {
+  if (sink_) {
+    sink_(static_cast<enum ovsp4rt_log_level>(level), text, aux_);
+  } else {
+    printf("OVSP4RT %-5s - %s\n", get_level_name(level), text);
+  }
+}
+
+}  // namespace ovsp4rt
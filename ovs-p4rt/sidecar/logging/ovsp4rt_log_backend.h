@@ -0,0 +1,152 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_LOG_BACKEND_H_
+#define OVSP4RT_LOG_BACKEND_H_
+
+#include <stdarg.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "ovsp4rt/ovs-p4rt.h"
+
+namespace ovsp4rt {
+
+// A formatted log message.
+struct LogRecord {
+  static constexpr size_t kMaxLength = 500;
+
+  int level;
+  char text[kMaxLength + 1];
+};
+
+// Single-producer, single-consumer ring of log records. The producer
+// formats a message in place, so a message is copied only once.
+class LogRing {
+ public:
+  static constexpr uint32_t kCapacity = 128;
+
+  LogRing() = default;
+
+  // Disable copy semantics.
+  LogRing(const LogRing&) = delete;
+  LogRing& operator=(const LogRing&) = delete;
+
+  // Returns the next free record, or nullptr if the ring is full.
+  // Producer only.
+  LogRecord* Reserve() {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == kCapacity) {
+      return nullptr;
+    }
+    return &records_[tail % kCapacity];
+  }
+
+  // Publishes the record returned by Reserve(). Producer only.
+  void Commit() {
+    tail_.store(tail_.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+  }
+
+  // Returns the oldest record, or nullptr if the ring is empty.
+  // Consumer only.
+  const LogRecord* Front() const {
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    return &records_[head % kCapacity];
+  }
+
+  // Releases the record returned by Front(). Consumer only.
+  void Pop() {
+    head_.store(head_.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+  }
+
+  // Set when the producer thread exits.
+  std::atomic<bool> orphaned{false};
+
+ private:
+  alignas(64) std::atomic<uint32_t> head_{0};
+  alignas(64) std::atomic<uint32_t> tail_{0};
+  LogRecord records_[kCapacity];
+};
+
+// Writes log messages on a background thread.
+//
+// Each thread that logs gets a LogRing of its own, so formatting a
+// message takes no locks. The drain thread sleeps until a message is
+// committed, then writes the messages of all the rings to the sink.
+class LogBackend {
+ public:
+  // Returns the process-wide instance.
+  static LogBackend& Instance();
+
+  LogBackend() = default;
+
+  // Disable copy semantics.
+  LogBackend(const LogBackend&) = delete;
+  LogBackend& operator=(const LogBackend&) = delete;
+
+  // Formats a message into the ring of the calling thread. If
+  // suppressed is not zero, the message says that many similar
+  // messages were suppressed before it.
+  void Write(int level, uint32_t suppressed, const char* format,
+             va_list args);
+
+  // Sets the sink. A null sink writes to stdout.
+  void SetSink(ovsp4rt_log_sink_cb sink, void* aux);
+
+  // Writes the messages committed before the call.
+  void Flush();
+
+  // Returns the number of messages dropped because a ring was full.
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+ private:
+  struct RingSlot;
+
+  // Returns the ring of the calling thread.
+  LogRing* LocalRing();
+
+  // Starts the drain thread, if it is not running.
+  void Start();
+
+  // Body of the drain thread.
+  void Run();
+
+  // Waits until there is a message to write.
+  void WaitForWork();
+
+  // Writes the messages in the rings. Requires mutex_.
+  void DrainLocked();
+
+  // Writes a message to the sink. Requires mutex_.
+  void Emit(int level, const char* text);
+
+  // Protects the rings, the sink, and the role of consumer.
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<LogRing>> rings_;
+  ovsp4rt_log_sink_cb sink_ = nullptr;
+  void* aux_ = nullptr;
+  uint64_t dropped_reported_ = 0;
+
+  std::atomic<bool> started_{false};
+  std::atomic<uint64_t> dropped_{0};
+
+  // Messages committed but not yet written.
+  std::atomic<uint32_t> pending_{0};
+  std::atomic<bool> sleeping_{false};
+  std::mutex wakeup_mutex_;
+  std::condition_variable wakeup_;
+};
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_LOG_BACKEND_H_
@@ -4,32 +4,94 @@
 #include "ovsp4rt_logging.h"
 
 #include <stdarg.h>
-#include <stdio.h>
+
+#include <atomic>
+#include <chrono>
+
+#include "ovsp4rt_log_backend.h"
 
 namespace {
 
-const char* get_level_name(int level) {
-  switch (level) {
-    case OVSP4RT_LEVEL_ERROR:
-      return "ERROR";
-    case OVSP4RT_LEVEL_WARN:
-      return "WARN";
-    case OVSP4RT_LEVEL_INFO:
-      return "INFO";
-    case OVSP4RT_LEVEL_DEBUG:
-      return "DEBUG";
-    default:
-      return "UNKNOWN";
+// Default number of messages a call site may log per second.
+constexpr uint32_t kDefaultRateLimit = 20;
+
+std::atomic<int> log_level{OVSP4RT_LEVEL_DEBUG};
+std::atomic<uint32_t> rate_limit{kDefaultRateLimit};
+
+uint64_t NowSeconds() {
+  return std::chrono::duration_cast<std::chrono::seconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Returns true if the site may log a message now. If so, *suppressed
+// receives the number of messages suppressed since its last one.
+//
+// The site is plain C data shared by all the threads that reach the
+// call site, so it is updated with atomic builtins. Threads racing at
+// the start of a window may let a message or two more through.
+bool AdmitMessage(struct ovsp4rt_log_site* site, uint32_t* suppressed) {
+  uint32_t limit = rate_limit.load(std::memory_order_relaxed);
+  if (limit) {
+    uint64_t now = NowSeconds();
+    uint64_t window = __atomic_load_n(&site->window, __ATOMIC_RELAXED);
+    if (window != now &&
+        __atomic_compare_exchange_n(&site->window, &window, now, false,
+                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+      __atomic_store_n(&site->count, 0, __ATOMIC_RELAXED);
+    }
+    if (__atomic_fetch_add(&site->count, 1, __ATOMIC_RELAXED) >= limit) {
+      __atomic_fetch_add(&site->suppressed, 1, __ATOMIC_RELAXED);
+      return false;
+    }
   }
+  *suppressed = __atomic_exchange_n(&site->suppressed, 0, __ATOMIC_RELAXED);
+  return true;
 }
 
 }  // namespace
 
+bool ovsp4rt_log_enabled(int level) {
+  return level >= log_level.load(std::memory_order_relaxed);
+}
+
+void ovsp4rt_log_site_message(struct ovsp4rt_log_site* site, int level,
+                              const char* format, ...) {
+  uint32_t suppressed;
+  if (!AdmitMessage(site, &suppressed)) {
+    return;
+  }
+  va_list args;
+  va_start(args, format);
+  ovsp4rt::LogBackend::Instance().Write(level, suppressed, format, args);
+  va_end(args);
+}
+
 void ovsp4rt_log_message(int level, const char* format, ...) {
-  printf("OVSP4RT %-5s - ", get_level_name(level));
+  if (!ovsp4rt_log_enabled(level)) {
+    return;
+  }
   va_list args;
   va_start(args, format);
-  vprintf(format, args);
+  ovsp4rt::LogBackend::Instance().Write(level, 0, format, args);
   va_end(args);
-  printf("\n");
 }
+
+void ovsp4rt_log_set_level(enum ovsp4rt_log_level level) {
+  log_level.store(level, std::memory_order_relaxed);
+}
+
+enum ovsp4rt_log_level ovsp4rt_log_get_level(void) {
+  return static_cast<enum ovsp4rt_log_level>(
+      log_level.load(std::memory_order_relaxed));
+}
+
+void ovsp4rt_log_set_rate_limit(uint32_t messages_per_second) {
+  rate_limit.store(messages_per_second, std::memory_order_relaxed);
+}
+
+void ovsp4rt_log_set_sink(ovsp4rt_log_sink_cb sink, void* aux) {
+  ovsp4rt::LogBackend::Instance().SetSink(sink, aux);
+}
+
+void ovsp4rt_log_flush(void) { ovsp4rt::LogBackend::Instance().Flush(); }
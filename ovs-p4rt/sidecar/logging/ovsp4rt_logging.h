@@ -4,30 +4,57 @@
 #ifndef OVSP4RT_LOGGING_H_
 #define OVSP4RT_LOGGING_H_
 
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ovsp4rt/ovs-p4rt.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-enum {
-  OVSP4RT_LEVEL_DEBUG,
-  OVSP4RT_LEVEL_INFO,
-  OVSP4RT_LEVEL_WARN,
-  OVSP4RT_LEVEL_ERROR,
+// Messages below this level are compiled out.
+#ifndef OVSP4RT_LOG_MIN_LEVEL
+#define OVSP4RT_LOG_MIN_LEVEL OVSP4RT_LEVEL_DEBUG
+#endif
+
+// Rate-limiting state of a call site.
+struct ovsp4rt_log_site {
+  uint64_t window;      // second the current window began
+  uint32_t count;       // messages in the current window
+  uint32_t suppressed;  // messages suppressed since the last one logged
 };
 
-#define ovsp4rt_log_debug(...) \
-  ovsp4rt_log_message(OVSP4RT_LEVEL_DEBUG, __VA_ARGS__)
+// Logs a message, subject to the level and the rate limit of the call
+// site. The arguments are not evaluated if the message is filtered out
+// by level.
+#define OVSP4RT_LOG(level, ...)                                         \
+  do {                                                                  \
+    static struct ovsp4rt_log_site ovsp4rt_log_site_;                   \
+    if ((level) >= OVSP4RT_LOG_MIN_LEVEL && ovsp4rt_log_enabled(level)) { \
+      ovsp4rt_log_site_message(&ovsp4rt_log_site_, (level), __VA_ARGS__); \
+    }                                                                   \
+  } while (0)
+
+#define ovsp4rt_log_debug(...) OVSP4RT_LOG(OVSP4RT_LEVEL_DEBUG, __VA_ARGS__)
+
+#define ovsp4rt_log_error(...) OVSP4RT_LOG(OVSP4RT_LEVEL_ERROR, __VA_ARGS__)
+
+#define ovsp4rt_log_info(...) OVSP4RT_LOG(OVSP4RT_LEVEL_INFO, __VA_ARGS__)
 
-#define ovsp4rt_log_error(...) \
-  ovsp4rt_log_message(OVSP4RT_LEVEL_ERROR, __VA_ARGS__)
+#define ovsp4rt_log_warn(...) OVSP4RT_LOG(OVSP4RT_LEVEL_WARN, __VA_ARGS__)
 
-#define ovsp4rt_log_info(...) \
-  ovsp4rt_log_message(OVSP4RT_LEVEL_INFO, __VA_ARGS__)
+// Returns true if messages at the level are logged.
+extern bool ovsp4rt_log_enabled(int level);
 
-#define ovsp4rt_log_warn(...) \
-  ovsp4rt_log_message(OVSP4RT_LEVEL_WARN, __VA_ARGS__)
+// Logs a message from a call site. Use OVSP4RT_LOG() instead.
+extern void ovsp4rt_log_site_message(struct ovsp4rt_log_site* site, int level,
+                                     const char* format, ...)
+    __attribute__((format(printf, 3, 4)));
 
-extern void ovsp4rt_log_message(int level, const char* format, ...);
+// Logs a message, subject to the level but not to rate limiting.
+extern void ovsp4rt_log_message(int level, const char* format, ...)
+    __attribute__((format(printf, 2, 3)));
 
 #ifdef __cplusplus
 }
@@ -3,16 +3,39 @@
 
 #include <arpa/inet.h>
 
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/flags/flag.h"
+#include "absl/status/status.h"
+#include "async/ovsp4rt_async_writer.h"
+#include "async/ovsp4rt_dependency_scheduler.h"
+#include "async/ovsp4rt_sharded_writer.h"
+#include "journal/ovsp4rt_journal.h"
 #include "logging/ovsp4rt_diag_detail.h"
 #include "logging/ovsp4rt_logging.h"
 #include "logging/ovsp4rt_logutils.h"
 #include "ovsp4rt/ovs-p4rt.h"
+#include "ovsp4rt_field_encoding.h"
 #include "ovsp4rt_private.h"
-#include "session/ovsp4rt_credentials.h"
+#include "p4ids/ovsp4rt_p4ids.h"
+#include "resync/ovsp4rt_resync.h"
+#include "session/ovsp4rt_epoch_audit.h"
+#include "session/ovsp4rt_fdb_aging.h"
+#include "session/ovsp4rt_p4info_cache.h"
+#include "session/ovsp4rt_request_arena.h"
 #include "session/ovsp4rt_session.h"
+#include "session/ovsp4rt_session_manager.h"
+#include "session/ovsp4rt_shadow_table.h"
+#include "session/ovsp4rt_table_template.h"
+#include "session/ovsp4rt_vsi_port_map.h"
+#include "stats/ovsp4rt_probes.h"
+#include "stats/ovsp4rt_stats.h"
 
 #if defined(DPDK_TARGET)
 #include "dpdk/p4_name_mapping.h"
@@ -25,102 +48,230 @@
 ABSL_FLAG(uint64_t, device_id, 1, "P4Runtime device ID.");
 ABSL_FLAG(std::string, role_name, DEFAULT_OVS_P4RT_ROLE_NAME,
           "P4 config role name.");
+ABSL_FLAG(int32_t, max_write_request_bytes, 2 * 1024 * 1024,
+          "Approximate size limit of a batched FDB WriteRequest. Must be "
+          "less than the server's maximum message size.");
 
 namespace ovsp4rt {
 
-#if defined(ES2K_TARGET)
-static const std::string tunnel_v6_param_name[] = {
-    ACTION_SET_TUNNEL_V6_PARAM_IPV6_1, ACTION_SET_TUNNEL_V6_PARAM_IPV6_2,
-    ACTION_SET_TUNNEL_V6_PARAM_IPV6_3, ACTION_SET_TUNNEL_V6_PARAM_IPV6_4};
-#endif
+//----------------------------------------------------------------------
+// Table descriptors
+//
+// Tables whose entries the Prepare functions build by filling in a
+// template (see session/ovsp4rt_table_template.h). There is one
+// descriptor per table and action.
+//
+// Every table on the MAC learning path has a descriptor. The tunnel
+// encap and decap tables, the tunnel termination and source port
+// tables, and the tables with ternary keys are still built field by
+// field: they are programmed once per port or tunnel, and descriptors
+// only describe exact matches.
+//----------------------------------------------------------------------
 
-std::string EncodeByteValue(int arg_count...) {
-  std::string byte_value;
-  va_list args;
-  va_start(args, arg_count);
+#if defined(ES2K_TARGET)
 
-  for (int arg = 0; arg < arg_count; ++arg) {
-    uint8_t byte = va_arg(args, int);
-    byte_value.push_back(byte);
+const TableDescriptor kL2FwdSmacNoAction(
+    L2_FWD_SMAC_TABLE,
+    {L2_FWD_SMAC_TABLE_KEY_SA, L2_FWD_SMAC_TABLE_KEY_BRIDGE_ID},
+    L2_FWD_SMAC_TABLE_ACTION_NO_ACTION);
+
+const TableDescriptor kL2FwdTxL2Fwd(
+    L2_FWD_TX_TABLE,
+    {L2_FWD_TX_TABLE_KEY_DST_MAC, L2_FWD_TX_TABLE_KEY_BRIDGE_ID},
+    L2_FWD_TX_TABLE_ACTION_L2_FWD, {ACTION_L2_FWD_PARAM_PORT});
+
+const TableDescriptor kL2FwdTxRemoveVlanAndFwd(
+    L2_FWD_TX_TABLE,
+    {L2_FWD_TX_TABLE_KEY_DST_MAC, L2_FWD_TX_TABLE_KEY_BRIDGE_ID},
+    L2_FWD_TX_TABLE_ACTION_REMOVE_VLAN_AND_FWD,
+    {ACTION_REMOVE_VLAN_AND_FWD_PARAM_PORT_ID,
+     ACTION_REMOVE_VLAN_AND_FWD_PARAM_VLAN_PTR});
+
+const TableDescriptor kL2FwdTxVxlanUnderlayV4(
+    L2_FWD_TX_TABLE,
+    {L2_FWD_TX_TABLE_KEY_DST_MAC, L2_FWD_TX_TABLE_KEY_BRIDGE_ID},
+    L2_FWD_TX_TABLE_ACTION_SET_VXLAN_UNDERLAY_V4, {ACTION_PARAM_TUNNEL_ID});
+
+const TableDescriptor kL2FwdTxVxlanUnderlayV6(
+    L2_FWD_TX_TABLE,
+    {L2_FWD_TX_TABLE_KEY_DST_MAC, L2_FWD_TX_TABLE_KEY_BRIDGE_ID},
+    L2_FWD_TX_TABLE_ACTION_SET_VXLAN_UNDERLAY_V6, {ACTION_PARAM_TUNNEL_ID});
+
+const TableDescriptor kL2FwdTxPopVlanVxlanUnderlayV4(
+    L2_FWD_TX_TABLE,
+    {L2_FWD_TX_TABLE_KEY_DST_MAC, L2_FWD_TX_TABLE_KEY_BRIDGE_ID},
+    L2_FWD_TX_TABLE_ACTION_POP_VLAN_SET_VXLAN_UNDERLAY_V4,
+    {ACTION_PARAM_TUNNEL_ID});
+
+const TableDescriptor kL2FwdTxPopVlanVxlanUnderlayV6(
+    L2_FWD_TX_TABLE,
+    {L2_FWD_TX_TABLE_KEY_DST_MAC, L2_FWD_TX_TABLE_KEY_BRIDGE_ID},
+    L2_FWD_TX_TABLE_ACTION_POP_VLAN_SET_VXLAN_UNDERLAY_V6,
+    {ACTION_PARAM_TUNNEL_ID});
+
+const TableDescriptor kL2FwdTxGeneveUnderlayV4(
+    L2_FWD_TX_TABLE,
+    {L2_FWD_TX_TABLE_KEY_DST_MAC, L2_FWD_TX_TABLE_KEY_BRIDGE_ID},
+    L2_FWD_TX_TABLE_ACTION_SET_GENEVE_UNDERLAY_V4, {ACTION_PARAM_TUNNEL_ID});
+
+const TableDescriptor kL2FwdTxGeneveUnderlayV6(
+    L2_FWD_TX_TABLE,
+    {L2_FWD_TX_TABLE_KEY_DST_MAC, L2_FWD_TX_TABLE_KEY_BRIDGE_ID},
+    L2_FWD_TX_TABLE_ACTION_SET_GENEVE_UNDERLAY_V6, {ACTION_PARAM_TUNNEL_ID});
+
+const TableDescriptor kL2FwdTxPopVlanGeneveUnderlayV4(
+    L2_FWD_TX_TABLE,
+    {L2_FWD_TX_TABLE_KEY_DST_MAC, L2_FWD_TX_TABLE_KEY_BRIDGE_ID},
+    L2_FWD_TX_TABLE_ACTION_POP_VLAN_SET_GENEVE_UNDERLAY_V4,
+    {ACTION_PARAM_TUNNEL_ID});
+
+const TableDescriptor kL2FwdTxPopVlanGeneveUnderlayV6(
+    L2_FWD_TX_TABLE,
+    {L2_FWD_TX_TABLE_KEY_DST_MAC, L2_FWD_TX_TABLE_KEY_BRIDGE_ID},
+    L2_FWD_TX_TABLE_ACTION_POP_VLAN_SET_GENEVE_UNDERLAY_V6,
+    {ACTION_PARAM_TUNNEL_ID});
+
+const TableDescriptor kL2FwdRxL2Fwd(
+    L2_FWD_RX_TABLE,
+    {L2_FWD_RX_TABLE_KEY_DST_MAC, L2_FWD_RX_TABLE_KEY_BRIDGE_ID},
+    L2_FWD_RX_TABLE_ACTION_L2_FWD, {ACTION_L2_FWD_PARAM_PORT});
+
+const TableDescriptor kL2ToTunnelV4(L2_TO_TUNNEL_V4_TABLE,
+                                    {L2_TO_TUNNEL_V4_KEY_DA},
+                                    L2_TO_TUNNEL_V4_ACTION_SET_TUNNEL_V4,
+                                    {ACTION_SET_TUNNEL_V4_PARAM_DST_ADDR});
+
+const TableDescriptor kL2ToTunnelV6(
+    L2_TO_TUNNEL_V6_TABLE, {L2_TO_TUNNEL_V6_KEY_DA},
+    L2_TO_TUNNEL_V6_ACTION_SET_TUNNEL_V6,
+    {ACTION_SET_TUNNEL_V6_PARAM_IPV6_1, ACTION_SET_TUNNEL_V6_PARAM_IPV6_2,
+     ACTION_SET_TUNNEL_V6_PARAM_IPV6_3, ACTION_SET_TUNNEL_V6_PARAM_IPV6_4});
+
+const TableDescriptor kVlanPushModVlanPush(
+    VLAN_PUSH_MOD_TABLE, {VLAN_PUSH_MOD_KEY_MOD_BLOB_PTR},
+    VLAN_PUSH_MOD_ACTION_VLAN_PUSH,
+    {ACTION_VLAN_PUSH_PARAM_PCP, ACTION_VLAN_PUSH_PARAM_DEI,
+     ACTION_VLAN_PUSH_PARAM_VLAN_ID});
+
+const TableDescriptor kVlanPopModVlanPop(VLAN_POP_MOD_TABLE,
+                                         {VLAN_POP_MOD_KEY_MOD_BLOB_PTR},
+                                         VLAN_POP_MOD_ACTION_VLAN_POP);
+
+const TableDescriptor kSrcIpMacMapSmacMap(
+    SRC_IP_MAC_MAP_TABLE, {SRC_IP_MAC_MAP_TABLE_KEY_SRC_IP},
+    SRC_IP_MAC_MAP_TABLE_ACTION_SMAC_MAP,
+    {ACTION_SET_SRC_MAC_HIGH, ACTION_SET_SRC_MAC_MID,
+     ACTION_SET_SRC_MAC_LOW});
+
+const TableDescriptor kDstIpMacMapDmacMap(
+    DST_IP_MAC_MAP_TABLE, {DST_IP_MAC_MAP_TABLE_KEY_DST_IP},
+    DST_IP_MAC_MAP_TABLE_ACTION_DMAC_MAP,
+    {ACTION_SET_DST_MAC_HIGH, ACTION_SET_DST_MAC_MID,
+     ACTION_SET_DST_MAC_LOW});
+
+const TableDescriptor kTxAccVsiL2FwdAndBypassBridge(
+    TX_ACC_VSI_TABLE, {TX_ACC_VSI_TABLE_KEY_VSI},
+    TX_ACC_VSI_TABLE_ACTION_L2_FWD_AND_BYPASS_BRIDGE,
+    {ACTION_L2_FWD_AND_BYPASS_BRIDGE_PARAM_PORT});
+
+// Returns the descriptor of the l2_fwd_tx action that sets the tunnel
+// underlay for a learned MAC, or nullptr if the local and remote
+// addresses are not of the same family.
+const TableDescriptor* SelectL2FwdTxUnderlay(
+    const struct mac_learning_info& learn_info,
+    const TableDescriptor& set_v4, const TableDescriptor& pop_vlan_set_v4,
+    const TableDescriptor& set_v6, const TableDescriptor& pop_vlan_set_v6) {
+  bool untagged =
+      learn_info.vlan_info.port_vlan_mode == P4_PORT_VLAN_NATIVE_UNTAGGED;
+  const auto& tnl_info = learn_info.tnl_info;
+  if (tnl_info.local_ip.family == AF_INET &&
+      tnl_info.remote_ip.family == AF_INET) {
+    return untagged ? &pop_vlan_set_v4 : &set_v4;
   }
-
-  va_end(args);
-  return byte_value;
-}
-
-// Encodes tunnel_info.vni as a "tunnel_id" action parameter,
-// which is bit<20> in all cases except set_ipsec_tunnel.
-static inline std::string EncodeTunnelId(uint32_t vni) {
-  return EncodeByteValue(3, (vni >> 16) & 0x0F, (vni >> 8) & 0xFF, vni & 0xFF);
+  if (tnl_info.local_ip.family == AF_INET6 &&
+      tnl_info.remote_ip.family == AF_INET6) {
+    return untagged ? &pop_vlan_set_v6 : &set_v6;
+  }
+  return nullptr;
 }
 
-// Encodes tunnel_info.vni as a "vni" or "mod_blob_ptr" match
-// field or action parameter, which are bit<24> in all cases.
-static inline std::string EncodeVniValue(uint32_t vni) {
-  return EncodeByteValue(3, (vni >> 16) & 0xFF, (vni >> 8) & 0xFF, vni & 0xFF);
-}
+#elif defined(DPDK_TARGET)
 
-std::string CanonicalizeIp(const uint32_t ipv4addr) {
-  // note: low-to-high byte order
-  return EncodeByteValue(4, (ipv4addr & 0xff), ((ipv4addr >> 8) & 0xff),
-                         ((ipv4addr >> 16) & 0xff), ((ipv4addr >> 24) & 0xff));
-}
+const TableDescriptor kL2FwdTxL2Fwd(L2_FWD_TX_TABLE,
+                                    {L2_FWD_TX_TABLE_KEY_DST_MAC},
+                                    L2_FWD_TX_TABLE_ACTION_L2_FWD,
+                                    {ACTION_L2_FWD_PARAM_PORT});
 
-std::string CanonicalizeIpv6(const struct in6_addr ipv6addr) {
-  return EncodeByteValue(
-      16, ipv6addr.__in6_u.__u6_addr8[0], ipv6addr.__in6_u.__u6_addr8[1],
-      ipv6addr.__in6_u.__u6_addr8[2], ipv6addr.__in6_u.__u6_addr8[3],
-      ipv6addr.__in6_u.__u6_addr8[4], ipv6addr.__in6_u.__u6_addr8[5],
-      ipv6addr.__in6_u.__u6_addr8[6], ipv6addr.__in6_u.__u6_addr8[7],
-      ipv6addr.__in6_u.__u6_addr8[8], ipv6addr.__in6_u.__u6_addr8[9],
-      ipv6addr.__in6_u.__u6_addr8[10], ipv6addr.__in6_u.__u6_addr8[11],
-      ipv6addr.__in6_u.__u6_addr8[12], ipv6addr.__in6_u.__u6_addr8[13],
-      ipv6addr.__in6_u.__u6_addr8[14], ipv6addr.__in6_u.__u6_addr8[15]);
-}
+const TableDescriptor kL2FwdTxSetTunnel(
+    L2_FWD_TX_TABLE, {L2_FWD_TX_TABLE_KEY_DST_MAC},
+    L2_FWD_TX_TABLE_ACTION_SET_TUNNEL,
+    {ACTION_SET_TUNNEL_PARAM_TUNNEL_ID, ACTION_SET_TUNNEL_PARAM_DST_ADDR});
 
-std::string CanonicalizeMac(const uint8_t mac[6]) {
-  return EncodeByteValue(6, (mac[0] & 0xff), (mac[1] & 0xff), (mac[2] & 0xff),
-                         (mac[3] & 0xff), (mac[4] & 0xff), (mac[5] & 0xff));
-}
+const TableDescriptor kL2FwdRxWithTunnelL2Fwd(
+    L2_FWD_RX_WITH_TUNNEL_TABLE, {L2_FWD_RX_WITH_TUNNEL_TABLE_KEY_DST_MAC},
+    L2_FWD_RX_WITH_TUNNEL_TABLE_ACTION_L2_FWD, {ACTION_L2_FWD_PARAM_PORT});
 
-int GetTableId(const ::p4::config::v1::P4Info& p4info,
-               const std::string& t_name) {
-  for (const auto& table : p4info.tables()) {
-    const auto& pre = table.preamble();
-    if (pre.name() == t_name) return pre.id();
-  }
-  return -1;
-}
+#endif
 
-int GetActionId(const ::p4::config::v1::P4Info& p4info,
-                const std::string& a_name) {
-  for (const auto& action : p4info.actions()) {
-    const auto& pre = action.preamble();
-    if (pre.name() == a_name) return pre.id();
-  }
-  return -1;
-}
+//----------------------------------------------------------------------
+// FDB aging
+//
+// The switch ages one table per FDB entry: the source MAC table on
+// ES2K, and the transmit table on DPDK, which has no source MAC table.
+//----------------------------------------------------------------------
 
-int GetParamId(const ::p4::config::v1::P4Info& p4info,
-               const std::string& a_name, const std::string& param_name) {
-  for (const auto& action : p4info.actions()) {
-    const auto& pre = action.preamble();
-    if (pre.name() != a_name) continue;
-    for (const auto& param : action.params())
-      if (param.name() == param_name) return param.id();
-  }
-  return -1;
-}
+#if defined(ES2K_TARGET)
+const TableDescriptor& kFdbAgingTable = kL2FwdSmacNoAction;
+#elif defined(DPDK_TARGET)
+const TableDescriptor& kFdbAgingTable = kL2FwdTxL2Fwd;
+#endif
 
-int GetMatchFieldId(const ::p4::config::v1::P4Info& p4info,
-                    const std::string& t_name, const std::string& mf_name) {
-  for (const auto& table : p4info.tables()) {
-    const auto& pre = table.preamble();
-    if (pre.name() != t_name) continue;
-    for (const auto& mf : table.match_fields())
-      if (mf.name() == mf_name) return mf.id();
+// Sets the idle timeout of a new entry in the aging table, if aging is
+// enabled and the pipeline supports it.
+void SetFdbIdleTimeout(p4::v1::TableEntry* table_entry,
+                       const P4InfoResolver& p4info) {
+  int64_t idle_timeout_ns = FdbAging::Instance().idle_timeout_ns();
+  if (idle_timeout_ns && p4info.SupportsIdleTimeout(kFdbAgingTable.table())) {
+    table_entry->set_idle_timeout_ns(idle_timeout_ns);
+  }
+}
+
+bool DecodeFdbAgingTableEntry(const p4::v1::TableEntry& table_entry,
+                              const P4InfoResolver& p4info,
+                              struct ovsp4rt_aged_mac* aged_mac) {
+  // The names come from the descriptor, so use the function forms.
+  const char* table = kFdbAgingTable.table();
+  if (static_cast<int>(table_entry.table_id()) !=
+      (GetTableId)(p4info, table)) {
+    return false;
+  }
+
+  const auto& match_fields = kFdbAgingTable.match_fields();
+  int mac_field_id = (GetMatchFieldId)(p4info, table, match_fields[0]);
+  int bridge_field_id =
+      match_fields.size() > 1
+          ? (GetMatchFieldId)(p4info, table, match_fields[1])
+          : -1;
+
+  bool has_mac = false;
+  *aged_mac = {};
+  for (const auto& match : table_entry.match()) {
+    const std::string& value = match.exact().value();
+    int field_id = match.field_id();
+    if (field_id == mac_field_id) {
+      // The value is canonical: leading zero bytes are omitted.
+      size_t len = sizeof(aged_mac->mac_addr);
+      if (value.size() > len) {
+        return false;
+      }
+      memcpy(aged_mac->mac_addr + len - value.size(), value.data(),
+             value.size());
+      has_mac = true;
+    } else if (field_id == bridge_field_id) {
+      aged_mac->bridge_id = value.empty() ? 0 : value.back();
+    }
   }
-  return -1;
+  return has_mac;
 }
 
 static inline int32_t ValidIpAddr(uint32_t nw_addr) {
@@ -131,110 +282,61 @@ static inline int32_t ValidIpAddr(uint32_t nw_addr) {
 #if defined(ES2K_TARGET)
 void PrepareFdbSmacTableEntry(p4::v1::TableEntry* table_entry,
                               const struct mac_learning_info& learn_info,
-                              const ::p4::config::v1::P4Info& p4info,
-                              bool insert_entry, DiagDetail& detail) {
+                              const P4InfoResolver& p4info, bool insert_entry,
+                              DiagDetail& detail) {
   detail.table_id = LOG_L2_FWD_SMAC_TABLE;
-  table_entry->set_table_id(GetTableId(p4info, L2_FWD_SMAC_TABLE));
-
-  auto match = table_entry->add_match();
-  match->set_field_id(
-      GetMatchFieldId(p4info, L2_FWD_SMAC_TABLE, L2_FWD_SMAC_TABLE_KEY_SA));
-  std::string mac_addr = CanonicalizeMac(learn_info.mac_addr);
-  match->mutable_exact()->set_value(mac_addr);
-
-  auto match1 = table_entry->add_match();
-  match1->set_field_id(GetMatchFieldId(p4info, L2_FWD_SMAC_TABLE,
-                                       L2_FWD_SMAC_TABLE_KEY_BRIDGE_ID));
-  match1->mutable_exact()->set_value(EncodeByteValue(1, learn_info.bridge_id));
+  p4info.GetTemplate(kL2FwdSmacNoAction).Fill(table_entry, insert_entry);
+  SetMatchValue(table_entry, 0, CanonicalizeMac(learn_info.mac_addr));
+  SetMatchValue(table_entry, 1, EncodeBits<8>(learn_info.bridge_id));
 
   if (insert_entry) {
-    auto table_action = table_entry->mutable_action();
-    auto action = table_action->mutable_action();
-    action->set_action_id(
-        GetActionId(p4info, L2_FWD_SMAC_TABLE_ACTION_NO_ACTION));
+    SetFdbIdleTimeout(table_entry, p4info);
   }
 }
 #endif  // ES2K_TARGET
 
 void PrepareFdbTxVlanTableEntry(p4::v1::TableEntry* table_entry,
                                 const struct mac_learning_info& learn_info,
-                                const ::p4::config::v1::P4Info& p4info,
-                                bool insert_entry, DiagDetail& detail) {
+                                const P4InfoResolver& p4info, bool insert_entry,
+                                DiagDetail& detail) {
   detail.table_id = LOG_L2_FWD_TX_TABLE;
-  table_entry->set_table_id(GetTableId(p4info, L2_FWD_TX_TABLE));
-
-  auto match = table_entry->add_match();
-  match->set_field_id(
-      GetMatchFieldId(p4info, L2_FWD_TX_TABLE, L2_FWD_TX_TABLE_KEY_DST_MAC));
-
-  std::string mac_addr = CanonicalizeMac(learn_info.mac_addr);
-  match->mutable_exact()->set_value(mac_addr);
 
 #if defined(ES2K_TARGET)
   // Based on p4 program for ES2K, we need to provide a match key Bridge ID
-  auto match1 = table_entry->add_match();
-  match1->set_field_id(
-      GetMatchFieldId(p4info, L2_FWD_TX_TABLE, L2_FWD_TX_TABLE_KEY_BRIDGE_ID));
-
-  match1->mutable_exact()->set_value(EncodeByteValue(1, learn_info.bridge_id));
+  bool untagged =
+      learn_info.vlan_info.port_vlan_mode == P4_PORT_VLAN_NATIVE_UNTAGGED;
+  const auto& desc = untagged ? kL2FwdTxRemoveVlanAndFwd : kL2FwdTxL2Fwd;
+  p4info.GetTemplate(desc).Fill(table_entry, insert_entry);
+  SetMatchValue(table_entry, 0, CanonicalizeMac(learn_info.mac_addr));
+  SetMatchValue(table_entry, 1, EncodeBits<8>(learn_info.bridge_id));
 
   if (insert_entry) {
     /* Action param configured by user in TX_ACC_VSI_TABLE is used as port_id
      * We call GET api to fetch this value and pass it to FDB programming.
      */
-    auto table_action = table_entry->mutable_action();
-    auto action = table_action->mutable_action();
-    if (learn_info.vlan_info.port_vlan_mode == P4_PORT_VLAN_NATIVE_UNTAGGED) {
-      action->set_action_id(
-          GetActionId(p4info, L2_FWD_TX_TABLE_ACTION_REMOVE_VLAN_AND_FWD));
-      {
-        auto param = action->add_params();
-        param->set_param_id(
-            GetParamId(p4info, L2_FWD_TX_TABLE_ACTION_REMOVE_VLAN_AND_FWD,
-                       ACTION_REMOVE_VLAN_AND_FWD_PARAM_PORT_ID));
-        auto port_id = learn_info.src_port;
-        // TODO(derek): port_id truncated to 8 bits. [es2k]
-        // See https://github.com/ipdk-io/networking-recipe/issues/619
-        param->set_value(EncodeByteValue(1, port_id));
-      }
-      {
-        auto param = action->add_params();
-        param->set_param_id(
-            GetParamId(p4info, L2_FWD_TX_TABLE_ACTION_REMOVE_VLAN_AND_FWD,
-                       ACTION_REMOVE_VLAN_AND_FWD_PARAM_VLAN_PTR));
-        // TODO(derek): port_vlan truncated to 8 bits. [es2k]
-        // See https://github.com/ipdk-io/networking-recipe/issues/620
-        param->set_value(EncodeByteValue(1, learn_info.vlan_info.port_vlan));
-      }
-    } else {
-      action->set_action_id(GetActionId(p4info, L2_FWD_TX_TABLE_ACTION_L2_FWD));
-      {
-        auto param = action->add_params();
-        param->set_param_id(GetParamId(p4info, L2_FWD_TX_TABLE_ACTION_L2_FWD,
-                                       ACTION_L2_FWD_PARAM_PORT));
-        auto port_id = learn_info.src_port;
-        // TODO(derek): port_id truncated to 8 bits. [es2k]
-        // See https://github.com/ipdk-io/networking-recipe/issues/619
-        param->set_value(EncodeByteValue(1, port_id));
-      }
+    auto port_id = learn_info.src_port;
+    // TODO(derek): port_id truncated to 8 bits. [es2k]
+    // See https://github.com/ipdk-io/networking-recipe/issues/619
+    SetParamValue(table_entry, 0, EncodeBits<8>(port_id));
+    if (untagged) {
+      // TODO(derek): port_vlan truncated to 8 bits. [es2k]
+      // See https://github.com/ipdk-io/networking-recipe/issues/620
+      SetParamValue(table_entry, 1,
+                    EncodeBits<8>(learn_info.vlan_info.port_vlan));
     }
   }
 #elif defined(DPDK_TARGET)
+  p4info.GetTemplate(kL2FwdTxL2Fwd).Fill(table_entry, insert_entry);
+  SetMatchValue(table_entry, 0, CanonicalizeMac(learn_info.mac_addr));
+
   if (insert_entry) {
-    auto table_action = table_entry->mutable_action();
-    auto action = table_action->mutable_action();
-    action->set_action_id(GetActionId(p4info, L2_FWD_TX_TABLE_ACTION_L2_FWD));
-    {
-      auto param = action->add_params();
-      param->set_param_id(GetParamId(p4info, L2_FWD_TX_TABLE_ACTION_L2_FWD,
-                                     ACTION_L2_FWD_PARAM_PORT));
-      // TODO(derek) Questionable value semantics. [dpdk]
-      // See https://github.com/ipdk-io/networking-recipe/issues/689
-      auto port_id = learn_info.vln_info.vlan_id - 1;
-      // TODO(derek): vlan_id truncated to 8 bits. [dpdk]
-      // See https://github.com/ipdk-io/networking-recipe/issues/689
-      param->set_value(EncodeByteValue(1, port_id));
-    }
+    // TODO(derek) Questionable value semantics. [dpdk]
+    // See https://github.com/ipdk-io/networking-recipe/issues/689
+    auto port_id = learn_info.vln_info.vlan_id - 1;
+    // TODO(derek): vlan_id truncated to 8 bits. [dpdk]
+    // See https://github.com/ipdk-io/networking-recipe/issues/689
+    SetParamValue(table_entry, 0, EncodeBits<8>(port_id));
+    SetFdbIdleTimeout(table_entry, p4info);
   }
 #else
 #error "ASSERT: Unknown TARGET type!"
@@ -245,37 +347,20 @@ void PrepareFdbTxVlanTableEntry(p4::v1::TableEntry* table_entry,
 
 void PrepareFdbRxVlanTableEntry(p4::v1::TableEntry* table_entry,
                                 const struct mac_learning_info& learn_info,
-                                const ::p4::config::v1::P4Info& p4info,
-                                bool insert_entry, DiagDetail& detail) {
+                                const P4InfoResolver& p4info, bool insert_entry,
+                                DiagDetail& detail) {
   detail.table_id = LOG_L2_FWD_RX_TABLE;
-  table_entry->set_table_id(GetTableId(p4info, L2_FWD_RX_TABLE));
-
-  auto match = table_entry->add_match();
-  match->set_field_id(
-      GetMatchFieldId(p4info, L2_FWD_RX_TABLE, L2_FWD_RX_TABLE_KEY_DST_MAC));
-  std::string mac_addr = CanonicalizeMac(learn_info.mac_addr);
-  match->mutable_exact()->set_value(mac_addr);
 
   // Based on p4 program for ES2K, we need to provide a match key Bridge ID
-  auto match1 = table_entry->add_match();
-  match1->set_field_id(
-      GetMatchFieldId(p4info, L2_FWD_RX_TABLE, L2_FWD_RX_TABLE_KEY_BRIDGE_ID));
-
-  match1->mutable_exact()->set_value(EncodeByteValue(1, learn_info.bridge_id));
+  p4info.GetTemplate(kL2FwdRxL2Fwd).Fill(table_entry, insert_entry);
+  SetMatchValue(table_entry, 0, CanonicalizeMac(learn_info.mac_addr));
+  SetMatchValue(table_entry, 1, EncodeBits<8>(learn_info.bridge_id));
 
   if (insert_entry) {
-    auto table_action = table_entry->mutable_action();
-    auto action = table_action->mutable_action();
-    action->set_action_id(GetActionId(p4info, L2_FWD_RX_TABLE_ACTION_L2_FWD));
-    {
-      auto param = action->add_params();
-      param->set_param_id(GetParamId(p4info, L2_FWD_RX_TABLE_ACTION_L2_FWD,
-                                     ACTION_L2_FWD_PARAM_PORT));
-      auto port_id = learn_info.rx_src_port;
-      // TODO(derek): port_id truncated to 8 bits. [es2k]
-      // See https://github.com/ipdk-io/networking-recipe/issues/682
-      param->set_value(EncodeByteValue(1, port_id));
-    }
+    auto port_id = learn_info.rx_src_port;
+    // TODO(derek): port_id truncated to 8 bits. [es2k]
+    // See https://github.com/ipdk-io/networking-recipe/issues/682
+    SetParamValue(table_entry, 0, EncodeBits<8>(port_id));
   }
 }
 
@@ -283,32 +368,19 @@ void PrepareFdbRxVlanTableEntry(p4::v1::TableEntry* table_entry,
 
 void PrepareFdbRxVlanTableEntry(p4::v1::TableEntry* table_entry,
                                 const struct mac_learning_info& learn_info,
-                                const ::p4::config::v1::P4Info& p4info,
-                                bool insert_entry, DiagDetail& detail) {
+                                const P4InfoResolver& p4info, bool insert_entry,
+                                DiagDetail& detail) {
   detail.table_id = LOG_L2_FWD_RX_WITH_TUNNEL_TABLE;
-  table_entry->set_table_id(GetTableId(p4info, L2_FWD_RX_WITH_TUNNEL_TABLE));
-
-  auto match = table_entry->add_match();
-  match->set_field_id(GetMatchFieldId(p4info, L2_FWD_RX_WITH_TUNNEL_TABLE,
-                                      L2_FWD_TX_TABLE_KEY_DST_MAC));
-  std::string mac_addr = CanonicalizeMac(learn_info.mac_addr);
-  match->mutable_exact()->set_value(mac_addr);
+  p4info.GetTemplate(kL2FwdRxWithTunnelL2Fwd).Fill(table_entry, insert_entry);
+  SetMatchValue(table_entry, 0, CanonicalizeMac(learn_info.mac_addr));
 
   if (insert_entry) {
-    auto table_action = table_entry->mutable_action();
-    auto action = table_action->mutable_action();
-    action->set_action_id(GetActionId(p4info, L2_FWD_TX_TABLE_ACTION_L2_FWD));
-    {
-      auto param = action->add_params();
-      param->set_param_id(GetParamId(p4info, L2_FWD_RX_TABLE_ACTION_L2_FWD,
-                                     ACTION_L2_FWD_PARAM_PORT));
-      // TODO(derek): questionable value semantics. [dpdk]
-      // See https://github.com/ipdk-io/networking-recipe/issues/683
-      auto port_id = learn_info.vln_info.vlan_id - 1;
-      // TODO(derek): vlan_id truncated to 8 bits. [dpdk]
-      // See https://github.com/ipdk-io/networking-recipe/issues/683
-      param->set_value(EncodeByteValue(1, port_id));
-    }
+    // TODO(derek): questionable value semantics. [dpdk]
+    // See https://github.com/ipdk-io/networking-recipe/issues/683
+    auto port_id = learn_info.vln_info.vlan_id - 1;
+    // TODO(derek): vlan_id truncated to 8 bits. [dpdk]
+    // See https://github.com/ipdk-io/networking-recipe/issues/683
+    SetParamValue(table_entry, 0, EncodeBits<8>(port_id));
   }
 }
 
@@ -318,102 +390,42 @@ void PrepareFdbRxVlanTableEntry(p4::v1::TableEntry* table_entry,
 
 void PrepareFdbTableEntryforV4VxlanTunnel(
     p4::v1::TableEntry* table_entry, const struct mac_learning_info& learn_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry,
-    DiagDetail& detail) {
+    const P4InfoResolver& p4info, bool insert_entry, DiagDetail& detail) {
   detail.table_id = LOG_L2_FWD_TX_TABLE;
-  table_entry->set_table_id(GetTableId(p4info, L2_FWD_TX_TABLE));
-
-  auto match = table_entry->add_match();
-  match->set_field_id(
-      GetMatchFieldId(p4info, L2_FWD_TX_TABLE, L2_FWD_TX_TABLE_KEY_DST_MAC));
-  std::string mac_addr = CanonicalizeMac(learn_info.mac_addr);
-  match->mutable_exact()->set_value(mac_addr);
-
-#if defined(ES2K_TARGET)
-  // Based on p4 program for ES2K, we need to provide a match key Bridge ID
-  auto match1 = table_entry->add_match();
-  match1->set_field_id(
-      GetMatchFieldId(p4info, L2_FWD_TX_TABLE, L2_FWD_TX_TABLE_KEY_BRIDGE_ID));
-  match1->mutable_exact()->set_value(EncodeByteValue(1, learn_info.bridge_id));
-#endif
 
 #if defined(DPDK_TARGET)
-  if (insert_entry) {
-    auto table_action = table_entry->mutable_action();
-    auto action = table_action->mutable_action();
-    action->set_action_id(
-        GetActionId(p4info, L2_FWD_TX_TABLE_ACTION_SET_TUNNEL));
-    {
-      auto param = action->add_params();
-      param->set_param_id(GetParamId(p4info, L2_FWD_TX_TABLE_ACTION_SET_TUNNEL,
-                                     ACTION_SET_TUNNEL_PARAM_TUNNEL_ID));
-      // TODO(derek): 8-bit value for 24-bit action parameter. [dpdk]
-      // See https://github.com/ipdk-io/networking-recipe/issues/677
-      param->set_value(EncodeByteValue(1, learn_info.tnl_info.vni));
-    }
+  p4info.GetTemplate(kL2FwdTxSetTunnel).Fill(table_entry, insert_entry);
+  SetMatchValue(table_entry, 0, CanonicalizeMac(learn_info.mac_addr));
 
-    {
-      auto param = action->add_params();
-      param->set_param_id(GetParamId(p4info, L2_FWD_TX_TABLE_ACTION_SET_TUNNEL,
-                                     ACTION_SET_TUNNEL_PARAM_DST_ADDR));
-      std::string ip_address =
-          CanonicalizeIp(learn_info.tnl_info.remote_ip.ip.v4addr.s_addr);
-      param->set_value(ip_address);
-    }
+  if (insert_entry) {
+    // TODO(derek): 8-bit value for 24-bit action parameter. [dpdk]
+    // See https://github.com/ipdk-io/networking-recipe/issues/677
+    SetParamValue(table_entry, 0, EncodeBits<8>(learn_info.tnl_info.vni));
+    SetParamValue(
+        table_entry, 1,
+        CanonicalizeIp(learn_info.tnl_info.remote_ip.ip.v4addr.s_addr));
+    SetFdbIdleTimeout(table_entry, p4info);
   }
 #elif defined(ES2K_TARGET)
-  if (insert_entry) {
-    auto table_action = table_entry->mutable_action();
-    auto action = table_action->mutable_action();
-
-    if (learn_info.tnl_info.local_ip.family == AF_INET &&
-        learn_info.tnl_info.remote_ip.family == AF_INET) {
-      if (learn_info.vlan_info.port_vlan_mode == P4_PORT_VLAN_NATIVE_UNTAGGED) {
-        action->set_action_id(GetActionId(
-            p4info, L2_FWD_TX_TABLE_ACTION_POP_VLAN_SET_VXLAN_UNDERLAY_V4));
-        {
-          auto param = action->add_params();
-          param->set_param_id(GetParamId(
-              p4info, L2_FWD_TX_TABLE_ACTION_POP_VLAN_SET_VXLAN_UNDERLAY_V4,
-              ACTION_PARAM_TUNNEL_ID));
-          param->set_value(EncodeTunnelId(learn_info.tnl_info.vni));
-        }
-      } else {
-        action->set_action_id(
-            GetActionId(p4info, L2_FWD_TX_TABLE_ACTION_SET_VXLAN_UNDERLAY_V4));
-        {
-          auto param = action->add_params();
-          param->set_param_id(
-              GetParamId(p4info, L2_FWD_TX_TABLE_ACTION_SET_VXLAN_UNDERLAY_V4,
-                         ACTION_PARAM_TUNNEL_ID));
-          param->set_value(EncodeTunnelId(learn_info.tnl_info.vni));
-        }
-      }
-    } else if (learn_info.tnl_info.local_ip.family == AF_INET6 &&
-               learn_info.tnl_info.remote_ip.family == AF_INET6) {
-      if (learn_info.vlan_info.port_vlan_mode == P4_PORT_VLAN_NATIVE_UNTAGGED) {
-        action->set_action_id(GetActionId(
-            p4info, L2_FWD_TX_TABLE_ACTION_POP_VLAN_SET_VXLAN_UNDERLAY_V6));
-        {
-          auto param = action->add_params();
-          param->set_param_id(GetParamId(
-              p4info, L2_FWD_TX_TABLE_ACTION_POP_VLAN_SET_VXLAN_UNDERLAY_V6,
-              ACTION_PARAM_TUNNEL_ID));
-          param->set_value(EncodeTunnelId(learn_info.tnl_info.vni));
-        }
-      } else {
-        action->set_action_id(
-            GetActionId(p4info, L2_FWD_TX_TABLE_ACTION_SET_VXLAN_UNDERLAY_V6));
-        {
-          auto param = action->add_params();
-          param->set_param_id(
-              GetParamId(p4info, L2_FWD_TX_TABLE_ACTION_SET_VXLAN_UNDERLAY_V6,
-                         ACTION_PARAM_TUNNEL_ID));
-          param->set_value(EncodeTunnelId(learn_info.tnl_info.vni));
-        }
-      }
+  // Based on p4 program for ES2K, we need to provide a match key Bridge ID
+  const TableDescriptor* desc = SelectL2FwdTxUnderlay(
+      learn_info, kL2FwdTxVxlanUnderlayV4, kL2FwdTxPopVlanVxlanUnderlayV4,
+      kL2FwdTxVxlanUnderlayV6, kL2FwdTxPopVlanVxlanUnderlayV6);
+  if (desc) {
+    p4info.GetTemplate(*desc).Fill(table_entry, insert_entry);
+  } else {
+    // Neither underlay: the action is left without an ID.
+    p4info.GetTemplate(kL2FwdTxVxlanUnderlayV4).Fill(table_entry, false);
+    if (insert_entry) {
+      table_entry->mutable_action()->mutable_action();
     }
   }
+  SetMatchValue(table_entry, 0, CanonicalizeMac(learn_info.mac_addr));
+  SetMatchValue(table_entry, 1, EncodeBits<8>(learn_info.bridge_id));
+
+  if (insert_entry && desc) {
+    SetParamValue(table_entry, 0, EncodeTunnelId(learn_info.tnl_info.vni));
+  }
 #else
 #error "ASSERT: Unknown TARGET type!"
 #endif
@@ -424,205 +436,253 @@ void PrepareFdbTableEntryforV4VxlanTunnel(
 // Never called when DPDK_TARGET is enabled.
 void PrepareFdbTableEntryforV4GeneveTunnel(
     p4::v1::TableEntry* table_entry, const struct mac_learning_info& learn_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry,
-    DiagDetail& detail) {
+    const P4InfoResolver& p4info, bool insert_entry, DiagDetail& detail) {
   detail.table_id = LOG_L2_FWD_TX_TABLE;
-  table_entry->set_table_id(GetTableId(p4info, L2_FWD_TX_TABLE));
-
-  auto match = table_entry->add_match();
-  match->set_field_id(
-      GetMatchFieldId(p4info, L2_FWD_TX_TABLE, L2_FWD_TX_TABLE_KEY_DST_MAC));
-
-  std::string mac_addr = CanonicalizeMac(learn_info.mac_addr);
-  match->mutable_exact()->set_value(mac_addr);
-
-#if defined(ES2K_TARGET)
   // Based on p4 program for ES2K, we need to provide a match key Bridge ID
-  auto match1 = table_entry->add_match();
-  match1->set_field_id(
-      GetMatchFieldId(p4info, L2_FWD_TX_TABLE, L2_FWD_TX_TABLE_KEY_BRIDGE_ID));
-  match1->mutable_exact()->set_value(EncodeByteValue(1, learn_info.bridge_id));
-#endif
-
-#if defined(DPDK_TARGET)
-  if (insert_entry) {
-    auto table_action = table_entry->mutable_action();
-    auto action = table_action->mutable_action();
-    action->set_action_id(
-        GetActionId(p4info, L2_FWD_TX_TABLE_ACTION_SET_TUNNEL));
-    {
-      auto param = action->add_params();
-      param->set_param_id(GetParamId(p4info, L2_FWD_TX_TABLE_ACTION_SET_TUNNEL,
-                                     ACTION_SET_TUNNEL_PARAM_TUNNEL_ID));
-      // note: 8-bit vni (dpdk)
-      param->set_value(EncodeByteValue(1, learn_info.tnl_info.vni));
-    }
-
-    {
-      auto param = action->add_params();
-      param->set_param_id(GetParamId(p4info, L2_FWD_TX_TABLE_ACTION_SET_TUNNEL,
-                                     ACTION_SET_TUNNEL_PARAM_DST_ADDR));
-      std::string ip_address =
-          CanonicalizeIp(learn_info.tnl_info.remote_ip.ip.v4addr.s_addr);
-      param->set_value(ip_address);
+  const TableDescriptor* desc = SelectL2FwdTxUnderlay(
+      learn_info, kL2FwdTxGeneveUnderlayV4, kL2FwdTxPopVlanGeneveUnderlayV4,
+      kL2FwdTxGeneveUnderlayV6, kL2FwdTxPopVlanGeneveUnderlayV6);
+  if (desc) {
+    p4info.GetTemplate(*desc).Fill(table_entry, insert_entry);
+  } else {
+    // Neither underlay: the action is left without an ID.
+    p4info.GetTemplate(kL2FwdTxGeneveUnderlayV4).Fill(table_entry, false);
+    if (insert_entry) {
+      table_entry->mutable_action()->mutable_action();
     }
   }
-#elif defined(ES2K_TARGET)
-  if (insert_entry) {
-    auto table_action = table_entry->mutable_action();
-    auto action = table_action->mutable_action();
+  SetMatchValue(table_entry, 0, CanonicalizeMac(learn_info.mac_addr));
+  SetMatchValue(table_entry, 1, EncodeBits<8>(learn_info.bridge_id));
 
-    if (learn_info.tnl_info.local_ip.family == AF_INET &&
-        learn_info.tnl_info.remote_ip.family == AF_INET) {
-      if (learn_info.vlan_info.port_vlan_mode == P4_PORT_VLAN_NATIVE_UNTAGGED) {
-        action->set_action_id(GetActionId(
-            p4info, L2_FWD_TX_TABLE_ACTION_POP_VLAN_SET_GENEVE_UNDERLAY_V4));
-        {
-          auto param = action->add_params();
-          param->set_param_id(GetParamId(
-              p4info, L2_FWD_TX_TABLE_ACTION_POP_VLAN_SET_GENEVE_UNDERLAY_V4,
-              ACTION_PARAM_TUNNEL_ID));
-          param->set_value(EncodeTunnelId(learn_info.tnl_info.vni));
-        }
-      } else {
-        action->set_action_id(
-            GetActionId(p4info, L2_FWD_TX_TABLE_ACTION_SET_GENEVE_UNDERLAY_V4));
-        {
-          auto param = action->add_params();
-          param->set_param_id(
-              GetParamId(p4info, L2_FWD_TX_TABLE_ACTION_SET_GENEVE_UNDERLAY_V4,
-                         ACTION_PARAM_TUNNEL_ID));
-          param->set_value(EncodeTunnelId(learn_info.tnl_info.vni));
-        }
-      }
-    } else if (learn_info.tnl_info.local_ip.family == AF_INET6 &&
-               learn_info.tnl_info.remote_ip.family == AF_INET6) {
-      if (learn_info.vlan_info.port_vlan_mode == P4_PORT_VLAN_NATIVE_UNTAGGED) {
-        action->set_action_id(GetActionId(
-            p4info, L2_FWD_TX_TABLE_ACTION_POP_VLAN_SET_GENEVE_UNDERLAY_V6));
-        {
-          auto param = action->add_params();
-          param->set_param_id(GetParamId(
-              p4info, L2_FWD_TX_TABLE_ACTION_POP_VLAN_SET_GENEVE_UNDERLAY_V6,
-              ACTION_PARAM_TUNNEL_ID));
-          param->set_value(EncodeTunnelId(learn_info.tnl_info.vni));
-        }
-      } else {
-        action->set_action_id(
-            GetActionId(p4info, L2_FWD_TX_TABLE_ACTION_SET_GENEVE_UNDERLAY_V6));
-        {
-          auto param = action->add_params();
-          param->set_param_id(
-              GetParamId(p4info, L2_FWD_TX_TABLE_ACTION_SET_GENEVE_UNDERLAY_V6,
-                         ACTION_PARAM_TUNNEL_ID));
-          param->set_value(EncodeTunnelId(learn_info.tnl_info.vni));
-        }
-      }
-    }
+  if (insert_entry && desc) {
+    SetParamValue(table_entry, 0, EncodeTunnelId(learn_info.tnl_info.vni));
   }
-#else
-#error "ASSERT: Unknown TARGET type!"
-#endif
 }
 
 void PrepareL2ToTunnelV4(p4::v1::TableEntry* table_entry,
                          const struct mac_learning_info& learn_info,
-                         const ::p4::config::v1::P4Info& p4info,
-                         bool insert_entry, DiagDetail& detail) {
+                         const P4InfoResolver& p4info, bool insert_entry,
+                         DiagDetail& detail) {
   detail.table_id = LOG_L2_TO_TUNNEL_V4_TABLE;
-  table_entry->set_table_id(GetTableId(p4info, L2_TO_TUNNEL_V4_TABLE));
-
-  auto match = table_entry->add_match();
-  match->set_field_id(
-      GetMatchFieldId(p4info, L2_TO_TUNNEL_V4_TABLE, L2_TO_TUNNEL_V4_KEY_DA));
-  std::string mac_addr = CanonicalizeMac(learn_info.mac_addr);
-  match->mutable_exact()->set_value(mac_addr);
+  p4info.GetTemplate(kL2ToTunnelV4).Fill(table_entry, insert_entry);
+  SetMatchValue(table_entry, 0, CanonicalizeMac(learn_info.mac_addr));
 
   if (insert_entry) {
-    auto table_action = table_entry->mutable_action();
-    auto action = table_action->mutable_action();
-    action->set_action_id(
-        GetActionId(p4info, L2_TO_TUNNEL_V4_ACTION_SET_TUNNEL_V4));
-    {
-      auto param = action->add_params();
-      param->set_param_id(GetParamId(p4info,
-                                     L2_TO_TUNNEL_V4_ACTION_SET_TUNNEL_V4,
-                                     ACTION_SET_TUNNEL_V4_PARAM_DST_ADDR));
-      std::string ip_address =
-          CanonicalizeIp(learn_info.tnl_info.remote_ip.ip.v4addr.s_addr);
-      param->set_value(ip_address);
-    }
+    SetParamValue(
+        table_entry, 0,
+        CanonicalizeIp(learn_info.tnl_info.remote_ip.ip.v4addr.s_addr));
   }
 }
 
 void PrepareL2ToTunnelV6(p4::v1::TableEntry* table_entry,
                          const struct mac_learning_info& learn_info,
-                         const ::p4::config::v1::P4Info& p4info,
-                         bool insert_entry, DiagDetail& detail) {
+                         const P4InfoResolver& p4info, bool insert_entry,
+                         DiagDetail& detail) {
   detail.table_id = LOG_L2_TO_TUNNEL_V6_TABLE;
-  table_entry->set_table_id(GetTableId(p4info, L2_TO_TUNNEL_V6_TABLE));
-
-  auto match = table_entry->add_match();
-  match->set_field_id(
-      GetMatchFieldId(p4info, L2_TO_TUNNEL_V6_TABLE, L2_TO_TUNNEL_V6_KEY_DA));
-  std::string mac_addr = CanonicalizeMac(learn_info.mac_addr);
-  match->mutable_exact()->set_value(mac_addr);
+  p4info.GetTemplate(kL2ToTunnelV6).Fill(table_entry, insert_entry);
+  SetMatchValue(table_entry, 0, CanonicalizeMac(learn_info.mac_addr));
 
   if (insert_entry) {
-    auto table_action = table_entry->mutable_action();
-    auto action = table_action->mutable_action();
-    action->set_action_id(
-        GetActionId(p4info, L2_TO_TUNNEL_V6_ACTION_SET_TUNNEL_V6));
-    for (unsigned int i = 0; i < 4; i++) {
-      auto param = action->add_params();
-      param->set_param_id(GetParamId(p4info,
-                                     L2_TO_TUNNEL_V6_ACTION_SET_TUNNEL_V6,
-                                     tunnel_v6_param_name[i]));
-      std::string ip_address = CanonicalizeIp(
-          learn_info.tnl_info.remote_ip.ip.v6addr.__in6_u.__u6_addr32[i]);
-      param->set_value(ip_address);
+    for (int i = 0; i < 4; i++) {
+      SetParamValue(table_entry, i,
+                    CanonicalizeIp(learn_info.tnl_info.remote_ip.ip.v6addr
+                                       .__in6_u.__u6_addr32[i]));
     }
   }
 }
 
-absl::Status ConfigFdbSmacTableEntry(ovsp4rt::OvsP4rtSession* session,
-                                     const struct mac_learning_info& learn_info,
-                                     const ::p4::config::v1::P4Info& p4info,
-                                     bool insert_entry) {
-  ::p4::v1::WriteRequest write_request;
-  ::p4::v1::TableEntry* table_entry;
-  DiagDetail detail;
+#endif  // ES2K_TARGET
+
+//----------------------------------------------------------------------
+// FDB write batch
+//
+// The table entries for FDB learn events are sent to the switch in
+// a single WriteRequest. The Config functions below add their update
+// to the batch; StartFdbWriteBatch() sends it in the caller's group
+// of writes on the session's AsyncWriteChannel, so that one batch can
+// be in flight while the next is being built.
+//
+// The server applies the updates with CONTINUE_ON_ERROR, so an update
+// that depends on another is applied even if the other one fails. Such
+// an update is recorded as a dependent, and if it was an insert that
+// took effect, RollBackFdbUpdates() deletes the entry afterwards.
+//----------------------------------------------------------------------
 
+struct FdbWriteBatch {
+  // Identifies the table and learn event of an update.
+  struct UpdateDetail {
+    DiagDetail detail;
+    bool insert_entry;
+    uint8_t mac_addr[6];
+    size_t event;
+  };
+
+  // Records the detail of the update that was just prepared.
+  void AddDetail(const DiagDetail& detail,
+                 const struct mac_learning_info& learn_info,
+                 bool insert_entry) {
+    details.push_back({detail, insert_entry});
+    memcpy(details.back().mac_addr, learn_info.mac_addr,
+           sizeof(learn_info.mac_addr));
+    details.back().event = event;
+
+    // Encoded size of the update, plus its tag and length prefix.
+    const auto& updates = write_request.updates();
+    byte_size += updates[updates.size() - 1].ByteSizeLong() + 6;
+  }
+
+  // An inserted entry that must not stay in place if the update it
+  // depends on fails.
+  struct Dependent {
+    size_t update;
+    size_t prerequisite;
+    ::p4::v1::TableEntry table_entry;
+  };
+
+  // Makes the last update depend on an earlier update of the batch.
+  void AddDependency(size_t prerequisite) {
+    size_t update = write_request.updates_size() - 1;
+    dependents.push_back(
+        {update, prerequisite,
+         write_request.updates(update).entity().table_entry()});
+  }
+
+  ::p4::v1::WriteRequest write_request;
+  // One per update, in update order.
+  std::vector<UpdateDetail> details;
+  std::vector<Dependent> dependents;
+  // Approximate encoded size of the updates.
+  size_t byte_size = 0;
+  // Index of the learn event whose updates are being added.
+  size_t event = 0;
+};
+
+// Entries inserted by dependent updates whose prerequisite failed.
+// Filled in by the write callbacks, and deleted by
+// RollBackFdbUpdates().
+struct FdbRollbacks {
+  struct Rollback {
+    ::p4::v1::TableEntry table_entry;
+    FdbWriteBatch::UpdateDetail detail;
+  };
+
+  std::mutex mutex;
+  std::vector<Rollback> rollbacks;
+};
+
+::p4::v1::TableEntry* AddFdbTableEntry(ovsp4rt::OvsP4rtSession* session,
+                                       bool insert_entry,
+                                       FdbWriteBatch& batch) {
   if (insert_entry) {
-    table_entry = ovsp4rt::SetupTableEntryToInsert(session, &write_request);
-  } else {
-    table_entry = ovsp4rt::SetupTableEntryToDelete(session, &write_request);
+    return ovsp4rt::SetupTableEntryToInsert(session, &batch.write_request);
+  }
+  return ovsp4rt::SetupTableEntryToDelete(session, &batch.write_request);
+}
+
+// Starts sending the updates in the batch and empties it. When the
+// write completes, the failed updates are logged, and if event_status
+// is not null, the status of the first failed update of each learn
+// event is stored in its element. The dependents to roll back are
+// added to rollbacks.
+void StartFdbWriteBatch(ovsp4rt::AsyncWriteChannel::Group& writes,
+                        FdbWriteBatch& batch,
+                        absl::Status* event_status = nullptr,
+                        FdbRollbacks* rollbacks = nullptr) {
+  if (batch.write_request.updates().empty()) {
+    return;
+  }
+
+  auto details = std::make_shared<std::vector<FdbWriteBatch::UpdateDetail>>(
+      std::move(batch.details));
+  auto dependents = std::make_shared<std::vector<FdbWriteBatch::Dependent>>(
+      std::move(batch.dependents));
+
+  writes.StartWrite(
+      std::move(batch.write_request),
+      [details, dependents, event_status, rollbacks](
+          const absl::Status& status,
+          const std::vector<absl::Status>& update_status) {
+        auto& stats = Stats::Instance();
+        for (size_t i = 0; i < update_status.size(); i++) {
+          auto& update = (*details)[i];
+          stats.CountUpdate(update.detail.table_id, update_status[i].ok());
+          if (!update_status[i].ok()) {
+            LogFailureWithMacAddr(update.insert_entry,
+                                  update.detail.getLogTableName(),
+                                  update.mac_addr);
+            if (event_status && event_status[update.event].ok()) {
+              event_status[update.event] = update_status[i];
+            }
+          }
+        }
+        if (!rollbacks) {
+          return;
+        }
+        for (auto& dependent : *dependents) {
+          if (dependent.update >= update_status.size() ||
+              !update_status[dependent.update].ok()) {
+            continue;
+          }
+          // A prerequisite that already exists is in place.
+          const auto& prerequisite = update_status[dependent.prerequisite];
+          if (!prerequisite.ok() && !absl::IsAlreadyExists(prerequisite)) {
+            std::lock_guard<std::mutex> lock(rollbacks->mutex);
+            rollbacks->rollbacks.push_back(
+                {std::move(dependent.table_entry),
+                 (*details)[dependent.update]});
+          }
+        }
+      });
+
+  batch.write_request.Clear();
+  batch.details.clear();
+  batch.dependents.clear();
+  batch.byte_size = 0;
+}
+
+// Deletes the entries in rollbacks. The write callbacks must have
+// completed, so the caller drains its group first.
+void RollBackFdbUpdates(ovsp4rt::OvsP4rtSession* session,
+                        ovsp4rt::AsyncWriteChannel::Group& writes,
+                        FdbRollbacks& rollbacks) {
+  FdbWriteBatch batch;
+
+  for (auto& rollback : rollbacks.rollbacks) {
+    auto* table_entry = AddFdbTableEntry(session, false, batch);
+    *table_entry = std::move(rollback.table_entry);
+    table_entry->clear_action();
+    batch.details.push_back(rollback.detail);
+    batch.details.back().insert_entry = false;
   }
+  rollbacks.rollbacks.clear();
+
+  StartFdbWriteBatch(writes, batch);
+  writes.Drain();
+}
+
+#if defined(ES2K_TARGET)
+
+void ConfigFdbSmacTableEntry(ovsp4rt::OvsP4rtSession* session,
+                             const struct mac_learning_info& learn_info,
+                             const P4InfoResolver& p4info, bool insert_entry,
+                             FdbWriteBatch& batch) {
+  DiagDetail detail;
+
+  auto table_entry = AddFdbTableEntry(session, insert_entry, batch);
 
   PrepareFdbSmacTableEntry(table_entry, learn_info, p4info, insert_entry,
                            detail);
 
-  auto status = ovsp4rt::SendWriteRequest(session, write_request);
-  if (!status.ok()) {
-    LogFailureWithMacAddr(insert_entry, detail.getLogTableName(),
-                          learn_info.mac_addr);
-  }
-  return status;
+  batch.AddDetail(detail, learn_info, insert_entry);
 }
 
-absl::Status ConfigL2TunnelTableEntry(
-    ovsp4rt::OvsP4rtSession* session,
-    const struct mac_learning_info& learn_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry) {
-  ::p4::v1::WriteRequest write_request;
-  ::p4::v1::TableEntry* table_entry;
+void ConfigL2TunnelTableEntry(ovsp4rt::OvsP4rtSession* session,
+                              const struct mac_learning_info& learn_info,
+                              const P4InfoResolver& p4info, bool insert_entry,
+                              FdbWriteBatch& batch) {
   DiagDetail detail;
 
-  if (insert_entry) {
-    table_entry = ovsp4rt::SetupTableEntryToInsert(session, &write_request);
-  } else {
-    table_entry = ovsp4rt::SetupTableEntryToDelete(session, &write_request);
-  }
+  auto table_entry = AddFdbTableEntry(session, insert_entry, batch);
 
   if (learn_info.tnl_info.local_ip.family == AF_INET6 &&
       learn_info.tnl_info.remote_ip.family == AF_INET6) {
@@ -631,114 +691,81 @@ absl::Status ConfigL2TunnelTableEntry(
     PrepareL2ToTunnelV4(table_entry, learn_info, p4info, insert_entry, detail);
   }
 
-  auto status = ovsp4rt::SendWriteRequest(session, write_request);
-  if (!status.ok()) {
-    LogFailureWithMacAddr(insert_entry, detail.getLogTableName(),
-                          learn_info.mac_addr);
-  }
-  return status;
+  batch.AddDetail(detail, learn_info, insert_entry);
 }
 
 #endif  // ES2K_TARGET
 
-absl::Status ConfigFdbTxVlanTableEntry(
-    ovsp4rt::OvsP4rtSession* session,
-    const struct mac_learning_info& learn_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry) {
-  ::p4::v1::WriteRequest write_request;
-  ::p4::v1::TableEntry* table_entry;
+void ConfigFdbTxVlanTableEntry(ovsp4rt::OvsP4rtSession* session,
+                               const struct mac_learning_info& learn_info,
+                               const P4InfoResolver& p4info, bool insert_entry,
+                               FdbWriteBatch& batch) {
   DiagDetail detail;
 
-  if (insert_entry) {
-    table_entry = ovsp4rt::SetupTableEntryToInsert(session, &write_request);
-  } else {
-    table_entry = ovsp4rt::SetupTableEntryToDelete(session, &write_request);
-  }
+  auto table_entry = AddFdbTableEntry(session, insert_entry, batch);
 
   PrepareFdbTxVlanTableEntry(table_entry, learn_info, p4info, insert_entry,
                              detail);
 
-  auto status = ovsp4rt::SendWriteRequest(session, write_request);
-  if (!status.ok()) {
-    LogFailureWithMacAddr(insert_entry, detail.getLogTableName(),
-                          learn_info.mac_addr);
-  }
-  return status;
+  batch.AddDetail(detail, learn_info, insert_entry);
 }
 
-absl::Status ConfigFdbRxVlanTableEntry(
-    ovsp4rt::OvsP4rtSession* session,
-    const struct mac_learning_info& learn_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry) {
-  ::p4::v1::WriteRequest write_request;
-  ::p4::v1::TableEntry* table_entry;
+void ConfigFdbRxVlanTableEntry(ovsp4rt::OvsP4rtSession* session,
+                               const struct mac_learning_info& learn_info,
+                               const P4InfoResolver& p4info, bool insert_entry,
+                               FdbWriteBatch& batch) {
   DiagDetail detail;
 
-  if (insert_entry) {
-    table_entry = ovsp4rt::SetupTableEntryToInsert(session, &write_request);
-  } else {
-    table_entry = ovsp4rt::SetupTableEntryToDelete(session, &write_request);
-  }
+  auto table_entry = AddFdbTableEntry(session, insert_entry, batch);
 
   PrepareFdbRxVlanTableEntry(table_entry, learn_info, p4info, insert_entry,
                              detail);
 
-  auto status = ovsp4rt::SendWriteRequest(session, write_request);
-  if (!status.ok()) {
-    LogFailureWithMacAddr(insert_entry, detail.getLogTableName(),
-                          learn_info.mac_addr);
-  }
-  return status;
+  batch.AddDetail(detail, learn_info, insert_entry);
 }
 
-absl::Status ConfigFdbTunnelTableEntry(
-    ovsp4rt::OvsP4rtSession* session,
-    const struct mac_learning_info& learn_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry) {
-  ::p4::v1::WriteRequest write_request;
-  ::p4::v1::TableEntry* table_entry;
+void ConfigFdbTunnelTableEntry(ovsp4rt::OvsP4rtSession* session,
+                               const struct mac_learning_info& learn_info,
+                               const P4InfoResolver& p4info, bool insert_entry,
+                               FdbWriteBatch& batch) {
   DiagDetail detail;
 
-  if (insert_entry) {
-    table_entry = ovsp4rt::SetupTableEntryToInsert(session, &write_request);
-  } else {
-    table_entry = ovsp4rt::SetupTableEntryToDelete(session, &write_request);
-  }
-
 #if defined(DPDK_TARGET)
+  auto table_entry = AddFdbTableEntry(session, insert_entry, batch);
   PrepareFdbTableEntryforV4VxlanTunnel(table_entry, learn_info, p4info,
                                        insert_entry, detail);
 #elif defined(ES2K_TARGET)
   if (learn_info.tnl_info.tunnel_type == OVS_TUNNEL_VXLAN) {
+    auto table_entry = AddFdbTableEntry(session, insert_entry, batch);
     PrepareFdbTableEntryforV4VxlanTunnel(table_entry, learn_info, p4info,
                                          insert_entry, detail);
   } else if (learn_info.tnl_info.tunnel_type == OVS_TUNNEL_GENEVE) {
+    auto table_entry = AddFdbTableEntry(session, insert_entry, batch);
     PrepareFdbTableEntryforV4GeneveTunnel(table_entry, learn_info, p4info,
                                           insert_entry, detail);
   } else {
     if (!insert_entry) {
       // Tunnel type doesn't matter for delete. So calling one of the functions
       // to prepare the entry
+      auto table_entry = AddFdbTableEntry(session, insert_entry, batch);
       PrepareFdbTableEntryforV4VxlanTunnel(table_entry, learn_info, p4info,
                                            insert_entry, detail);
+    } else {
+      // Nothing to add for an unknown tunnel type.
+      return;
     }
   }
 #else
 #error "ASSERT: Unknown TARGET type!"
 #endif
 
-  auto status = ovsp4rt::SendWriteRequest(session, write_request);
-  if (!status.ok()) {
-    LogFailureWithMacAddr(insert_entry, detail.getLogTableName(),
-                          learn_info.mac_addr);
-  }
-  return status;
+  batch.AddDetail(detail, learn_info, insert_entry);
 }
 
 /* VXLAN_ENCAP_MOD_TABLE */
 void PrepareVxlanEncapTableEntry(p4::v1::TableEntry* table_entry,
                                  const struct tunnel_info& tunnel_info,
-                                 const ::p4::config::v1::P4Info& p4info,
+                                 const P4InfoResolver& p4info,
                                  bool insert_entry) {
   table_entry->set_table_id(GetTableId(p4info, VXLAN_ENCAP_MOD_TABLE));
   auto match = table_entry->add_match();
@@ -772,10 +799,7 @@ void PrepareVxlanEncapTableEntry(p4::v1::TableEntry* table_entry,
       // To work around a bug in the Linux Networking P4 program, we
       // ignore the src_port value specified by the caller and instead
       // set the src_port param to (dst_port * 2).
-      uint16_t src_port = htons(tunnel_info.dst_port) * 2;
-
-      param->set_value(
-          EncodeByteValue(2, ((src_port >> 8) & 0xff), (src_port & 0xff)));
+      param->set_value(EncodeHostPortValue(tunnel_info.dst_port));
     }
 #endif
     {
@@ -784,8 +808,7 @@ void PrepareVxlanEncapTableEntry(p4::v1::TableEntry* table_entry,
                                      ACTION_VXLAN_ENCAP_PARAM_DST_PORT));
       uint16_t dst_port = htons(tunnel_info.dst_port);
 
-      param->set_value(
-          EncodeByteValue(2, ((dst_port >> 8) & 0xff), (dst_port & 0xff)));
+      param->set_value(EncodeBits<16>(dst_port));
     }
     {
       auto param = action->add_params();
@@ -800,7 +823,7 @@ void PrepareVxlanEncapTableEntry(p4::v1::TableEntry* table_entry,
 /* GENEVE_ENCAP_MOD_TABLE */
 void PrepareGeneveEncapTableEntry(p4::v1::TableEntry* table_entry,
                                   const struct tunnel_info& tunnel_info,
-                                  const ::p4::config::v1::P4Info& p4info,
+                                  const P4InfoResolver& p4info,
                                   bool insert_entry) {
   table_entry->set_table_id(GetTableId(p4info, GENEVE_ENCAP_MOD_TABLE));
   auto match = table_entry->add_match();
@@ -833,10 +856,7 @@ void PrepareGeneveEncapTableEntry(p4::v1::TableEntry* table_entry,
       // To work around a bug in the Linux Networking P4 program, we
       // ignore the src_port value specified by the caller and instead
       // set the src_port param to (dst_port * 2).
-      uint16_t src_port = htons(tunnel_info.dst_port) * 2;
-
-      param->set_value(
-          EncodeByteValue(2, ((src_port >> 8) & 0xff), (src_port & 0xff)));
+      param->set_value(EncodeHostPortValue(tunnel_info.dst_port));
     }
     {
       auto param = action->add_params();
@@ -844,8 +864,7 @@ void PrepareGeneveEncapTableEntry(p4::v1::TableEntry* table_entry,
                                      ACTION_GENEVE_ENCAP_PARAM_DST_PORT));
       uint16_t dst_port = htons(tunnel_info.dst_port);
 
-      param->set_value(
-          EncodeByteValue(2, ((dst_port >> 8) & 0xff), (dst_port & 0xff)));
+      param->set_value(EncodeBits<16>(dst_port));
     }
     {
       auto param = action->add_params();
@@ -859,8 +878,7 @@ void PrepareGeneveEncapTableEntry(p4::v1::TableEntry* table_entry,
 
 void PrepareEncapTableEntry(p4::v1::TableEntry* table_entry,
                             const struct tunnel_info& tunnel_info,
-                            const ::p4::config::v1::P4Info& p4info,
-                            bool insert_entry) {
+                            const P4InfoResolver& p4info, bool insert_entry) {
 #if defined(DPDK_TARGET)
   PrepareVxlanEncapTableEntry(table_entry, tunnel_info, p4info, insert_entry);
 #elif defined(ES2K_TARGET)
@@ -880,7 +898,7 @@ void PrepareEncapTableEntry(p4::v1::TableEntry* table_entry,
 /* VXLAN_ENCAP_V6_MOD_TABLE */
 void PrepareV6VxlanEncapTableEntry(p4::v1::TableEntry* table_entry,
                                    const struct tunnel_info& tunnel_info,
-                                   const ::p4::config::v1::P4Info& p4info,
+                                   const P4InfoResolver& p4info,
                                    bool insert_entry) {
   table_entry->set_table_id(GetTableId(p4info, VXLAN_ENCAP_V6_MOD_TABLE));
   auto match = table_entry->add_match();
@@ -913,10 +931,7 @@ void PrepareV6VxlanEncapTableEntry(p4::v1::TableEntry* table_entry,
       // To work around a bug in the Linux Networking P4 program, we
       // ignore the src_port value specified by the caller and instead
       // set the src_port param to (dst_port * 2).
-      uint16_t src_port = htons(tunnel_info.dst_port) * 2;
-
-      param->set_value(
-          EncodeByteValue(2, (src_port >> 8) & 0xff, src_port & 0xff));
+      param->set_value(EncodeHostPortValue(tunnel_info.dst_port));
     }
     {
       auto param = action->add_params();
@@ -924,8 +939,7 @@ void PrepareV6VxlanEncapTableEntry(p4::v1::TableEntry* table_entry,
                                      ACTION_VXLAN_ENCAP_V6_PARAM_DST_PORT));
       uint16_t dst_port = htons(tunnel_info.dst_port);
 
-      param->set_value(
-          EncodeByteValue(2, (dst_port >> 8) & 0xff, dst_port & 0xff));
+      param->set_value(EncodeBits<16>(dst_port));
     }
     {
       auto param = action->add_params();
@@ -939,7 +953,7 @@ void PrepareV6VxlanEncapTableEntry(p4::v1::TableEntry* table_entry,
 /* GENEVE_ENCAP_V6_MOD_TABLE */
 void PrepareV6GeneveEncapTableEntry(p4::v1::TableEntry* table_entry,
                                     const struct tunnel_info& tunnel_info,
-                                    const ::p4::config::v1::P4Info& p4info,
+                                    const P4InfoResolver& p4info,
                                     bool insert_entry) {
   table_entry->set_table_id(GetTableId(p4info, GENEVE_ENCAP_V6_MOD_TABLE));
   auto match = table_entry->add_match();
@@ -972,10 +986,7 @@ void PrepareV6GeneveEncapTableEntry(p4::v1::TableEntry* table_entry,
       // To work around a bug in the Linux Networking P4 program, we
       // ignore the src_port value specified by the caller and instead
       // set the src_port param to (dst_port * 2).
-      uint16_t src_port = htons(tunnel_info.dst_port) * 2;
-
-      param->set_value(
-          EncodeByteValue(2, (src_port >> 8) & 0xff, src_port & 0xff));
+      param->set_value(EncodeHostPortValue(tunnel_info.dst_port));
     }
     {
       auto param = action->add_params();
@@ -983,8 +994,7 @@ void PrepareV6GeneveEncapTableEntry(p4::v1::TableEntry* table_entry,
                                      ACTION_GENEVE_ENCAP_V6_PARAM_DST_PORT));
       uint16_t dst_port = htons(tunnel_info.dst_port);
 
-      param->set_value(
-          EncodeByteValue(2, (dst_port >> 8) & 0xff, dst_port & 0xff));
+      param->set_value(EncodeBits<16>(dst_port));
     }
     {
       auto param = action->add_params();
@@ -997,8 +1007,7 @@ void PrepareV6GeneveEncapTableEntry(p4::v1::TableEntry* table_entry,
 
 void PrepareV6EncapTableEntry(p4::v1::TableEntry* table_entry,
                               const struct tunnel_info& tunnel_info,
-                              const ::p4::config::v1::P4Info& p4info,
-                              bool insert_entry) {
+                              const P4InfoResolver& p4info, bool insert_entry) {
   if (tunnel_info.tunnel_type == OVS_TUNNEL_VXLAN) {
     PrepareV6VxlanEncapTableEntry(table_entry, tunnel_info, p4info,
                                   insert_entry);
@@ -1013,7 +1022,7 @@ void PrepareV6EncapTableEntry(p4::v1::TableEntry* table_entry,
 /* VXLAN_ENCAP_VLAN_POP_MOD_TABLE */
 void PrepareVxlanEncapAndVlanPopTableEntry(
     p4::v1::TableEntry* table_entry, const struct tunnel_info& tunnel_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry) {
+    const P4InfoResolver& p4info, bool insert_entry) {
   table_entry->set_table_id(GetTableId(p4info, VXLAN_ENCAP_VLAN_POP_MOD_TABLE));
   auto match = table_entry->add_match();
   match->set_field_id(GetMatchFieldId(
@@ -1048,10 +1057,7 @@ void PrepareVxlanEncapAndVlanPopTableEntry(
       // To work around a bug in the Linux Networking P4 program, we
       // ignore the src_port value specified by the caller and instead
       // set the src_port param to (dst_port * 2).
-      uint16_t src_port = htons(tunnel_info.dst_port) * 2;
-
-      param->set_value(
-          EncodeByteValue(2, ((src_port >> 8) & 0xff), (src_port & 0xff)));
+      param->set_value(EncodeHostPortValue(tunnel_info.dst_port));
     }
     {
       auto param = action->add_params();
@@ -1060,8 +1066,7 @@ void PrepareVxlanEncapAndVlanPopTableEntry(
                      ACTION_VXLAN_ENCAP_VLAN_POP_PARAM_DST_PORT));
       uint16_t dst_port = htons(tunnel_info.dst_port);
 
-      param->set_value(
-          EncodeByteValue(2, ((dst_port >> 8) & 0xff), (dst_port & 0xff)));
+      param->set_value(EncodeBits<16>(dst_port));
     }
     {
       auto param = action->add_params();
@@ -1075,7 +1080,7 @@ void PrepareVxlanEncapAndVlanPopTableEntry(
 /* GENEVE_ENCAP_VLAN_POP_MOD_TABLE */
 void PrepareGeneveEncapAndVlanPopTableEntry(
     p4::v1::TableEntry* table_entry, const struct tunnel_info& tunnel_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry) {
+    const P4InfoResolver& p4info, bool insert_entry) {
   table_entry->set_table_id(
       GetTableId(p4info, GENEVE_ENCAP_VLAN_POP_MOD_TABLE));
   auto match = table_entry->add_match();
@@ -1111,10 +1116,7 @@ void PrepareGeneveEncapAndVlanPopTableEntry(
       // To work around a bug in the Linux Networking P4 program, we
       // ignore the src_port value specified by the caller and instead
       // set the src_port param to (dst_port * 2).
-      uint16_t src_port = htons(tunnel_info.dst_port) * 2;
-
-      param->set_value(
-          EncodeByteValue(2, ((src_port >> 8) & 0xff), (src_port & 0xff)));
+      param->set_value(EncodeHostPortValue(tunnel_info.dst_port));
     }
     {
       auto param = action->add_params();
@@ -1123,8 +1125,7 @@ void PrepareGeneveEncapAndVlanPopTableEntry(
                      ACTION_GENEVE_ENCAP_VLAN_POP_PARAM_DST_PORT));
       uint16_t dst_port = htons(tunnel_info.dst_port);
 
-      param->set_value(
-          EncodeByteValue(2, ((dst_port >> 8) & 0xff), (dst_port & 0xff)));
+      param->set_value(EncodeBits<16>(dst_port));
     }
     {
       auto param = action->add_params();
@@ -1137,7 +1138,7 @@ void PrepareGeneveEncapAndVlanPopTableEntry(
 
 void PrepareEncapAndVlanPopTableEntry(p4::v1::TableEntry* table_entry,
                                       const struct tunnel_info& tunnel_info,
-                                      const ::p4::config::v1::P4Info& p4info,
+                                      const P4InfoResolver& p4info,
                                       bool insert_entry) {
   if (tunnel_info.tunnel_type == OVS_TUNNEL_VXLAN) {
     PrepareVxlanEncapAndVlanPopTableEntry(table_entry, tunnel_info, p4info,
@@ -1153,7 +1154,7 @@ void PrepareEncapAndVlanPopTableEntry(p4::v1::TableEntry* table_entry,
 /* VXLAN_ENCAP_V6_VLAN_POP_MOD_TABLE */
 void PrepareV6VxlanEncapAndVlanPopTableEntry(
     p4::v1::TableEntry* table_entry, const struct tunnel_info& tunnel_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry) {
+    const P4InfoResolver& p4info, bool insert_entry) {
   table_entry->set_table_id(
       GetTableId(p4info, VXLAN_ENCAP_V6_VLAN_POP_MOD_TABLE));
   auto match = table_entry->add_match();
@@ -1189,10 +1190,7 @@ void PrepareV6VxlanEncapAndVlanPopTableEntry(
       // To work around a bug in the Linux Networking P4 program, we
       // ignore the src_port value specified by the caller and instead
       // set the src_port param to (dst_port * 2).
-      uint16_t src_port = htons(tunnel_info.dst_port) * 2;
-
-      param->set_value(
-          EncodeByteValue(2, (src_port >> 8) & 0xff, src_port & 0xff));
+      param->set_value(EncodeHostPortValue(tunnel_info.dst_port));
     }
     {
       auto param = action->add_params();
@@ -1201,8 +1199,7 @@ void PrepareV6VxlanEncapAndVlanPopTableEntry(
                      ACTION_VXLAN_ENCAP_V6_VLAN_POP_PARAM_DST_PORT));
       uint16_t dst_port = htons(tunnel_info.dst_port);
 
-      param->set_value(
-          EncodeByteValue(2, (dst_port >> 8) & 0xff, dst_port & 0xff));
+      param->set_value(EncodeBits<16>(dst_port));
     }
     {
       auto param = action->add_params();
@@ -1216,7 +1213,7 @@ void PrepareV6VxlanEncapAndVlanPopTableEntry(
 /* GENEVE_ENCAP_V6_VLAN_POP_MOD_TABLE */
 void PrepareV6GeneveEncapAndVlanPopTableEntry(
     p4::v1::TableEntry* table_entry, const struct tunnel_info& tunnel_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry) {
+    const P4InfoResolver& p4info, bool insert_entry) {
   table_entry->set_table_id(
       GetTableId(p4info, GENEVE_ENCAP_V6_VLAN_POP_MOD_TABLE));
   auto match = table_entry->add_match();
@@ -1252,10 +1249,7 @@ void PrepareV6GeneveEncapAndVlanPopTableEntry(
       // To work around a bug in the Linux Networking P4 program, we
       // ignore the src_port value specified by the caller and instead
       // set the src_port param to (dst_port * 2).
-      uint16_t src_port = htons(tunnel_info.dst_port) * 2;
-
-      param->set_value(
-          EncodeByteValue(2, (src_port >> 8) & 0xff, src_port & 0xff));
+      param->set_value(EncodeHostPortValue(tunnel_info.dst_port));
     }
     {
       auto param = action->add_params();
@@ -1264,8 +1258,7 @@ void PrepareV6GeneveEncapAndVlanPopTableEntry(
                      ACTION_GENEVE_ENCAP_V6_VLAN_POP_PARAM_DST_PORT));
       uint16_t dst_port = htons(tunnel_info.dst_port);
 
-      param->set_value(
-          EncodeByteValue(2, (dst_port >> 8) & 0xff, dst_port & 0xff));
+      param->set_value(EncodeBits<16>(dst_port));
     }
     {
       auto param = action->add_params();
@@ -1279,7 +1272,7 @@ void PrepareV6GeneveEncapAndVlanPopTableEntry(
 
 void PrepareV6EncapAndVlanPopTableEntry(p4::v1::TableEntry* table_entry,
                                         const struct tunnel_info& tunnel_info,
-                                        const ::p4::config::v1::P4Info& p4info,
+                                        const P4InfoResolver& p4info,
                                         bool insert_entry) {
   if (tunnel_info.tunnel_type == OVS_TUNNEL_VXLAN) {
     PrepareV6VxlanEncapAndVlanPopTableEntry(table_entry, tunnel_info, p4info,
@@ -1294,7 +1287,7 @@ void PrepareV6EncapAndVlanPopTableEntry(p4::v1::TableEntry* table_entry,
 
 void PrepareRxTunnelTableEntry(p4::v1::TableEntry* table_entry,
                                const struct tunnel_info& tunnel_info,
-                               const ::p4::config::v1::P4Info& p4info,
+                               const P4InfoResolver& p4info,
                                bool insert_entry) {
   table_entry->set_table_id(
       GetTableId(p4info, RX_IPV4_TUNNEL_SOURCE_PORT_TABLE));
@@ -1322,15 +1315,14 @@ void PrepareRxTunnelTableEntry(p4::v1::TableEntry* table_entry,
       param->set_param_id(GetParamId(
           p4info, RX_IPV4_TUNNEL_SOURCE_PORT_TABLE_ACTION_SET_SRC_PORT,
           ACTION_SET_SRC_PORT));
-      param->set_value(EncodeByteValue(2, ((tunnel_info.src_port >> 8) & 0xff),
-                                       (tunnel_info.src_port & 0xff)));
+      param->set_value(EncodeBits<16>(tunnel_info.src_port));
     }
   }
 }
 
 void PrepareV6RxTunnelTableEntry(p4::v1::TableEntry* table_entry,
                                  const struct tunnel_info& tunnel_info,
-                                 const ::p4::config::v1::P4Info& p4info,
+                                 const P4InfoResolver& p4info,
                                  bool insert_entry) {
   table_entry->set_table_id(
       GetTableId(p4info, RX_IPV6_TUNNEL_SOURCE_PORT_TABLE));
@@ -1358,8 +1350,7 @@ void PrepareV6RxTunnelTableEntry(p4::v1::TableEntry* table_entry,
       param->set_param_id(GetParamId(
           p4info, RX_IPV6_TUNNEL_SOURCE_PORT_TABLE_ACTION_SET_SRC_PORT,
           ACTION_SET_SRC_PORT));
-      param->set_value(EncodeByteValue(2, ((tunnel_info.src_port >> 8) & 0xff),
-                                       (tunnel_info.src_port & 0xff)));
+      param->set_value(EncodeBits<16>(tunnel_info.src_port));
     }
   }
 }
@@ -1368,7 +1359,7 @@ void PrepareV6RxTunnelTableEntry(p4::v1::TableEntry* table_entry,
 
 void PrepareTunnelTermTableEntry(p4::v1::TableEntry* table_entry,
                                  const struct tunnel_info& tunnel_info,
-                                 const ::p4::config::v1::P4Info& p4info,
+                                 const P4InfoResolver& p4info,
                                  bool insert_entry) {
   // match remote ipv4 addr
   auto match1 = table_entry->add_match();
@@ -1385,7 +1376,7 @@ void PrepareTunnelTermTableEntry(p4::v1::TableEntry* table_entry,
   auto match = table_entry->add_match();
   match->set_field_id(GetMatchFieldId(p4info, IPV4_TUNNEL_TERM_TABLE,
                                       IPV4_TUNNEL_TERM_TABLE_KEY_BRIDGE_ID));
-  match->mutable_exact()->set_value(EncodeByteValue(1, tunnel_info.bridge_id));
+  match->mutable_exact()->set_value(EncodeBits<8>(tunnel_info.bridge_id));
 
   // match vni
   auto match2 = table_entry->add_match();
@@ -1399,7 +1390,7 @@ void PrepareTunnelTermTableEntry(p4::v1::TableEntry* table_entry,
   auto match = table_entry->add_match();
   match->set_field_id(GetMatchFieldId(p4info, IPV4_TUNNEL_TERM_TABLE,
                                       IPV4_TUNNEL_TERM_TABLE_KEY_TUNNEL_TYPE));
-  match->mutable_exact()->set_value(EncodeByteValue(1, TUNNEL_TYPE_VXLAN));
+  match->mutable_exact()->set_value(EncodeBits<8>(TUNNEL_TYPE_VXLAN));
 
   // match local ipv4 addr
   auto match2 = table_entry->add_match();
@@ -1422,7 +1413,7 @@ void PrepareTunnelTermTableEntry(p4::v1::TableEntry* table_entry,
                                      ACTION_DECAP_OUTER_IPV4_PARAM_TUNNEL_ID));
       // TODO(derek): tunnel_id truncated to 8 bits. [dpdk]
       // See https://github.com/ipdk-io/networking-recipe/issues/685
-      param->set_value(EncodeByteValue(1, tunnel_info.vni));
+      param->set_value(EncodeBits<8>(tunnel_info.vni));
     }
   }
 #elif defined(ES2K_TARGET)
@@ -1481,7 +1472,7 @@ void PrepareTunnelTermTableEntry(p4::v1::TableEntry* table_entry,
 #if defined(ES2K_TARGET)
 void PrepareV6TunnelTermTableEntry(p4::v1::TableEntry* table_entry,
                                    const struct tunnel_info& tunnel_info,
-                                   const ::p4::config::v1::P4Info& p4info,
+                                   const P4InfoResolver& p4info,
                                    bool insert_entry) {
   table_entry->set_table_id(GetTableId(p4info, IPV6_TUNNEL_TERM_TABLE));
 
@@ -1490,7 +1481,7 @@ void PrepareV6TunnelTermTableEntry(p4::v1::TableEntry* table_entry,
   auto match = table_entry->add_match();
   match->set_field_id(GetMatchFieldId(p4info, IPV6_TUNNEL_TERM_TABLE,
                                       IPV6_TUNNEL_TERM_TABLE_KEY_BRIDGE_ID));
-  match->mutable_exact()->set_value(EncodeByteValue(1, tunnel_info.bridge_id));
+  match->mutable_exact()->set_value(EncodeBits<8>(tunnel_info.bridge_id));
 
   auto match1 = table_entry->add_match();
   match1->set_field_id(GetMatchFieldId(p4info, IPV6_TUNNEL_TERM_TABLE,
@@ -1555,15 +1546,16 @@ void PrepareV6TunnelTermTableEntry(p4::v1::TableEntry* table_entry,
 
 absl::Status ConfigEncapTableEntry(ovsp4rt::OvsP4rtSession* session,
                                    const struct tunnel_info& tunnel_info,
-                                   const ::p4::config::v1::P4Info& p4info,
+                                   const P4InfoResolver& p4info,
                                    bool insert_entry) {
-  p4::v1::WriteRequest write_request;
+  RequestArena arena;
+  auto* write_request = arena.Create<p4::v1::WriteRequest>();
   ::p4::v1::TableEntry* table_entry;
 
   if (insert_entry) {
-    table_entry = ovsp4rt::SetupTableEntryToInsert(session, &write_request);
+    table_entry = ovsp4rt::SetupTableEntryToInsert(session, write_request);
   } else {
-    table_entry = ovsp4rt::SetupTableEntryToDelete(session, &write_request);
+    table_entry = ovsp4rt::SetupTableEntryToDelete(session, write_request);
   }
 
 #if defined(DPDK_TARGET)
@@ -1591,14 +1583,14 @@ absl::Status ConfigEncapTableEntry(ovsp4rt::OvsP4rtSession* session,
 #error "ASSERT: Unknown TARGET type!"
 #endif
 
-  return ovsp4rt::SendWriteRequest(session, write_request);
+  return ovsp4rt::SendWriteRequest(session, *write_request);
 }
 
 #if defined(ES2K_TARGET)
 
 void PrepareVxlanDecapModTableEntry(p4::v1::TableEntry* table_entry,
                                     const struct tunnel_info& tunnel_info,
-                                    const ::p4::config::v1::P4Info& p4info,
+                                    const P4InfoResolver& p4info,
                                     bool insert_entry) {
   table_entry->set_table_id(GetTableId(p4info, VXLAN_DECAP_MOD_TABLE));
   auto match = table_entry->add_match();
@@ -1617,7 +1609,7 @@ void PrepareVxlanDecapModTableEntry(p4::v1::TableEntry* table_entry,
 
 void PrepareGeneveDecapModTableEntry(p4::v1::TableEntry* table_entry,
                                      const struct tunnel_info& tunnel_info,
-                                     const ::p4::config::v1::P4Info& p4info,
+                                     const P4InfoResolver& p4info,
                                      bool insert_entry) {
   table_entry->set_table_id(GetTableId(p4info, GENEVE_DECAP_MOD_TABLE));
   auto match = table_entry->add_match();
@@ -1636,7 +1628,7 @@ void PrepareGeneveDecapModTableEntry(p4::v1::TableEntry* table_entry,
 
 void PrepareDecapModTableEntry(p4::v1::TableEntry* table_entry,
                                const struct tunnel_info& tunnel_info,
-                               const ::p4::config::v1::P4Info& p4info,
+                               const P4InfoResolver& p4info,
                                bool insert_entry) {
   if (tunnel_info.tunnel_type == OVS_TUNNEL_VXLAN) {
     PrepareVxlanDecapModTableEntry(table_entry, tunnel_info, p4info,
@@ -1651,7 +1643,7 @@ void PrepareDecapModTableEntry(p4::v1::TableEntry* table_entry,
 
 void PrepareVxlanDecapModAndVlanPushTableEntry(
     p4::v1::TableEntry* table_entry, const struct tunnel_info& tunnel_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry) {
+    const P4InfoResolver& p4info, bool insert_entry) {
   table_entry->set_table_id(
       GetTableId(p4info, VXLAN_DECAP_AND_VLAN_PUSH_MOD_TABLE));
   auto match = table_entry->add_match();
@@ -1671,7 +1663,7 @@ void PrepareVxlanDecapModAndVlanPushTableEntry(
           GetParamId(p4info, ACTION_VXLAN_DECAP_AND_PUSH_VLAN,
                      ACTION_VXLAN_DECAP_AND_PUSH_VLAN_PARAM_PCP));
       // note: magic number
-      param->set_value(EncodeByteValue(1, 1));
+      param->set_value(EncodeBits<8>(1));
     }
     {
       auto param = action->add_params();
@@ -1679,7 +1671,7 @@ void PrepareVxlanDecapModAndVlanPushTableEntry(
           GetParamId(p4info, ACTION_VXLAN_DECAP_AND_PUSH_VLAN,
                      ACTION_VXLAN_DECAP_AND_PUSH_VLAN_PARAM_DEI));
       // note: magic number
-      param->set_value(EncodeByteValue(1, 0));
+      param->set_value(EncodeBits<8>(0));
     }
     {
       auto param = action->add_params();
@@ -1688,14 +1680,14 @@ void PrepareVxlanDecapModAndVlanPushTableEntry(
                      ACTION_VXLAN_DECAP_AND_PUSH_VLAN_PARAM_VLAN_ID));
       // TODO(derek): port_vlan truncated to 8 bits. [es2k]
       // See https://github.com/ipdk-io/networking-recipe/issues/678
-      param->set_value(EncodeByteValue(1, tunnel_info.vlan_info.port_vlan));
+      param->set_value(EncodeBits<8>(tunnel_info.vlan_info.port_vlan));
     }
   }
 }
 
 void PrepareGeneveDecapModAndVlanPushTableEntry(
     p4::v1::TableEntry* table_entry, const struct tunnel_info& tunnel_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry) {
+    const P4InfoResolver& p4info, bool insert_entry) {
   table_entry->set_table_id(
       GetTableId(p4info, GENEVE_DECAP_AND_VLAN_PUSH_MOD_TABLE));
   auto match = table_entry->add_match();
@@ -1715,7 +1707,7 @@ void PrepareGeneveDecapModAndVlanPushTableEntry(
           GetParamId(p4info, ACTION_GENEVE_DECAP_AND_PUSH_VLAN,
                      ACTION_GENEVE_DECAP_AND_PUSH_VLAN_PARAM_PCP));
       // note: magic number
-      param->set_value(EncodeByteValue(1, 1));
+      param->set_value(EncodeBits<8>(1));
     }
     {
       auto param = action->add_params();
@@ -1723,7 +1715,7 @@ void PrepareGeneveDecapModAndVlanPushTableEntry(
           GetParamId(p4info, ACTION_GENEVE_DECAP_AND_PUSH_VLAN,
                      ACTION_GENEVE_DECAP_AND_PUSH_VLAN_PARAM_DEI));
       // note: magic number
-      param->set_value(EncodeByteValue(1, 0));
+      param->set_value(EncodeBits<8>(0));
     }
     {
       auto param = action->add_params();
@@ -1732,14 +1724,15 @@ void PrepareGeneveDecapModAndVlanPushTableEntry(
                      ACTION_GENEVE_DECAP_AND_PUSH_VLAN_PARAM_VLAN_ID));
       // TODO(derek): port_vlan truncated to 8 bits. [es2k]
       // See https://github.com/ipdk-io/networking-recipe/issues/679
-      param->set_value(EncodeByteValue(1, tunnel_info.vlan_info.port_vlan));
+      param->set_value(EncodeBits<8>(tunnel_info.vlan_info.port_vlan));
     }
   }
 }
 
-void PrepareDecapModAndVlanPushTableEntry(
-    p4::v1::TableEntry* table_entry, const struct tunnel_info& tunnel_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry) {
+void PrepareDecapModAndVlanPushTableEntry(p4::v1::TableEntry* table_entry,
+                                          const struct tunnel_info& tunnel_info,
+                                          const P4InfoResolver& p4info,
+                                          bool insert_entry) {
   if (tunnel_info.tunnel_type == OVS_TUNNEL_VXLAN) {
     PrepareVxlanDecapModAndVlanPushTableEntry(table_entry, tunnel_info, p4info,
                                               insert_entry);
@@ -1753,15 +1746,16 @@ void PrepareDecapModAndVlanPushTableEntry(
 
 absl::Status ConfigDecapTableEntry(ovsp4rt::OvsP4rtSession* session,
                                    const struct tunnel_info& tunnel_info,
-                                   const ::p4::config::v1::P4Info& p4info,
+                                   const P4InfoResolver& p4info,
                                    bool insert_entry) {
-  p4::v1::WriteRequest write_request;
+  RequestArena arena;
+  auto* write_request = arena.Create<p4::v1::WriteRequest>();
   ::p4::v1::TableEntry* table_entry;
 
   if (insert_entry) {
-    table_entry = ovsp4rt::SetupTableEntryToInsert(session, &write_request);
+    table_entry = ovsp4rt::SetupTableEntryToInsert(session, write_request);
   } else {
-    table_entry = ovsp4rt::SetupTableEntryToDelete(session, &write_request);
+    table_entry = ovsp4rt::SetupTableEntryToDelete(session, write_request);
   }
 
   if (tunnel_info.vlan_info.port_vlan_mode == P4_PORT_VLAN_NATIVE_TAGGED) {
@@ -1771,109 +1765,79 @@ absl::Status ConfigDecapTableEntry(ovsp4rt::OvsP4rtSession* session,
                                          insert_entry);
   }
 
-  return ovsp4rt::SendWriteRequest(session, write_request);
+  return ovsp4rt::SendWriteRequest(session, *write_request);
 }
 
 void PrepareVlanPushTableEntry(p4::v1::TableEntry* table_entry,
                                const uint16_t vlan_id,
-                               const ::p4::config::v1::P4Info& p4info,
+                               const P4InfoResolver& p4info,
                                bool insert_entry) {
-  table_entry->set_table_id(GetTableId(p4info, VLAN_PUSH_MOD_TABLE));
-  auto match = table_entry->add_match();
-  match->set_field_id(GetMatchFieldId(p4info, VLAN_PUSH_MOD_TABLE,
-                                      VLAN_PUSH_MOD_KEY_MOD_BLOB_PTR));
+  p4info.GetTemplate(kVlanPushModVlanPush).Fill(table_entry, insert_entry);
   // note: mod_blob_ptr is bit<24>, vlan_id is bit<12>, encoded value is bit<8>.
-  match->mutable_exact()->set_value(EncodeByteValue(1, vlan_id));
+  SetMatchValue(table_entry, 0, EncodeBits<8>(vlan_id));
 
   if (insert_entry) {
-    auto table_action = table_entry->mutable_action();
-    auto action = table_action->mutable_action();
-    action->set_action_id(GetActionId(p4info, VLAN_PUSH_MOD_ACTION_VLAN_PUSH));
-    {
-      auto param = action->add_params();
-      param->set_param_id(GetParamId(p4info, VLAN_PUSH_MOD_ACTION_VLAN_PUSH,
-                                     ACTION_VLAN_PUSH_PARAM_PCP));
-      // note: magic number
-      // note: pcp is bit<3>
-      param->set_value(EncodeByteValue(1, 1));
-    }
-    {
-      auto param = action->add_params();
-      param->set_param_id(GetParamId(p4info, VLAN_PUSH_MOD_ACTION_VLAN_PUSH,
-                                     ACTION_VLAN_PUSH_PARAM_DEI));
-      // note: magic number
-      // note: dei is bit<1>
-      param->set_value(EncodeByteValue(1, 0));
-    }
-    {
-      auto param = action->add_params();
-      param->set_param_id(GetParamId(p4info, VLAN_PUSH_MOD_ACTION_VLAN_PUSH,
-                                     ACTION_VLAN_PUSH_PARAM_VLAN_ID));
-      // note: vlan_id is bit<12>, encoded value is bit<8>
-      param->set_value(EncodeByteValue(1, vlan_id));
-    }
+    // note: magic number
+    // note: pcp is bit<3>
+    SetParamValue(table_entry, 0, EncodeBits<8>(1));
+    // note: magic number
+    // note: dei is bit<1>
+    SetParamValue(table_entry, 1, EncodeBits<8>(0));
+    // note: vlan_id is bit<12>, encoded value is bit<8>
+    SetParamValue(table_entry, 2, EncodeBits<8>(vlan_id));
   }
 }
 
 void PrepareVlanPopTableEntry(p4::v1::TableEntry* table_entry,
                               const uint16_t vlan_id,
-                              const ::p4::config::v1::P4Info& p4info,
-                              bool insert_entry) {
-  table_entry->set_table_id(GetTableId(p4info, VLAN_POP_MOD_TABLE));
-  auto match = table_entry->add_match();
-  match->set_field_id(GetMatchFieldId(p4info, VLAN_POP_MOD_TABLE,
-                                      VLAN_POP_MOD_KEY_MOD_BLOB_PTR));
+                              const P4InfoResolver& p4info, bool insert_entry) {
+  p4info.GetTemplate(kVlanPopModVlanPop).Fill(table_entry, insert_entry);
   // TODO(derek): vlan_id truncated to 8 bits. [es2k]
   // See https://github.com/ipdk-io/networking-recipe/issues/684
-  match->mutable_exact()->set_value(EncodeByteValue(1, vlan_id));
-
-  if (insert_entry) {
-    auto table_action = table_entry->mutable_action();
-    auto action = table_action->mutable_action();
-    action->set_action_id(GetActionId(p4info, VLAN_POP_MOD_ACTION_VLAN_POP));
-  }
+  SetMatchValue(table_entry, 0, EncodeBits<8>(vlan_id));
 }
 
 absl::Status ConfigVlanPushTableEntry(ovsp4rt::OvsP4rtSession* session,
                                       const uint16_t vlan_id,
-                                      const ::p4::config::v1::P4Info& p4info,
+                                      const P4InfoResolver& p4info,
                                       bool insert_entry) {
-  p4::v1::WriteRequest write_request;
+  RequestArena arena;
+  auto* write_request = arena.Create<p4::v1::WriteRequest>();
   ::p4::v1::TableEntry* table_entry;
 
   if (insert_entry) {
-    table_entry = ovsp4rt::SetupTableEntryToInsert(session, &write_request);
+    table_entry = ovsp4rt::SetupTableEntryToInsert(session, write_request);
   } else {
-    table_entry = ovsp4rt::SetupTableEntryToDelete(session, &write_request);
+    table_entry = ovsp4rt::SetupTableEntryToDelete(session, write_request);
   }
 
   PrepareVlanPushTableEntry(table_entry, vlan_id, p4info, insert_entry);
 
-  return ovsp4rt::SendWriteRequest(session, write_request);
+  return ovsp4rt::SendWriteRequest(session, *write_request);
 }
 
 absl::Status ConfigVlanPopTableEntry(ovsp4rt::OvsP4rtSession* session,
                                      const uint16_t vlan_id,
-                                     const ::p4::config::v1::P4Info& p4info,
+                                     const P4InfoResolver& p4info,
                                      bool insert_entry) {
-  p4::v1::WriteRequest write_request;
+  RequestArena arena;
+  auto* write_request = arena.Create<p4::v1::WriteRequest>();
   ::p4::v1::TableEntry* table_entry;
 
   if (insert_entry) {
-    table_entry = ovsp4rt::SetupTableEntryToInsert(session, &write_request);
+    table_entry = ovsp4rt::SetupTableEntryToInsert(session, write_request);
   } else {
-    table_entry = ovsp4rt::SetupTableEntryToDelete(session, &write_request);
+    table_entry = ovsp4rt::SetupTableEntryToDelete(session, write_request);
   }
 
   PrepareVlanPopTableEntry(table_entry, vlan_id, p4info, insert_entry);
 
-  return ovsp4rt::SendWriteRequest(session, write_request);
+  return ovsp4rt::SendWriteRequest(session, *write_request);
 }
 
 void PrepareSrcPortTableEntry(p4::v1::TableEntry* table_entry,
                               const struct src_port_info& sp,
-                              const ::p4::config::v1::P4Info& p4info,
-                              bool insert_entry) {
+                              const P4InfoResolver& p4info, bool insert_entry) {
   table_entry->set_table_id(
       GetTableId(p4info, SOURCE_PORT_TO_BRIDGE_MAP_TABLE));
 
@@ -1882,18 +1846,16 @@ void PrepareSrcPortTableEntry(p4::v1::TableEntry* table_entry,
   match->set_field_id(
       GetMatchFieldId(p4info, SOURCE_PORT_TO_BRIDGE_MAP_TABLE,
                       SOURCE_PORT_TO_BRIDGE_MAP_TABLE_KEY_SRC_PORT));
-  match->mutable_ternary()->set_value(
-      EncodeByteValue(2, ((sp.src_port >> 8) & 0xff), (sp.src_port & 0xff)));
-  match->mutable_ternary()->set_mask(EncodeByteValue(2, 0xff, 0xff));
+  match->mutable_ternary()->set_value(EncodeBits<16>(sp.src_port));
+  match->mutable_ternary()->set_mask(EncodeBits<16>(0xffff));
 
   auto match1 = table_entry->add_match();
   match1->set_field_id(
       GetMatchFieldId(p4info, SOURCE_PORT_TO_BRIDGE_MAP_TABLE,
                       SOURCE_PORT_TO_BRIDGE_MAP_TABLE_KEY_VID));
-  match1->mutable_ternary()->set_value(
-      EncodeByteValue(2, ((sp.vlan_id >> 8) & 0x0f), (sp.vlan_id & 0xff)));
-  match1->mutable_ternary()->set_mask(EncodeByteValue(2, 0x0f, 0xff));
-  // match1->mutable_ternary()->set_mask(EncodeByteValue(1, 0xff));
+  match1->mutable_ternary()->set_value(EncodeBits<12>(sp.vlan_id));
+  match1->mutable_ternary()->set_mask(EncodeBits<12>(0xfff));
+  // match1->mutable_ternary()->set_mask(EncodeBits<8>(0xff));
 
   if (insert_entry) {
     auto table_action = table_entry->mutable_action();
@@ -1905,250 +1867,179 @@ void PrepareSrcPortTableEntry(p4::v1::TableEntry* table_entry,
       param->set_param_id(GetParamId(
           p4info, SOURCE_PORT_TO_BRIDGE_MAP_TABLE_ACTION_SET_BRIDGE_ID,
           ACTION_SET_BRIDGE_ID_PARAM_BRIDGE_ID));
-      param->set_value(EncodeByteValue(1, sp.bridge_id));
+      param->set_value(EncodeBits<8>(sp.bridge_id));
     }
   }
 }
 
 void PrepareSrcIpMacMapTableEntry(p4::v1::TableEntry* table_entry,
                                   struct ip_mac_map_info& ip_info,
-                                  const ::p4::config::v1::P4Info& p4info,
+                                  const P4InfoResolver& p4info,
                                   bool insert_entry, DiagDetail& detail) {
   detail.table_id = LOG_SRC_IP_MAC_MAP_TABLE;
-  table_entry->set_table_id(GetTableId(p4info, SRC_IP_MAC_MAP_TABLE));
-
-  auto match = table_entry->add_match();
-  match->set_field_id(GetMatchFieldId(p4info, SRC_IP_MAC_MAP_TABLE,
-                                      SRC_IP_MAC_MAP_TABLE_KEY_SRC_IP));
-  match->mutable_exact()->set_value(
-      CanonicalizeIp(ip_info.src_ip_addr.ip.v4addr.s_addr));
+  p4info.GetTemplate(kSrcIpMacMapSmacMap).Fill(table_entry, insert_entry);
+  SetMatchValue(table_entry, 0,
+                CanonicalizeIp(ip_info.src_ip_addr.ip.v4addr.s_addr));
 
   if (insert_entry) {
-    auto table_action = table_entry->mutable_action();
-    auto action = table_action->mutable_action();
-    action->set_action_id(
-        GetActionId(p4info, SRC_IP_MAC_MAP_TABLE_ACTION_SMAC_MAP));
-    {
-      auto param = action->add_params();
-      param->set_param_id(GetParamId(p4info,
-                                     SRC_IP_MAC_MAP_TABLE_ACTION_SMAC_MAP,
-                                     ACTION_SET_SRC_MAC_HIGH));
-      std::string mac_high =
-          EncodeByteValue(2, (ip_info.src_mac_addr[0] & 0xff),
-                          (ip_info.src_mac_addr[1] & 0xff));
-      param->set_value(mac_high);
-    }
-    {
-      auto param = action->add_params();
-      param->set_param_id(GetParamId(p4info,
-                                     SRC_IP_MAC_MAP_TABLE_ACTION_SMAC_MAP,
-                                     ACTION_SET_SRC_MAC_MID));
-      std::string mac_mid = EncodeByteValue(2, (ip_info.src_mac_addr[2] & 0xff),
-                                            (ip_info.src_mac_addr[3] & 0xff));
-      param->set_value(mac_mid);
-    }
-    {
-      auto param = action->add_params();
-      param->set_param_id(GetParamId(p4info,
-                                     SRC_IP_MAC_MAP_TABLE_ACTION_SMAC_MAP,
-                                     ACTION_SET_SRC_MAC_LOW));
-      std::string mac_low = EncodeByteValue(2, (ip_info.src_mac_addr[4] & 0xff),
-                                            (ip_info.src_mac_addr[5] & 0xff));
-      param->set_value(mac_low);
+    const uint8_t* mac = ip_info.src_mac_addr;
+    // High, middle and low 16 bits of the MAC address.
+    for (int i = 0; i < 3; i++) {
+      SetParamValue(table_entry, i, EncodeBytes<2>(mac + 2 * i));
     }
   }
 }
 
 void PrepareDstIpMacMapTableEntry(p4::v1::TableEntry* table_entry,
                                   struct ip_mac_map_info& ip_info,
-                                  const ::p4::config::v1::P4Info& p4info,
+                                  const P4InfoResolver& p4info,
                                   bool insert_entry, DiagDetail& detail) {
   detail.table_id = LOG_DST_IP_MAC_MAP_TABLE;
-  table_entry->set_table_id(GetTableId(p4info, DST_IP_MAC_MAP_TABLE));
-
-  auto match = table_entry->add_match();
-  match->set_field_id(GetMatchFieldId(p4info, DST_IP_MAC_MAP_TABLE,
-                                      DST_IP_MAC_MAP_TABLE_KEY_DST_IP));
-  match->mutable_exact()->set_value(
-      CanonicalizeIp((ip_info.dst_ip_addr.ip.v4addr.s_addr)));
+  p4info.GetTemplate(kDstIpMacMapDmacMap).Fill(table_entry, insert_entry);
+  SetMatchValue(table_entry, 0,
+                CanonicalizeIp(ip_info.dst_ip_addr.ip.v4addr.s_addr));
 
   if (insert_entry) {
-    auto table_action = table_entry->mutable_action();
-    auto action = table_action->mutable_action();
-    action->set_action_id(
-        GetActionId(p4info, DST_IP_MAC_MAP_TABLE_ACTION_DMAC_MAP));
-    {
-      auto param = action->add_params();
-      param->set_param_id(GetParamId(p4info,
-                                     DST_IP_MAC_MAP_TABLE_ACTION_DMAC_MAP,
-                                     ACTION_SET_DST_MAC_HIGH));
-      std::string mac_high =
-          EncodeByteValue(2, (ip_info.dst_mac_addr[0] & 0xff),
-                          (ip_info.dst_mac_addr[1] & 0xff));
-      param->set_value(mac_high);
-    }
-    {
-      auto param = action->add_params();
-      param->set_param_id(GetParamId(p4info,
-                                     DST_IP_MAC_MAP_TABLE_ACTION_DMAC_MAP,
-                                     ACTION_SET_DST_MAC_MID));
-      std::string mac_mid = EncodeByteValue(2, (ip_info.dst_mac_addr[2] & 0xff),
-                                            (ip_info.dst_mac_addr[3] & 0xff));
-      param->set_value(mac_mid);
-    }
-    {
-      auto param = action->add_params();
-      param->set_param_id(GetParamId(p4info,
-                                     DST_IP_MAC_MAP_TABLE_ACTION_DMAC_MAP,
-                                     ACTION_SET_DST_MAC_LOW));
-      std::string mac_low = EncodeByteValue(2, (ip_info.dst_mac_addr[4] & 0xff),
-                                            (ip_info.dst_mac_addr[5] & 0xff));
-      param->set_value(mac_low);
+    const uint8_t* mac = ip_info.dst_mac_addr;
+    // High, middle and low 16 bits of the MAC address.
+    for (int i = 0; i < 3; i++) {
+      SetParamValue(table_entry, i, EncodeBytes<2>(mac + 2 * i));
     }
   }
 }
 
 void PrepareTxAccVsiTableEntry(p4::v1::TableEntry* table_entry, uint32_t sp,
-                               const ::p4::config::v1::P4Info& p4info) {
-  table_entry->set_table_id(GetTableId(p4info, TX_ACC_VSI_TABLE));
-
-  auto match = table_entry->add_match();
-  match->set_field_id(
-      GetMatchFieldId(p4info, TX_ACC_VSI_TABLE, TX_ACC_VSI_TABLE_KEY_VSI));
+                               const P4InfoResolver& p4info) {
+  p4info.GetTemplate(kTxAccVsiL2FwdAndBypassBridge).Fill(table_entry, false);
   // TODO(derek): sp value truncated to 8 bits. [es2k]
   // See https://github.com/ipdk-io/networking-recipe/issues/680 for details.
-  match->mutable_exact()->set_value(
-      EncodeByteValue(1, (sp - ES2K_VPORT_ID_OFFSET)));
+  SetMatchValue(table_entry, 0, EncodeBits<8>((sp - ES2K_VPORT_ID_OFFSET)));
+}
 
-#if 0
-  /* unused match key of 0, code is added for reference */
-  auto match1 = table_entry->add_match();
-  match1->set_field_id(
-      GetMatchFieldId(p4info, TX_ACC_VSI_TABLE,
-                      TX_ACC_VSI_TABLE_KEY_ZERO_PADDING));
-  match->mutable_exact()->set_value(EncodeByteValue(1, 0));
-#endif
+//----------------------------------------------------------------------
+// Existence checks
+//
+// These are answered from the shadow table, which reads a table from
+// the switch only the first time it is checked in a session. A failed
+// read counts as "not found", as it did when each entry was read.
+//
+// An entry that is found during an audit epoch is marked, since OVS
+// still wants it.
+//----------------------------------------------------------------------
+bool TableEntryExists(ovsp4rt::OvsP4rtSession* session,
+                      const ::p4::v1::TableEntry& table_entry) {
+  auto status_or_exists = session->Shadow().Contains(session, table_entry);
+  bool exists = status_or_exists.ok() && *status_or_exists;
+  if (exists) {
+    EpochAudit::Instance().Mark(session->SessionId(), table_entry);
+  }
+  return exists;
 }
 
-absl::StatusOr<::p4::v1::ReadResponse> GetL2ToTunnelV4TableEntry(
-    ovsp4rt::OvsP4rtSession* session,
-    const struct mac_learning_info& learn_info,
-    const ::p4::config::v1::P4Info& p4info) {
-  ::p4::v1::ReadRequest read_request;
-  ::p4::v1::TableEntry* table_entry;
+bool HasL2ToTunnelV4TableEntry(ovsp4rt::OvsP4rtSession* session,
+                               const struct mac_learning_info& learn_info,
+                               const P4InfoResolver& p4info) {
+  RequestArena arena;
+  auto* table_entry = arena.Create<::p4::v1::TableEntry>();
   DiagDetail detail;
 
-  table_entry = ovsp4rt::SetupTableEntryToRead(session, &read_request);
-
   PrepareL2ToTunnelV4(table_entry, learn_info, p4info, false, detail);
 
   // This function does not log failed requests.
-  return ovsp4rt::SendReadRequest(session, read_request);
+  return TableEntryExists(session, *table_entry);
 }
 
-absl::StatusOr<::p4::v1::ReadResponse> GetL2ToTunnelV6TableEntry(
-    ovsp4rt::OvsP4rtSession* session,
-    const struct mac_learning_info& learn_info,
-    const ::p4::config::v1::P4Info& p4info) {
-  ::p4::v1::ReadRequest read_request;
-  ::p4::v1::TableEntry* table_entry;
+bool HasL2ToTunnelV6TableEntry(ovsp4rt::OvsP4rtSession* session,
+                               const struct mac_learning_info& learn_info,
+                               const P4InfoResolver& p4info) {
+  RequestArena arena;
+  auto* table_entry = arena.Create<::p4::v1::TableEntry>();
   DiagDetail detail;
 
-  table_entry = ovsp4rt::SetupTableEntryToRead(session, &read_request);
-
   PrepareL2ToTunnelV6(table_entry, learn_info, p4info, false, detail);
 
   // This function does not log failed requests.
-  return ovsp4rt::SendReadRequest(session, read_request);
+  return TableEntryExists(session, *table_entry);
 }
 
-absl::StatusOr<::p4::v1::ReadResponse> GetFdbTunnelTableEntry(
-    ovsp4rt::OvsP4rtSession* session,
-    const struct mac_learning_info& learn_info,
-    const ::p4::config::v1::P4Info& p4info, bool adding = false) {
-  ::p4::v1::ReadRequest read_request;
-  ::p4::v1::TableEntry* table_entry;
+bool HasFdbTunnelTableEntry(ovsp4rt::OvsP4rtSession* session,
+                            const struct mac_learning_info& learn_info,
+                            const P4InfoResolver& p4info,
+                            bool adding = false) {
+  RequestArena arena;
+  auto* table_entry = arena.Create<::p4::v1::TableEntry>();
   DiagDetail detail;
 
-  table_entry = ovsp4rt::SetupTableEntryToRead(session, &read_request);
-
 #if defined(DPDK_TARGET)
-  PrepareFdbTableEntryforV4VxlanTunnel(table_entry, learn_info, p4info, false,
-                                       detail);
+  PrepareFdbTableEntryforV4VxlanTunnel(table_entry, learn_info, p4info,
+                                       false, detail);
 #elif defined(ES2K_TARGET)
   if (learn_info.tnl_info.tunnel_type == OVS_TUNNEL_VXLAN) {
-    PrepareFdbTableEntryforV4VxlanTunnel(table_entry, learn_info, p4info, false,
-                                         detail);
+    PrepareFdbTableEntryforV4VxlanTunnel(table_entry, learn_info, p4info,
+                                         false, detail);
   } else if (learn_info.tnl_info.tunnel_type == OVS_TUNNEL_GENEVE) {
     PrepareFdbTableEntryforV4GeneveTunnel(table_entry, learn_info, p4info,
                                           false, detail);
   } else {
-    return absl::UnknownError("Unsupported tunnel type");
+    return false;
   }
 #else
 #error "ASSERT: Unknown TARGET type!"
 #endif
 
-  auto status = ovsp4rt::SendReadRequest(session, read_request);
-  if (status.ok() && adding) {
+  bool exists = TableEntryExists(session, *table_entry);
+  if (exists && adding) {
     ovsp4rt_log_error("Error adding to %s: entry already exists",
                       detail.getLogTableName());
   }
-  return status;
+  return exists;
 }
 
-absl::StatusOr<::p4::v1::ReadResponse> GetFdbVlanTableEntry(
-    ovsp4rt::OvsP4rtSession* session,
-    const struct mac_learning_info& learn_info,
-    const ::p4::config::v1::P4Info& p4info, bool adding = false) {
-  ::p4::v1::ReadRequest read_request;
-  ::p4::v1::TableEntry* table_entry;
+bool HasFdbVlanTableEntry(ovsp4rt::OvsP4rtSession* session,
+                          const struct mac_learning_info& learn_info,
+                          const P4InfoResolver& p4info, bool adding = false) {
+  RequestArena arena;
+  auto* table_entry = arena.Create<::p4::v1::TableEntry>();
   DiagDetail detail;
 
-  table_entry = ovsp4rt::SetupTableEntryToRead(session, &read_request);
-
   PrepareFdbTxVlanTableEntry(table_entry, learn_info, p4info, false, detail);
 
-  auto status = ovsp4rt::SendReadRequest(session, read_request);
-  if (status.ok() && adding) {
-    ovsp4rt_log_error("Error adding to %: entry already exists",
+  bool exists = TableEntryExists(session, *table_entry);
+  if (exists && adding) {
+    ovsp4rt_log_error("Error adding to %s: entry already exists",
                       detail.getLogTableName());
   }
-  return status;
+  return exists;
 }
 
-absl::StatusOr<::p4::v1::ReadResponse> GetVmSrcTableEntry(
-    ovsp4rt::OvsP4rtSession* session, struct ip_mac_map_info ip_info,
-    const ::p4::config::v1::P4Info& p4info) {
-  ::p4::v1::ReadRequest read_request;
-  ::p4::v1::TableEntry* table_entry;
+bool HasVmSrcTableEntry(ovsp4rt::OvsP4rtSession* session,
+                        struct ip_mac_map_info ip_info,
+                        const P4InfoResolver& p4info) {
+  RequestArena arena;
+  auto* table_entry = arena.Create<::p4::v1::TableEntry>();
   DiagDetail detail;
 
-  table_entry = ovsp4rt::SetupTableEntryToRead(session, &read_request);
-
   PrepareSrcIpMacMapTableEntry(table_entry, ip_info, p4info, false, detail);
 
   // This function does not log failed requests.
-  return ovsp4rt::SendReadRequest(session, read_request);
+  return TableEntryExists(session, *table_entry);
 }
 
-absl::StatusOr<::p4::v1::ReadResponse> GetVmDstTableEntry(
-    ovsp4rt::OvsP4rtSession* session, struct ip_mac_map_info ip_info,
-    const ::p4::config::v1::P4Info& p4info) {
-  ::p4::v1::ReadRequest read_request;
-  ::p4::v1::TableEntry* table_entry;
+bool HasVmDstTableEntry(ovsp4rt::OvsP4rtSession* session,
+                        struct ip_mac_map_info ip_info,
+                        const P4InfoResolver& p4info) {
+  RequestArena arena;
+  auto* table_entry = arena.Create<::p4::v1::TableEntry>();
   DiagDetail detail;
 
-  table_entry = ovsp4rt::SetupTableEntryToRead(session, &read_request);
-
   PrepareDstIpMacMapTableEntry(table_entry, ip_info, p4info, false, detail);
 
-  return ovsp4rt::SendReadRequest(session, read_request);
+  return TableEntryExists(session, *table_entry);
 }
 
 absl::StatusOr<::p4::v1::ReadResponse> GetTxAccVsiTableEntry(
     ovsp4rt::OvsP4rtSession* session, uint32_t sp,
-    const ::p4::config::v1::P4Info& p4info) {
+    const P4InfoResolver& p4info) {
   ::p4::v1::ReadRequest read_request;
   ::p4::v1::TableEntry* table_entry;
 
@@ -2159,33 +2050,145 @@ absl::StatusOr<::p4::v1::ReadResponse> GetTxAccVsiTableEntry(
   return ovsp4rt::SendReadRequest(session, read_request);
 }
 
-absl::Status ConfigureVsiSrcPortTableEntry(
-    ovsp4rt::OvsP4rtSession* session, const struct src_port_info& sp,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry) {
-  p4::v1::WriteRequest write_request;
+//----------------------------------------------------------------------
+// VSI-to-host-port resolution (ES2K)
+//
+// The tx_acc_vsi table maps each VSI to its host port. The mappings
+// are cached in the VsiPortMap, so resolving a port only reads the
+// switch the first time in a session, or when the VSI is new.
+//----------------------------------------------------------------------
+
+// Returns the tx_acc_vsi key for a source port. The match field only
+// holds the low 8 bits of the VSI.
+uint32_t TxAccVsiKey(uint32_t sp) {
+  return (sp - ES2K_VPORT_ID_OFFSET) & 0xff;
+}
+
+// Returns the value of a big-endian bytestring.
+static uint32_t DecodeUint32(const std::string& value) {
+  uint32_t result = 0;
+  for (unsigned char byte : value) {
+    result = result << 8 | byte;
+  }
+  return result;
+}
+
+bool DecodeTxAccVsiTableEntry(const ::p4::v1::TableEntry& table_entry,
+                              const P4InfoResolver& p4info, uint32_t* vsi,
+                              uint32_t* host_port) {
+  const auto& table = p4info.GetTemplate(kTxAccVsiL2FwdAndBypassBridge);
+
+  // The switch returns every key of the table, so find the VSI by its
+  // field ID and ignore the others (e.g., zero_padding).
+  const ::p4::v1::FieldMatch* vsi_match = nullptr;
+  for (const auto& match : table_entry.match()) {
+    if (static_cast<int>(match.field_id()) == table.match_field_id(0)) {
+      vsi_match = &match;
+      break;
+    }
+  }
+  if (vsi_match == nullptr || !vsi_match->has_exact()) {
+    return false;
+  }
+
+  for (const auto& param : table_entry.action().action().params()) {
+    if (static_cast<int>(param.param_id()) == table.param_id(0)) {
+      *vsi = DecodeUint32(vsi_match->exact().value());
+      *host_port = DecodeUint32(param.value());
+      return true;
+    }
+  }
+  return false;
+}
+
+// Loads the VSI port map with a read of the whole tx_acc_vsi table.
+void LoadVsiPortMap(ovsp4rt::OvsP4rtSession* session,
+                    const P4InfoResolver& p4info) {
+  ::p4::v1::ReadRequest read_request;
+  ::p4::v1::TableEntry* table_entry;
+  VsiPortMap::PortMap ports;
+
+  table_entry = ovsp4rt::SetupTableEntryToRead(session, &read_request);
+  table_entry->set_table_id(
+      p4info.GetTemplate(kTxAccVsiL2FwdAndBypassBridge).table_id());
+
+  auto add_port = [&](const ::p4::v1::Entity& entity) {
+    uint32_t vsi, host_port;
+    if (DecodeTxAccVsiTableEntry(entity.table_entry(), p4info, &vsi,
+                                 &host_port)) {
+      ports[vsi] = host_port;
+    }
+    return true;
+  };
+
+  // If the read fails, the ports that were not received are read
+  // when they are first resolved.
+  ovsp4rt::ReadEntities(session, read_request, add_port).IgnoreError();
+
+  session->VsiPorts().Load(std::move(ports));
+}
+
+// Returns the host port for a source port (VSI).
+absl::StatusOr<uint32_t> GetHostPort(ovsp4rt::OvsP4rtSession* session,
+                                     uint32_t sp,
+                                     const P4InfoResolver& p4info) {
+  auto& port_map = session->VsiPorts();
+
+  if (!port_map.IsLoaded()) {
+    LoadVsiPortMap(session, p4info);
+  }
+
+  auto host_port = port_map.Find(TxAccVsiKey(sp));
+  if (host_port) {
+    return *host_port;
+  }
+
+  // The VSI may have been added since the map was loaded.
+  auto status_or_read_response = GetTxAccVsiTableEntry(session, sp, p4info);
+  if (!status_or_read_response.ok()) {
+    return status_or_read_response.status();
+  }
+
+  for (const auto& entity : status_or_read_response->entities()) {
+    uint32_t vsi, port;
+    if (DecodeTxAccVsiTableEntry(entity.table_entry(), p4info, &vsi, &port)) {
+      port_map.Insert(vsi, port);
+      return port;
+    }
+  }
+  return absl::NotFoundError("No host port for VSI");
+}
+
+absl::Status ConfigureVsiSrcPortTableEntry(ovsp4rt::OvsP4rtSession* session,
+                                           const struct src_port_info& sp,
+                                           const P4InfoResolver& p4info,
+                                           bool insert_entry) {
+  RequestArena arena;
+  auto* write_request = arena.Create<p4::v1::WriteRequest>();
   ::p4::v1::TableEntry* table_entry;
 
   if (insert_entry) {
-    table_entry = ovsp4rt::SetupTableEntryToInsert(session, &write_request);
+    table_entry = ovsp4rt::SetupTableEntryToInsert(session, write_request);
   } else {
-    table_entry = ovsp4rt::SetupTableEntryToDelete(session, &write_request);
+    table_entry = ovsp4rt::SetupTableEntryToDelete(session, write_request);
   }
 
   PrepareSrcPortTableEntry(table_entry, sp, p4info, insert_entry);
 
-  return ovsp4rt::SendWriteRequest(session, write_request);
+  return ovsp4rt::SendWriteRequest(session, *write_request);
 }
 
 absl::Status ConfigRxTunnelSrcPortTableEntry(
     ovsp4rt::OvsP4rtSession* session, const struct tunnel_info& tunnel_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry) {
-  p4::v1::WriteRequest write_request;
+    const P4InfoResolver& p4info, bool insert_entry) {
+  RequestArena arena;
+  auto* write_request = arena.Create<p4::v1::WriteRequest>();
   ::p4::v1::TableEntry* table_entry;
 
   if (insert_entry) {
-    table_entry = ovsp4rt::SetupTableEntryToInsert(session, &write_request);
+    table_entry = ovsp4rt::SetupTableEntryToInsert(session, write_request);
   } else {
-    table_entry = ovsp4rt::SetupTableEntryToDelete(session, &write_request);
+    table_entry = ovsp4rt::SetupTableEntryToDelete(session, write_request);
   }
 
   if (tunnel_info.local_ip.family == AF_INET &&
@@ -2196,22 +2199,23 @@ absl::Status ConfigRxTunnelSrcPortTableEntry(
     PrepareV6RxTunnelTableEntry(table_entry, tunnel_info, p4info, insert_entry);
   }
 
-  return ovsp4rt::SendWriteRequest(session, write_request);
+  return ovsp4rt::SendWriteRequest(session, *write_request);
 }
 
 #endif  // ES2K_TARGET
 
 absl::Status ConfigTunnelTermTableEntry(ovsp4rt::OvsP4rtSession* session,
                                         const struct tunnel_info& tunnel_info,
-                                        const ::p4::config::v1::P4Info& p4info,
+                                        const P4InfoResolver& p4info,
                                         bool insert_entry) {
-  p4::v1::WriteRequest write_request;
+  RequestArena arena;
+  auto* write_request = arena.Create<p4::v1::WriteRequest>();
   ::p4::v1::TableEntry* table_entry;
 
   if (insert_entry) {
-    table_entry = ovsp4rt::SetupTableEntryToInsert(session, &write_request);
+    table_entry = ovsp4rt::SetupTableEntryToInsert(session, write_request);
   } else {
-    table_entry = ovsp4rt::SetupTableEntryToDelete(session, &write_request);
+    table_entry = ovsp4rt::SetupTableEntryToDelete(session, write_request);
   }
 #if defined(DPDK_TARGET)
   PrepareTunnelTermTableEntry(table_entry, tunnel_info, p4info, insert_entry);
@@ -2229,29 +2233,31 @@ absl::Status ConfigTunnelTermTableEntry(ovsp4rt::OvsP4rtSession* session,
 #error "ASSERT: Unknown TARGET type!"
 #endif
 
-  return ovsp4rt::SendWriteRequest(session, write_request);
+  return ovsp4rt::SendWriteRequest(session, *write_request);
 }
 
 #if defined(ES2K_TARGET)
 
 absl::Status ConfigDstIpMacMapTableEntry(ovsp4rt::OvsP4rtSession* session,
                                          struct ip_mac_map_info& ip_info,
-                                         const ::p4::config::v1::P4Info& p4info,
+                                         const P4InfoResolver& p4info,
                                          bool insert_entry) {
-  ::p4::v1::WriteRequest write_request;
+  RequestArena arena;
+  auto* write_request = arena.Create<::p4::v1::WriteRequest>();
   ::p4::v1::TableEntry* table_entry;
   DiagDetail detail;
 
   if (insert_entry) {
-    table_entry = ovsp4rt::SetupTableEntryToInsert(session, &write_request);
+    table_entry = ovsp4rt::SetupTableEntryToInsert(session, write_request);
   } else {
-    table_entry = ovsp4rt::SetupTableEntryToDelete(session, &write_request);
+    table_entry = ovsp4rt::SetupTableEntryToDelete(session, write_request);
   }
 
   PrepareDstIpMacMapTableEntry(table_entry, ip_info, p4info, insert_entry,
                                detail);
 
-  auto status = ovsp4rt::SendWriteRequest(session, write_request);
+  auto status = ovsp4rt::SendWriteRequest(session, *write_request);
+  Stats::Instance().CountUpdate(detail.table_id, status.ok());
   if (!status.ok()) {
     LogFailure(insert_entry, detail.getLogTableName());
   }
@@ -2260,22 +2266,24 @@ absl::Status ConfigDstIpMacMapTableEntry(ovsp4rt::OvsP4rtSession* session,
 
 absl::Status ConfigSrcIpMacMapTableEntry(ovsp4rt::OvsP4rtSession* session,
                                          struct ip_mac_map_info& ip_info,
-                                         const ::p4::config::v1::P4Info& p4info,
+                                         const P4InfoResolver& p4info,
                                          bool insert_entry) {
-  ::p4::v1::WriteRequest write_request;
+  RequestArena arena;
+  auto* write_request = arena.Create<::p4::v1::WriteRequest>();
   ::p4::v1::TableEntry* table_entry;
   DiagDetail detail;
 
   if (insert_entry) {
-    table_entry = ovsp4rt::SetupTableEntryToInsert(session, &write_request);
+    table_entry = ovsp4rt::SetupTableEntryToInsert(session, write_request);
   } else {
-    table_entry = ovsp4rt::SetupTableEntryToDelete(session, &write_request);
+    table_entry = ovsp4rt::SetupTableEntryToDelete(session, write_request);
   }
 
   PrepareSrcIpMacMapTableEntry(table_entry, ip_info, p4info, insert_entry,
                                detail);
 
-  auto status = ovsp4rt::SendWriteRequest(session, write_request);
+  auto status = ovsp4rt::SendWriteRequest(session, *write_request);
+  Stats::Instance().CountUpdate(detail.table_id, status.ok());
   if (!status.ok()) {
     LogFailure(insert_entry, detail.getLogTableName());
   }
@@ -2284,45 +2292,18 @@ absl::Status ConfigSrcIpMacMapTableEntry(ovsp4rt::OvsP4rtSession* session,
 
 #endif  // ES2K_TARGET
 
-}  // namespace ovsp4rt
-
-//----------------------------------------------------------------------
-// ovsp4rt_str_to_tunnel_type (common)
-//----------------------------------------------------------------------
-enum ovs_tunnel_type ovsp4rt_str_to_tunnel_type(const char* tnl_type) {
-  if (tnl_type) {
-    if (strcmp(tnl_type, "vxlan") == 0) {
-      return OVS_TUNNEL_VXLAN;
-    } else if (strcmp(tnl_type, "geneve") == 0) {
-      return OVS_TUNNEL_GENEVE;
-    }
-  }
-  return OVS_TUNNEL_UNKNOWN;
-}
-
 #if defined(ES2K_TARGET)
 
 //----------------------------------------------------------------------
-// ovsp4rt_config_fdb_entry (ES2K)
+// ConfigFdbEntry (ES2K)
+//
+// Adds the updates for an FDB learn event to the write batch. Returns
+// an error if the event does not need or cannot have updates.
 //----------------------------------------------------------------------
-void ovsp4rt_config_fdb_entry(struct mac_learning_info learn_info,
-                              bool insert_entry, const char* grpc_addr) {
-  using namespace ovsp4rt;
-
-  // Start a new client session.
-  auto status_or_session = ovsp4rt::OvsP4rtSession::Create(
-      grpc_addr, GenerateClientCredentials(), absl::GetFlag(FLAGS_device_id),
-      absl::GetFlag(FLAGS_role_name));
-  if (!status_or_session.ok()) return;
-
-  // Unwrap the session from the StatusOr object.
-  std::unique_ptr<ovsp4rt::OvsP4rtSession> session =
-      std::move(status_or_session).value();
-  ::p4::config::v1::P4Info p4info;
-  ::absl::Status status =
-      ovsp4rt::GetForwardingPipelineConfig(session.get(), &p4info);
-  if (!status.ok()) return;
-
+absl::Status ConfigFdbEntry(OvsP4rtSession* session,
+                            const P4InfoResolver& p4info,
+                            struct mac_learning_info learn_info,
+                            bool insert_entry, FdbWriteBatch& batch) {
   /* Hack: When we delete an FDB entry based on current logic  we will not know
    * we will not know if it's a Tunnel learn FDB or regular VSI learn FDB.
    * This hack, during delete case check if entry is present in l2_to_tunnel_v4
@@ -2331,9 +2312,7 @@ void ovsp4rt_config_fdb_entry(struct mac_learning_info learn_info,
    */
 
   if (!insert_entry) {
-    auto status_or_read_response =
-        GetL2ToTunnelV4TableEntry(session.get(), learn_info, p4info);
-    if (status_or_read_response.ok()) {
+    if (HasL2ToTunnelV4TableEntry(session, learn_info, p4info)) {
       learn_info.is_tunnel = true;
     }
 
@@ -2341,9 +2320,7 @@ void ovsp4rt_config_fdb_entry(struct mac_learning_info learn_info,
      * entry as the entry can be either in V4 or V6 tunnel table.
      */
     if (!learn_info.is_tunnel) {
-      status_or_read_response =
-          GetL2ToTunnelV6TableEntry(session.get(), learn_info, p4info);
-      if (status_or_read_response.ok()) {
+      if (HasL2ToTunnelV6TableEntry(session, learn_info, p4info)) {
         learn_info.is_tunnel = true;
         learn_info.tnl_info.local_ip.family = AF_INET6;
         learn_info.tnl_info.remote_ip.family = AF_INET6;
@@ -2351,288 +2328,764 @@ void ovsp4rt_config_fdb_entry(struct mac_learning_info learn_info,
     }
   }
 
+  // During an audit epoch, every entry of the FDB entry is written, so
+  // that all of them are marked. The ones already present are replaced.
+  bool auditing = EpochAudit::Instance().IsActive(session->SessionId());
+
   if (learn_info.is_tunnel) {
-    if (insert_entry) {
-      auto status_or_read_response =
-          GetFdbTunnelTableEntry(session.get(), learn_info, p4info, true);
-      if (status_or_read_response.ok()) {
-        return;
+    if (insert_entry && !auditing) {
+      if (HasFdbTunnelTableEntry(session, learn_info, p4info, true)) {
+        return absl::AlreadyExistsError("FDB entry already exists");
       }
     }
 
-    status = ConfigFdbTunnelTableEntry(session.get(), learn_info, p4info,
-                                       insert_entry);
-    if (!status.ok()) {
-    }
-
-    status = ConfigL2TunnelTableEntry(session.get(), learn_info, p4info,
-                                      insert_entry);
-    if (!status.ok()) {
-    }
-
-    status = ConfigFdbSmacTableEntry(session.get(), learn_info, p4info,
-                                     insert_entry);
-    if (!status.ok()) {
-    }
+    ConfigFdbTunnelTableEntry(session, learn_info, p4info, insert_entry, batch);
+    ConfigL2TunnelTableEntry(session, learn_info, p4info, insert_entry, batch);
+    ConfigFdbSmacTableEntry(session, learn_info, p4info, insert_entry, batch);
   } else {
     if (insert_entry) {
-      auto status_or_read_response =
-          GetFdbVlanTableEntry(session.get(), learn_info, p4info, true);
-      if (status_or_read_response.ok()) {
-        return;
-      }
-
-      status = ConfigFdbRxVlanTableEntry(session.get(), learn_info, p4info,
-                                         insert_entry);
-      if (!status.ok()) {
+      if (!auditing &&
+          HasFdbVlanTableEntry(session, learn_info, p4info, true)) {
+        return absl::AlreadyExistsError("FDB entry already exists");
       }
 
-      status_or_read_response =
-          GetTxAccVsiTableEntry(session.get(), learn_info.src_port, p4info);
-      if (!status_or_read_response.ok()) {
-        return;
-      }
-
-      ::p4::v1::ReadResponse read_response =
-          std::move(status_or_read_response).value();
-      std::vector<::p4::v1::TableEntry> table_entries;
-
-      table_entries.reserve(read_response.entities().size());
-
-      int param_id =
-          GetParamId(p4info, TX_ACC_VSI_TABLE_ACTION_L2_FWD_AND_BYPASS_BRIDGE,
-                     ACTION_L2_FWD_AND_BYPASS_BRIDGE_PARAM_PORT);
-
-      uint32_t host_sp = 0;
-      for (const auto& entity : read_response.entities()) {
-        p4::v1::TableEntry table_entry_1 = entity.table_entry();
-        auto* table_action = table_entry_1.mutable_action();
-        auto* action = table_action->mutable_action();
-        for (const auto& param : action->params()) {
-          if (param_id == param.param_id()) {
-            const std::string& s1 = param.value();
-            std::string s2 = s1;
-            for (int param_bytes = 0; param_bytes < 4; param_bytes++) {
-              host_sp = host_sp << 8 | int(s2[param_bytes]);
-            }
-            break;
-          }
-        }
+      auto status_or_host_port =
+          GetHostPort(session, learn_info.src_port, p4info);
+      if (!status_or_host_port.ok()) {
+        return status_or_host_port.status();
       }
 
-      learn_info.src_port = host_sp;
-    }
+      // The RX entry uses the port the MAC was learned on, so prepare it
+      // before src_port is replaced by the host port.
+      ConfigFdbRxVlanTableEntry(session, learn_info, p4info, insert_entry,
+                                batch);
 
-    status = ConfigFdbTxVlanTableEntry(session.get(), learn_info, p4info,
-                                       insert_entry);
-    if (!status.ok()) {
+      learn_info.src_port = *status_or_host_port;
     }
 
-    status = ConfigFdbSmacTableEntry(session.get(), learn_info, p4info,
-                                     insert_entry);
-    if (!status.ok()) {
-    }
+    ConfigFdbTxVlanTableEntry(session, learn_info, p4info, insert_entry, batch);
+    ConfigFdbSmacTableEntry(session, learn_info, p4info, insert_entry, batch);
   }
+  return absl::OkStatus();
 }
 
+#elif defined(DPDK_TARGET)
+
 //----------------------------------------------------------------------
-// ovsp4rt_config_rx_tunnel_src_entry (ES2K)
+// ConfigFdbEntry (DPDK)
+//
+// Adds the updates for an FDB learn event to the write batch.
 //----------------------------------------------------------------------
-void ovsp4rt_config_rx_tunnel_src_entry(struct tunnel_info tunnel_info,
-                                        bool insert_entry,
-                                        const char* grpc_addr) {
-  using namespace ovsp4rt;
-
-  // Start a new client session.
-  auto status_or_session = ovsp4rt::OvsP4rtSession::Create(
-      grpc_addr, GenerateClientCredentials(), absl::GetFlag(FLAGS_device_id),
-      absl::GetFlag(FLAGS_role_name));
-  if (!status_or_session.ok()) return;
-
-  // Unwrap the session from the StatusOr object.
-  std::unique_ptr<OvsP4rtSession> session =
-      std::move(status_or_session).value();
-
-  // Fetch P4Info object from server.
-  ::p4::config::v1::P4Info p4info;
-  ::absl::Status status = GetForwardingPipelineConfig(session.get(), &p4info);
-  if (!status.ok()) return;
+absl::Status ConfigFdbEntry(OvsP4rtSession* session,
+                            const P4InfoResolver& p4info,
+                            const struct mac_learning_info& learn_info,
+                            bool insert_entry, FdbWriteBatch& batch) {
+  if (learn_info.is_tunnel) {
+    ConfigFdbTunnelTableEntry(session, learn_info, p4info, insert_entry, batch);
+  } else if (learn_info.is_vlan) {
+    ConfigFdbTxVlanTableEntry(session, learn_info, p4info, insert_entry, batch);
+    size_t tx_update = batch.write_request.updates_size() - 1;
+    ConfigFdbRxVlanTableEntry(session, learn_info, p4info, insert_entry, batch);
 
-  status = ConfigRxTunnelSrcPortTableEntry(session.get(), tunnel_info, p4info,
-                                           insert_entry);
-  if (!status.ok()) return;
+    // Do not leave the RX entry in place if the TX entry could not be
+    // inserted.
+    if (insert_entry) {
+      batch.AddDependency(tx_update);
+    }
+  }
+  return absl::OkStatus();
 }
 
+#else
+#error "ASSERT: Unknown TARGET type!"
+#endif
+
 //----------------------------------------------------------------------
-// ovsp4rt_config_tunnel_src_port_entry (ES2K)
+// ConfigFdbEntries (common)
 //----------------------------------------------------------------------
-void ovsp4rt_config_tunnel_src_port_entry(struct src_port_info tnl_sp,
-                                          bool insert_entry,
-                                          const char* grpc_addr) {
-  using namespace ovsp4rt;
-
-  ::p4::v1::WriteRequest write_request;
-  ::p4::v1::TableEntry* table_entry;
+void ConfigFdbEntries(const FdbLearnEvent* events, size_t num_events,
+                      const char* grpc_addr, absl::Status* event_status) {
+  auto set_all_status = [&](const absl::Status& status) {
+    if (event_status) {
+      std::fill(event_status, event_status + num_events, status);
+    }
+  };
 
-  // Start a new client session.
-  auto status_or_session = OvsP4rtSession::Create(
-      grpc_addr, GenerateClientCredentials(), absl::GetFlag(FLAGS_device_id),
+  // Get the shared client session.
+  auto status_or_session = SessionManager::Instance().GetSession(
+      grpc_addr, absl::GetFlag(FLAGS_device_id),
       absl::GetFlag(FLAGS_role_name));
-  if (!status_or_session.ok()) return;
+  if (!status_or_session.ok()) {
+    set_all_status(status_or_session.status());
+    return;
+  }
 
   // Unwrap the session from the StatusOr object.
-  std::unique_ptr<OvsP4rtSession> session =
+  std::shared_ptr<OvsP4rtSession> session =
       std::move(status_or_session).value();
 
-  // Fetch P4Info object from server.
-  ::p4::config::v1::P4Info p4info;
-  ::absl::Status status = GetForwardingPipelineConfig(session.get(), &p4info);
-  if (!status.ok()) return;
-
-  if (insert_entry) {
-    table_entry =
-        ovsp4rt::SetupTableEntryToInsert(session.get(), &write_request);
-  } else {
-    table_entry =
-        ovsp4rt::SetupTableEntryToDelete(session.get(), &write_request);
+  // Get the current P4Info snapshot.
+  auto status_or_snapshot = session->P4Info().GetSnapshot();
+  if (!status_or_snapshot.ok()) {
+    set_all_status(status_or_snapshot.status());
+    return;
   }
 
-  PrepareSrcPortTableEntry(table_entry, tnl_sp, p4info, insert_entry);
+  std::shared_ptr<const P4InfoSnapshot> snapshot =
+      std::move(status_or_snapshot).value();
+  const P4InfoResolver& p4info = snapshot->resolver();
 
-  status = ovsp4rt::SendWriteRequest(session.get(), write_request);
-  if (!status.ok()) return;
-}
+  set_all_status(absl::OkStatus());
 
-//----------------------------------------------------------------------
-// ovsp4rt_config_src_port_entry (ES2K)
-//----------------------------------------------------------------------
-void ovsp4rt_config_src_port_entry(struct src_port_info vsi_sp,
-                                   bool insert_entry, const char* grpc_addr) {
-  using namespace ovsp4rt;
+  const size_t max_bytes = absl::GetFlag(FLAGS_max_write_request_bytes);
+  FdbWriteBatch batch;
+  FdbRollbacks rollbacks;
 
-  // Start a new client session.
-  auto status_or_session = OvsP4rtSession::Create(
-      grpc_addr, GenerateClientCredentials(), absl::GetFlag(FLAGS_device_id),
-      absl::GetFlag(FLAGS_role_name));
-  if (!status_or_session.ok()) return;
+  // Other callers (e.g., the other writer shards) share the channel of
+  // the session. Wait only for our own writes.
+  AsyncWriteChannel::Group writes(session->AsyncWrites());
 
-  // Unwrap the session from the StatusOr object.
-  std::unique_ptr<OvsP4rtSession> session =
-      std::move(status_or_session).value();
+  // MAC addresses (qualified by bridge) with updates that may not
+  // have completed. ConfigFdbEntry() reads the tables to decide what
+  // to write, and the server may apply concurrent writes in any order,
+  // so a second event for the same MAC must wait until the first has
+  // completed.
+  absl::flat_hash_set<uint64_t> pending_macs;
 
-  // Fetch P4Info object from server.
-  ::p4::config::v1::P4Info p4info;
-  ::absl::Status status = GetForwardingPipelineConfig(session.get(), &p4info);
-  if (!status.ok()) return;
-
-  auto status_or_read_response =
-      GetTxAccVsiTableEntry(session.get(), vsi_sp.src_port, p4info);
-  if (!status_or_read_response.ok()) return;
-
-  ::p4::v1::ReadResponse read_response =
-      std::move(status_or_read_response).value();
-  std::vector<::p4::v1::TableEntry> table_entries;
-
-  table_entries.reserve(read_response.entities().size());
-
-  int param_id =
-      GetParamId(p4info, TX_ACC_VSI_TABLE_ACTION_L2_FWD_AND_BYPASS_BRIDGE,
-                 ACTION_L2_FWD_AND_BYPASS_BRIDGE_PARAM_PORT);
-
-  uint32_t host_sp = 0;
-  for (const auto& entity : read_response.entities()) {
-    p4::v1::TableEntry table_entry_1 = entity.table_entry();
-    auto* table_action = table_entry_1.mutable_action();
-    auto* action = table_action->mutable_action();
-    for (const auto& param : action->params()) {
-      if (param_id == param.param_id()) {
-        const std::string& s1 = param.value();
-        std::string s2 = s1;
-        for (int param_bytes = 0; param_bytes < 4; param_bytes++) {
-          host_sp = host_sp << 8 | int(s2[param_bytes]);
-        }
-        break;
-      }
+  for (size_t i = 0; i < num_events; i++) {
+    const auto& learn_info = events[i].learn_info;
+    uint64_t key = FdbKey(learn_info);
+    if (batch.byte_size >= max_bytes) {
+      StartFdbWriteBatch(writes, batch, event_status, &rollbacks);
+    }
+    if (!pending_macs.insert(key).second) {
+      // The event depends on updates that have not completed yet.
+      StartFdbWriteBatch(writes, batch, event_status, &rollbacks);
+      writes.Drain();
+      RollBackFdbUpdates(session.get(), writes, rollbacks);
+      pending_macs.clear();
+      pending_macs.insert(key);
+    }
+    batch.event = i;
+    auto status = ConfigFdbEntry(session.get(), p4info, learn_info,
+                                 events[i].insert_entry, batch);
+    if (event_status) {
+      event_status[i] = status;
     }
   }
 
-  vsi_sp.src_port = host_sp;
-
-  status = ConfigureVsiSrcPortTableEntry(session.get(), vsi_sp, p4info,
-                                         insert_entry);
-  if (!status.ok()) return;
+  StartFdbWriteBatch(writes, batch, event_status, &rollbacks);
+  writes.Drain();
+  RollBackFdbUpdates(session.get(), writes, rollbacks);
 }
 
 //----------------------------------------------------------------------
-// ovsp4rt_config_vlan_entry (ES2K)
+// Replays during an audit epoch (common)
+//
+// A tunnel or VLAN is programmed in several tables, and a failed entry
+// normally ends it. During an audit epoch, OVS replays the objects it
+// wants, so an INSERT that finds its entry already present (and marks
+// it) is in place, and the remaining entries must still be written, or
+// the sweep would delete them.
 //----------------------------------------------------------------------
-void ovsp4rt_config_vlan_entry(uint16_t vlan_id, bool insert_entry,
-                               const char* grpc_addr) {
-  using namespace ovsp4rt;
+bool IsReplaying(ovsp4rt::OvsP4rtSession* session, bool insert_entry) {
+  return insert_entry &&
+         EpochAudit::Instance().IsActive(session->SessionId());
+}
+
+bool EntryIsInPlace(const absl::Status& status, bool replaying) {
+  return status.ok() || (replaying && absl::IsAlreadyExists(status));
+}
 
-  // Start a new client session.
-  auto status_or_session = OvsP4rtSession::Create(
-      grpc_addr, GenerateClientCredentials(), absl::GetFlag(FLAGS_device_id),
+//----------------------------------------------------------------------
+// ConfigTunnelTables (common)
+//----------------------------------------------------------------------
+absl::Status ConfigTunnelTables(const struct tunnel_info& tunnel_info,
+                                bool insert_entry, const char* grpc_addr) {
+  // Get the shared client session.
+  auto status_or_session = SessionManager::Instance().GetSession(
+      grpc_addr, absl::GetFlag(FLAGS_device_id),
       absl::GetFlag(FLAGS_role_name));
-  if (!status_or_session.ok()) return;
+  if (!status_or_session.ok()) return status_or_session.status();
 
   // Unwrap the session from the StatusOr object.
-  std::unique_ptr<OvsP4rtSession> session =
+  std::shared_ptr<OvsP4rtSession> session =
       std::move(status_or_session).value();
 
-  // Fetch P4Info object from the server.
-  ::p4::config::v1::P4Info p4info;
-  ::absl::Status status = GetForwardingPipelineConfig(session.get(), &p4info);
-  if (!status.ok()) return;
+  // Get the current P4Info snapshot.
+  auto status_or_snapshot = session->P4Info().GetSnapshot();
+  if (!status_or_snapshot.ok()) return status_or_snapshot.status();
+
+  std::shared_ptr<const P4InfoSnapshot> snapshot =
+      std::move(status_or_snapshot).value();
+  const P4InfoResolver& p4info = snapshot->resolver();
+  bool replaying = IsReplaying(session.get(), insert_entry);
+  ::absl::Status status;
+
+  status =
+      ConfigEncapTableEntry(session.get(), tunnel_info, p4info, insert_entry);
+  if (!EntryIsInPlace(status, replaying)) return status;
+
+#if defined(ES2K_TARGET)
+  status =
+      ConfigDecapTableEntry(session.get(), tunnel_info, p4info, insert_entry);
+  if (!EntryIsInPlace(status, replaying)) return status;
+#endif
+
+  status = ConfigTunnelTermTableEntry(session.get(), tunnel_info, p4info,
+                                      insert_entry);
+  if (!EntryIsInPlace(status, replaying)) return status;
+
+  return absl::OkStatus();
+}
+
+
+//----------------------------------------------------------------------
+// ConfigTunnelEntry (common)
+//----------------------------------------------------------------------
+absl::Status ConfigTunnelEntry(const struct tunnel_info& tunnel_info,
+                               bool insert_entry, const char* grpc_addr) {
+  auto status = ConfigTunnelTables(tunnel_info, insert_entry, grpc_addr);
+
+  // Let the FDB entries that use the tunnel proceed.
+  DependencyScheduler::Instance().Record(grpc_addr,
+                                         TunnelPrerequisite(tunnel_info.vni),
+                                         insert_entry, status);
+  return status;
+}
+
+#if defined(ES2K_TARGET)
+
+//----------------------------------------------------------------------
+// ConfigVlanTables (ES2K)
+//----------------------------------------------------------------------
+absl::Status ConfigVlanTables(uint16_t vlan_id, bool insert_entry,
+                              const char* grpc_addr) {
+  // Get the shared client session.
+  auto status_or_session = SessionManager::Instance().GetSession(
+      grpc_addr, absl::GetFlag(FLAGS_device_id),
+      absl::GetFlag(FLAGS_role_name));
+  if (!status_or_session.ok()) return status_or_session.status();
+
+  // Unwrap the session from the StatusOr object.
+  std::shared_ptr<OvsP4rtSession> session =
+      std::move(status_or_session).value();
+
+  // Get the current P4Info snapshot.
+  auto status_or_snapshot = session->P4Info().GetSnapshot();
+  if (!status_or_snapshot.ok()) return status_or_snapshot.status();
+
+  std::shared_ptr<const P4InfoSnapshot> snapshot =
+      std::move(status_or_snapshot).value();
+  const P4InfoResolver& p4info = snapshot->resolver();
+  bool replaying = IsReplaying(session.get(), insert_entry);
+  ::absl::Status status;
 
   status =
       ConfigVlanPushTableEntry(session.get(), vlan_id, p4info, insert_entry);
-  if (!status.ok()) return;
+  if (!EntryIsInPlace(status, replaying)) return status;
 
   status =
       ConfigVlanPopTableEntry(session.get(), vlan_id, p4info, insert_entry);
-  if (!status.ok()) return;
+  if (!EntryIsInPlace(status, replaying)) return status;
+
+  return absl::OkStatus();
+}
+
+//----------------------------------------------------------------------
+// ConfigVlanEntry (ES2K)
+//----------------------------------------------------------------------
+absl::Status ConfigVlanEntry(uint16_t vlan_id, bool insert_entry,
+                             const char* grpc_addr) {
+  auto status = ConfigVlanTables(vlan_id, insert_entry, grpc_addr);
+
+  // Let the FDB entries that use the VLAN proceed.
+  DependencyScheduler::Instance().Record(grpc_addr, VlanPrerequisite(vlan_id),
+                                         insert_entry, status);
+  return status;
+}
+
+//----------------------------------------------------------------------
+// ConfigRxTunnelSrcEntry (ES2K)
+//----------------------------------------------------------------------
+absl::Status ConfigRxTunnelSrcEntry(const struct tunnel_info& tunnel_info,
+                                    bool insert_entry, const char* grpc_addr) {
+  // Get the shared client session.
+  auto status_or_session = SessionManager::Instance().GetSession(
+      grpc_addr, absl::GetFlag(FLAGS_device_id),
+      absl::GetFlag(FLAGS_role_name));
+  if (!status_or_session.ok()) return status_or_session.status();
+
+  // Unwrap the session from the StatusOr object.
+  std::shared_ptr<OvsP4rtSession> session =
+      std::move(status_or_session).value();
+
+  // Get the current P4Info snapshot.
+  auto status_or_snapshot = session->P4Info().GetSnapshot();
+  if (!status_or_snapshot.ok()) return status_or_snapshot.status();
+
+  std::shared_ptr<const P4InfoSnapshot> snapshot =
+      std::move(status_or_snapshot).value();
+  const P4InfoResolver& p4info = snapshot->resolver();
+
+  return ConfigRxTunnelSrcPortTableEntry(session.get(), tunnel_info, p4info,
+                                         insert_entry);
+}
+
+//----------------------------------------------------------------------
+// ConfigTunnelSrcPortEntry (ES2K)
+//----------------------------------------------------------------------
+absl::Status ConfigTunnelSrcPortEntry(const struct src_port_info& tnl_sp,
+                                      bool insert_entry,
+                                      const char* grpc_addr) {
+  RequestArena arena;
+  auto* write_request = arena.Create<::p4::v1::WriteRequest>();
+  ::p4::v1::TableEntry* table_entry;
+
+  // Get the shared client session.
+  auto status_or_session = SessionManager::Instance().GetSession(
+      grpc_addr, absl::GetFlag(FLAGS_device_id),
+      absl::GetFlag(FLAGS_role_name));
+  if (!status_or_session.ok()) return status_or_session.status();
+
+  // Unwrap the session from the StatusOr object.
+  std::shared_ptr<OvsP4rtSession> session =
+      std::move(status_or_session).value();
+
+  // Get the current P4Info snapshot.
+  auto status_or_snapshot = session->P4Info().GetSnapshot();
+  if (!status_or_snapshot.ok()) return status_or_snapshot.status();
+
+  std::shared_ptr<const P4InfoSnapshot> snapshot =
+      std::move(status_or_snapshot).value();
+  const P4InfoResolver& p4info = snapshot->resolver();
+
+  if (insert_entry) {
+    table_entry =
+        ovsp4rt::SetupTableEntryToInsert(session.get(), write_request);
+  } else {
+    table_entry =
+        ovsp4rt::SetupTableEntryToDelete(session.get(), write_request);
+  }
+
+  PrepareSrcPortTableEntry(table_entry, tnl_sp, p4info, insert_entry);
+
+  return ovsp4rt::SendWriteRequest(session.get(), *write_request);
+}
+
+//----------------------------------------------------------------------
+// ConfigSrcPortEntry (ES2K)
+//----------------------------------------------------------------------
+absl::Status ConfigSrcPortEntry(struct src_port_info vsi_sp, bool insert_entry,
+                                const char* grpc_addr) {
+  // Get the shared client session.
+  auto status_or_session = SessionManager::Instance().GetSession(
+      grpc_addr, absl::GetFlag(FLAGS_device_id),
+      absl::GetFlag(FLAGS_role_name));
+  if (!status_or_session.ok()) return status_or_session.status();
+
+  // Unwrap the session from the StatusOr object.
+  std::shared_ptr<OvsP4rtSession> session =
+      std::move(status_or_session).value();
+
+  // Get the current P4Info snapshot.
+  auto status_or_snapshot = session->P4Info().GetSnapshot();
+  if (!status_or_snapshot.ok()) return status_or_snapshot.status();
+
+  std::shared_ptr<const P4InfoSnapshot> snapshot =
+      std::move(status_or_snapshot).value();
+  const P4InfoResolver& p4info = snapshot->resolver();
+  ::absl::Status status;
+
+  uint32_t vsi = TxAccVsiKey(vsi_sp.src_port);
+
+  auto status_or_host_port =
+      GetHostPort(session.get(), vsi_sp.src_port, p4info);
+  if (!status_or_host_port.ok()) return status_or_host_port.status();
+
+  vsi_sp.src_port = *status_or_host_port;
+
+  status = ConfigureVsiSrcPortTableEntry(session.get(), vsi_sp, p4info,
+                                         insert_entry);
+  if (!status.ok()) return status;
+
+  // Forget the mapping when the port goes away, in case the VSI is
+  // reassigned.
+  if (!insert_entry) {
+    session->VsiPorts().Erase(vsi);
+  }
+  return status;
 }
 
+//----------------------------------------------------------------------
+// ConfigIpMacMapEntry (ES2K)
+//----------------------------------------------------------------------
+absl::Status ConfigIpMacMapEntry(struct ip_mac_map_info ip_info,
+                                 bool insert_entry, const char* grpc_addr) {
+  // Get the shared client session.
+  auto status_or_session = SessionManager::Instance().GetSession(
+      grpc_addr, absl::GetFlag(FLAGS_device_id),
+      absl::GetFlag(FLAGS_role_name));
+  if (!status_or_session.ok()) return status_or_session.status();
+
+  // Unwrap the session from the StatusOr object.
+  std::shared_ptr<OvsP4rtSession> session =
+      std::move(status_or_session).value();
+
+  // Get the current P4Info snapshot.
+  auto status_or_snapshot = session->P4Info().GetSnapshot();
+  if (!status_or_snapshot.ok()) return status_or_snapshot.status();
+
+  std::shared_ptr<const P4InfoSnapshot> snapshot =
+      std::move(status_or_snapshot).value();
+  const P4InfoResolver& p4info = snapshot->resolver();
+  ::absl::Status status;
+
+  if (insert_entry) {
+    if (HasVmSrcTableEntry(session.get(), ip_info, p4info)) {
+      goto try_dstip;
+    }
+  }
+
+  if (ValidIpAddr(ip_info.src_ip_addr.ip.v4addr.s_addr)) {
+    status = ConfigSrcIpMacMapTableEntry(session.get(), ip_info, p4info,
+                                         insert_entry);
+    if (!status.ok()) {
+    }
+  }
+
+try_dstip:
+  if (insert_entry) {
+    if (HasVmDstTableEntry(session.get(), ip_info, p4info)) {
+      return status;
+    }
+  }
+
+  if (ValidIpAddr(ip_info.src_ip_addr.ip.v4addr.s_addr)) {
+    auto dst_status = ConfigDstIpMacMapTableEntry(session.get(), ip_info,
+                                                  p4info, insert_entry);
+    status.Update(dst_status);
+  }
+  return status;
+}
+
+#endif  // ES2K_TARGET
+
+//----------------------------------------------------------------------
+// Audit after OVS restarts
+//
+// The tables the audit sweeps. The sidecar is assumed to be the only
+// client that writes them. They are swept in this order, so an entry is
+// deleted before the entries it refers to.
+//----------------------------------------------------------------------
+#if defined(ES2K_TARGET)
+const char* const kAuditedTables[] = {
+    // FDB entries.
+    L2_FWD_RX_TABLE,
+    L2_FWD_RX_WITH_TUNNEL_TABLE,
+    L2_FWD_TX_TABLE,
+    L2_TO_TUNNEL_V4_TABLE,
+    L2_TO_TUNNEL_V6_TABLE,
+    L2_FWD_SMAC_TABLE,
+    SRC_IP_MAC_MAP_TABLE,
+    DST_IP_MAC_MAP_TABLE,
+    // Port and tunnel termination entries.
+    RX_IPV4_TUNNEL_SOURCE_PORT_TABLE,
+    RX_IPV6_TUNNEL_SOURCE_PORT_TABLE,
+    SOURCE_PORT_TO_BRIDGE_MAP_TABLE,
+    IPV4_TUNNEL_TERM_TABLE,
+    IPV6_TUNNEL_TERM_TABLE,
+    // Encapsulation, decapsulation and VLAN entries.
+    VXLAN_ENCAP_MOD_TABLE,
+    VXLAN_ENCAP_VLAN_POP_MOD_TABLE,
+    VXLAN_ENCAP_V6_MOD_TABLE,
+    VXLAN_ENCAP_V6_VLAN_POP_MOD_TABLE,
+    GENEVE_ENCAP_MOD_TABLE,
+    GENEVE_ENCAP_VLAN_POP_MOD_TABLE,
+    GENEVE_ENCAP_V6_MOD_TABLE,
+    GENEVE_ENCAP_V6_VLAN_POP_MOD_TABLE,
+    VXLAN_DECAP_MOD_TABLE,
+    VXLAN_DECAP_AND_VLAN_PUSH_MOD_TABLE,
+    GENEVE_DECAP_MOD_TABLE,
+    GENEVE_DECAP_AND_VLAN_PUSH_MOD_TABLE,
+    VLAN_PUSH_MOD_TABLE,
+    VLAN_POP_MOD_TABLE,
+};
 #elif defined(DPDK_TARGET)
+const char* const kAuditedTables[] = {
+    L2_FWD_RX_TABLE,
+    L2_FWD_TX_TABLE,
+    IPV4_TUNNEL_TERM_TABLE,
+    VXLAN_ENCAP_MOD_TABLE,
+};
+#else
+#error "ASSERT: Unknown TARGET type!"
+#endif
+
+// Returns the IDs of the audited tables in the pipeline. Tables the
+// pipeline does not have are skipped.
+std::vector<uint32_t> AuditedTableIds(const P4InfoResolver& p4info) {
+  std::vector<uint32_t> table_ids;
+  for (const char* table_name : kAuditedTables) {
+    // The name is not a literal, so use the function form.
+    int table_id = (GetTableId)(p4info, table_name);
+    if (table_id != -1) {
+      table_ids.push_back(table_id);
+    }
+  }
+  return table_ids;
+}
+
+absl::Status BeginAuditEpoch(const char* grpc_addr) {
+  // Get the shared client session.
+  auto status_or_session = SessionManager::Instance().GetSession(
+      grpc_addr, absl::GetFlag(FLAGS_device_id),
+      absl::GetFlag(FLAGS_role_name));
+  if (!status_or_session.ok()) return status_or_session.status();
+
+  EpochAudit::Instance().Begin((*status_or_session)->SessionId());
+  return absl::OkStatus();
+}
+
+absl::StatusOr<uint64_t> EndAuditEpoch(const char* grpc_addr) {
+  // Get the shared client session.
+  auto status_or_session = SessionManager::Instance().GetSession(
+      grpc_addr, absl::GetFlag(FLAGS_device_id),
+      absl::GetFlag(FLAGS_role_name));
+  if (!status_or_session.ok()) return status_or_session.status();
+
+  // Unwrap the session from the StatusOr object.
+  std::shared_ptr<OvsP4rtSession> session =
+      std::move(status_or_session).value();
+
+  // Get the current P4Info snapshot.
+  auto status_or_snapshot = session->P4Info().GetSnapshot();
+  if (!status_or_snapshot.ok()) return status_or_snapshot.status();
+
+  return EpochAudit::Instance().End(
+      session.get(), AuditedTableIds((*status_or_snapshot)->resolver()));
+}
+
+absl::StatusOr<bool> HasProgrammedEntries(const char* grpc_addr) {
+  // Get the shared client session.
+  auto status_or_session = SessionManager::Instance().GetSession(
+      grpc_addr, absl::GetFlag(FLAGS_device_id),
+      absl::GetFlag(FLAGS_role_name));
+  if (!status_or_session.ok()) return status_or_session.status();
+
+  // Unwrap the session from the StatusOr object.
+  std::shared_ptr<OvsP4rtSession> session =
+      std::move(status_or_session).value();
+
+  // Get the current P4Info snapshot.
+  auto status_or_snapshot = session->P4Info().GetSnapshot();
+  if (!status_or_snapshot.ok()) return status_or_snapshot.status();
+
+  // Read all of the tables at once, and stop at the first entry.
+  ::p4::v1::ReadRequest read_request;
+  read_request.set_device_id(session->DeviceId());
+  for (uint32_t table_id :
+       AuditedTableIds((*status_or_snapshot)->resolver())) {
+    read_request.add_entities()->mutable_table_entry()->set_table_id(
+        table_id);
+  }
+  if (read_request.entities().empty()) {
+    return false;
+  }
+
+  bool found = false;
+  auto status = ReadEntities(session.get(), read_request,
+                             [&found](const ::p4::v1::Entity& entity) {
+                               found = true;
+                               return false;
+                             });
+  if (!status.ok()) return status;
+  return found;
+}
+
+}  // namespace ovsp4rt
+
+//----------------------------------------------------------------------
+// ovsp4rt_str_to_tunnel_type (common)
+//----------------------------------------------------------------------
+enum ovs_tunnel_type ovsp4rt_str_to_tunnel_type(const char* tnl_type) {
+  if (tnl_type) {
+    if (strcmp(tnl_type, "vxlan") == 0) {
+      return OVS_TUNNEL_VXLAN;
+    } else if (strcmp(tnl_type, "geneve") == 0) {
+      return OVS_TUNNEL_GENEVE;
+    }
+  }
+  return OVS_TUNNEL_UNKNOWN;
+}
 
 //----------------------------------------------------------------------
-// ovsp4rt_config_fdb_entry (DPDK)
+// ovsp4rt_config_fdb_entry (common)
 //----------------------------------------------------------------------
 void ovsp4rt_config_fdb_entry(struct mac_learning_info learn_info,
                               bool insert_entry, const char* grpc_addr) {
   using namespace ovsp4rt;
+  ScopedLatency latency(OVSP4RT_LATENCY_API);
+  ApiProbe probe("config_fdb_entry", insert_entry);
+  Journal journal;
+  journal.recordInput(__func__, learn_info, insert_entry);
 
-  // Start a new client session.
-  auto status_or_session = ovsp4rt::OvsP4rtSession::Create(
-      grpc_addr, GenerateClientCredentials(), absl::GetFlag(FLAGS_device_id),
-      absl::GetFlag(FLAGS_role_name));
-  if (!status_or_session.ok()) return;
+  RecordIntent(AsyncOp::CONFIG_FDB_ENTRY, learn_info, insert_entry, grpc_addr);
 
-  // Unwrap the session from the StatusOr object.
-  std::unique_ptr<ovsp4rt::OvsP4rtSession> session =
-      std::move(status_or_session).value();
+  // In asynchronous mode, queue the request for the writer thread.
+  if (ShardedWriter::Instance().Enqueue(AsyncOp::CONFIG_FDB_ENTRY, learn_info,
+                                        insert_entry, grpc_addr)) {
+    return;
+  }
 
-  // Fetch P4Info object from the server.
-  ::p4::config::v1::P4Info p4info;
-  ::absl::Status status =
-      ovsp4rt::GetForwardingPipelineConfig(session.get(), &p4info);
-  if (!status.ok()) return;
+  FdbLearnEvent event = {learn_info, insert_entry};
+  absl::Status status;
+  ConfigFdbEntries(&event, 1, grpc_addr, &status);
+  journal.recordStatus(status);
+}
 
-  if (learn_info.is_tunnel) {
-    status = ConfigFdbTunnelTableEntry(session.get(), learn_info, p4info,
-                                       insert_entry);
-  } else if (learn_info.is_vlan) {
-    status = ConfigFdbTxVlanTableEntry(session.get(), learn_info, p4info,
-                                       insert_entry);
-    if (!status.ok()) return;
+//----------------------------------------------------------------------
+// ovsp4rt_config_fdb_entries (common)
+//----------------------------------------------------------------------
+int ovsp4rt_config_fdb_entries(const struct mac_learning_info* learn_info,
+                               size_t num_entries, bool insert_entry,
+                               const char* grpc_addr, int* status) {
+  using namespace ovsp4rt;
+  ScopedLatency latency(OVSP4RT_LATENCY_API);
+  ApiProbe probe("config_fdb_entries", insert_entry);
+  Journal journal;
+  journal.recordInputs(__func__, learn_info, num_entries, insert_entry);
+
+  // Keep the entries in order with any requests already queued.
+  ShardedWriter::Instance().Flush();
+
+  std::vector<FdbLearnEvent> events;
+  events.reserve(num_entries);
+  for (size_t i = 0; i < num_entries; i++) {
+    RecordIntent(AsyncOp::CONFIG_FDB_ENTRY, learn_info[i], insert_entry,
+                 grpc_addr);
+    events.push_back({learn_info[i], insert_entry});
+  }
+
+  std::vector<absl::Status> event_status(num_entries);
+  ConfigFdbEntries(events.data(), events.size(), grpc_addr,
+                   event_status.data());
+
+  int num_failed = 0;
+  for (size_t i = 0; i < num_entries; i++) {
+    if (status) {
+      status[i] = static_cast<int>(event_status[i].code());
+    }
+    // An entry that is already in place is not a failure.
+    if (!event_status[i].ok() && !absl::IsAlreadyExists(event_status[i])) {
+      if (!num_failed) {
+        journal.recordStatus(event_status[i]);
+      }
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
 
-    status = ConfigFdbRxVlanTableEntry(session.get(), learn_info, p4info,
-                                       insert_entry);
-    if (!status.ok()) return;
+#if defined(ES2K_TARGET)
+
+//----------------------------------------------------------------------
+// ovsp4rt_config_rx_tunnel_src_entry (ES2K)
+//----------------------------------------------------------------------
+void ovsp4rt_config_rx_tunnel_src_entry(struct tunnel_info tunnel_info,
+                                        bool insert_entry,
+                                        const char* grpc_addr) {
+  using namespace ovsp4rt;
+  ScopedLatency latency(OVSP4RT_LATENCY_API);
+  ApiProbe probe("config_rx_tunnel_src_entry", insert_entry);
+  Journal journal;
+  journal.recordInput(__func__, tunnel_info, insert_entry);
+
+  RecordIntent(AsyncOp::CONFIG_RX_TUNNEL_SRC_ENTRY, tunnel_info, insert_entry,
+               grpc_addr);
+
+  // In asynchronous mode, queue the request for the writer thread.
+  if (ShardedWriter::Instance().Enqueue(AsyncOp::CONFIG_RX_TUNNEL_SRC_ENTRY,
+                                        tunnel_info, insert_entry, grpc_addr)) {
+    return;
   }
+
+  journal.recordStatus(
+      ConfigRxTunnelSrcEntry(tunnel_info, insert_entry, grpc_addr));
 }
 
+//----------------------------------------------------------------------
+// ovsp4rt_config_tunnel_src_port_entry (ES2K)
+//----------------------------------------------------------------------
+void ovsp4rt_config_tunnel_src_port_entry(struct src_port_info tnl_sp,
+                                          bool insert_entry,
+                                          const char* grpc_addr) {
+  using namespace ovsp4rt;
+  ScopedLatency latency(OVSP4RT_LATENCY_API);
+  ApiProbe probe("config_tunnel_src_port_entry", insert_entry);
+  Journal journal;
+  journal.recordInput(__func__, tnl_sp, insert_entry);
+
+  RecordIntent(AsyncOp::CONFIG_TUNNEL_SRC_PORT_ENTRY, tnl_sp, insert_entry,
+               grpc_addr);
+
+  // In asynchronous mode, queue the request for the writer thread.
+  if (ShardedWriter::Instance().Enqueue(AsyncOp::CONFIG_TUNNEL_SRC_PORT_ENTRY,
+                                        tnl_sp, insert_entry, grpc_addr)) {
+    return;
+  }
+
+  journal.recordStatus(
+      ConfigTunnelSrcPortEntry(tnl_sp, insert_entry, grpc_addr));
+}
+
+//----------------------------------------------------------------------
+// ovsp4rt_config_src_port_entry (ES2K)
+//----------------------------------------------------------------------
+void ovsp4rt_config_src_port_entry(struct src_port_info vsi_sp,
+                                   bool insert_entry, const char* grpc_addr) {
+  using namespace ovsp4rt;
+  ScopedLatency latency(OVSP4RT_LATENCY_API);
+  ApiProbe probe("config_src_port_entry", insert_entry);
+  Journal journal;
+  journal.recordInput(__func__, vsi_sp, insert_entry);
+
+  RecordIntent(AsyncOp::CONFIG_SRC_PORT_ENTRY, vsi_sp, insert_entry,
+               grpc_addr);
+
+  // In asynchronous mode, queue the request for the writer thread.
+  if (ShardedWriter::Instance().Enqueue(AsyncOp::CONFIG_SRC_PORT_ENTRY, vsi_sp,
+                                        insert_entry, grpc_addr)) {
+    return;
+  }
+
+  journal.recordStatus(ConfigSrcPortEntry(vsi_sp, insert_entry, grpc_addr));
+}
+
+//----------------------------------------------------------------------
+// ovsp4rt_config_vlan_entry (ES2K)
+//----------------------------------------------------------------------
+void ovsp4rt_config_vlan_entry(uint16_t vlan_id, bool insert_entry,
+                               const char* grpc_addr) {
+  using namespace ovsp4rt;
+  ScopedLatency latency(OVSP4RT_LATENCY_API);
+  ApiProbe probe("config_vlan_entry", insert_entry);
+  Journal journal;
+  journal.recordInput(__func__, vlan_id, insert_entry);
+
+  RecordIntent(AsyncOp::CONFIG_VLAN_ENTRY, vlan_id, insert_entry, grpc_addr);
+
+  // In asynchronous mode, queue the request for the writer thread.
+  if (ShardedWriter::Instance().Enqueue(AsyncOp::CONFIG_VLAN_ENTRY, vlan_id,
+                                        insert_entry, grpc_addr)) {
+    return;
+  }
+
+  journal.recordStatus(ConfigVlanEntry(vlan_id, insert_entry, grpc_addr));
+}
+
+#elif defined(DPDK_TARGET)
+
 //----------------------------------------------------------------------
 // Unimplemented functions (DPDK)
 //----------------------------------------------------------------------
@@ -2664,35 +3117,21 @@ void ovsp4rt_config_ip_mac_map_entry(struct ip_mac_map_info ip_info,
 void ovsp4rt_config_tunnel_entry(struct tunnel_info tunnel_info,
                                  bool insert_entry, const char* grpc_addr) {
   using namespace ovsp4rt;
+  ScopedLatency latency(OVSP4RT_LATENCY_API);
+  ApiProbe probe("config_tunnel_entry", insert_entry);
+  Journal journal;
+  journal.recordInput(__func__, tunnel_info, insert_entry);
 
-  // Start a new client session.
-  auto status_or_session = OvsP4rtSession::Create(
-      grpc_addr, GenerateClientCredentials(), absl::GetFlag(FLAGS_device_id),
-      absl::GetFlag(FLAGS_role_name));
-  if (!status_or_session.ok()) return;
+  RecordIntent(AsyncOp::CONFIG_TUNNEL_ENTRY, tunnel_info, insert_entry,
+               grpc_addr);
 
-  // Unwrap the session from the StatusOr object.
-  std::unique_ptr<OvsP4rtSession> session =
-      std::move(status_or_session).value();
-
-  // Fetch P4Info object from the server.
-  ::p4::config::v1::P4Info p4info;
-  ::absl::Status status = GetForwardingPipelineConfig(session.get(), &p4info);
-  if (!status.ok()) return;
-
-  status =
-      ConfigEncapTableEntry(session.get(), tunnel_info, p4info, insert_entry);
-  if (!status.ok()) return;
-
-#if defined(ES2K_TARGET)
-  status =
-      ConfigDecapTableEntry(session.get(), tunnel_info, p4info, insert_entry);
-  if (!status.ok()) return;
-#endif
+  // In asynchronous mode, queue the request for the writer thread.
+  if (ShardedWriter::Instance().Enqueue(AsyncOp::CONFIG_TUNNEL_ENTRY,
+                                        tunnel_info, insert_entry, grpc_addr)) {
+    return;
+  }
 
-  status = ConfigTunnelTermTableEntry(session.get(), tunnel_info, p4info,
-                                      insert_entry);
-  if (!status.ok()) return;
+  journal.recordStatus(ConfigTunnelEntry(tunnel_info, insert_entry, grpc_addr));
 }
 
 #if defined(ES2K_TARGET)
@@ -2702,52 +3141,179 @@ void ovsp4rt_config_tunnel_entry(struct tunnel_info tunnel_info,
 void ovsp4rt_config_ip_mac_map_entry(struct ip_mac_map_info ip_info,
                                      bool insert_entry, const char* grpc_addr) {
   using namespace ovsp4rt;
+  ScopedLatency latency(OVSP4RT_LATENCY_API);
+  ApiProbe probe("config_ip_mac_map_entry", insert_entry);
+  Journal journal;
+  journal.recordInput(__func__, ip_info, insert_entry);
 
-  // Start a new client session.
-  auto status_or_session = ovsp4rt::OvsP4rtSession::Create(
-      grpc_addr, GenerateClientCredentials(), absl::GetFlag(FLAGS_device_id),
-      absl::GetFlag(FLAGS_role_name));
-  if (!status_or_session.ok()) return;
+  RecordIntent(AsyncOp::CONFIG_IP_MAC_MAP_ENTRY, ip_info, insert_entry,
+               grpc_addr);
 
-  // Unwrap the session from the StatusOr object.
-  std::unique_ptr<ovsp4rt::OvsP4rtSession> session =
-      std::move(status_or_session).value();
+  // In asynchronous mode, queue the request for the writer thread.
+  if (ShardedWriter::Instance().Enqueue(AsyncOp::CONFIG_IP_MAC_MAP_ENTRY,
+                                        ip_info, insert_entry, grpc_addr)) {
+    return;
+  }
 
-  // Fetch P4Info object from the server.
-  ::p4::config::v1::P4Info p4info;
-  ::absl::Status status =
-      ovsp4rt::GetForwardingPipelineConfig(session.get(), &p4info);
-  if (!status.ok()) return;
+  journal.recordStatus(ConfigIpMacMapEntry(ip_info, insert_entry, grpc_addr));
+}
+#endif  // ES2K_TARGET
 
-  if (insert_entry) {
-    auto status_or_read_response =
-        GetVmSrcTableEntry(session.get(), ip_info, p4info);
-    if (status_or_read_response.ok()) {
-      goto try_dstip;
-    }
+//----------------------------------------------------------------------
+// Asynchronous mode (common)
+//----------------------------------------------------------------------
+void ovsp4rt_async_enable(uint32_t queue_limit) {
+  ovsp4rt::ShardedWriter::Instance().Enable(queue_limit);
+}
+
+void ovsp4rt_async_disable(void) {
+  ovsp4rt::ShardedWriter::Instance().Disable();
+}
+
+void ovsp4rt_async_flush(void) { ovsp4rt::ShardedWriter::Instance().Flush(); }
+
+void ovsp4rt_async_get_stats(struct ovsp4rt_async_stats* stats) {
+  ovsp4rt::ShardedWriter::Instance().GetStats(stats);
+}
+
+uint32_t ovsp4rt_async_num_shards(void) {
+  return ovsp4rt::ShardedWriter::Instance().num_shards();
+}
+
+bool ovsp4rt_async_get_shard_stats(uint32_t shard,
+                                   struct ovsp4rt_async_stats* stats) {
+  return ovsp4rt::ShardedWriter::Instance().GetShardStats(shard, stats);
+}
+
+//----------------------------------------------------------------------
+// Resynchronization (common)
+//----------------------------------------------------------------------
+void ovsp4rt_resync_get_stats(struct ovsp4rt_resync_stats* stats) {
+  ovsp4rt::Resyncer::Instance().GetStats(stats);
+}
+
+//----------------------------------------------------------------------
+// Audit after OVS restarts (common)
+//----------------------------------------------------------------------
+int ovsp4rt_audit_begin_epoch(const char* grpc_addr) {
+  using namespace ovsp4rt;
+
+  // Requests queued before the epoch belong to the state OVS is
+  // replacing.
+  ShardedWriter::Instance().Flush();
+
+  return static_cast<int>(BeginAuditEpoch(grpc_addr).code());
+}
+
+int ovsp4rt_audit_end_epoch(const char* grpc_addr, uint64_t* num_deleted) {
+  using namespace ovsp4rt;
+
+  // Entries still queued are wanted, so they must be marked first.
+  ShardedWriter::Instance().Flush();
+
+  auto status_or_deleted = EndAuditEpoch(grpc_addr);
+  if (num_deleted) {
+    *num_deleted = status_or_deleted.ok() ? *status_or_deleted : 0;
   }
+  return static_cast<int>(status_or_deleted.status().code());
+}
 
-  if (ValidIpAddr(ip_info.src_ip_addr.ip.v4addr.s_addr)) {
-    status = ConfigSrcIpMacMapTableEntry(session.get(), ip_info, p4info,
-                                         insert_entry);
-    if (!status.ok()) {
-    }
+//----------------------------------------------------------------------
+// ovsp4rt_fdb_aging_enable
+//----------------------------------------------------------------------
+void ovsp4rt_fdb_aging_enable(uint32_t idle_timeout_ms,
+                              ovsp4rt_fdb_aged_cb callback, void* aux) {
+  using namespace ovsp4rt;
+
+  if (!idle_timeout_ms || !callback) {
+    FdbAging::Instance().Disable();
+    return;
   }
 
-try_dstip:
-  if (insert_entry) {
-    auto status_or_read_response =
-        GetVmDstTableEntry(session.get(), ip_info, p4info);
-    if (status_or_read_response.ok()) {
-      return;
+  auto decoder = [](OvsP4rtSession* session,
+                    const p4::v1::TableEntry& table_entry,
+                    struct ovsp4rt_aged_mac* aged_mac) {
+    auto status_or_snapshot = session->P4Info().GetSnapshot();
+    if (!status_or_snapshot.ok()) {
+      return false;
     }
+    return DecodeFdbAgingTableEntry(
+        table_entry, (*status_or_snapshot)->resolver(), aged_mac);
+  };
+
+  FdbAging::Instance().Enable(
+      absl::Milliseconds(idle_timeout_ms), decoder,
+      [callback, aux](const struct ovsp4rt_aged_mac* macs, size_t num_macs) {
+        callback(macs, num_macs, aux);
+      });
+}
+
+//----------------------------------------------------------------------
+// ovsp4rt_fdb_aging_disable
+//----------------------------------------------------------------------
+void ovsp4rt_fdb_aging_disable(void) {
+  ovsp4rt::FdbAging::Instance().Disable();
+}
+
+//----------------------------------------------------------------------
+// ovsp4rt_fdb_aging_supported
+//----------------------------------------------------------------------
+bool ovsp4rt_fdb_aging_supported(const char* grpc_addr) {
+  using namespace ovsp4rt;
+
+  auto status_or_session = SessionManager::Instance().GetSession(
+      grpc_addr, absl::GetFlag(FLAGS_device_id),
+      absl::GetFlag(FLAGS_role_name));
+  if (!status_or_session.ok()) {
+    return false;
   }
 
-  if (ValidIpAddr(ip_info.src_ip_addr.ip.v4addr.s_addr)) {
-    status = ConfigDstIpMacMapTableEntry(session.get(), ip_info, p4info,
-                                         insert_entry);
-    if (!status.ok()) {
-    }
+  auto status_or_snapshot = (*status_or_session)->P4Info().GetSnapshot();
+  if (!status_or_snapshot.ok()) {
+    return false;
   }
+
+  return (*status_or_snapshot)
+      ->resolver()
+      .SupportsIdleTimeout(kFdbAgingTable.table());
+}
+
+//----------------------------------------------------------------------
+// ovsp4rt_get_stats
+//----------------------------------------------------------------------
+void ovsp4rt_get_stats(struct ovsp4rt_stats* stats) {
+  ovsp4rt::Stats::Instance().GetStats(stats);
+}
+
+//----------------------------------------------------------------------
+// ovsp4rt_stats_latency_name
+//----------------------------------------------------------------------
+const char* ovsp4rt_stats_latency_name(enum ovsp4rt_latency_type type) {
+  switch (type) {
+    case OVSP4RT_LATENCY_SESSION_CREATE:
+      return "session_create";
+    case OVSP4RT_LATENCY_PIPELINE_FETCH:
+      return "pipeline_fetch";
+    case OVSP4RT_LATENCY_READ_RPC:
+      return "read_rpc";
+    case OVSP4RT_LATENCY_WRITE_RPC:
+      return "write_rpc";
+    case OVSP4RT_LATENCY_API:
+      return "api";
+    default:
+      return nullptr;
+  }
+}
+
+//----------------------------------------------------------------------
+// ovsp4rt_stats_table_name
+//----------------------------------------------------------------------
+const char* ovsp4rt_stats_table_name(uint32_t table) {
+  using namespace ovsp4rt;
+
+  if (table >= LOG_NUM_TABLES) {
+    return nullptr;
+  }
+  DiagDetail detail(static_cast<LogTableId>(table));
+  return detail.getLogTableName();
 }
-#endif  // ES2K_TARGET
@@ -0,0 +1,138 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Fixed-width encoders for match field and action parameter values.
+//
+// Each encoder returns its value in a ByteValue, a fixed-size byte
+// array that lives on the stack, or writes it into a buffer supplied
+// by the caller. Neither form allocates memory. A ByteValue converts
+// to absl::string_view, and to std::string so that it can be passed
+// directly to the set_value() method of a protobuf message.
+//
+// Values are big-endian and occupy (bits + 7) / 8 bytes, as P4Runtime
+// requires. Bits above the width of the field are discarded.
+
+#ifndef OVSP4RT_FIELD_ENCODING_H_
+#define OVSP4RT_FIELD_ENCODING_H_
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include "absl/strings/string_view.h"
+
+namespace ovsp4rt {
+
+// Number of bytes in the encoding of a bit<BITS> value.
+template <int BITS>
+constexpr size_t EncodedSize() {
+  static_assert(BITS > 0, "field width must be positive");
+  return (BITS + 7) / 8;
+}
+
+template <size_t N>
+class ByteValue {
+ public:
+  constexpr ByteValue() = default;
+
+  constexpr char* data() { return bytes_; }
+  constexpr const char* data() const { return bytes_; }
+  static constexpr size_t size() { return N; }
+
+  constexpr uint8_t operator[](size_t i) const {
+    return static_cast<uint8_t>(bytes_[i]);
+  }
+
+  operator absl::string_view() const { return absl::string_view(bytes_, N); }
+  operator std::string() const { return str(); }
+
+  std::string str() const { return std::string(bytes_, N); }
+
+ private:
+  char bytes_[N] = {};
+};
+
+// Writes the low BITS bits of value to out, big-endian. Returns the
+// position after the last byte written.
+template <int BITS>
+constexpr char* EncodeBitsTo(uint64_t value, char* out) {
+  static_assert(BITS <= 64, "use EncodeBytes for fields wider than 64 bits");
+  constexpr size_t n = EncodedSize<BITS>();
+  if constexpr (BITS < 64) {
+    value &= (uint64_t{1} << BITS) - 1;
+  }
+  for (size_t i = n; i-- > 0;) {
+    out[i] = static_cast<char>(value & 0xff);
+    value >>= 8;
+  }
+  return out + n;
+}
+
+// Encodes the low BITS bits of value, e.g. EncodeBits<12>(vlan_id).
+template <int BITS>
+constexpr ByteValue<EncodedSize<BITS>()> EncodeBits(uint64_t value) {
+  ByteValue<EncodedSize<BITS>()> encoded;
+  EncodeBitsTo<BITS>(value, encoded.data());
+  return encoded;
+}
+
+// Encodes N bytes that are already in network order, such as a MAC or
+// IPv6 address.
+template <size_t N>
+constexpr ByteValue<N> EncodeBytes(const uint8_t* bytes) {
+  ByteValue<N> encoded;
+  for (size_t i = 0; i < N; i++) {
+    encoded.data()[i] = static_cast<char>(bytes[i]);
+  }
+  return encoded;
+}
+
+//----------------------------------------------------------------------
+// Field encoders
+//----------------------------------------------------------------------
+
+// Encodes a 48-bit MAC address.
+constexpr ByteValue<6> CanonicalizeMac(const uint8_t mac[6]) {
+  return EncodeBytes<6>(mac);
+}
+
+// Encodes an IPv4 address stored in network order.
+constexpr ByteValue<4> CanonicalizeIp(uint32_t ipv4addr) {
+  // note: low-to-high byte order
+  ByteValue<4> encoded;
+  for (size_t i = 0; i < 4; i++) {
+    encoded.data()[i] = static_cast<char>((ipv4addr >> (8 * i)) & 0xff);
+  }
+  return encoded;
+}
+
+// Encodes a 128-bit IPv6 address.
+inline ByteValue<16> CanonicalizeIpv6(const struct in6_addr& ipv6addr) {
+  return EncodeBytes<16>(ipv6addr.s6_addr);
+}
+
+// Encodes tunnel_info.vni as a "tunnel_id" action parameter,
+// which is bit<20> in all cases except set_ipsec_tunnel.
+constexpr ByteValue<3> EncodeTunnelId(uint32_t vni) {
+  return EncodeBits<20>(vni);
+}
+
+// Encodes tunnel_info.vni as a "vni" or "mod_blob_ptr" match
+// field or action parameter, which are bit<24> in all cases.
+constexpr ByteValue<3> EncodeVniValue(uint32_t vni) {
+  return EncodeBits<24>(vni);
+}
+
+// Encodes the tunnel src_port action parameter as (dst_port * 2), to
+// work around a bug in the Linux Networking P4 program. dst_port is
+// in host byte order.
+inline ByteValue<2> EncodeHostPortValue(uint16_t dst_port) {
+  return EncodeBits<16>(htons(dst_port) * 2);
+}
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_FIELD_ENCODING_H_
@@ -4,54 +4,117 @@
 #ifndef OVSP4RT_PRIVATE_H_
 #define OVSP4RT_PRIVATE_H_
 
-#include <stdarg.h>
 #include <stdbool.h>
 
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "logging/ovsp4rt_diag_detail.h"
 #include "ovsp4rt/ovs-p4rt.h"
 #include "p4/config/v1/p4info.pb.h"
 #include "p4/v1/p4runtime.pb.h"
+#include "session/ovsp4rt_p4info_resolver.h"
 
 namespace ovsp4rt {
 
 //----------------------------------------------------------------------
-// Utility functions
+// FDB learn events
 //----------------------------------------------------------------------
 
-extern std::string EncodeByteValue(int arg_count...);
+struct FdbLearnEvent {
+  struct mac_learning_info learn_info;
+  bool insert_entry;
+};
+
+// Returns a key that identifies the FDB entry for a learn event: the
+// bridge ID and MAC address, packed into 56 bits.
+inline uint64_t FdbKey(const struct mac_learning_info& learn_info) {
+  uint64_t key = learn_info.bridge_id;
+  for (int i = 0; i < 6; i++) {
+    key = key << 8 | learn_info.mac_addr[i];
+  }
+  return key;
+}
+
+// Returns true if the switch holds an entry in any of the tables the
+// sidecar programs. The resyncer uses it to tell a reconnect to a
+// switch that kept its state from one that lost it.
+extern absl::StatusOr<bool> HasProgrammedEntries(const char* grpc_addr);
+
+// Programs the FDB entries for a series of learn events. The updates
+// are sent in as few WriteRequests as possible. If event_status is not
+// null, it receives the status of each event.
+extern void ConfigFdbEntries(const FdbLearnEvent* events, size_t num_events,
+                             const char* grpc_addr,
+                             absl::Status* event_status = nullptr);
+
+//----------------------------------------------------------------------
+// Configuration functions
+//
+// Program the entries for an API request and return the status. The
+// API functions, the asynchronous writer and the resynchronization
+// after a reconnect all use them.
+//----------------------------------------------------------------------
+
+extern absl::Status ConfigTunnelEntry(const struct tunnel_info& tunnel_info,
+                                      bool insert_entry, const char* grpc_addr);
+
+#if defined(ES2K_TARGET)
+
+extern absl::Status ConfigIpMacMapEntry(struct ip_mac_map_info ip_info,
+                                        bool insert_entry,
+                                        const char* grpc_addr);
+
+extern absl::Status ConfigRxTunnelSrcEntry(
+    const struct tunnel_info& tunnel_info, bool insert_entry,
+    const char* grpc_addr);
+
+extern absl::Status ConfigSrcPortEntry(struct src_port_info vsi_sp,
+                                       bool insert_entry,
+                                       const char* grpc_addr);
+
+extern absl::Status ConfigTunnelSrcPortEntry(const struct src_port_info& tnl_sp,
+                                             bool insert_entry,
+                                             const char* grpc_addr);
+
+extern absl::Status ConfigVlanEntry(uint16_t vlan_id, bool insert_entry,
+                                    const char* grpc_addr);
+
+#endif  // ES2K_TARGET
 
 //----------------------------------------------------------------------
 // Common functions
 //----------------------------------------------------------------------
 
+// Returns the bridge and MAC address of an entry in the table the
+// target ages FDB entries in, or false if the entry cannot be decoded.
+extern bool DecodeFdbAgingTableEntry(const p4::v1::TableEntry& table_entry,
+                                     const P4InfoResolver& p4info,
+                                     struct ovsp4rt_aged_mac* aged_mac);
+
 extern void PrepareFdbRxVlanTableEntry(
     p4::v1::TableEntry* table_entry, const struct mac_learning_info& learn_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry,
-    DiagDetail& detail);
+    const P4InfoResolver& p4info, bool insert_entry, DiagDetail& detail);
 
 extern void PrepareFdbTableEntryforV4GeneveTunnel(
     p4::v1::TableEntry* table_entry, const struct mac_learning_info& learn_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry,
-    DiagDetail& detail);
+    const P4InfoResolver& p4info, bool insert_entry, DiagDetail& detail);
 
 extern void PrepareFdbTableEntryforV4VxlanTunnel(
     p4::v1::TableEntry* table_entry, const struct mac_learning_info& learn_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry,
-    DiagDetail& detail);
+    const P4InfoResolver& p4info, bool insert_entry, DiagDetail& detail);
 
 extern void PrepareFdbTxVlanTableEntry(
     p4::v1::TableEntry* table_entry, const struct mac_learning_info& learn_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry,
-    DiagDetail& detail);
+    const P4InfoResolver& p4info, bool insert_entry, DiagDetail& detail);
 
 extern void PrepareVxlanEncapTableEntry(p4::v1::TableEntry* table_entry,
                                         const struct tunnel_info& tunnel_info,
-                                        const ::p4::config::v1::P4Info& p4info,
+                                        const P4InfoResolver& p4info,
                                         bool insert_entry);
 
 extern void PrepareTunnelTermTableEntry(p4::v1::TableEntry* table_entry,
                                         const struct tunnel_info& tunnel_info,
-                                        const ::p4::config::v1::P4Info& p4info,
+                                        const P4InfoResolver& p4info,
                                         bool insert_entry);
 
 //----------------------------------------------------------------------
@@ -62,106 +125,116 @@ extern void PrepareTunnelTermTableEntry(p4::v1::TableEntry* table_entry,
 
 extern void PrepareDstIpMacMapTableEntry(p4::v1::TableEntry* table_entry,
                                          struct ip_mac_map_info& ip_info,
-                                         const ::p4::config::v1::P4Info& p4info,
+                                         const P4InfoResolver& p4info,
                                          bool insert_entry, DiagDetail& detail);
 
 extern void PrepareFdbSmacTableEntry(p4::v1::TableEntry* table_entry,
                                      const struct mac_learning_info& learn_info,
-                                     const ::p4::config::v1::P4Info& p4info,
+                                     const P4InfoResolver& p4info,
                                      bool insert_entry, DiagDetail& detail);
 
 extern void PrepareSrcIpMacMapTableEntry(p4::v1::TableEntry* table_entry,
                                          struct ip_mac_map_info& ip_info,
-                                         const ::p4::config::v1::P4Info& p4info,
+                                         const P4InfoResolver& p4info,
                                          bool insert_entry, DiagDetail& detail);
 
 extern void PrepareL2ToTunnelV4(p4::v1::TableEntry* table_entry,
                                 const struct mac_learning_info& learn_info,
-                                const ::p4::config::v1::P4Info& p4info,
-                                bool insert_entry, DiagDetail& detail);
+                                const P4InfoResolver& p4info, bool insert_entry,
+                                DiagDetail& detail);
 
 extern void PrepareL2ToTunnelV6(p4::v1::TableEntry* table_entry,
                                 const struct mac_learning_info& learn_info,
-                                const ::p4::config::v1::P4Info& p4info,
-                                bool insert_entry, DiagDetail& detail);
+                                const P4InfoResolver& p4info, bool insert_entry,
+                                DiagDetail& detail);
 
 extern void PrepareGeneveDecapModTableEntry(
     p4::v1::TableEntry* table_entry, const struct tunnel_info& tunnel_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry);
+    const P4InfoResolver& p4info, bool insert_entry);
 
 extern void PrepareGeneveDecapModAndVlanPushTableEntry(
     p4::v1::TableEntry* table_entry, const struct tunnel_info& tunnel_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry);
+    const P4InfoResolver& p4info, bool insert_entry);
 
 extern void PrepareGeneveEncapTableEntry(p4::v1::TableEntry* table_entry,
                                          const struct tunnel_info& tunnel_info,
-                                         const ::p4::config::v1::P4Info& p4info,
+                                         const P4InfoResolver& p4info,
                                          bool insert_entry);
 
 extern void PrepareGeneveEncapAndVlanPopTableEntry(
     p4::v1::TableEntry* table_entry, const struct tunnel_info& tunnel_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry);
+    const P4InfoResolver& p4info, bool insert_entry);
 
 extern void PrepareV6GeneveEncapAndVlanPopTableEntry(
     p4::v1::TableEntry* table_entry, const struct tunnel_info& tunnel_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry);
+    const P4InfoResolver& p4info, bool insert_entry);
 
 extern void PrepareV6GeneveEncapTableEntry(
     p4::v1::TableEntry* table_entry, const struct tunnel_info& tunnel_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry);
+    const P4InfoResolver& p4info, bool insert_entry);
 
 extern void PrepareRxTunnelTableEntry(p4::v1::TableEntry* table_entry,
                                       const struct tunnel_info& tunnel_info,
-                                      const ::p4::config::v1::P4Info& p4info,
+                                      const P4InfoResolver& p4info,
                                       bool insert_entry);
 
 extern void PrepareV6RxTunnelTableEntry(p4::v1::TableEntry* table_entry,
                                         const struct tunnel_info& tunnel_info,
-                                        const ::p4::config::v1::P4Info& p4info,
+                                        const P4InfoResolver& p4info,
                                         bool insert_entry);
 
 extern void PrepareSrcPortTableEntry(p4::v1::TableEntry* table_entry,
                                      const struct src_port_info& sp,
-                                     const ::p4::config::v1::P4Info& p4info,
+                                     const P4InfoResolver& p4info,
                                      bool insert_entry);
 
 extern void PrepareTxAccVsiTableEntry(p4::v1::TableEntry* table_entry,
                                       uint32_t sp,
-                                      const ::p4::config::v1::P4Info& p4info);
+                                      const P4InfoResolver& p4info);
 
-extern void PrepareV6TunnelTermTableEntry(
-    p4::v1::TableEntry* table_entry, const struct tunnel_info& tunnel_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry);
+extern uint32_t TxAccVsiKey(uint32_t sp);
+
+// Returns the VSI and host port of a tx_acc_vsi entry read from the
+// switch, or false if the entry cannot be decoded.
+extern bool DecodeTxAccVsiTableEntry(const p4::v1::TableEntry& table_entry,
+                                     const P4InfoResolver& p4info,
+                                     uint32_t* vsi, uint32_t* host_port);
+
+extern void PrepareV6TunnelTermTableEntry(p4::v1::TableEntry* table_entry,
+                                          const struct tunnel_info& tunnel_info,
+                                          const P4InfoResolver& p4info,
+                                          bool insert_entry);
 
 extern void PrepareVlanPopTableEntry(p4::v1::TableEntry* table_entry,
                                      const uint16_t vlan_id,
-                                     const ::p4::config::v1::P4Info& p4info,
+                                     const P4InfoResolver& p4info,
                                      bool insert_entry);
 
 extern void PrepareVlanPushTableEntry(p4::v1::TableEntry* table_entry,
                                       const uint16_t vlan_id,
-                                      const ::p4::config::v1::P4Info& p4info,
+                                      const P4InfoResolver& p4info,
                                       bool insert_entry);
 
 extern void PrepareVxlanDecapModTableEntry(
     p4::v1::TableEntry* table_entry, const struct tunnel_info& tunnel_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry);
+    const P4InfoResolver& p4info, bool insert_entry);
 
 extern void PrepareVxlanDecapModAndVlanPushTableEntry(
     p4::v1::TableEntry* table_entry, const struct tunnel_info& tunnel_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry);
+    const P4InfoResolver& p4info, bool insert_entry);
 
 extern void PrepareVxlanEncapAndVlanPopTableEntry(
     p4::v1::TableEntry* table_entry, const struct tunnel_info& tunnel_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry);
+    const P4InfoResolver& p4info, bool insert_entry);
 
 extern void PrepareV6VxlanEncapAndVlanPopTableEntry(
     p4::v1::TableEntry* table_entry, const struct tunnel_info& tunnel_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry);
+    const P4InfoResolver& p4info, bool insert_entry);
 
-extern void PrepareV6VxlanEncapTableEntry(
-    p4::v1::TableEntry* table_entry, const struct tunnel_info& tunnel_info,
-    const ::p4::config::v1::P4Info& p4info, bool insert_entry);
+extern void PrepareV6VxlanEncapTableEntry(p4::v1::TableEntry* table_entry,
+                                          const struct tunnel_info& tunnel_info,
+                                          const P4InfoResolver& p4info,
+                                          bool insert_entry);
 
 #endif  // ES2K_TARGET
 
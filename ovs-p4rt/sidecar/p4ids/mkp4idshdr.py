@@ -0,0 +1,254 @@
+#!/usr/bin/env python3
+#
+# Copyright 2024 Intel Corporation.
+# SPDX-License-Identifier: Apache-2.0
+#
+# Generates a C++ header file of compile-time P4 object IDs from a
+# P4Info.txt file.
+#
+# The header defines constexpr functions that map table, action, match
+# field and action parameter names to IDs, and the fingerprint of the
+# P4Info. At runtime, P4InfoResolver computes the fingerprint of the
+# live P4Info and uses the compile-time IDs only if the two are equal.
+# The fingerprint algorithm must match P4InfoFingerprint() in
+# session/ovsp4rt_p4info_resolver.cc.
+#
+
+import argparse
+import logging
+import os
+import re
+
+DEFAULT_OUTFILE = "ovsp4rt_p4ids_gen.h"
+
+FNV_OFFSET_BASIS = 0xcbf29ce484222325
+FNV_PRIME = 0x100000001b3
+
+PREAMBLE = \
+"""// Generated by mkp4idshdr.py from {infile}.
+// Do not edit.
+
+#ifndef OVSP4RT_P4IDS_GEN_H_
+#define OVSP4RT_P4IDS_GEN_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ovsp4rt {{
+namespace p4ids {{
+
+struct IdEntry {{
+  const char* scope;
+  const char* name;
+  int id;
+}};
+
+// Compares two strings at compile time.
+constexpr int Compare(const char* a, const char* b) {{
+  while (*a != '\\0' && *a == *b) {{
+    ++a;
+    ++b;
+  }}
+  return static_cast<unsigned char>(*a) - static_cast<unsigned char>(*b);
+}}
+
+// Looks up an ID in a table sorted by scope and name.
+template <size_t N>
+constexpr int FindId(const IdEntry (&entries)[N], const char* scope,
+                     const char* name) {{
+  size_t lo = 0;
+  size_t hi = N;
+  while (lo < hi) {{
+    size_t mid = lo + (hi - lo) / 2;
+    int cmp = Compare(entries[mid].scope, scope);
+    if (cmp == 0) cmp = Compare(entries[mid].name, name);
+    if (cmp == 0) return entries[mid].id;
+    if (cmp < 0) {{
+      lo = mid + 1;
+    }} else {{
+      hi = mid;
+    }}
+  }}
+  return -1;
+}}
+
+// Fingerprint of the P4Info from which this file was generated.
+constexpr uint64_t kFingerprint = {fingerprint:#018x}ULL;
+"""
+
+POSTAMBLE = \
+"""
+constexpr int TableId(const char* t_name) {
+  return FindId(kTableIds, "", t_name);
+}
+
+constexpr int ActionId(const char* a_name) {
+  return FindId(kActionIds, "", a_name);
+}
+
+constexpr int MatchFieldId(const char* t_name, const char* mf_name) {
+  return FindId(kMatchFieldIds, t_name, mf_name);
+}
+
+constexpr int ParamId(const char* a_name, const char* param_name) {
+  return FindId(kParamIds, a_name, param_name);
+}
+
+}  // namespace p4ids
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_P4IDS_GEN_H_
+"""
+
+#-----------------------------------------------------------------------
+# Text format parser
+#
+# Just enough of the protobuf text format to read a P4Info file.
+#-----------------------------------------------------------------------
+
+TOKEN_RE = re.compile(r'\s*(?:#[^\n]*\n\s*)*'
+                      r'("(?:[^"\\]|\\.)*"|[{}:]|[^\s{}:"]+)')
+
+def tokenize(text):
+    pos = 0
+    tokens = []
+    while True:
+        match = TOKEN_RE.match(text, pos)
+        if not match:
+            break
+        tokens.append(match.group(1))
+        pos = match.end()
+    if text[pos:].strip():
+        raise ValueError(f"Unexpected input at offset {pos}")
+    return tokens
+
+def parse_message(tokens, pos):
+    """Returns a list of (name, value) pairs and the new position."""
+    fields = []
+    while pos < len(tokens) and tokens[pos] != '}':
+        name = tokens[pos]
+        pos += 1
+        if tokens[pos] == ':':
+            pos += 1
+        if tokens[pos] == '{':
+            value, pos = parse_message(tokens, pos + 1)
+            pos += 1  # skip '}'
+        else:
+            value = tokens[pos]
+            if value.startswith('"'):
+                value = value[1:-1]
+            pos += 1
+        fields.append((name, value))
+    return fields, pos
+
+def get_field(message, name, default=None):
+    for field_name, value in message:
+        if field_name == name:
+            return value
+    return default
+
+def get_fields(message, name):
+    return [value for field_name, value in message if field_name == name]
+
+#-----------------------------------------------------------------------
+# P4Info processing
+#-----------------------------------------------------------------------
+
+def read_p4info(infile):
+    with open(infile, 'r') as file:
+        logging.info(f"Reading {infile}")
+        p4info, _ = parse_message(tokenize(file.read()), 0)
+
+    def named_id(message):
+        return (int(get_field(message, 'id', '0')), get_field(message, 'name'))
+
+    tables = []
+    for table in get_fields(p4info, 'tables'):
+        preamble = get_field(table, 'preamble')
+        fields = [named_id(mf) for mf in get_fields(table, 'match_fields')]
+        tables.append(named_id(preamble) + (fields,))
+
+    actions = []
+    for action in get_fields(p4info, 'actions'):
+        preamble = get_field(action, 'preamble')
+        params = [named_id(param) for param in get_fields(action, 'params')]
+        actions.append(named_id(preamble) + (params,))
+
+    if not tables or not actions:
+        raise ValueError(f"{infile} does not define any tables or actions")
+
+    return tables, actions
+
+def compute_fingerprint(tables, actions):
+    """Computes the 64-bit FNV-1a hash of the P4 object names and IDs."""
+    text = ""
+    for id, name, fields in tables:
+        text += f"T {id} {name}\n"
+        for mf_id, mf_name in fields:
+            text += f"F {mf_id} {mf_name}\n"
+    for id, name, params in actions:
+        text += f"A {id} {name}\n"
+        for param_id, param_name in params:
+            text += f"P {param_id} {param_name}\n"
+
+    hash = FNV_OFFSET_BASIS
+    for byte in text.encode():
+        hash ^= byte
+        hash = (hash * FNV_PRIME) & 0xffffffffffffffff
+    return hash
+
+def make_entries(objects, scoped):
+    entries = {}
+    for id, name, children in objects:
+        if scoped:
+            for child_id, child_name in children:
+                # Lookups return the first child with a given name.
+                entries.setdefault((name, child_name), child_id)
+        else:
+            entries.setdefault(("", name), id)
+    return sorted(entries.items(), key=lambda e: (e[0][0].encode(),
+                                                  e[0][1].encode()))
+
+def write_entries(file, array_name, entries):
+    file.write(f"\nconstexpr IdEntry {array_name}[] = {{\n")
+    for (scope, name), id in entries:
+        file.write(f'    {{"{scope}", "{name}", {id}}},\n')
+    file.write("};\n")
+
+def create_header(infile, outfile):
+    tables, actions = read_p4info(infile)
+
+    with open(outfile, 'w') as file:
+        logging.info(f"Writing {outfile}")
+        file.write(PREAMBLE.format(
+            infile=os.path.basename(infile),
+            fingerprint=compute_fingerprint(tables, actions)))
+        write_entries(file, "kTableIds", make_entries(tables, False))
+        write_entries(file, "kActionIds", make_entries(actions, False))
+        write_entries(file, "kMatchFieldIds", make_entries(tables, True))
+        write_entries(file, "kParamIds", make_entries(actions, True))
+        file.write(POSTAMBLE)
+
+def create_parser():
+    parser = argparse.ArgumentParser(
+        prog="mkp4idshdr",
+        description="Generates C++ header file of P4 object IDs from a "
+                    "P4Info.txt file.")
+
+    parser.add_argument("--input", "-i", dest="infile", required=True,
+                        help="input file path")
+
+    parser.add_argument("--output", "-o", dest="outfile",
+                        default=DEFAULT_OUTFILE,
+                        help=f"output file path (default: {DEFAULT_OUTFILE})")
+
+    return parser
+
+if __name__ == "__main__":
+    logging.basicConfig(level=logging.INFO)
+
+    parser = create_parser()
+    args = parser.parse_args()
+    create_header(args.infile, args.outfile)
+
+# end __main__
@@ -0,0 +1,69 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Compile-time P4 object IDs.
+//
+// If libovsp4rt is configured with OVSP4RT_P4INFO_FILE, the build
+// generates ovsp4rt_p4ids_gen.h from the P4Info and defines
+// OVSP4RT_STATIC_P4IDS. This header then redefines GetTableId(),
+// GetActionId(), GetParamId() and GetMatchFieldId() as macros that
+// look up the name when the code is compiled. At runtime, the
+// compile-time ID is used if the resolver's P4Info has the same
+// fingerprint as the one the IDs were generated from. Otherwise, and
+// for names that are not in the generated table, the ID is resolved
+// by the P4InfoResolver.
+//
+// The name arguments must be string literals. Use the function form,
+// e.g. (GetParamId)(p4info, a_name, param_name), for names that are
+// not known at compile time.
+//
+// Include this header only in files that build table entries.
+
+#ifndef OVSP4RT_P4IDS_H_
+#define OVSP4RT_P4IDS_H_
+
+#include "session/ovsp4rt_p4info_resolver.h"
+
+#if defined(OVSP4RT_STATIC_P4IDS)
+
+#include "ovsp4rt_p4ids_gen.h"
+
+namespace ovsp4rt {
+namespace p4ids {
+
+// Returns STATIC_ID if it is valid for the resolver's P4Info.
+// Otherwise returns the result of the runtime lookup.
+template <int STATIC_ID, typename Lookup>
+inline int SelectId(const P4InfoResolver& p4info, Lookup lookup) {
+  if (STATIC_ID >= 0 && p4info.static_ids_valid()) {
+    return STATIC_ID;
+  }
+  return lookup();
+}
+
+}  // namespace p4ids
+}  // namespace ovsp4rt
+
+#define GetTableId(p4info, t_name)                               \
+  ::ovsp4rt::p4ids::SelectId<::ovsp4rt::p4ids::TableId(t_name)>( \
+      (p4info), [&] { return (::ovsp4rt::GetTableId)((p4info), (t_name)); })
+
+#define GetActionId(p4info, a_name)                               \
+  ::ovsp4rt::p4ids::SelectId<::ovsp4rt::p4ids::ActionId(a_name)>( \
+      (p4info), [&] { return (::ovsp4rt::GetActionId)((p4info), (a_name)); })
+
+#define GetParamId(p4info, a_name, param_name)                               \
+  ::ovsp4rt::p4ids::SelectId<::ovsp4rt::p4ids::ParamId(a_name, param_name)>( \
+      (p4info), [&] {                                                        \
+        return (::ovsp4rt::GetParamId)((p4info), (a_name), (param_name));    \
+      })
+
+#define GetMatchFieldId(p4info, t_name, mf_name)                        \
+  ::ovsp4rt::p4ids::SelectId<                                           \
+      ::ovsp4rt::p4ids::MatchFieldId(t_name, mf_name)>((p4info), [&] {  \
+    return (::ovsp4rt::GetMatchFieldId)((p4info), (t_name), (mf_name)); \
+  })
+
+#endif  // OVSP4RT_STATIC_P4IDS
+
+#endif  // OVSP4RT_P4IDS_H_
@@ -0,0 +1,180 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ovsp4rt_intent_store.h"
+
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "ovsp4rt_private.h"
+
+namespace ovsp4rt {
+
+namespace {
+
+// Returns the position of a kind of request in dependency order.
+int DependencyRank(AsyncOp::Type type) {
+  switch (type) {
+    case AsyncOp::CONFIG_VLAN_ENTRY:
+      return 0;
+    case AsyncOp::CONFIG_TUNNEL_ENTRY:
+      return 1;
+    case AsyncOp::CONFIG_RX_TUNNEL_SRC_ENTRY:
+      return 2;
+    case AsyncOp::CONFIG_TUNNEL_SRC_PORT_ENTRY:
+      return 3;
+    case AsyncOp::CONFIG_SRC_PORT_ENTRY:
+      return 4;
+    case AsyncOp::CONFIG_IP_MAC_MAP_ENTRY:
+      return 5;
+    case AsyncOp::CONFIG_FDB_ENTRY:
+    default:
+      return 6;
+  }
+}
+
+bool InDependencyOrder(const Intent& a, const Intent& b) {
+  int rank_a = DependencyRank(a.op.type);
+  int rank_b = DependencyRank(b.op.type);
+  return rank_a != rank_b ? rank_a < rank_b : a.seq < b.seq;
+}
+
+template <typename T>
+void AppendKey(std::string& key, const T& value) {
+  key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void AppendKey(std::string& key, const struct p4_ipaddr& addr) {
+  AppendKey(key, addr.family);
+  if (addr.family == AF_INET6) {
+    AppendKey(key, addr.ip.v6addr);
+  } else {
+    AppendKey(key, addr.ip.v4addr);
+  }
+}
+
+}  // namespace
+
+IntentStore& IntentStore::Instance() {
+  static IntentStore* instance = new IntentStore;
+  return *instance;
+}
+
+std::string IntentStore::Key(const AsyncOp& op) {
+  std::string key(1, static_cast<char>(op.type));
+  switch (op.type) {
+    case AsyncOp::CONFIG_FDB_ENTRY:
+      AppendKey(key, FdbKey(op.learn_info));
+      break;
+    case AsyncOp::CONFIG_IP_MAC_MAP_ENTRY:
+      AppendKey(key, op.ip_info.src_ip_addr);
+      AppendKey(key, op.ip_info.dst_ip_addr);
+      break;
+    case AsyncOp::CONFIG_RX_TUNNEL_SRC_ENTRY:
+    case AsyncOp::CONFIG_TUNNEL_ENTRY:
+      AppendKey(key, op.tnl_info.vni);
+      AppendKey(key, op.tnl_info.remote_ip);
+      break;
+    case AsyncOp::CONFIG_SRC_PORT_ENTRY:
+    case AsyncOp::CONFIG_TUNNEL_SRC_PORT_ENTRY:
+      AppendKey(key, op.sp_info.src_port);
+      AppendKey(key, op.sp_info.vlan_id);
+      break;
+    case AsyncOp::CONFIG_VLAN_ENTRY:
+      AppendKey(key, op.vlan_id);
+      break;
+    default:
+      break;
+  }
+  return key;
+}
+
+void IntentStore::Record(const AsyncOp& op) {
+  std::string key = Key(op);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& intents = intents_[op.grpc_addr];
+  if (!op.insert_entry) {
+    size_ -= intents.erase(key);
+    return;
+  }
+  auto [iter, inserted] = intents.try_emplace(std::move(key));
+  iter->second.op = op;
+  iter->second.op.enqueue_ns = 0;
+  iter->second.seq = next_seq_++;
+  if (inserted) {
+    ++size_;
+  }
+}
+
+std::vector<Intent> IntentStore::Snapshot(const std::string& grpc_addr) const {
+  std::vector<Intent> snapshot;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = intents_.find(grpc_addr);
+    if (iter == intents_.end()) {
+      return snapshot;
+    }
+    snapshot.reserve(iter->second.size());
+    for (const auto& [key, intent] : iter->second) {
+      snapshot.push_back(intent);
+    }
+  }
+  std::sort(snapshot.begin(), snapshot.end(), InDependencyOrder);
+  return snapshot;
+}
+
+std::vector<Intent> IntentStore::Changes(
+    const std::string& grpc_addr, const std::vector<Intent>& snapshot) const {
+  std::vector<Intent> deletes;
+  std::vector<Intent> inserts;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = intents_.find(grpc_addr);
+    for (const auto& before : snapshot) {
+      const Intent* now = nullptr;
+      if (iter != intents_.end()) {
+        auto entry = iter->second.find(Key(before.op));
+        if (entry != iter->second.end()) {
+          now = &entry->second;
+        }
+      }
+      if (!now) {
+        deletes.push_back(before);
+        deletes.back().op.insert_entry = false;
+      } else if (now->seq != before.seq) {
+        inserts.push_back(*now);
+      }
+    }
+  }
+  std::sort(inserts.begin(), inserts.end(), InDependencyOrder);
+  std::sort(deletes.begin(), deletes.end(), InDependencyOrder);
+  std::reverse(deletes.begin(), deletes.end());
+  deletes.insert(deletes.end(), inserts.begin(), inserts.end());
+  return deletes;
+}
+
+std::vector<std::string> IntentStore::Addresses() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<std::string> addresses;
+  for (const auto& [grpc_addr, intents] : intents_) {
+    if (!intents.empty()) {
+      addresses.push_back(grpc_addr);
+    }
+  }
+  return addresses;
+}
+
+size_t IntentStore::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return size_;
+}
+
+void IntentStore::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  intents_.clear();
+  size_ = 0;
+}
+
+}  // namespace ovsp4rt
@@ -0,0 +1,83 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_INTENT_STORE_H_
+#define OVSP4RT_INTENT_STORE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "async/ovsp4rt_async_writer.h"
+
+namespace ovsp4rt {
+
+// An API request that is part of the intended state, with the sequence
+// number of the Record() call that stored it.
+struct Intent {
+  AsyncOp op;
+  uint64_t seq = 0;
+};
+
+// The state that OVS has asked the sidecar to program: the most recent
+// insert request for each entry that has not since been deleted.
+//
+// The switch loses every entry the sidecar programmed when infrap4d
+// restarts. The Resyncer uses the store to program them again.
+class IntentStore {
+ public:
+  // Returns the process-wide intent store.
+  static IntentStore& Instance();
+
+  IntentStore() = default;
+
+  // Disable copy semantics.
+  IntentStore(const IntentStore&) = delete;
+  IntentStore& operator=(const IntentStore&) = delete;
+
+  // Records an API request. An insert replaces the intent for its
+  // entry, and a delete removes it.
+  void Record(const AsyncOp& op);
+
+  // Returns the intents for a server, in dependency order: VLANs and
+  // tunnels before the entries that refer to them, and FDB entries
+  // last. Intents of the same kind are in the order they were recorded.
+  std::vector<Intent> Snapshot(const std::string& grpc_addr) const;
+
+  // Returns the requests that bring the entries in an earlier snapshot
+  // up to date: the current intent for each entry that has changed,
+  // and a delete for each entry that has been removed. The deletes come
+  // first, in reverse dependency order.
+  std::vector<Intent> Changes(const std::string& grpc_addr,
+                              const std::vector<Intent>& snapshot) const;
+
+  // Returns the servers with recorded intents.
+  std::vector<std::string> Addresses() const;
+
+  // Returns the number of intents.
+  size_t size() const;
+
+  // Discards all intents.
+  void Clear();
+
+  // Returns the key that identifies the entry a request programs.
+  static std::string Key(const AsyncOp& op);
+
+ private:
+  mutable std::mutex mutex_;
+
+  // Intents by server address and entry key.
+  absl::flat_hash_map<std::string, absl::flat_hash_map<std::string, Intent>>
+      intents_;
+
+  uint64_t next_seq_ = 1;
+  size_t size_ = 0;
+};
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_INTENT_STORE_H_
@@ -0,0 +1,238 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ovsp4rt_resync.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <utility>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/flags/declare.h"
+#include "absl/flags/flag.h"
+#include "absl/status/status.h"
+#include "logging/ovsp4rt_logging.h"
+#include "ovsp4rt_private.h"
+#include "session/ovsp4rt_p4info_cache.h"
+#include "session/ovsp4rt_session_manager.h"
+#include "session/ovsp4rt_shadow_table.h"
+#include "session/ovsp4rt_vsi_port_map.h"
+
+ABSL_FLAG(int32_t, resync_interval_ms, 1000,
+          "Interval, in milliseconds, at which the sidecar checks whether "
+          "infrap4d has restarted or its pipeline has changed. Zero "
+          "disables resynchronization.");
+
+ABSL_DECLARE_FLAG(uint64_t, device_id);
+ABSL_DECLARE_FLAG(std::string, role_name);
+
+namespace ovsp4rt {
+
+namespace {
+
+// Returns true if an entry is in the state its request asked for.
+bool IsInPlace(const absl::Status& status) {
+  return status.ok() || status.code() == absl::StatusCode::kAlreadyExists ||
+         status.code() == absl::StatusCode::kNotFound;
+}
+
+absl::StatusOr<SyncState> ProbeServer(const std::string& grpc_addr) {
+  // Get the shared client session, reconnecting if the stream channel
+  // has closed.
+  auto status_or_session = SessionManager::Instance().GetSession(
+      grpc_addr, absl::GetFlag(FLAGS_device_id),
+      absl::GetFlag(FLAGS_role_name));
+  if (!status_or_session.ok()) return status_or_session.status();
+
+  std::shared_ptr<OvsP4rtSession> session =
+      std::move(status_or_session).value();
+
+  // Fails until a pipeline has been loaded.
+  auto status_or_snapshot = session->P4Info().GetSnapshot();
+  if (!status_or_snapshot.ok()) return status_or_snapshot.status();
+
+  SyncState state;
+  state.session_id = session->SessionId();
+  state.cookie = (*status_or_snapshot)->cookie();
+  return state;
+}
+
+bool HasEntries(const std::string& grpc_addr) {
+  // If the tables cannot be read, replay to be safe.
+  auto status_or_found = HasProgrammedEntries(grpc_addr.c_str());
+  return status_or_found.ok() && *status_or_found;
+}
+
+size_t ReplayIntents(const std::vector<Intent>& intents) {
+  // The mirrors may describe the switch as it was before.
+  absl::flat_hash_set<std::string> grpc_addrs;
+  for (const auto& intent : intents) {
+    if (grpc_addrs.insert(intent.op.grpc_addr).second) {
+      auto status_or_session = SessionManager::Instance().GetSession(
+          intent.op.grpc_addr, absl::GetFlag(FLAGS_device_id),
+          absl::GetFlag(FLAGS_role_name));
+      if (status_or_session.ok()) {
+        (*status_or_session)->Shadow().Invalidate();
+        (*status_or_session)->VsiPorts().Invalidate();
+      }
+    }
+  }
+
+  size_t num_failed = 0;
+  std::vector<FdbLearnEvent> events;
+  std::vector<absl::Status> event_status;
+  const char* grpc_addr = nullptr;
+
+  // Consecutive FDB intents are programmed together, so their updates
+  // share WriteRequests and several are in flight at once.
+  auto config_fdb_entries = [&]() {
+    if (events.empty()) {
+      return;
+    }
+    event_status.assign(events.size(), absl::OkStatus());
+    ConfigFdbEntries(events.data(), events.size(), grpc_addr,
+                     event_status.data());
+    num_failed += std::count_if(
+        event_status.begin(), event_status.end(),
+        [](const absl::Status& status) { return !IsInPlace(status); });
+    events.clear();
+  };
+
+  for (const auto& intent : intents) {
+    const auto& op = intent.op;
+    if (op.type == AsyncOp::CONFIG_FDB_ENTRY) {
+      events.push_back({op.learn_info, op.insert_entry});
+      grpc_addr = op.grpc_addr.c_str();
+      continue;
+    }
+    config_fdb_entries();
+    if (!IsInPlace(ExecuteAsyncOp(op))) {
+      num_failed++;
+    }
+  }
+  config_fdb_entries();
+
+  return num_failed;
+}
+
+}  // namespace
+
+Resyncer& Resyncer::Instance() {
+  // Intentionally leaked: the resync thread uses the SessionManager,
+  // which is never destroyed, and may be mid-replay at exit.
+  static Resyncer* instance = new Resyncer(
+      IntentStore::Instance(), ProbeServer, ReplayIntents,
+      absl::Milliseconds(absl::GetFlag(FLAGS_resync_interval_ms)),
+      HasEntries);
+  return *instance;
+}
+
+Resyncer::~Resyncer() {
+  if (thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(stop_mutex_);
+      stopping_ = true;
+    }
+    stop_.notify_one();
+    thread_.join();
+  }
+}
+
+void Resyncer::Start() {
+  if (!enabled()) {
+    return;
+  }
+  std::call_once(start_once_,
+                 [this]() { thread_ = std::thread(&Resyncer::Run, this); });
+}
+
+void Resyncer::Run() {
+  auto interval = absl::ToChronoMilliseconds(interval_);
+  std::unique_lock<std::mutex> lock(stop_mutex_);
+  while (!stop_.wait_for(lock, interval, [this]() { return stopping_; })) {
+    lock.unlock();
+    Poll();
+    lock.lock();
+  }
+}
+
+int Resyncer::Poll() {
+  std::lock_guard<std::mutex> lock(poll_mutex_);
+  int num_resyncs = 0;
+
+  for (const auto& grpc_addr : store_.Addresses()) {
+    auto status_or_state = probe_(grpc_addr);
+    if (!status_or_state.ok()) {
+      // The server is down or has no pipeline yet. Try again at the
+      // next poll.
+      continue;
+    }
+
+    // The first state seen is the one the intents were programmed in.
+    auto [iter, inserted] = synced_.try_emplace(grpc_addr, *status_or_state);
+    if (inserted || iter->second == *status_or_state) {
+      continue;
+    }
+
+    // Only the session changed, and the switch kept its entries.
+    if (iter->second.cookie == status_or_state->cookie && has_entries_ &&
+        has_entries_(grpc_addr)) {
+      ovsp4rt_log_info("Pipeline on %s unchanged after reconnect, "
+                       "not resynchronizing",
+                       grpc_addr.c_str());
+      iter->second = *status_or_state;
+      continue;
+    }
+
+    Resync(grpc_addr);
+
+    // If the server went away again during the replay, the next probe
+    // sees another new state and replays again.
+    iter->second = *status_or_state;
+    num_resyncs++;
+  }
+
+  return num_resyncs;
+}
+
+void Resyncer::Resync(const std::string& grpc_addr) {
+  absl::Time start = absl::Now();
+
+  auto intents = store_.Snapshot(grpc_addr);
+  size_t num_replayed = intents.size();
+  size_t num_failed = replay_(intents);
+
+  // Requests processed while the replay was running may have been
+  // overtaken by it.
+  auto changes = store_.Changes(grpc_addr, intents);
+  if (!changes.empty()) {
+    num_replayed += changes.size();
+    num_failed += replay_(changes);
+  }
+
+  uint64_t duration_us = absl::ToInt64Microseconds(absl::Now() - start);
+
+  resyncs_.fetch_add(1, std::memory_order_relaxed);
+  entries_replayed_.fetch_add(num_replayed, std::memory_order_relaxed);
+  entries_failed_.fetch_add(num_failed, std::memory_order_relaxed);
+  last_duration_us_.store(duration_us, std::memory_order_relaxed);
+  if (duration_us > max_duration_us_.load(std::memory_order_relaxed)) {
+    max_duration_us_.store(duration_us, std::memory_order_relaxed);
+  }
+
+  ovsp4rt_log_info("Resynchronized %zu entries on %s in %llu ms, %zu failed",
+                   num_replayed, grpc_addr.c_str(),
+                   static_cast<unsigned long long>(duration_us / 1000),
+                   num_failed);
+}
+
+void Resyncer::GetStats(struct ovsp4rt_resync_stats* stats) const {
+  stats->resyncs = resyncs_.load(std::memory_order_relaxed);
+  stats->entries_replayed = entries_replayed_.load(std::memory_order_relaxed);
+  stats->entries_failed = entries_failed_.load(std::memory_order_relaxed);
+  stats->last_duration_us = last_duration_us_.load(std::memory_order_relaxed);
+  stats->max_duration_us = max_duration_us_.load(std::memory_order_relaxed);
+}
+
+}  // namespace ovsp4rt
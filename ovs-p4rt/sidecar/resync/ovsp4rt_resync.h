@@ -0,0 +1,153 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_RESYNC_H_
+#define OVSP4RT_RESYNC_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "async/ovsp4rt_async_writer.h"
+#include "ovsp4rt/ovs-p4rt.h"
+#include "resync/ovsp4rt_intent_store.h"
+
+namespace ovsp4rt {
+
+// Identifies the state of a server: the session the sidecar has with
+// it and the forwarding pipeline it is running. A change in either
+// means the entries the sidecar programmed may be gone.
+struct SyncState {
+  uint64_t session_id = 0;
+  uint64_t cookie = 0;
+
+  bool operator==(const SyncState& other) const {
+    return session_id == other.session_id && cookie == other.cookie;
+  }
+  bool operator!=(const SyncState& other) const { return !(*this == other); }
+};
+
+// Restores the intended state on a server after infrap4d restarts.
+//
+// A background thread probes each server that has intents at the
+// resync interval. The probe reconnects if the stream channel has
+// closed, and revalidates the pipeline cookie. When the session or
+// cookie differs from the last one seen, the intents are replayed in
+// dependency order, with the FDB entries programmed in large pipelined
+// batches. Requests made while the replay is running are reconciled
+// once it is done, so a stale intent cannot overwrite a newer request.
+//
+// A new session with an unchanged cookie may only mean that the
+// sidecar reconnected, e.g., to take mastership back, and the switch
+// kept its entries. The replay is skipped if the switch still holds
+// entries in the sidecar's tables.
+class Resyncer {
+ public:
+  // Returns the current state of a server, connecting to it if needed.
+  using Probe =
+      std::function<::absl::StatusOr<SyncState>(const std::string& grpc_addr)>;
+
+  // Programs a series of intents for one server. Returns the number
+  // that failed.
+  using Replayer = std::function<size_t(const std::vector<Intent>& intents)>;
+
+  // Returns true if a server still holds the entries the sidecar
+  // programmed. Called only when the session has changed but the
+  // pipeline cookie has not.
+  using EntryCheck = std::function<bool(const std::string& grpc_addr)>;
+
+  // Returns the process-wide resyncer.
+  static Resyncer& Instance();
+
+  // If has_entries is null, every change of state is replayed.
+  Resyncer(IntentStore& store, Probe probe, Replayer replay,
+           absl::Duration interval, EntryCheck has_entries = nullptr)
+      : store_(store),
+        probe_(std::move(probe)),
+        replay_(std::move(replay)),
+        has_entries_(std::move(has_entries)),
+        interval_(interval) {}
+
+  // Stops the background thread.
+  ~Resyncer();
+
+  // Disable copy semantics.
+  Resyncer(const Resyncer&) = delete;
+  Resyncer& operator=(const Resyncer&) = delete;
+
+  // Returns true if resynchronization is enabled. If it is not, no
+  // intents are recorded.
+  bool enabled() const { return interval_ > absl::ZeroDuration(); }
+
+  // Starts the background thread, if it is not already running.
+  void Start();
+
+  // Probes each server once and replays the intents for those whose
+  // state has changed. Returns the number of servers resynchronized.
+  int Poll();
+
+  void GetStats(struct ovsp4rt_resync_stats* stats) const;
+
+ private:
+  // Body of the background thread.
+  void Run();
+
+  // Replays the intents for a server.
+  void Resync(const std::string& grpc_addr);
+
+  IntentStore& store_;
+  const Probe probe_;
+  const Replayer replay_;
+  const EntryCheck has_entries_;
+  const absl::Duration interval_;
+
+  std::once_flag start_once_;
+  std::thread thread_;
+
+  std::mutex stop_mutex_;
+  std::condition_variable stop_;
+  bool stopping_ = false;
+
+  // Serializes Poll(). Guards synced_.
+  std::mutex poll_mutex_;
+
+  // State of each server at its last probe.
+  absl::flat_hash_map<std::string, SyncState> synced_;
+
+  std::atomic<uint64_t> resyncs_{0};
+  std::atomic<uint64_t> entries_replayed_{0};
+  std::atomic<uint64_t> entries_failed_{0};
+  std::atomic<uint64_t> last_duration_us_{0};
+  std::atomic<uint64_t> max_duration_us_{0};
+};
+
+// Records an API request in the intent store and starts the resyncer.
+template <typename Info>
+void RecordIntent(AsyncOp::Type type, const Info& info, bool insert_entry,
+                  const char* grpc_addr) {
+  auto& resyncer = Resyncer::Instance();
+  if (!resyncer.enabled()) {
+    return;
+  }
+  AsyncOp op;
+  op.type = type;
+  op.SetInput(info);
+  op.insert_entry = insert_entry;
+  op.grpc_addr = grpc_addr;
+  IntentStore::Instance().Record(op);
+  resyncer.Start();
+}
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_RESYNC_H_
@@ -0,0 +1,197 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ovsp4rt_async_write_channel.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "journal/ovsp4rt_journal.h"
+#include "ovsp4rt_session.h"
+#include "ovsp4rt_write_retry.h"
+#include "stats/ovsp4rt_probes.h"
+#include "stats/ovsp4rt_stats.h"
+
+namespace ovsp4rt {
+
+// State of an outstanding write. Its address is the completion tag.
+struct AsyncWriteChannel::Call {
+  ::grpc::ClientContext context;
+  p4::v1::WriteRequest request;
+  p4::v1::WriteResponse response;
+  ::grpc::Status status;
+  std::unique_ptr<::grpc::ClientAsyncResponseReader<p4::v1::WriteResponse>>
+      reader;
+  Callback done;
+  Group* group;
+  uint64_t start_ns;
+};
+
+AsyncWriteChannel::AsyncWriteChannel(p4::v1::P4Runtime::Stub& stub,
+                                     Observer observer, int max_in_flight,
+                                     ::absl::Duration timeout,
+                                     bool retry_failed_updates)
+    : stub_(stub),
+      observer_(std::move(observer)),
+      max_in_flight_(std::max(max_in_flight, 1)),
+      timeout_(timeout),
+      retry_failed_updates_(retry_failed_updates) {
+  completer_ = std::thread(&AsyncWriteChannel::ProcessCompletions, this);
+  if (retry_failed_updates_) {
+    retrier_ = std::thread(&AsyncWriteChannel::ProcessRetries, this);
+  }
+}
+
+AsyncWriteChannel::~AsyncWriteChannel() {
+  Drain();
+  if (retrier_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    retry_ready_.notify_one();
+    retrier_.join();
+  }
+  cq_.Shutdown();
+  completer_.join();
+}
+
+void AsyncWriteChannel::StartWrite(p4::v1::WriteRequest write_request,
+                                   Callback done, Group* group) {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    call_done_.wait(lock, [this, group]() {
+      return group->in_flight_ < max_in_flight_;
+    });
+    ++group->in_flight_;
+    ++in_flight_;
+  }
+
+  auto* call = new Call;
+  call->request = std::move(write_request);
+  call->done = std::move(done);
+  call->group = group;
+  if (auto* journal = Journal::Current()) {
+    journal->recordOutput(__func__, call->request);
+  }
+  if (timeout_ > ::absl::ZeroDuration()) {
+    call->context.set_deadline(::absl::ToChronoTime(::absl::Now() + timeout_));
+  }
+
+  OVSP4RT_PROBE2(write__start, reinterpret_cast<uintptr_t>(call),
+                 call->request.updates_size());
+  call->start_ns = Stats::NowNs();
+  call->reader = stub_.PrepareAsyncWrite(&call->context, call->request, &cq_);
+  call->reader->StartCall();
+  call->reader->Finish(&call->response, &call->status, call);
+}
+
+void AsyncWriteChannel::Drain() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  call_done_.wait(lock, [this]() { return in_flight_ == 0; });
+}
+
+void AsyncWriteChannel::Drain(Group* group) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  call_done_.wait(lock, [group]() { return group->in_flight_ == 0; });
+}
+
+int AsyncWriteChannel::in_flight() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return in_flight_;
+}
+
+void AsyncWriteChannel::ProcessCompletions() {
+  void* tag;
+  bool ok;
+  while (cq_.Next(&tag, &ok)) {
+    // Finish() always completes with ok set; the outcome of the RPC is
+    // in call->status.
+    std::unique_ptr<Call> call(static_cast<Call*>(tag));
+    Stats::Instance().RecordLatency(OVSP4RT_LATENCY_WRITE_RPC,
+                                    Stats::NowNs() - call->start_ns);
+    OVSP4RT_PROBE2(write__done, reinterpret_cast<uintptr_t>(call.get()),
+                   static_cast<int>(call->status.error_code()));
+
+    auto update_status =
+        GetUpdateStatus(call->status, call->request.updates_size());
+    if (observer_) {
+      observer_(call->request, update_status);
+    }
+    auto status = GrpcStatusToAbslStatus(call->status);
+    if (!status.ok() && retry_failed_updates_) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        retries_.push_back(std::move(call));
+      }
+      retry_ready_.notify_one();
+      continue;
+    }
+    Complete(std::move(call), status, update_status);
+  }
+}
+
+void AsyncWriteChannel::ProcessRetries() {
+  while (true) {
+    std::unique_ptr<Call> call;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      retry_ready_.wait(lock,
+                        [this]() { return stopping_ || !retries_.empty(); });
+      if (retries_.empty()) {
+        return;
+      }
+      call = std::move(retries_.front());
+      retries_.pop_front();
+    }
+
+    std::vector<::absl::Status> update_status;
+    auto status = RetryFailedUpdates(
+        [this](const p4::v1::WriteRequest& write_request) {
+          return Write(write_request);
+        },
+        call->request, call->status, &update_status);
+    Complete(std::move(call), status, update_status);
+  }
+}
+
+void AsyncWriteChannel::Complete(
+    std::unique_ptr<Call> call, const ::absl::Status& status,
+    const std::vector<::absl::Status>& update_status) {
+  if (call->done) {
+    call->done(status, update_status);
+  }
+  Group* group = call->group;
+  call.reset();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --group->in_flight_;
+    --in_flight_;
+  }
+  call_done_.notify_all();
+}
+
+::grpc::Status AsyncWriteChannel::Write(
+    const p4::v1::WriteRequest& write_request) {
+  ::grpc::ClientContext context;
+  p4::v1::WriteResponse response;
+  if (timeout_ > ::absl::ZeroDuration()) {
+    context.set_deadline(::absl::ToChronoTime(::absl::Now() + timeout_));
+  }
+
+  OVSP4RT_PROBE1(write__entry, write_request.updates_size());
+  uint64_t start_ns = Stats::NowNs();
+  auto status = stub_.Write(&context, write_request, &response);
+  Stats::Instance().RecordLatency(OVSP4RT_LATENCY_WRITE_RPC,
+                                  Stats::NowNs() - start_ns);
+  OVSP4RT_PROBE1(write__return, static_cast<int>(status.error_code()));
+  auto update_status = GetUpdateStatus(status, write_request.updates_size());
+  if (observer_) {
+    observer_(write_request, update_status);
+  }
+  return status;
+}
+
+}  // namespace ovsp4rt
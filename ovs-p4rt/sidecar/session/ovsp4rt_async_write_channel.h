@@ -0,0 +1,168 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_ASYNC_WRITE_CHANNEL_H_
+#define OVSP4RT_ASYNC_WRITE_CHANNEL_H_
+
+#include <grpcpp/grpcpp.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "p4/v1/p4runtime.grpc.pb.h"
+#include "p4/v1/p4runtime.pb.h"
+
+namespace ovsp4rt {
+
+// Sends Write RPCs on a P4Runtime stub without waiting for each one to
+// complete, so that several WriteRequests can be in flight at once.
+//
+// The RPCs are started on a gRPC CompletionQueue. A completion thread
+// collects the results, passes them to the channel's observer (e.g.,
+// to update the ShadowTable), and invokes the caller's callback. If
+// the channel retries failed updates, it passes a failed write to a
+// retry thread, which resends the updates (see RetryFailedUpdates())
+// and then invokes the callback. The retries are synchronous RPCs, so
+// they are kept off the completion thread, which goes on collecting
+// the results of the other writes. The write counts as outstanding
+// until its callback has been invoked.
+//
+// The server may apply concurrent writes in any order, so the caller
+// must not have two writes for the same entry in flight at the same
+// time.
+//
+// Callers that share the channel (e.g., the writer shards) each start
+// their writes through a Group, so that the in-flight limit applies to
+// each caller, and a caller waits only for its own writes.
+class AsyncWriteChannel {
+ public:
+  // Receives the result of a write: the overall status and the status
+  // of each update. Runs on the completion thread or the retry thread,
+  // and must not start another write.
+  using Callback = std::function<void(
+      const ::absl::Status& status,
+      const std::vector<::absl::Status>& update_status)>;
+
+  // Receives the result of every Write RPC the channel sends, including
+  // the ones that retry failed updates.
+  using Observer =
+      std::function<void(const p4::v1::WriteRequest& write_request,
+                         const std::vector<::absl::Status>& update_status)>;
+
+  // The writes started by one caller.
+  class Group {
+   public:
+    explicit Group(AsyncWriteChannel& channel) : channel_(channel) {}
+
+    // Waits for the writes of the group to complete.
+    ~Group() { Drain(); }
+
+    // Disable copy semantics.
+    Group(const Group&) = delete;
+    Group& operator=(const Group&) = delete;
+
+    // Starts a Write RPC. Blocks while the maximum number of writes of
+    // the group is already outstanding.
+    void StartWrite(p4::v1::WriteRequest write_request, Callback done) {
+      channel_.StartWrite(std::move(write_request), std::move(done), this);
+    }
+
+    // Waits until the group has no outstanding writes.
+    void Drain() { channel_.Drain(this); }
+
+   private:
+    friend class AsyncWriteChannel;
+
+    AsyncWriteChannel& channel_;
+
+    // Protected by the mutex of the channel.
+    int in_flight_ = 0;
+  };
+
+  // Creates a channel that allows up to max_in_flight outstanding
+  // writes per group. The observer may be empty. A non-zero timeout
+  // sets the deadline of each RPC. If retry_failed_updates is true,
+  // the updates of a failed write are resent before its callback is
+  // invoked.
+  AsyncWriteChannel(p4::v1::P4Runtime::Stub& stub, Observer observer,
+                    int max_in_flight,
+                    ::absl::Duration timeout = ::absl::ZeroDuration(),
+                    bool retry_failed_updates = false);
+
+  // Waits for the outstanding writes to complete.
+  ~AsyncWriteChannel();
+
+  // Disable copy semantics.
+  AsyncWriteChannel(const AsyncWriteChannel&) = delete;
+  AsyncWriteChannel& operator=(const AsyncWriteChannel&) = delete;
+
+  // Starts a Write RPC in the default group. Blocks while the maximum
+  // number of writes of the default group is already outstanding.
+  void StartWrite(p4::v1::WriteRequest write_request, Callback done) {
+    StartWrite(std::move(write_request), std::move(done), &default_group_);
+  }
+
+  // Waits until there are no outstanding writes, in any group.
+  void Drain();
+
+  int max_in_flight() const { return max_in_flight_; }
+
+  // Returns the number of outstanding writes, in all groups.
+  int in_flight() const;
+
+ private:
+  struct Call;
+
+  void StartWrite(p4::v1::WriteRequest write_request, Callback done,
+                  Group* group);
+
+  // Waits until a group has no outstanding writes.
+  void Drain(Group* group);
+
+  // Body of the completion thread.
+  void ProcessCompletions();
+
+  // Body of the retry thread.
+  void ProcessRetries();
+
+  // Invokes the callback of a write and releases its slot.
+  void Complete(std::unique_ptr<Call> call, const ::absl::Status& status,
+                const std::vector<::absl::Status>& update_status);
+
+  // Sends a WriteRequest synchronously, to retry failed updates.
+  ::grpc::Status Write(const p4::v1::WriteRequest& write_request);
+
+  p4::v1::P4Runtime::Stub& stub_;
+  const Observer observer_;
+  const int max_in_flight_;
+  const ::absl::Duration timeout_;
+  const bool retry_failed_updates_;
+
+  ::grpc::CompletionQueue cq_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable call_done_;
+  int in_flight_ = 0;
+
+  Group default_group_{*this};
+
+  // Failed writes waiting for the retry thread.
+  std::condition_variable retry_ready_;
+  std::deque<std::unique_ptr<Call>> retries_;
+  bool stopping_ = false;
+
+  std::thread completer_;
+  std::thread retrier_;
+};
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_ASYNC_WRITE_CHANNEL_H_
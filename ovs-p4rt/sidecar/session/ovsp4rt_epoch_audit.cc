@@ -0,0 +1,187 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ovsp4rt_epoch_audit.h"
+
+#include <memory>
+#include <utility>
+
+#include "ovsp4rt_shadow_table.h"
+
+namespace ovsp4rt {
+
+EpochAudit& EpochAudit::Instance() {
+  static EpochAudit* instance = new EpochAudit;
+  return *instance;
+}
+
+void EpochAudit::Begin(uint64_t session_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  marked_.clear();
+  session_id_.store(session_id, std::memory_order_release);
+}
+
+void EpochAudit::Mark(uint64_t session_id,
+                      const ::p4::v1::TableEntry& table_entry) {
+  if (!IsActive(session_id)) {
+    return;
+  }
+  std::string key = ShadowTable::MatchKey(table_entry);
+  std::lock_guard<std::mutex> lock(mutex_);
+  marked_[table_entry.table_id()].insert(std::move(key));
+}
+
+void EpochAudit::RecordWrite(
+    uint64_t session_id, const ::p4::v1::WriteRequest& write_request,
+    const std::vector<::absl::Status>& update_status) {
+  if (!IsActive(session_id)) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (int i = 0; i < write_request.updates_size(); i++) {
+    const auto& update = write_request.updates(i);
+    if (!update.entity().has_table_entry()) {
+      continue;
+    }
+    const auto& table_entry = update.entity().table_entry();
+
+    ::absl::StatusCode code = update_status[i].code();
+    switch (update.type()) {
+      case ::p4::v1::Update::INSERT:
+      case ::p4::v1::Update::MODIFY:
+        if (code == ::absl::StatusCode::kOk ||
+            code == ::absl::StatusCode::kAlreadyExists) {
+          marked_[table_entry.table_id()].insert(
+              ShadowTable::MatchKey(table_entry));
+        }
+        break;
+      case ::p4::v1::Update::DELETE:
+        if (code == ::absl::StatusCode::kOk ||
+            code == ::absl::StatusCode::kNotFound) {
+          auto iter = marked_.find(table_entry.table_id());
+          if (iter != marked_.end()) {
+            iter->second.erase(ShadowTable::MatchKey(table_entry));
+          }
+        }
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+bool EpochAudit::IsMarked(const ::p4::v1::TableEntry& table_entry) const {
+  std::string key = ShadowTable::MatchKey(table_entry);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = marked_.find(table_entry.table_id());
+  return iter != marked_.end() && iter->second.contains(key);
+}
+
+::absl::StatusOr<uint64_t> EpochAudit::End(
+    OvsP4rtSession* session, const std::vector<uint32_t>& table_ids) {
+  if (!IsActive(session->SessionId())) {
+    return ::absl::FailedPreconditionError(
+        "No audit epoch is active in this session");
+  }
+
+  ::p4::v1::WriteRequest write_header;
+  write_header.set_device_id(session->DeviceId());
+  *write_header.mutable_election_id() = session->ElectionId();
+
+  auto status_or_deleted =
+      Sweep(session->Stub(), session->AsyncWrites(), write_header, table_ids);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  session_id_.store(0, std::memory_order_release);
+  marked_.clear();
+  return status_or_deleted;
+}
+
+::absl::StatusOr<uint64_t> EpochAudit::Sweep(
+    ::p4::v1::P4Runtime::Stub& stub, AsyncWriteChannel& channel,
+    const ::p4::v1::WriteRequest& write_header,
+    const std::vector<uint32_t>& table_ids) {
+  // Waits only for the writes of the sweep.
+  AsyncWriteChannel::Group writes(channel);
+  auto num_deleted = std::make_shared<std::atomic<uint64_t>>(0);
+
+  ::p4::v1::WriteRequest write_request;
+  auto start_write = [&]() {
+    if (write_request.updates().empty()) {
+      return;
+    }
+    writes.StartWrite(std::move(write_request),
+                      [num_deleted](const ::absl::Status& status,
+                                    const std::vector<::absl::Status>&
+                                        update_status) {
+                        for (const auto& update : update_status) {
+                          if (update.ok()) {
+                            num_deleted->fetch_add(1);
+                          }
+                        }
+                      });
+    write_request.Clear();
+  };
+
+  for (uint32_t table_id : table_ids) {
+    ::p4::v1::ReadRequest read_request;
+    read_request.set_device_id(write_header.device_id());
+    read_request.add_entities()->mutable_table_entry()->set_table_id(
+        table_id);
+
+    // Collect the stale entries before deleting any of them, so the
+    // read does not see a table that is changing under it.
+    std::vector<::p4::v1::TableEntry> stale;
+    auto status = ReadEntities(
+        stub, read_request, [&](const ::p4::v1::Entity& entity) {
+          if (entity.has_table_entry() &&
+              entity.table_entry().table_id() == table_id &&
+              !IsMarked(entity.table_entry())) {
+            stale.push_back(entity.table_entry());
+          }
+          return true;
+        });
+    if (!status.ok()) {
+      writes.Drain();
+      return status;
+    }
+
+    for (auto& table_entry : stale) {
+      if (write_request.updates().empty()) {
+        write_request.set_device_id(write_header.device_id());
+        *write_request.mutable_election_id() = write_header.election_id();
+      }
+      auto* update = write_request.add_updates();
+      update->set_type(::p4::v1::Update::DELETE);
+
+      // A DELETE is identified by its table and match key.
+      auto* entry = update->mutable_entity()->mutable_table_entry();
+      entry->set_table_id(table_id);
+      entry->mutable_match()->Swap(table_entry.mutable_match());
+      entry->set_priority(table_entry.priority());
+
+      if (write_request.updates_size() >= kSweepBatchSize) {
+        start_write();
+      }
+    }
+    start_write();
+
+    // The entries in later tables may be referred to by the ones in
+    // this table.
+    writes.Drain();
+  }
+
+  return num_deleted->load();
+}
+
+size_t EpochAudit::num_marked() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t count = 0;
+  for (const auto& [table_id, keys] : marked_) {
+    count += keys.size();
+  }
+  return count;
+}
+
+}  // namespace ovsp4rt
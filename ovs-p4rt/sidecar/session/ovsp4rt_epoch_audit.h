@@ -0,0 +1,99 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_EPOCH_AUDIT_H_
+#define OVSP4RT_EPOCH_AUDIT_H_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "ovsp4rt_async_write_channel.h"
+#include "ovsp4rt_session.h"
+#include "p4/v1/p4runtime.grpc.pb.h"
+#include "p4/v1/p4runtime.pb.h"
+
+namespace ovsp4rt {
+
+// Finds and removes the entries that OVS no longer wants after it
+// restarts, by mark and sweep.
+//
+// OVS begins an epoch before it reconciles its state with the switch.
+// While the epoch is active, every entry the sidecar programs, or finds
+// already present, is marked. When OVS ends the epoch, each table the
+// sidecar owns is read once, and the entries that were not marked are
+// removed with batched DELETEs.
+class EpochAudit {
+ public:
+  // Maximum number of updates in a DELETE batch.
+  static constexpr int kSweepBatchSize = 1000;
+
+  // Returns the process-wide audit.
+  static EpochAudit& Instance();
+
+  EpochAudit() = default;
+
+  // Disable copy semantics.
+  EpochAudit(const EpochAudit&) = delete;
+  EpochAudit& operator=(const EpochAudit&) = delete;
+
+  // Begins an epoch in a session, discarding the marks of any epoch in
+  // progress.
+  void Begin(uint64_t session_id);
+
+  // Returns true if an epoch is active in the session.
+  bool IsActive(uint64_t session_id) const {
+    return session_id != 0 &&
+           session_id_.load(std::memory_order_acquire) == session_id;
+  }
+
+  // Marks an entry that is known to be present.
+  void Mark(uint64_t session_id, const ::p4::v1::TableEntry& table_entry);
+
+  // Marks the entries that the table entry updates in a WriteRequest
+  // inserted or modified (or found already present), and unmarks the
+  // ones it deleted. update_status holds the status of each update.
+  void RecordWrite(uint64_t session_id,
+                   const ::p4::v1::WriteRequest& write_request,
+                   const std::vector<::absl::Status>& update_status);
+
+  // Returns true if an entry has been marked in the current epoch.
+  bool IsMarked(const ::p4::v1::TableEntry& table_entry) const;
+
+  // Ends the epoch in the session and sweeps the tables. Returns the
+  // number of entries deleted. Fails if the epoch is not active in the
+  // session, e.g., because the session was replaced during the epoch.
+  ::absl::StatusOr<uint64_t> End(OvsP4rtSession* session,
+                                 const std::vector<uint32_t>& table_ids);
+
+  // Deletes the entries in each table that were not marked, one table
+  // at a time, in the order given. The deletes are pipelined on the
+  // write channel, and carry the device ID and election ID of
+  // write_header. Returns the number of entries deleted.
+  ::absl::StatusOr<uint64_t> Sweep(::p4::v1::P4Runtime::Stub& stub,
+                                   AsyncWriteChannel& channel,
+                                   const ::p4::v1::WriteRequest& write_header,
+                                   const std::vector<uint32_t>& table_ids);
+
+  // Returns the number of marked entries.
+  size_t num_marked() const;
+
+ private:
+  // Session of the active epoch, or zero.
+  std::atomic<uint64_t> session_id_{0};
+
+  mutable std::mutex mutex_;
+
+  // Match keys of the marked entries, by table.
+  absl::flat_hash_map<uint32_t, absl::flat_hash_set<std::string>> marked_;
+};
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_EPOCH_AUDIT_H_
@@ -0,0 +1,102 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ovsp4rt_fdb_aging.h"
+
+#include <utility>
+#include <vector>
+
+namespace ovsp4rt {
+
+namespace {
+
+// The instance whose callback is running on this thread, if any.
+thread_local const FdbAging* running_aging = nullptr;
+
+}  // namespace
+
+FdbAging& FdbAging::Instance() {
+  static FdbAging* instance = new FdbAging;
+  return *instance;
+}
+
+void FdbAging::Enable(absl::Duration idle_timeout, Decoder decoder,
+                      Callback callback) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  decoder_ = std::move(decoder);
+  callback_ = std::move(callback);
+  idle_timeout_ns_.store(absl::ToInt64Nanoseconds(idle_timeout),
+                         std::memory_order_relaxed);
+}
+
+void FdbAging::Disable() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  idle_timeout_ns_.store(0, std::memory_order_relaxed);
+  decoder_ = nullptr;
+  callback_ = nullptr;
+
+  // A callback that disables aging cannot wait for itself.
+  if (running_aging != this) {
+    idle_.wait(lock, [this] { return num_running_ == 0; });
+  }
+}
+
+void FdbAging::HandleNotification(
+    OvsP4rtSession* session,
+    const ::p4::v1::IdleTimeoutNotification& notification) {
+  // Copy the decoder and callback, and call them without the lock.
+  Decoder decoder;
+  Callback callback;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!callback_) {
+      return;
+    }
+    decoder = decoder_;
+    callback = callback_;
+    ++num_running_;
+  }
+
+  std::vector<struct ovsp4rt_aged_mac> macs;
+  macs.reserve(notification.table_entry_size());
+  uint64_t num_undecoded = 0;
+  for (const auto& table_entry : notification.table_entry()) {
+    struct ovsp4rt_aged_mac aged_mac = {};
+    if (decoder(session, table_entry, &aged_mac)) {
+      macs.push_back(aged_mac);
+    } else {
+      ++num_undecoded;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    num_aged_ += macs.size();
+    num_undecoded_ += num_undecoded;
+  }
+
+  if (!macs.empty()) {
+    const FdbAging* outer = running_aging;
+    running_aging = this;
+    callback(macs.data(), macs.size());
+    running_aging = outer;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --num_running_;
+  }
+  idle_.notify_all();
+}
+
+uint64_t FdbAging::num_aged() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_aged_;
+}
+
+uint64_t FdbAging::num_undecoded() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_undecoded_;
+}
+
+}  // namespace ovsp4rt
@@ -0,0 +1,95 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_FDB_AGING_H_
+#define OVSP4RT_FDB_AGING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+#include "absl/time/time.h"
+#include "ovsp4rt/ovs-p4rt.h"
+#include "p4/v1/p4runtime.pb.h"
+
+namespace ovsp4rt {
+
+class OvsP4rtSession;
+
+// Ages the FDB entries in the switch instead of in OVS.
+//
+// While aging is enabled, the FDB entries are programmed with an idle
+// timeout in the table the target uses for aging. When entries have
+// not been hit for the idle timeout, the switch sends an
+// IdleTimeoutNotification on the stream channel. The stream reader
+// thread of the session passes it to HandleNotification(), which
+// decodes the entries and delivers the aged-out MAC addresses to the
+// callback in one batch.
+class FdbAging {
+ public:
+  // Receives a batch of aged-out MAC addresses.
+  using Callback =
+      std::function<void(const struct ovsp4rt_aged_mac* macs, size_t num_macs)>;
+
+  // Decodes the bridge and MAC address of an entry in the aging table.
+  // Returns false if the entry cannot be decoded.
+  using Decoder = std::function<bool(OvsP4rtSession* session,
+                                     const ::p4::v1::TableEntry& table_entry,
+                                     struct ovsp4rt_aged_mac* aged_mac)>;
+
+  // Returns the process-wide instance.
+  static FdbAging& Instance();
+
+  FdbAging() = default;
+
+  // Disable copy semantics.
+  FdbAging(const FdbAging&) = delete;
+  FdbAging& operator=(const FdbAging&) = delete;
+
+  // Enables aging. The FDB entries programmed afterward age out after
+  // idle_timeout without a hit.
+  void Enable(absl::Duration idle_timeout, Decoder decoder, Callback callback);
+
+  // Disables aging. When it returns, the callback is no longer running
+  // and will not be called again. The callback may call Disable(); it
+  // then returns without waiting for callbacks on other threads.
+  void Disable();
+
+  // Returns the idle timeout to program, in nanoseconds, or zero if
+  // aging is disabled.
+  int64_t idle_timeout_ns() const {
+    return idle_timeout_ns_.load(std::memory_order_relaxed);
+  }
+
+  // Delivers the entries of a notification received on a session.
+  void HandleNotification(
+      OvsP4rtSession* session,
+      const ::p4::v1::IdleTimeoutNotification& notification);
+
+  // Returns the number of MAC addresses delivered, and the number of
+  // notified entries that could not be decoded.
+  uint64_t num_aged() const;
+  uint64_t num_undecoded() const;
+
+ private:
+  std::atomic<int64_t> idle_timeout_ns_{0};
+
+  // Not held while the callback runs, so that the callback can call
+  // back into the library. Disable() waits for num_running_ instead.
+  mutable std::mutex mutex_;
+  std::condition_variable idle_;
+  Decoder decoder_;
+  Callback callback_;
+  int num_running_ = 0;
+
+  uint64_t num_aged_ = 0;
+  uint64_t num_undecoded_ = 0;
+};
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_FDB_AGING_H_
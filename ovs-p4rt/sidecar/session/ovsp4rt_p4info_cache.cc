@@ -0,0 +1,138 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ovsp4rt_p4info_cache.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "absl/flags/flag.h"
+#include "absl/time/clock.h"
+#include "google/protobuf/util/message_differencer.h"
+#include "logging/ovsp4rt_logging.h"
+#include "ovsp4rt_session.h"
+
+ABSL_FLAG(int32_t, p4info_revalidate_ms, 1000,
+          "Interval at which the cached P4Info is revalidated.");
+
+namespace ovsp4rt {
+
+bool P4InfoCache::IsFresh() const {
+  return absl::GetCurrentTimeNanos() <
+         revalidate_after_ns_.load(std::memory_order_relaxed);
+}
+
+::absl::StatusOr<std::shared_ptr<const P4InfoSnapshot>>
+P4InfoCache::GetSnapshot() {
+  auto snapshot = std::atomic_load(&snapshot_);
+  if (snapshot && IsFresh()) {
+    return snapshot;
+  }
+
+  std::unique_lock<std::mutex> lock(revalidate_mutex_, std::defer_lock);
+
+  if (snapshot) {
+    // The snapshot is only due for a periodic check. If another thread
+    // is already doing it, keep going with what we have.
+    if (!lock.try_lock()) {
+      return snapshot;
+    }
+  } else {
+    // Wait for the P4Info to be fetched.
+    lock.lock();
+  }
+
+  // Another thread may have revalidated the snapshot while we waited.
+  snapshot = std::atomic_load(&snapshot_);
+  if (snapshot && IsFresh()) {
+    return snapshot;
+  }
+
+  ::absl::Status status = Revalidate();
+  if (!status.ok()) {
+    if (!snapshot) {
+      return status;
+    }
+    // Keep using the snapshot we have. The pipeline is checked again
+    // when the (longer) revalidation interval has elapsed.
+    ovsp4rt_log_error("Unable to revalidate P4Info for device %u: %s",
+                      device_id_, status.ToString().c_str());
+  }
+
+  return std::atomic_load(&snapshot_);
+}
+
+::absl::Status P4InfoCache::Revalidate() {
+  ::absl::Status status = CheckPipeline();
+  if (!status.ok()) {
+    // Give the server time to recover before the next check.
+    backoff_ = std::min(backoff_ * 2, kMaxBackoff);
+  }
+
+  revalidate_after_ns_.store(
+      absl::GetCurrentTimeNanos() + absl::GetFlag(FLAGS_p4info_revalidate_ms) *
+                                        int64_t{1000000} * backoff_,
+      std::memory_order_relaxed);
+
+  return status;
+}
+
+::absl::Status P4InfoCache::CheckPipeline() {
+  auto current = std::atomic_load(&snapshot_);
+
+  // A cookie of zero means the pipeline was pushed without one, in
+  // which case only the P4Info itself tells whether it has changed.
+  bool changed = true;
+  if (current && current->cookie() != 0) {
+    uint64_t cookie;
+    ::absl::Status status =
+        GetForwardingPipelineCookie(stub_, device_id_, &cookie);
+    if (!status.ok()) {
+      return status;
+    }
+    changed = cookie != current->cookie();
+    if (!changed) {
+      backoff_ = 1;
+    }
+  }
+
+  if (changed) {
+    ::p4::config::v1::P4Info p4info;
+    uint64_t cookie;
+    ::absl::Status status =
+        GetForwardingPipelineConfig(stub_, device_id_, &p4info, &cookie);
+    if (!status.ok()) {
+      return status;
+    }
+    if (p4info.tables().empty()) {
+      return ::absl::FailedPreconditionError(
+          "Forwarding pipeline has not been configured");
+    }
+    fetch_count_.fetch_add(1, std::memory_order_relaxed);
+
+    if (current && cookie == 0 && current->cookie() == 0 &&
+        google::protobuf::util::MessageDifferencer::Equals(
+            p4info, current->p4info())) {
+      // Keep the snapshot, and check less often.
+      backoff_ = std::min(backoff_ * 2, kMaxBackoff);
+    } else {
+      backoff_ = 1;
+      std::atomic_store(
+          &snapshot_,
+          std::shared_ptr<const P4InfoSnapshot>(
+              std::make_shared<const P4InfoSnapshot>(
+                  device_id_, std::move(p4info), cookie)));
+    }
+  }
+
+  return ::absl::OkStatus();
+}
+
+void P4InfoCache::Invalidate() {
+  std::lock_guard<std::mutex> lock(revalidate_mutex_);
+  std::atomic_store(&snapshot_, std::shared_ptr<const P4InfoSnapshot>());
+  revalidate_after_ns_.store(0, std::memory_order_relaxed);
+  backoff_ = 1;
+}
+
+}  // namespace ovsp4rt
@@ -0,0 +1,127 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_P4INFO_CACHE_H_
+#define OVSP4RT_P4INFO_CACHE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "ovsp4rt_p4info_resolver.h"
+#include "p4/config/v1/p4info.pb.h"
+#include "p4/v1/p4runtime.grpc.pb.h"
+
+namespace ovsp4rt {
+
+// Immutable copy of the P4Info for a forwarding pipeline, together with
+// the cookie that identifies the pipeline and a resolver that maps
+// P4 object names to IDs.
+class P4InfoSnapshot {
+ public:
+  P4InfoSnapshot(uint32_t device_id, ::p4::config::v1::P4Info p4info,
+                 uint64_t cookie)
+      : device_id_(device_id),
+        p4info_(std::move(p4info)),
+        resolver_(p4info_),
+        cookie_(cookie) {}
+
+  // Disable copy semantics.
+  P4InfoSnapshot(const P4InfoSnapshot&) = delete;
+  P4InfoSnapshot& operator=(const P4InfoSnapshot&) = delete;
+
+  uint32_t device_id() const { return device_id_; }
+
+  const ::p4::config::v1::P4Info& p4info() const { return p4info_; }
+
+  const P4InfoResolver& resolver() const { return resolver_; }
+
+  uint64_t cookie() const { return cookie_; }
+
+ private:
+  const uint32_t device_id_;
+  const ::p4::config::v1::P4Info p4info_;
+  const P4InfoResolver resolver_;
+  const uint64_t cookie_;
+};
+
+// Caches the P4Info of the forwarding pipeline of a session's device,
+// so the API functions do not have to fetch and parse it on every call.
+// Each session has its own (see OvsP4rtSession::P4Info()), so a new
+// session (e.g., after infrap4d restarts) fetches the P4Info again.
+//
+// The snapshot is shared and reference-counted. It is revalidated with
+// a COOKIE_ONLY GetForwardingPipelineConfig request when the
+// revalidation interval has elapsed, and is replaced atomically if the
+// cookie has changed. Threads that find another thread revalidating
+// continue to use the current snapshot instead of waiting.
+//
+// A pipeline pushed without a cookie can only be revalidated by
+// fetching the whole P4Info and comparing it. The snapshot is kept if
+// it has not changed, and the interval is doubled each time, up to
+// kMaxBackoff times the revalidation interval.
+//
+// If the check fails, the current snapshot is still returned, and the
+// interval is doubled in the same way, so that an unavailable server
+// is not asked on every call.
+class P4InfoCache {
+ public:
+  static constexpr int kMaxBackoff = 32;
+
+  // Fetches the P4Info with the stub, which must outlive the cache.
+  P4InfoCache(::p4::v1::P4Runtime::Stub& stub, uint32_t device_id)
+      : stub_(stub), device_id_(device_id) {}
+
+  // Disable copy semantics.
+  P4InfoCache(const P4InfoCache&) = delete;
+  P4InfoCache& operator=(const P4InfoCache&) = delete;
+
+  // Returns the current P4Info snapshot.
+  ::absl::StatusOr<std::shared_ptr<const P4InfoSnapshot>> GetSnapshot();
+
+  // Discards the current snapshot. The next request fetches the P4Info
+  // from the server.
+  void Invalidate();
+
+  // Returns the number of times the full P4Info has been fetched.
+  uint64_t FetchCount() const {
+    return fetch_count_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // Returns true if the snapshot may be used without revalidation.
+  bool IsFresh() const;
+
+  // Revalidates the current snapshot and sets the time of the next
+  // revalidation. Called with revalidate_mutex_ held.
+  ::absl::Status Revalidate();
+
+  // Replaces the current snapshot if the pipeline has changed, and
+  // adjusts the backoff. Called with revalidate_mutex_ held.
+  ::absl::Status CheckPipeline();
+
+  ::p4::v1::P4Runtime::Stub& stub_;
+  const uint32_t device_id_;
+
+  // Current snapshot. Accessed with std::atomic_load/atomic_store.
+  std::shared_ptr<const P4InfoSnapshot> snapshot_;
+
+  // Time (in nanoseconds) after which the snapshot must be revalidated.
+  std::atomic<int64_t> revalidate_after_ns_{0};
+
+  // Multiple of the revalidation interval to wait before the next
+  // revalidation. Guarded by revalidate_mutex_.
+  int backoff_ = 1;
+
+  std::atomic<uint64_t> fetch_count_{0};
+
+  // Ensures that only one thread revalidates at a time.
+  std::mutex revalidate_mutex_;
+};
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_P4INFO_CACHE_H_
@@ -0,0 +1,158 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ovsp4rt_p4info_resolver.h"
+
+#include <cinttypes>
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+#include "logging/ovsp4rt_logging.h"
+#include "ovsp4rt_table_template.h"
+
+#if defined(OVSP4RT_STATIC_P4IDS)
+#include "ovsp4rt_p4ids_gen.h"
+#endif
+
+namespace ovsp4rt {
+
+namespace {
+
+constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+void FnvHash(uint64_t& hash, absl::string_view text) {
+  for (unsigned char byte : text) {
+    hash ^= byte;
+    hash *= FNV_PRIME;
+  }
+}
+
+void FnvHash(uint64_t& hash, char kind, uint32_t id, absl::string_view name) {
+  FnvHash(hash, absl::StrCat(absl::string_view(&kind, 1), " ", id, " ", name,
+                             "\n"));
+}
+
+}  // namespace
+
+uint64_t P4InfoFingerprint(const ::p4::config::v1::P4Info& p4info) {
+  uint64_t hash = FNV_OFFSET_BASIS;
+  for (const auto& table : p4info.tables()) {
+    FnvHash(hash, 'T', table.preamble().id(), table.preamble().name());
+    for (const auto& mf : table.match_fields()) {
+      FnvHash(hash, 'F', mf.id(), mf.name());
+    }
+  }
+  for (const auto& action : p4info.actions()) {
+    FnvHash(hash, 'A', action.preamble().id(), action.preamble().name());
+    for (const auto& param : action.params()) {
+      FnvHash(hash, 'P', param.id(), param.name());
+    }
+  }
+  return hash;
+}
+
+P4InfoResolver::P4InfoResolver(const ::p4::config::v1::P4Info& p4info) {
+  tables_.reserve(p4info.tables_size());
+  table_index_.reserve(p4info.tables_size());
+  for (const auto& table : p4info.tables()) {
+    TableInfo info;
+    info.id = table.preamble().id();
+    info.idle_timeout_notify =
+        table.idle_timeout_behavior() ==
+        ::p4::config::v1::Table::NOTIFY_CONTROL;
+    info.match_fields.begin = fields_.size();
+    for (const auto& mf : table.match_fields()) {
+      fields_.push_back({mf.name(), static_cast<int>(mf.id())});
+    }
+    info.match_fields.end = fields_.size();
+    table_index_[table.preamble().name()] = tables_.size();
+    tables_.push_back(std::move(info));
+  }
+
+  actions_.reserve(p4info.actions_size());
+  action_index_.reserve(p4info.actions_size());
+  for (const auto& action : p4info.actions()) {
+    ActionInfo info;
+    info.id = action.preamble().id();
+    info.params.begin = params_.size();
+    for (const auto& param : action.params()) {
+      params_.push_back({param.name(), static_cast<int>(param.id())});
+    }
+    info.params.end = params_.size();
+    action_index_[action.preamble().name()] = actions_.size();
+    actions_.push_back(std::move(info));
+  }
+
+  fingerprint_ = P4InfoFingerprint(p4info);
+
+  const auto& descriptors = TableDescriptor::Registry();
+  templates_.reserve(descriptors.size());
+  for (const auto* desc : descriptors) {
+    templates_.emplace_back(*this, *desc);
+  }
+
+#if defined(OVSP4RT_STATIC_P4IDS)
+  static_ids_valid_ = (fingerprint_ == p4ids::kFingerprint);
+  if (!static_ids_valid_) {
+    ovsp4rt_log_warn("P4Info fingerprint %016" PRIx64
+                     " does not match compile-time IDs (%016" PRIx64
+                     "); resolving P4 object IDs at runtime",
+                     fingerprint_, p4ids::kFingerprint);
+  }
+#endif
+}
+
+P4InfoResolver::~P4InfoResolver() = default;
+
+const TableTemplate& P4InfoResolver::GetTemplate(
+    const TableDescriptor& desc) const {
+  return templates_[desc.index()];
+}
+
+template <typename Info>
+const Info* P4InfoResolver::FindByName(const std::vector<Info>& infos,
+                                       const NameIndex& index,
+                                       absl::string_view name) {
+  auto iter = index.find(name);
+  return (iter != index.end()) ? &infos[iter->second] : nullptr;
+}
+
+int P4InfoResolver::FindId(const std::vector<NamedId>& ids, Range range,
+                           absl::string_view name) {
+  for (uint32_t i = range.begin; i < range.end; i++) {
+    if (ids[i].name == name) return ids[i].id;
+  }
+  return -1;
+}
+
+int P4InfoResolver::GetTableId(absl::string_view table_name) const {
+  const auto* info = FindByName(tables_, table_index_, table_name);
+  return info ? info->id : -1;
+}
+
+int P4InfoResolver::GetActionId(absl::string_view action_name) const {
+  const auto* info = FindByName(actions_, action_index_, action_name);
+  return info ? info->id : -1;
+}
+
+int P4InfoResolver::GetMatchFieldId(absl::string_view table_name,
+                                    absl::string_view mf_name) const {
+  const auto* info = FindByName(tables_, table_index_, table_name);
+  if (!info) return -1;
+  return FindId(fields_, info->match_fields, mf_name);
+}
+
+int P4InfoResolver::GetParamId(absl::string_view action_name,
+                               absl::string_view param_name) const {
+  const auto* info = FindByName(actions_, action_index_, action_name);
+  if (!info) return -1;
+  return FindId(params_, info->params, param_name);
+}
+
+bool P4InfoResolver::SupportsIdleTimeout(absl::string_view table_name) const {
+  const auto* info = FindByName(tables_, table_index_, table_name);
+  return info && info->idle_timeout_notify;
+}
+
+}  // namespace ovsp4rt
@@ -0,0 +1,166 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_P4INFO_RESOLVER_H_
+#define OVSP4RT_P4INFO_RESOLVER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "p4/config/v1/p4info.pb.h"
+
+namespace ovsp4rt {
+
+class TableDescriptor;
+class TableTemplate;
+
+// Resolves P4 object names to IDs.
+//
+// The resolver is built once per P4Info. Tables and actions are kept
+// in dense arrays in P4Info order, and found by name through a hash
+// map of their positions. The match fields of all tables (and the
+// parameters of all actions) share one array, in which each table owns
+// a contiguous range.
+//
+// The lookup functions return -1 if the name is not found.
+//
+// The resolver also builds a TableTemplate for each registered
+// TableDescriptor, so the Prepare functions can fill in a prebuilt
+// table entry instead of resolving each ID.
+//
+// If libovsp4rt was built with compile-time P4 object IDs
+// (OVSP4RT_STATIC_P4IDS), the resolver also determines whether the
+// P4Info is the one the IDs were generated from.
+class P4InfoResolver {
+ public:
+  explicit P4InfoResolver(const ::p4::config::v1::P4Info& p4info);
+  ~P4InfoResolver();
+
+  // Disable copy semantics.
+  P4InfoResolver(const P4InfoResolver&) = delete;
+  P4InfoResolver& operator=(const P4InfoResolver&) = delete;
+
+  int GetTableId(absl::string_view table_name) const;
+
+  int GetActionId(absl::string_view action_name) const;
+
+  int GetMatchFieldId(absl::string_view table_name,
+                      absl::string_view mf_name) const;
+
+  int GetParamId(absl::string_view action_name,
+                 absl::string_view param_name) const;
+
+  // Returns true if the switch notifies the controller when entries
+  // of the table time out (see TableEntry::idle_timeout_ns).
+  bool SupportsIdleTimeout(absl::string_view table_name) const;
+
+  // Returns the template for a table descriptor.
+  const TableTemplate& GetTemplate(const TableDescriptor& desc) const;
+
+  // Returns the fingerprint of the P4Info.
+  uint64_t fingerprint() const { return fingerprint_; }
+
+  // Returns true if the compile-time P4 object IDs are valid for this
+  // P4Info.
+  bool static_ids_valid() const { return static_ids_valid_; }
+
+  size_t num_tables() const { return tables_.size(); }
+
+  size_t num_actions() const { return actions_.size(); }
+
+ private:
+  // A P4 object name and its ID.
+  struct NamedId {
+    std::string name;
+    int id;
+  };
+
+  // Range of a table's match fields or an action's parameters in
+  // fields_ or params_.
+  struct Range {
+    uint32_t begin;
+    uint32_t end;
+  };
+
+  struct TableInfo {
+    int id;
+    bool idle_timeout_notify;
+    Range match_fields;
+  };
+
+  struct ActionInfo {
+    int id;
+    Range params;
+  };
+
+  // Position of each table or action in tables_ or actions_, by name.
+  using NameIndex = absl::flat_hash_map<std::string, uint32_t>;
+
+  // Returns the element of a vector with the given name, or nullptr.
+  template <typename Info>
+  static const Info* FindByName(const std::vector<Info>& infos,
+                                const NameIndex& index,
+                                absl::string_view name);
+
+  // Returns the ID of the object in the range with the given name, or
+  // -1.
+  static int FindId(const std::vector<NamedId>& ids, Range range,
+                    absl::string_view name);
+
+  // In P4Info order.
+  std::vector<TableInfo> tables_;
+  std::vector<ActionInfo> actions_;
+
+  NameIndex table_index_;
+  NameIndex action_index_;
+
+  // Indexed by TableInfo::match_fields and ActionInfo::params.
+  std::vector<NamedId> fields_;
+  std::vector<NamedId> params_;
+
+  // Indexed by TableDescriptor::index().
+  std::vector<TableTemplate> templates_;
+
+  uint64_t fingerprint_;
+  bool static_ids_valid_ = false;
+};
+
+// Computes a 64-bit fingerprint of the names and IDs of the tables,
+// match fields, actions and action parameters in a P4Info. Must match
+// compute_fingerprint() in p4ids/mkp4idshdr.py.
+extern uint64_t P4InfoFingerprint(const ::p4::config::v1::P4Info& p4info);
+
+//----------------------------------------------------------------------
+// Lookup functions
+//
+// Free-function forms of the resolver methods, used by the Prepare
+// functions.
+//----------------------------------------------------------------------
+
+inline int GetTableId(const P4InfoResolver& p4info,
+                      absl::string_view t_name) {
+  return p4info.GetTableId(t_name);
+}
+
+inline int GetActionId(const P4InfoResolver& p4info,
+                       absl::string_view a_name) {
+  return p4info.GetActionId(a_name);
+}
+
+inline int GetParamId(const P4InfoResolver& p4info, absl::string_view a_name,
+                      absl::string_view param_name) {
+  return p4info.GetParamId(a_name, param_name);
+}
+
+inline int GetMatchFieldId(const P4InfoResolver& p4info,
+                           absl::string_view t_name,
+                           absl::string_view mf_name) {
+  return p4info.GetMatchFieldId(t_name, mf_name);
+}
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_P4INFO_RESOLVER_H_
@@ -0,0 +1,91 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ovsp4rt_request_arena.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+
+namespace ovsp4rt {
+
+namespace {
+
+std::atomic<uint64_t> scopes{0};
+std::atomic<uint64_t> blocks_allocated{0};
+std::atomic<uint64_t> bytes_allocated{0};
+std::atomic<uint64_t> max_bytes_used{0};
+
+// Allocates an arena block that does not fit in the first block.
+void* AllocBlock(size_t size) {
+  blocks_allocated.fetch_add(1, std::memory_order_relaxed);
+  bytes_allocated.fetch_add(size, std::memory_order_relaxed);
+  return ::operator new(size);
+}
+
+void DeallocBlock(void* block, size_t size) { ::operator delete(block); }
+
+// The arena of a thread, and the number of scopes it is in.
+struct ThreadArena {
+  ThreadArena()
+      : initial_block(new char[RequestArena::kInitialBlockSize]),
+        arena(MakeOptions(initial_block.get())) {}
+
+  static ::google::protobuf::ArenaOptions MakeOptions(char* block) {
+    ::google::protobuf::ArenaOptions options;
+    options.initial_block = block;
+    options.initial_block_size = RequestArena::kInitialBlockSize;
+    options.block_alloc = AllocBlock;
+    options.block_dealloc = DeallocBlock;
+    return options;
+  }
+
+  // Declared first, so that it outlives the arena.
+  std::unique_ptr<char[]> initial_block;
+  ::google::protobuf::Arena arena;
+  int depth = 0;
+};
+
+ThreadArena& GetThreadArena() {
+  static thread_local ThreadArena thread_arena;
+  return thread_arena;
+}
+
+}  // namespace
+
+RequestArena::RequestArena() {
+  auto& thread_arena = GetThreadArena();
+  ++thread_arena.depth;
+  arena_ = &thread_arena.arena;
+}
+
+RequestArena::~RequestArena() {
+  auto& thread_arena = GetThreadArena();
+  if (--thread_arena.depth > 0) {
+    return;
+  }
+
+  uint64_t used = arena_->SpaceUsed();
+  uint64_t max_used = max_bytes_used.load(std::memory_order_relaxed);
+  while (used > max_used &&
+         !max_bytes_used.compare_exchange_weak(max_used, used,
+                                               std::memory_order_relaxed)) {
+  }
+  scopes.fetch_add(1, std::memory_order_relaxed);
+
+  // Frees the blocks beyond the first, and runs the destructors of
+  // any objects that registered one.
+  arena_->Reset();
+}
+
+RequestArena::Stats RequestArena::GetStats() {
+  Stats stats;
+  stats.scopes = scopes.load(std::memory_order_relaxed);
+  stats.blocks_allocated = blocks_allocated.load(std::memory_order_relaxed);
+  stats.bytes_allocated = bytes_allocated.load(std::memory_order_relaxed);
+  stats.max_bytes_used = max_bytes_used.load(std::memory_order_relaxed);
+  return stats;
+}
+
+}  // namespace ovsp4rt
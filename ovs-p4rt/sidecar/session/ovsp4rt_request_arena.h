@@ -0,0 +1,59 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_REQUEST_ARENA_H_
+#define OVSP4RT_REQUEST_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "google/protobuf/arena.h"
+
+namespace ovsp4rt {
+
+// Scope in which P4Runtime requests are built on a per-thread protobuf
+// arena instead of the heap.
+//
+// Each thread has one arena, whose first block is allocated once and
+// kept. Messages created in a scope live until the outermost scope on
+// the thread ends, at which point the arena is reset. A request that
+// fits in the first block is therefore built without calling malloc.
+// Messages must not be passed to another thread, or kept after the
+// scope ends.
+class RequestArena {
+ public:
+  // Size of each thread's first arena block.
+  static constexpr size_t kInitialBlockSize = 64 * 1024;
+
+  struct Stats {
+    uint64_t scopes;          // outermost scopes that have ended
+    uint64_t blocks_allocated;  // blocks allocated beyond the first
+    uint64_t bytes_allocated;   // bytes allocated beyond the first block
+    uint64_t max_bytes_used;  // largest space used by one scope
+  };
+
+  RequestArena();
+  ~RequestArena();
+
+  // Disable copy semantics.
+  RequestArena(const RequestArena&) = delete;
+  RequestArena& operator=(const RequestArena&) = delete;
+
+  // Creates a message on the arena.
+  template <typename T>
+  T* Create() {
+    return ::google::protobuf::Arena::CreateMessage<T>(arena_);
+  }
+
+  ::google::protobuf::Arena* arena() const { return arena_; }
+
+  // Returns the counters of all threads' arenas.
+  static Stats GetStats();
+
+ private:
+  ::google::protobuf::Arena* arena_;
+};
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_REQUEST_ARENA_H_
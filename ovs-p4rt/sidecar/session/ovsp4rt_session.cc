@@ -6,13 +6,25 @@
 #include "ovsp4rt_session.h"
 
 #include <string>
+#include <vector>
 
+#include "absl/flags/flag.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "google/protobuf/arena.h"
+#include "google/rpc/status.pb.h"
 #include "grpcpp/channel.h"
 #include "grpcpp/create_channel.h"
+#include "journal/ovsp4rt_journal.h"
+#include "ovsp4rt_epoch_audit.h"
+#include "ovsp4rt_fdb_aging.h"
+#include "ovsp4rt_p4info_cache.h"
+#include "ovsp4rt_shadow_table.h"
+#include "ovsp4rt_vsi_port_map.h"
 #include "p4/v1/p4runtime.grpc.pb.h"
 #include "p4/v1/p4runtime.pb.h"
+#include "stats/ovsp4rt_probes.h"
+#include "stats/ovsp4rt_stats.h"
 #include "stratum/glue/status/status.h"
 #include "stratum/glue/status/status_macros.h"
 #include "stratum/lib/utils.h"
@@ -22,9 +34,17 @@
 #define DEFAULT_OVS_P4RT_ROLE_CONFIG_FILE \
   "/usr/share/stratum/ovs_p4rt_role_config.pb.txt"
 
+ABSL_FLAG(int32_t, max_writes_in_flight, 4,
+          "Maximum number of batched Write RPCs each writer (e.g., each "
+          "asynchronous shard) has outstanding at once.");
+ABSL_FLAG(int32_t, write_timeout_ms, 0,
+          "Deadline for each Write RPC, in milliseconds. Zero means no "
+          "deadline.");
+
 namespace ovsp4rt {
 
 using ::p4::config::v1::P4Info;
+using ::p4::v1::Entity;
 using ::p4::v1::GetForwardingPipelineConfigRequest;
 using ::p4::v1::GetForwardingPipelineConfigResponse;
 using ::p4::v1::P4Runtime;
@@ -65,6 +85,8 @@ std::unique_ptr<P4Runtime::Stub> CreateP4RuntimeStub(
 absl::StatusOr<std::unique_ptr<OvsP4rtSession>> OvsP4rtSession::Create(
     std::unique_ptr<P4Runtime::Stub> stub, uint32_t device_id,
     const std::string& role_name, absl::uint128 election_id) {
+  ScopedLatency latency(OVSP4RT_LATENCY_SESSION_CREATE);
+
   std::unique_ptr<OvsP4rtSession> session = absl::WrapUnique(
       new OvsP4rtSession(device_id, role_name, std::move(stub), election_id));
 
@@ -104,6 +126,11 @@ absl::StatusOr<std::unique_ptr<OvsP4rtSession>> OvsP4rtSession::Create(
     return ::absl::InternalError("Received device id doesn't match");
   }
 
+  // Hand the stream channel over to the reader thread, which keeps it
+  // open and tracks mastership changes for the life of the session.
+  session->HandleStreamMessage(response);
+  session->StartStreamReader();
+
   return std::move(session);
 }
 
@@ -114,71 +141,316 @@ absl::StatusOr<std::unique_ptr<OvsP4rtSession>> OvsP4rtSession::Create(
     const std::shared_ptr<grpc::ChannelCredentials>& credentials,
     uint32_t device_id, const std::string& role_name,
     absl::uint128 election_id) {
-  /* OVS spawns multiple revalidator threads and handler threads to handle
-   * datapath Notifications.
-   * When multiple L2 MAC's are learnt at the same time, the learn information
-   * can come from revlidator thread or handler thread. On a worst case
-   * scenario, both the threads will call OvsP4rtSession::Create exactly at
-   * the same time and both threads can get same election_id based on API
-   * TimeBasedElectionId(). This causes one of the threads to get stuck and
-   * no further data path information is received by the thread.
-   * To avoid this issue, we add Thread ID to the election ID to generate an
-   * unique election_id, even when two threads receive MAC learn at the same
-   * time.
-   */
-  election_id = election_id + (absl::uint128)pthread_self();
-  return Create(CreateP4RuntimeStub(address, credentials), device_id, role_name,
-                election_id);
+  OVSP4RT_PROBE1(session__create__entry, device_id);
+  auto status_or_session =
+      Create(CreateP4RuntimeStub(address, credentials), device_id, role_name,
+             election_id);
+  OVSP4RT_PROBE1(session__create__return,
+                 static_cast<int>(status_or_session.status().code()));
+  return status_or_session;
+}
+
+OvsP4rtSession::OvsP4rtSession(uint32_t device_id, std::string role_name,
+                               std::unique_ptr<P4Runtime::Stub> stub,
+                               absl::uint128 election_id)
+    : session_id_(NextSessionId()),
+      device_id_(device_id),
+      role_name_(std::move(role_name)),
+      stub_(std::move(stub)),
+      stream_channel_context_(absl::make_unique<grpc::ClientContext>()),
+      stream_channel_(stub_->StreamChannel(stream_channel_context_.get())),
+      shadow_(std::make_unique<ShadowTable>()),
+      p4info_(std::make_unique<P4InfoCache>(*stub_, device_id)),
+      vsi_ports_(std::make_unique<VsiPortMap>()) {
+  election_id_.set_high(absl::Uint128High64(election_id));
+  election_id_.set_low(absl::Uint128Low64(election_id));
+}
+
+uint64_t OvsP4rtSession::NextSessionId() {
+  static std::atomic<uint64_t> next_session_id{1};
+  return next_session_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+AsyncWriteChannel& OvsP4rtSession::AsyncWrites() {
+  std::call_once(async_writes_once_, [this]() {
+    async_writes_ = std::make_unique<AsyncWriteChannel>(
+        *stub_,
+        [this](const WriteRequest& write_request,
+               const std::vector<absl::Status>& update_status) {
+          RecordWrite(write_request, update_status);
+        },
+        absl::GetFlag(FLAGS_max_writes_in_flight), WriteTimeout(),
+        /*retry_failed_updates=*/true);
+  });
+  return *async_writes_;
+}
+
+void OvsP4rtSession::RecordWrite(
+    const WriteRequest& write_request,
+    const std::vector<absl::Status>& update_status) {
+  shadow_->RecordWrite(write_request, update_status);
+  EpochAudit::Instance().RecordWrite(session_id_, write_request,
+                                     update_status);
+}
+
+OvsP4rtSession::~OvsP4rtSession() {
+  Close();
+  // Close() does not join the reader thread from the reader thread
+  // itself, e.g., when a stream callback drops the last reference.
+  // Destroying a joinable thread would terminate the process.
+  if (stream_reader_.joinable()) {
+    stream_reader_.detach();
+  }
+}
+
+void OvsP4rtSession::Close() {
+  std::lock_guard<std::mutex> lock(close_mutex_);
+  stream_channel_context_->TryCancel();
+  // The reader thread may close the session itself, e.g., from an
+  // idle timeout callback.
+  if (stream_reader_.joinable() &&
+      stream_reader_.get_id() != std::this_thread::get_id()) {
+    stream_reader_.join();
+  }
+  connected_.store(false, std::memory_order_release);
+  primary_.store(false, std::memory_order_release);
+}
+
+void OvsP4rtSession::HandleStreamMessage(
+    const p4::v1::StreamMessageResponse& response) {
+  switch (response.update_case()) {
+    case p4::v1::StreamMessageResponse::kArbitration:
+      // The server sends an arbitration update whenever the primary
+      // client for our role changes. An OK status means we are primary.
+      primary_.store(response.arbitration().status().code() == grpc::OK,
+                     std::memory_order_release);
+      break;
+    case p4::v1::StreamMessageResponse::kIdleTimeoutNotification:
+      FdbAging::Instance().HandleNotification(
+          this, response.idle_timeout_notification());
+      break;
+    default:
+      break;
+  }
+}
+
+void OvsP4rtSession::StartStreamReader() {
+  connected_.store(true, std::memory_order_release);
+  stream_reader_ = std::thread(&OvsP4rtSession::ReadStreamChannel, this);
+}
+
+void OvsP4rtSession::ReadStreamChannel() {
+  p4::v1::StreamMessageResponse response;
+  while (stream_channel_->Read(&response)) {
+    HandleStreamMessage(response);
+  }
+  connected_.store(false, std::memory_order_release);
+  primary_.store(false, std::memory_order_release);
+  stream_channel_->Finish().IgnoreError();
 }
 
 absl::Status GetForwardingPipelineConfig(OvsP4rtSession* session,
                                          p4::config::v1::P4Info* p4info) {
+  uint64_t cookie;
+  return GetForwardingPipelineConfig(session, p4info, &cookie);
+}
+
+absl::Status GetForwardingPipelineConfig(OvsP4rtSession* session,
+                                         p4::config::v1::P4Info* p4info,
+                                         uint64_t* cookie) {
+  return GetForwardingPipelineConfig(session->Stub(), session->DeviceId(),
+                                     p4info, cookie);
+}
+
+absl::Status GetForwardingPipelineConfig(P4Runtime::Stub& stub,
+                                         uint32_t device_id,
+                                         p4::config::v1::P4Info* p4info,
+                                         uint64_t* cookie) {
+  ScopedLatency latency(OVSP4RT_LATENCY_PIPELINE_FETCH);
+
   GetForwardingPipelineConfigRequest request;
-  request.set_device_id(session->DeviceId());
+  request.set_device_id(device_id);
   request.set_response_type(
       GetForwardingPipelineConfigRequest::P4INFO_AND_COOKIE);
 
+  OVSP4RT_PROBE1(pipeline__fetch__entry, device_id);
   GetForwardingPipelineConfigResponse response;
   grpc::ClientContext context;
-  absl::Status status =
-      GrpcStatusToAbslStatus(session->Stub().GetForwardingPipelineConfig(
-          &context, request, &response));
+  absl::Status status = GrpcStatusToAbslStatus(
+      stub.GetForwardingPipelineConfig(&context, request, &response));
+  OVSP4RT_PROBE1(pipeline__fetch__return, static_cast<int>(status.code()));
+  if (!status.ok()) {
+    return status;
+  }
 
   *p4info = response.config().p4info();
+  *cookie = response.config().cookie().cookie();
+
+  return absl::OkStatus();
+}
+
+absl::Status GetForwardingPipelineCookie(OvsP4rtSession* session,
+                                         uint64_t* cookie) {
+  return GetForwardingPipelineCookie(session->Stub(), session->DeviceId(),
+                                     cookie);
+}
+
+absl::Status GetForwardingPipelineCookie(P4Runtime::Stub& stub,
+                                         uint32_t device_id,
+                                         uint64_t* cookie) {
+  GetForwardingPipelineConfigRequest request;
+  request.set_device_id(device_id);
+  request.set_response_type(GetForwardingPipelineConfigRequest::COOKIE_ONLY);
+
+  GetForwardingPipelineConfigResponse response;
+  grpc::ClientContext context;
+  absl::Status status = GrpcStatusToAbslStatus(
+      stub.GetForwardingPipelineConfig(&context, request, &response));
+  if (!status.ok()) {
+    return status;
+  }
+
+  *cookie = response.config().cookie().cookie();
 
   return absl::OkStatus();
 }
 
 absl::StatusOr<ReadResponse> SendReadRequest(OvsP4rtSession* session,
                                              const ReadRequest& read_request) {
+  ReadResponse response;
+  auto status =
+      ReadEntities(session, read_request, [&response](const Entity& entity) {
+        *response.add_entities() = entity;
+        return true;
+      });
+  if (!status.ok()) {
+    return status;
+  }
+
+  return std::move(response);
+}
+
+absl::Status ReadEntities(OvsP4rtSession* session,
+                          const ReadRequest& read_request,
+                          const EntityVisitor& visitor) {
+  return ReadEntities(session->Stub(), read_request, visitor);
+}
+
+absl::Status ReadEntities(P4Runtime::Stub& stub,
+                          const ReadRequest& read_request,
+                          const EntityVisitor& visitor) {
+  ScopedLatency latency(OVSP4RT_LATENCY_READ_RPC);
+  OVSP4RT_PROBE1(read__entry, read_request.entities_size());
+
   grpc::ClientContext context;
-  auto reader = session->Stub().Read(&context, read_request);
+  auto reader = stub.Read(&context, read_request);
 
-  ReadResponse response;
-  ReadResponse partial_response;
-  while (reader->Read(&partial_response)) {
-    response.MergeFrom(partial_response);
+  // Each message in the stream is parsed into the same arena-backed
+  // response, which reuses the memory of the previous one.
+  google::protobuf::Arena arena;
+  auto* response = google::protobuf::Arena::CreateMessage<ReadResponse>(&arena);
+
+  bool stopped = false;
+  while (!stopped && reader->Read(response)) {
+    for (const auto& entity : response->entities()) {
+      if (!visitor(entity)) {
+        stopped = true;
+        break;
+      }
+    }
   }
 
-  grpc::Status reader_status = reader->Finish();
-  if (!reader_status.ok()) {
-    return GrpcStatusToAbslStatus(reader_status);
+  if (stopped) {
+    // Tell the server to stop sending, and discard the rest.
+    context.TryCancel();
+    reader->Finish().IgnoreError();
+    OVSP4RT_PROBE1(read__return, 0);
+    return absl::OkStatus();
   }
 
-  return std::move(response);
+  auto status = GrpcStatusToAbslStatus(reader->Finish());
+  OVSP4RT_PROBE1(read__return, static_cast<int>(status.code()));
+  return status;
 }
 
 absl::Status SendWriteRequest(OvsP4rtSession* session,
                               const WriteRequest& write_request) {
+  std::vector<absl::Status> update_status;
+  return SendWriteRequest(session, write_request, &update_status);
+}
+
+absl::Duration WriteTimeout() {
+  return absl::Milliseconds(absl::GetFlag(FLAGS_write_timeout_ms));
+}
+
+absl::Status SendWriteRequest(OvsP4rtSession* session,
+                              const WriteRequest& write_request,
+                              std::vector<absl::Status>* update_status) {
   grpc::ClientContext context;
   WriteResponse response;
 
+  absl::Duration timeout = WriteTimeout();
+  if (timeout > absl::ZeroDuration()) {
+    context.set_deadline(absl::ToChronoTime(absl::Now() + timeout));
+  }
+
+  if (auto* journal = Journal::Current()) {
+    journal->recordOutput(__func__, write_request);
+  }
+
+  OVSP4RT_PROBE1(write__entry, write_request.updates_size());
+  uint64_t start_ns = Stats::NowNs();
   ::grpc::Status status =
       session->Stub().Write(&context, write_request, &response);
+  Stats::Instance().RecordLatency(OVSP4RT_LATENCY_WRITE_RPC,
+                                  Stats::NowNs() - start_ns);
+  OVSP4RT_PROBE1(write__return, static_cast<int>(status.error_code()));
+
+  *update_status = GetUpdateStatus(status, write_request.updates_size());
+  session->RecordWrite(write_request, *update_status);
 
   return GrpcStatusToAbslStatus(status);
 }
 
+std::vector<absl::Status> GetUpdateStatus(const grpc::Status& status,
+                                          int num_updates) {
+  std::vector<absl::Status> update_status;
+  ParseUpdateStatus(status, num_updates, &update_status);
+  return update_status;
+}
+
+bool ParseUpdateStatus(const grpc::Status& status, int num_updates,
+                       std::vector<absl::Status>* update_status) {
+  update_status->clear();
+  if (status.ok()) {
+    update_status->resize(num_updates);
+    return true;
+  }
+
+  // A failed batch carries a google.rpc.Status whose details hold one
+  // p4.v1.Error per update, including the ones that succeeded.
+  google::rpc::Status details;
+  if (status.error_details().empty() ||
+      !details.ParseFromString(status.error_details()) ||
+      details.details_size() != num_updates) {
+    update_status->assign(num_updates, GrpcStatusToAbslStatus(status));
+    return false;
+  }
+
+  update_status->reserve(num_updates);
+  for (const auto& detail : details.details()) {
+    ::p4::v1::Error error;
+    if (!detail.UnpackTo(&error)) {
+      update_status->push_back(GrpcStatusToAbslStatus(status));
+      continue;
+    }
+    update_status->emplace_back(
+        static_cast<absl::StatusCode>(error.canonical_code()),
+        error.message());
+  }
+  return true;
+}
+
 ::p4::v1::TableEntry* SetupTableEntryToRead(OvsP4rtSession* session,
                                             ::p4::v1::ReadRequest* req) {
   req->set_device_id(session->DeviceId());
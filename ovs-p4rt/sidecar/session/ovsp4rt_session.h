@@ -8,20 +8,31 @@
 
 #include <grpcpp/grpcpp.h>
 
+#include <atomic>
+#include <cstdint>
 #include <fstream>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "ovsp4rt_async_write_channel.h"
 #include "p4/v1/p4runtime.grpc.pb.h"
 #include "p4/v1/p4runtime.pb.h"
 
 namespace ovsp4rt {
 
+class P4InfoCache;
+class ShadowTable;
+class VsiPortMap;
+
 // Generates an election id that increases monotonically over time.
 // Specifically, the upper 64 bits are the unix timestamp in seconds, and the
 // lower 64 bits are 0. This is compatible with election systems that use the
@@ -48,14 +59,20 @@ class OvsP4rtSession {
       uint32_t device_id, const std::string& role_name,
       ::absl::uint128 election_id = TimeBasedElectionId());
 
-  // Disable copy semantics.
+  // Closes the stream channel and waits for the reader thread to exit.
+  ~OvsP4rtSession();
+
+  // Closes the stream channel, giving up mastership, and waits for the
+  // reader thread to exit. The session is no longer connected or
+  // primary, but the stub remains usable until the session is
+  // destroyed. May be called more than once.
+  void Close();
+
+  // Disable copy and move semantics. The stream reader thread holds a
+  // pointer to the session.
   OvsP4rtSession(const OvsP4rtSession&) = delete;
   OvsP4rtSession& operator=(const OvsP4rtSession&) = delete;
 
-  // Allow move semantics.
-  OvsP4rtSession(OvsP4rtSession&&) = default;
-  OvsP4rtSession& operator=(OvsP4rtSession&&) = default;
-
   uint32_t DeviceId() const { return device_id_; }
 
   std::string RoleName() const { return role_name_; }
@@ -64,17 +81,60 @@ class OvsP4rtSession {
 
   p4::v1::P4Runtime::Stub& Stub() { return *stub_; }
 
+  // Returns the channel for sending several WriteRequests at once,
+  // creating it on first use.
+  AsyncWriteChannel& AsyncWrites();
+
+  // Returns the mirror of the entries programmed in this session.
+  ShadowTable& Shadow() { return *shadow_; }
+
+  // Returns the cache of the P4Info of this session's device.
+  P4InfoCache& P4Info() { return *p4info_; }
+
+  // Returns the cache of the VSI-to-host-port mappings read in this
+  // session.
+  VsiPortMap& VsiPorts() { return *vsi_ports_; }
+
+  // Records the result of a Write RPC sent in this session, in the
+  // shadow table and the epoch audit.
+  void RecordWrite(const p4::v1::WriteRequest& write_request,
+                   const std::vector<::absl::Status>& update_status);
+
+  // Returns an identifier that is unique to this session within the
+  // process. A new session (e.g., after a reconnect) has a new ID.
+  uint64_t SessionId() const { return session_id_; }
+
+  // Returns true if the stream channel is still open. A session whose
+  // stream channel has closed must be replaced.
+  bool IsConnected() const {
+    return connected_.load(std::memory_order_acquire);
+  }
+
+  // Returns true if the server has told us we are the primary client
+  // for our role.
+  bool IsPrimary() const {
+    return primary_.load(std::memory_order_acquire);
+  }
+
  private:
   OvsP4rtSession(uint32_t device_id, std::string role_name,
                  std::unique_ptr<p4::v1::P4Runtime::Stub> stub,
-                 ::absl::uint128 election_id)
-      : device_id_(device_id),
-        stub_(std::move(stub)),
-        stream_channel_context_(::absl::make_unique<grpc::ClientContext>()),
-        stream_channel_(stub_->StreamChannel(stream_channel_context_.get())) {
-    election_id_.set_high(::absl::Uint128High64(election_id));
-    election_id_.set_low(::absl::Uint128Low64(election_id));
-  }
+                 ::absl::uint128 election_id);
+
+  // Returns the next session ID.
+  static uint64_t NextSessionId();
+
+  // Processes a message received on the stream channel.
+  void HandleStreamMessage(const p4::v1::StreamMessageResponse& response);
+
+  // Starts the thread that services the stream channel.
+  void StartStreamReader();
+
+  // Body of the stream reader thread. Runs until the stream channel
+  // is closed by either side.
+  void ReadStreamChannel();
+
+  uint64_t session_id_;
 
   uint32_t device_id_;
 
@@ -89,23 +149,110 @@ class OvsP4rtSession {
   std::unique_ptr<grpc::ClientReaderWriter<p4::v1::StreamMessageRequest,
                                            p4::v1::StreamMessageResponse>>
       stream_channel_;
+
+  // Services the stream channel after arbitration.
+  std::thread stream_reader_;
+
+  // Serializes Close().
+  std::mutex close_mutex_;
+
+  std::atomic<bool> connected_{false};
+
+  std::atomic<bool> primary_{false};
+
+  std::unique_ptr<ShadowTable> shadow_;
+
+  // Fetches the P4Info with stub_, so must be declared after it.
+  std::unique_ptr<P4InfoCache> p4info_;
+
+  std::unique_ptr<VsiPortMap> vsi_ports_;
+
+  // Created on first use. Declared last so that it is destroyed (and
+  // its outstanding writes completed) before the stub.
+  std::once_flag async_writes_once_;
+  std::unique_ptr<AsyncWriteChannel> async_writes_;
 };
 
 std::unique_ptr<p4::v1::P4Runtime::Stub> CreateP4RuntimeStub(
     const std::string& address,
     const std::shared_ptr<grpc::ChannelCredentials>& credentials);
 
+// Converts a gRPC status to an absl::Status.
+::absl::Status GrpcStatusToAbslStatus(const ::grpc::Status& status);
+
+// Returns the deadline for Write RPCs, or zero for no deadline.
+::absl::Duration WriteTimeout();
+
 // Functions that operate on a OvsP4rtSession.
 
 ::absl::StatusOr<p4::v1::ReadResponse> SendReadRequest(
     OvsP4rtSession* session, const p4::v1::ReadRequest& read_request);
 
+// Receives each entity of a read as it arrives. Returns false to stop
+// the read.
+using EntityVisitor = std::function<bool(const p4::v1::Entity& entity)>;
+
+// Sends a ReadRequest and passes each entity in the response stream to
+// the visitor, without accumulating the response. Stopping the read
+// early is not an error.
+::absl::Status ReadEntities(OvsP4rtSession* session,
+                            const p4::v1::ReadRequest& read_request,
+                            const EntityVisitor& visitor);
+
+::absl::Status ReadEntities(p4::v1::P4Runtime::Stub& stub,
+                            const p4::v1::ReadRequest& read_request,
+                            const EntityVisitor& visitor);
+
 ::absl::Status SendWriteRequest(OvsP4rtSession* session,
                                 const p4::v1::WriteRequest& write_request);
 
+// Sends a WriteRequest and returns the status of each update, in the
+// order of the updates in the request.
+//
+// Failed updates are not retried (see RetryFailedUpdates()), unlike
+// on the AsyncWriteChannel. The synchronous callers send one update
+// at a time and act on its status themselves: an INSERT that fails
+// with ALREADY_EXISTS, or a DELETE that fails with NOT_FOUND, tells
+// them the entry was already in place or already gone (see, e.g.,
+// resync). Resending the INSERT as a MODIFY would hide that.
+::absl::Status SendWriteRequest(OvsP4rtSession* session,
+                                const p4::v1::WriteRequest& write_request,
+                                std::vector<::absl::Status>* update_status);
+
+// Extracts the per-update status from the result of a Write RPC.
+// If the server did not supply a p4.v1.Error for each update, every
+// update is given the overall status.
+std::vector<::absl::Status> GetUpdateStatus(const ::grpc::Status& status,
+                                            int num_updates);
+
+// Same as GetUpdateStatus(), but stores the per-update status in
+// update_status. Returns false if the server did not supply a
+// p4.v1.Error for each update of a failed write.
+bool ParseUpdateStatus(const ::grpc::Status& status, int num_updates,
+                       std::vector<::absl::Status>* update_status);
+
 ::absl::Status GetForwardingPipelineConfig(OvsP4rtSession* session,
                                            p4::config::v1::P4Info* p4info);
 
+::absl::Status GetForwardingPipelineConfig(OvsP4rtSession* session,
+                                           p4::config::v1::P4Info* p4info,
+                                           uint64_t* cookie);
+
+// Same as above, but fetches the pipeline with the given stub and
+// device ID.
+::absl::Status GetForwardingPipelineConfig(p4::v1::P4Runtime::Stub& stub,
+                                           uint32_t device_id,
+                                           p4::config::v1::P4Info* p4info,
+                                           uint64_t* cookie);
+
+// Fetches only the cookie that identifies the current pipeline.
+::absl::Status GetForwardingPipelineCookie(OvsP4rtSession* session,
+                                           uint64_t* cookie);
+
+::absl::Status GetForwardingPipelineCookie(p4::v1::P4Runtime::Stub& stub,
+                                           uint32_t device_id,
+                                           uint64_t* cookie);
+
 ::p4::v1::TableEntry* SetupTableEntryToInsert(OvsP4rtSession* session,
                                               ::p4::v1::WriteRequest* req);
 
@@ -0,0 +1,116 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ovsp4rt_session_manager.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "logging/ovsp4rt_logging.h"
+#include "ovsp4rt_credentials.h"
+
+namespace ovsp4rt {
+
+SessionManager& SessionManager::Instance() {
+  // Intentionally leaked, so the sessions and their reader threads are
+  // not torn down by static destructors while OVS is exiting.
+  static SessionManager* instance = new SessionManager(
+      [](const std::string& address, uint32_t device_id,
+         const std::string& role_name, ::absl::uint128 election_id) {
+        return OvsP4rtSession::Create(address, GenerateClientCredentials(),
+                                      device_id, role_name, election_id);
+      });
+  return *instance;
+}
+
+::absl::StatusOr<std::shared_ptr<OvsP4rtSession>> SessionManager::GetSession(
+    const std::string& address, uint32_t device_id,
+    const std::string& role_name) {
+  std::shared_ptr<OvsP4rtSession> stale;
+  ::absl::uint128 election_id;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto& slot = sessions_[SessionKey(address, device_id, role_name)];
+  created_.wait(lock, [&slot]() { return !slot.creating; });
+
+  if (slot.session && slot.session->IsConnected() &&
+      slot.session->IsPrimary()) {
+    return slot.session;
+  }
+
+  // This thread creates the new session. The election ID must increase
+  // across reconnects, even if they happen within the same second.
+  stale = std::move(slot.session);
+  election_id = std::max(TimeBasedElectionId(), slot.election_id + 1);
+  slot.election_id = election_id;
+  slot.creating = true;
+  lock.unlock();
+
+  if (stale) {
+    if (stale->IsConnected()) {
+      ovsp4rt_log_warn("Lost mastership of device %u on %s, reconnecting",
+                       device_id, address.c_str());
+    }
+    // Close the stale session before we open a new one, so the server
+    // sees the old stream close before the new arbitration request.
+    // Threads still holding it see that it is no longer connected.
+    stale->Close();
+    stale.reset();
+  }
+
+  auto status_or_session =
+      factory_(address, device_id, role_name, election_id);
+
+  std::shared_ptr<OvsP4rtSession> session;
+  if (status_or_session.ok()) {
+    session = std::move(status_or_session).value();
+  }
+
+  lock.lock();
+  slot.creating = false;
+  if (session) {
+    slot.session = session;
+    ++sessions_created_;
+  }
+  lock.unlock();
+  created_.notify_all();
+
+  if (!session) {
+    return status_or_session.status();
+  }
+  if (!session->IsPrimary()) {
+    // Another client holds a higher election ID. The next request
+    // tries again with a higher one.
+    return ::absl::PermissionDeniedError(
+        "Not the primary client for device " + std::to_string(device_id) +
+        " on " + address);
+  }
+
+  return session;
+}
+
+uint64_t SessionManager::SessionsCreated() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return sessions_created_;
+}
+
+void SessionManager::Reset() {
+  std::vector<std::shared_ptr<OvsP4rtSession>> sessions;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [key, slot] : sessions_) {
+      if (slot.session) {
+        sessions.push_back(std::move(slot.session));
+      }
+    }
+  }
+
+  for (auto& session : sessions) {
+    session->Close();
+  }
+}
+
+}  // namespace ovsp4rt
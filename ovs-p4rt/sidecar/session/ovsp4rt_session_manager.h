@@ -0,0 +1,98 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_SESSION_MANAGER_H_
+#define OVSP4RT_SESSION_MANAGER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include "absl/numeric/int128.h"
+#include "absl/status/statusor.h"
+#include "ovsp4rt_session.h"
+
+namespace ovsp4rt {
+
+// Maintains one long-lived, arbitrated session per (grpc_addr, device_id,
+// role_name). The session is shared by all OVS threads that call into
+// libovsp4rt, so the cost of creating a channel, opening the stream
+// channel and winning mastership is paid once rather than per call.
+//
+// A session whose stream channel has closed (for example, because
+// infrap4d restarted), or that is no longer the primary client for its
+// role (for example, because p4rt-ctl took over), is closed and replaced
+// on the next request. The new session has a higher election ID, so it
+// takes mastership back.
+class SessionManager {
+ public:
+  // Opens an arbitrated session with a server.
+  using SessionFactory =
+      std::function<::absl::StatusOr<std::unique_ptr<OvsP4rtSession>>(
+          const std::string& address, uint32_t device_id,
+          const std::string& role_name, ::absl::uint128 election_id)>;
+
+  // Returns the process-wide session manager.
+  static SessionManager& Instance();
+
+  explicit SessionManager(SessionFactory factory)
+      : factory_(std::move(factory)) {}
+
+  // Disable copy semantics.
+  SessionManager(const SessionManager&) = delete;
+  SessionManager& operator=(const SessionManager&) = delete;
+
+  // Returns the session for the specified target, creating a new session
+  // if there is none or the existing one is no longer connected and
+  // primary. Returns PERMISSION_DENIED if the new session is not primary.
+  //
+  // The session is created without holding the lock, so requests for
+  // other targets are not held up by a slow connect. Concurrent requests
+  // for the same target wait for it and share it.
+  ::absl::StatusOr<std::shared_ptr<OvsP4rtSession>> GetSession(
+      const std::string& address, uint32_t device_id,
+      const std::string& role_name);
+
+  // Returns the number of sessions that have been created, including
+  // reconnects.
+  uint64_t SessionsCreated() const;
+
+  // Closes all sessions, including those still in use by other threads.
+  // The next request for a target creates a new session.
+  void Reset();
+
+ private:
+  using SessionKey = std::tuple<std::string, uint32_t, std::string>;
+
+  struct SessionSlot {
+    std::shared_ptr<OvsP4rtSession> session;
+    // Election ID used for the most recent session. Reconnects must
+    // use a higher value.
+    ::absl::uint128 election_id = 0;
+    // True while a thread is creating a session for the slot.
+    bool creating = false;
+  };
+
+  const SessionFactory factory_;
+
+  // Guards the slots. Not held while a session is created or closed.
+  mutable std::mutex mutex_;
+
+  // Notified when a thread is done creating a session.
+  std::condition_variable created_;
+
+  // Slots are never erased, so a reference to one stays valid while
+  // its session is created without the lock.
+  std::map<SessionKey, SessionSlot> sessions_;
+
+  uint64_t sessions_created_ = 0;
+};
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_SESSION_MANAGER_H_
@@ -0,0 +1,252 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ovsp4rt_shadow_table.h"
+
+#include <algorithm>
+
+#include "absl/strings/string_view.h"
+
+namespace ovsp4rt {
+
+namespace {
+
+void AppendInt(std::string* key, uint32_t value) {
+  key->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Appends a bytestring in canonical form (no leading zero bytes),
+// prefixed with its length.
+void AppendBytes(std::string* key, absl::string_view value) {
+  size_t first = value.find_first_not_of('\0');
+  value.remove_prefix(first == absl::string_view::npos ? value.size() : first);
+  AppendInt(key, value.size());
+  key->append(value.data(), value.size());
+}
+
+}  // namespace
+
+std::string ShadowTable::MatchKey(const ::p4::v1::TableEntry& table_entry) {
+  // The server may return the match fields in any order.
+  std::vector<const ::p4::v1::FieldMatch*> matches;
+  matches.reserve(table_entry.match_size());
+  for (const auto& match : table_entry.match()) {
+    matches.push_back(&match);
+  }
+  std::sort(matches.begin(), matches.end(),
+            [](const ::p4::v1::FieldMatch* a, const ::p4::v1::FieldMatch* b) {
+              return a->field_id() < b->field_id();
+            });
+
+  std::string key;
+  AppendInt(&key, table_entry.priority());
+  for (const auto* match : matches) {
+    AppendInt(&key, match->field_id());
+    AppendInt(&key, match->field_match_type_case());
+    switch (match->field_match_type_case()) {
+      case ::p4::v1::FieldMatch::kExact:
+        AppendBytes(&key, match->exact().value());
+        break;
+      case ::p4::v1::FieldMatch::kTernary:
+        AppendBytes(&key, match->ternary().value());
+        AppendBytes(&key, match->ternary().mask());
+        break;
+      case ::p4::v1::FieldMatch::kLpm:
+        AppendBytes(&key, match->lpm().value());
+        AppendInt(&key, match->lpm().prefix_len());
+        break;
+      case ::p4::v1::FieldMatch::kRange:
+        AppendBytes(&key, match->range().low());
+        AppendBytes(&key, match->range().high());
+        break;
+      case ::p4::v1::FieldMatch::kOptional:
+        AppendBytes(&key, match->optional().value());
+        break;
+      default:
+        break;
+    }
+  }
+  return key;
+}
+
+::absl::StatusOr<bool> ShadowTable::Contains(
+    OvsP4rtSession* session, const ::p4::v1::TableEntry& table_entry) {
+  return Contains(session->Stub(), session->DeviceId(), table_entry);
+}
+
+::absl::StatusOr<bool> ShadowTable::Contains(
+    ::p4::v1::P4Runtime::Stub& stub, uint32_t device_id,
+    const ::p4::v1::TableEntry& table_entry) {
+  const uint32_t table_id = table_entry.table_id();
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    auto iter = tables_.find(table_id);
+    if (iter == tables_.end()) {
+      auto status = SyncTableLocked(stub, device_id, table_id, lock);
+      if (!status.ok()) {
+        return status;
+      }
+    } else if (iter->second.load_id) {
+      // Another thread is reading the table.
+      synced_.wait(lock);
+    } else {
+      return iter->second.entries.contains(MatchKey(table_entry));
+    }
+  }
+}
+
+::absl::Status ShadowTable::SyncTableLocked(
+    ::p4::v1::P4Runtime::Stub& stub, uint32_t device_id, uint32_t table_id,
+    std::unique_lock<std::mutex>& lock) {
+  const uint64_t load_id = next_load_id_++;
+  tables_[table_id].load_id = load_id;
+
+  // Read the table without the lock, so that lookups of other tables
+  // and the results of writes are not held up by the RPC. The entries
+  // are added as they arrive, without holding the whole response.
+  lock.unlock();
+  ::p4::v1::ReadRequest read_request;
+  read_request.set_device_id(device_id);
+  read_request.add_entities()->mutable_table_entry()->set_table_id(table_id);
+  absl::flat_hash_set<std::string> entries;
+  auto status = ReadEntities(
+      stub, read_request, [&](const ::p4::v1::Entity& entity) {
+        AddEntity(table_id, entity, entries);
+        return true;
+      });
+  lock.lock();
+
+  // The table may have been invalidated, or loaded, during the read.
+  auto iter = tables_.find(table_id);
+  if (iter != tables_.end() && iter->second.load_id == load_id) {
+    auto& table = iter->second;
+    if (status.ok()) {
+      // Apply the writes that completed during the read. The read may
+      // or may not have seen them.
+      for (auto& [key, present] : table.pending) {
+        if (present) {
+          entries.insert(std::move(key));
+        } else {
+          entries.erase(key);
+        }
+      }
+      table.entries = std::move(entries);
+      table.pending.clear();
+      table.load_id = 0;
+      ++sync_count_;
+    } else {
+      tables_.erase(iter);
+    }
+  }
+  synced_.notify_all();
+  return status;
+}
+
+std::optional<bool> ShadowTable::Find(
+    const ::p4::v1::TableEntry& table_entry) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = tables_.find(table_entry.table_id());
+  if (iter == tables_.end() || iter->second.load_id) {
+    return std::nullopt;
+  }
+  return iter->second.entries.contains(MatchKey(table_entry));
+}
+
+void ShadowTable::LoadTable(uint32_t table_id,
+                            const ::p4::v1::ReadResponse& response) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& table = tables_[table_id];
+  table.entries.clear();
+  for (const auto& entity : response.entities()) {
+    AddEntity(table_id, entity, table.entries);
+  }
+  // Supersedes a read in progress.
+  table.pending.clear();
+  table.load_id = 0;
+  ++sync_count_;
+  synced_.notify_all();
+}
+
+void ShadowTable::AddEntity(uint32_t table_id, const ::p4::v1::Entity& entity,
+                            absl::flat_hash_set<std::string>& entries) {
+  if (entity.has_table_entry() &&
+      entity.table_entry().table_id() == table_id) {
+    entries.insert(MatchKey(entity.table_entry()));
+  }
+}
+
+void ShadowTable::RecordWrite(
+    const ::p4::v1::WriteRequest& write_request,
+    const std::vector<::absl::Status>& update_status) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (tables_.empty()) {
+    return;
+  }
+
+  for (int i = 0; i < write_request.updates_size(); i++) {
+    const auto& update = write_request.updates(i);
+    if (!update.entity().has_table_entry()) {
+      continue;
+    }
+    const auto& table_entry = update.entity().table_entry();
+    auto iter = tables_.find(table_entry.table_id());
+    if (iter == tables_.end()) {
+      continue;
+    }
+
+    // Whether the entry is present after the update, if known.
+    ::absl::StatusCode code = update_status[i].code();
+    std::optional<bool> present;
+    switch (update.type()) {
+      case ::p4::v1::Update::INSERT:
+      case ::p4::v1::Update::MODIFY:
+        if (code == ::absl::StatusCode::kOk ||
+            code == ::absl::StatusCode::kAlreadyExists) {
+          present = true;
+        }
+        break;
+      case ::p4::v1::Update::DELETE:
+        if (code == ::absl::StatusCode::kOk ||
+            code == ::absl::StatusCode::kNotFound) {
+          present = false;
+        }
+        break;
+      default:
+        break;
+    }
+    if (!present) {
+      continue;
+    }
+
+    auto& table = iter->second;
+    if (table.load_id) {
+      table.pending.emplace_back(MatchKey(table_entry), *present);
+    } else if (*present) {
+      table.entries.insert(MatchKey(table_entry));
+    } else {
+      table.entries.erase(MatchKey(table_entry));
+    }
+  }
+}
+
+void ShadowTable::Invalidate() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  tables_.clear();
+  synced_.notify_all();
+}
+
+size_t ShadowTable::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t size = 0;
+  for (const auto& table : tables_) {
+    size += table.second.entries.size();
+  }
+  return size;
+}
+
+uint64_t ShadowTable::SyncCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return sync_count_;
+}
+
+}  // namespace ovsp4rt
@@ -0,0 +1,124 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_SHADOW_TABLE_H_
+#define OVSP4RT_SHADOW_TABLE_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "ovsp4rt_session.h"
+#include "p4/v1/p4runtime.grpc.pb.h"
+#include "p4/v1/p4runtime.pb.h"
+
+namespace ovsp4rt {
+
+// Local mirror of the table entries the sidecar has programmed in a
+// session, so it can tell whether an entry exists without reading it
+// from the switch. Each session has its own (see
+// OvsP4rtSession::Shadow()), so a new session (e.g., after infrap4d
+// restarts) starts with an empty mirror.
+//
+// Entries are keyed by match key; actions are not kept. A table is
+// mirrored the first time it is looked up, with a wildcard read of the
+// table. After that, the mirror is kept up to date from the results of
+// the WriteRequests the session sends.
+class ShadowTable {
+ public:
+  ShadowTable() = default;
+
+  // Disable copy semantics.
+  ShadowTable(const ShadowTable&) = delete;
+  ShadowTable& operator=(const ShadowTable&) = delete;
+
+  // Returns true if the switch has an entry with the same table and
+  // match key as table_entry. Reads the table from the session if it
+  // is not yet mirrored.
+  //
+  // The lock is not held during the read. The writes recorded while
+  // the table is being read are applied to the entries read, after
+  // the read. Other lookups of the table wait for the read.
+  ::absl::StatusOr<bool> Contains(OvsP4rtSession* session,
+                                  const ::p4::v1::TableEntry& table_entry);
+
+  // Same as above, but reads the table with the given stub and device
+  // ID.
+  ::absl::StatusOr<bool> Contains(::p4::v1::P4Runtime::Stub& stub,
+                                  uint32_t device_id,
+                                  const ::p4::v1::TableEntry& table_entry);
+
+  // Looks up an entry without going to the switch. Returns nullopt if
+  // the table is not mirrored.
+  std::optional<bool> Find(const ::p4::v1::TableEntry& table_entry) const;
+
+  // Replaces the mirror of a table with the entries in a wildcard read
+  // response.
+  void LoadTable(uint32_t table_id, const ::p4::v1::ReadResponse& response);
+
+  // Applies the table entry updates in a WriteRequest that took effect
+  // to the mirrored tables. update_status holds the status of each
+  // update.
+  void RecordWrite(const ::p4::v1::WriteRequest& write_request,
+                   const std::vector<::absl::Status>& update_status);
+
+  // Discards the mirror.
+  void Invalidate();
+
+  // Returns the number of entries in the mirror.
+  size_t size() const;
+
+  // Returns the number of wildcard reads performed.
+  uint64_t SyncCount() const;
+
+  // Returns the key under which an entry is stored: the match fields,
+  // with leading zero bytes stripped from the values so that entries
+  // read back in canonical form compare equal.
+  static std::string MatchKey(const ::p4::v1::TableEntry& table_entry);
+
+ private:
+  struct Table {
+    // Match keys of the entries in the table.
+    absl::flat_hash_set<std::string> entries;
+
+    // Nonzero while the table is being read: identifies the read.
+    uint64_t load_id = 0;
+
+    // Entries written while the table is being read, in order: the
+    // match key, and whether the entry is now present.
+    std::vector<std::pair<std::string, bool>> pending;
+  };
+
+  // Reads a table from the switch and mirrors it. Called with the
+  // lock held; releases it during the read.
+  ::absl::Status SyncTableLocked(::p4::v1::P4Runtime::Stub& stub,
+                                 uint32_t device_id, uint32_t table_id,
+                                 std::unique_lock<std::mutex>& lock);
+
+  // Adds an entity from a wildcard read of the table to its entries.
+  static void AddEntity(uint32_t table_id, const ::p4::v1::Entity& entity,
+                        absl::flat_hash_set<std::string>& entries);
+
+  mutable std::mutex mutex_;
+
+  // Notified when a read of a table completes.
+  std::condition_variable synced_;
+
+  // The tables that have been read from the switch, or are being read.
+  absl::flat_hash_map<uint32_t, Table> tables_;
+
+  uint64_t next_load_id_ = 1;
+  uint64_t sync_count_ = 0;
+};
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_SHADOW_TABLE_H_
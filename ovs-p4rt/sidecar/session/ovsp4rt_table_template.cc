@@ -0,0 +1,63 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ovsp4rt_table_template.h"
+
+namespace ovsp4rt {
+
+namespace {
+
+std::vector<const TableDescriptor*>& MutableRegistry() {
+  // Intentionally leaked, so that descriptors may be registered and
+  // used regardless of the order of static initialization.
+  static auto* registry = new std::vector<const TableDescriptor*>;
+  return *registry;
+}
+
+}  // namespace
+
+TableDescriptor::TableDescriptor(const char* table,
+                                 std::vector<const char*> match_fields,
+                                 const char* action,
+                                 std::vector<const char*> params)
+    : table_(table),
+      match_fields_(std::move(match_fields)),
+      action_(action),
+      params_(std::move(params)) {
+  auto& registry = MutableRegistry();
+  index_ = registry.size();
+  registry.push_back(this);
+}
+
+const std::vector<const TableDescriptor*>& TableDescriptor::Registry() {
+  return MutableRegistry();
+}
+
+TableTemplate::TableTemplate(const P4InfoResolver& p4info,
+                             const TableDescriptor& desc) {
+  key_.set_table_id(p4info.GetTableId(desc.table()));
+  for (const char* mf_name : desc.match_fields()) {
+    auto* match = key_.add_match();
+    match->set_field_id(p4info.GetMatchFieldId(desc.table(), mf_name));
+    match->mutable_exact();
+  }
+
+  if (desc.action()) {
+    auto* action = action_.mutable_action();
+    action->set_action_id(p4info.GetActionId(desc.action()));
+    for (const char* param_name : desc.params()) {
+      action->add_params()->set_param_id(
+          p4info.GetParamId(desc.action(), param_name));
+    }
+  }
+}
+
+void TableTemplate::Fill(::p4::v1::TableEntry* table_entry,
+                         bool with_action) const {
+  *table_entry = key_;
+  if (with_action) {
+    *table_entry->mutable_action() = action_;
+  }
+}
+
+}  // namespace ovsp4rt
@@ -0,0 +1,106 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_TABLE_TEMPLATE_H_
+#define OVSP4RT_TABLE_TEMPLATE_H_
+
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "ovsp4rt_p4info_resolver.h"
+#include "p4/v1/p4runtime.pb.h"
+
+namespace ovsp4rt {
+
+// Declarative description of the entries of a table that use one
+// action: the names of the table and its exact match fields, and of
+// the action and its parameters, in the order the Prepare function
+// sets their values.
+//
+// Descriptors register themselves when they are constructed, and each
+// P4InfoResolver builds a TableTemplate for every registered
+// descriptor. They must therefore be defined at namespace scope.
+class TableDescriptor {
+ public:
+  TableDescriptor(const char* table, std::vector<const char*> match_fields,
+                  const char* action = nullptr,
+                  std::vector<const char*> params = {});
+
+  // Disable copy semantics.
+  TableDescriptor(const TableDescriptor&) = delete;
+  TableDescriptor& operator=(const TableDescriptor&) = delete;
+
+  const char* table() const { return table_; }
+  const std::vector<const char*>& match_fields() const {
+    return match_fields_;
+  }
+  const char* action() const { return action_; }
+  const std::vector<const char*>& params() const { return params_; }
+
+  // Position of the descriptor in the registry.
+  size_t index() const { return index_; }
+
+  // Returns the registered descriptors.
+  static const std::vector<const TableDescriptor*>& Registry();
+
+ private:
+  const char* const table_;
+  const std::vector<const char*> match_fields_;
+  const char* const action_;
+  const std::vector<const char*> params_;
+  size_t index_;
+};
+
+// Skeleton of a table entry, with the P4 object IDs of a descriptor
+// resolved and empty values. Filling in the skeleton copies it in one
+// pass, instead of looking up each ID and adding each field.
+//
+// Names that are not in the P4Info resolve to -1, as they do when the
+// entry is built field by field.
+class TableTemplate {
+ public:
+  TableTemplate(const P4InfoResolver& p4info, const TableDescriptor& desc);
+
+  // Replaces table_entry with the skeleton: the table ID and match
+  // field IDs, and, if with_action is true, the action ID and param
+  // IDs. The values are then set with SetMatchValue and SetParamValue.
+  void Fill(::p4::v1::TableEntry* table_entry, bool with_action) const;
+
+  // Returns the resolved table ID, e.g. for a wildcard read.
+  int table_id() const { return key_.table_id(); }
+
+  // Returns the resolved ID of the index-th match field, e.g. to find
+  // it in an entry read from the switch.
+  int match_field_id(int index) const {
+    return key_.match(index).field_id();
+  }
+
+  // Returns the resolved ID of the index-th action parameter, e.g. to
+  // decode an entry read from the switch.
+  int param_id(int index) const {
+    return action_.action().params(index).param_id();
+  }
+
+ private:
+  ::p4::v1::TableEntry key_;
+  ::p4::v1::TableAction action_;
+};
+
+// Sets the value of the index-th match field of a filled-in template.
+inline void SetMatchValue(::p4::v1::TableEntry* table_entry, int index,
+                          absl::string_view value) {
+  table_entry->mutable_match(index)->mutable_exact()->set_value(value.data(),
+                                                                value.size());
+}
+
+// Sets the value of the index-th action parameter of a filled-in
+// template.
+inline void SetParamValue(::p4::v1::TableEntry* table_entry, int index,
+                          absl::string_view value) {
+  auto* action = table_entry->mutable_action()->mutable_action();
+  action->mutable_params(index)->set_value(value.data(), value.size());
+}
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_TABLE_TEMPLATE_H_
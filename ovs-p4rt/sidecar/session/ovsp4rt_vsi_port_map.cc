@@ -0,0 +1,58 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ovsp4rt_vsi_port_map.h"
+
+#include <utility>
+
+namespace ovsp4rt {
+
+bool VsiPortMap::IsLoaded() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return loaded_;
+}
+
+void VsiPortMap::Load(PortMap ports) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ports_ = std::move(ports);
+  loaded_ = true;
+}
+
+std::optional<uint32_t> VsiPortMap::Find(uint32_t vsi) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!loaded_) {
+    return std::nullopt;
+  }
+  auto iter = ports_.find(vsi);
+  if (iter == ports_.end()) {
+    return std::nullopt;
+  }
+  return iter->second;
+}
+
+void VsiPortMap::Insert(uint32_t vsi, uint32_t host_port) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (loaded_) {
+    ports_[vsi] = host_port;
+  }
+}
+
+void VsiPortMap::Erase(uint32_t vsi) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (loaded_) {
+    ports_.erase(vsi);
+  }
+}
+
+void VsiPortMap::Invalidate() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ports_.clear();
+  loaded_ = false;
+}
+
+size_t VsiPortMap::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return ports_.size();
+}
+
+}  // namespace ovsp4rt
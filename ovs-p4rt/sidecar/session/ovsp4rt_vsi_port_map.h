@@ -0,0 +1,63 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_VSI_PORT_MAP_H_
+#define OVSP4RT_VSI_PORT_MAP_H_
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+#include "absl/container/flat_hash_map.h"
+
+namespace ovsp4rt {
+
+// Cache of the VSI-to-host-port mappings in the tx_acc_vsi table, so
+// the learn path does not have to read the table for every MAC.
+//
+// The map is loaded from a read of the whole table the first time it
+// is used. Entries are added as they are resolved and removed when the
+// VSI's source port entry is deleted. Each session has its own (see
+// OvsP4rtSession::VsiPorts()), so a new session (e.g., after infrap4d
+// restarts) reads the table again.
+class VsiPortMap {
+ public:
+  using PortMap = absl::flat_hash_map<uint32_t, uint32_t>;
+
+  VsiPortMap() = default;
+
+  // Disable copy semantics.
+  VsiPortMap(const VsiPortMap&) = delete;
+  VsiPortMap& operator=(const VsiPortMap&) = delete;
+
+  // Returns true if the map has been loaded.
+  bool IsLoaded() const;
+
+  // Replaces the map with the mappings read from the switch.
+  void Load(PortMap ports);
+
+  // Returns the host port for a VSI, or nullopt if it is not known.
+  std::optional<uint32_t> Find(uint32_t vsi) const;
+
+  // Adds or removes a mapping. Ignored if the map has not been loaded.
+  void Insert(uint32_t vsi, uint32_t host_port);
+  void Erase(uint32_t vsi);
+
+  // Discards the map.
+  void Invalidate();
+
+  // Returns the number of mappings.
+  size_t size() const;
+
+ private:
+  mutable std::mutex mutex_;
+
+  bool loaded_ = false;
+
+  // Host port for each VSI.
+  PortMap ports_;
+};
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_VSI_PORT_MAP_H_
@@ -0,0 +1,166 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ovsp4rt_write_retry.h"
+
+#include <utility>
+
+#include "ovsp4rt_session.h"
+
+namespace ovsp4rt {
+
+using ::p4::v1::Update;
+using ::p4::v1::WriteRequest;
+
+namespace {
+
+// Returns true if the status means that the RPC as a whole failed,
+// rather than one of its updates.
+bool IsRpcFailure(::absl::StatusCode code) {
+  switch (code) {
+    case ::absl::StatusCode::kCancelled:
+    case ::absl::StatusCode::kDeadlineExceeded:
+    case ::absl::StatusCode::kPermissionDenied:
+    case ::absl::StatusCode::kResourceExhausted:
+    case ::absl::StatusCode::kUnauthenticated:
+    case ::absl::StatusCode::kUnavailable:
+    case ::absl::StatusCode::kUnimplemented:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Resends the failed updates of a WriteRequest.
+//
+// The updates are sent non-atomically, so when the server does not
+// say which updates failed, some of them may already have taken
+// effect. Resending them is harmless: an INSERT that took effect fails
+// with ALREADY_EXISTS and becomes a MODIFY, and a DELETE that took
+// effect fails with NOT_FOUND and is treated as a success.
+class UpdateRetrier {
+ public:
+  UpdateRetrier(const WriteRpc& write, const WriteRequest& write_request,
+                std::vector<::absl::Status>* update_status)
+      : write_(write),
+        write_request_(write_request),
+        update_status_(*update_status) {
+    types_.reserve(write_request.updates_size());
+    for (const auto& update : write_request.updates()) {
+      types_.push_back(update.type());
+    }
+  }
+
+  // Applies the result of sending the updates with the given indices.
+  // Updates that need to be resent are queued.
+  void HandleResult(const std::vector<int>& indices,
+                    const ::grpc::Status& status);
+
+  // Resends the queued updates, in one WriteRequest per round, until
+  // none remain.
+  void ResendQueued();
+
+ private:
+  // Sends the updates with the given indices in one WriteRequest.
+  void Send(const std::vector<int>& indices);
+
+  // Records the status of an update. Returns true if the update
+  // should be resent.
+  bool Resolve(int index, ::absl::Status status);
+
+  const WriteRpc& write_;
+  const WriteRequest& write_request_;
+  std::vector<::absl::Status>& update_status_;
+
+  // Type with which each update is sent.
+  std::vector<Update::Type> types_;
+
+  // Updates to be resent.
+  std::vector<int> queued_;
+};
+
+void UpdateRetrier::HandleResult(const std::vector<int>& indices,
+                                 const ::grpc::Status& status) {
+  std::vector<::absl::Status> statuses;
+  bool has_details = ParseUpdateStatus(status, indices.size(), &statuses);
+
+  if (!has_details && indices.size() > 1 &&
+      !IsRpcFailure(static_cast<::absl::StatusCode>(status.error_code()))) {
+    // Find the failed updates by sending each half on its own.
+    auto middle = indices.begin() + indices.size() / 2;
+    Send(std::vector<int>(indices.begin(), middle));
+    Send(std::vector<int>(middle, indices.end()));
+    return;
+  }
+
+  for (size_t i = 0; i < indices.size(); i++) {
+    if (Resolve(indices[i], std::move(statuses[i]))) {
+      queued_.push_back(indices[i]);
+    }
+  }
+}
+
+void UpdateRetrier::ResendQueued() {
+  while (!queued_.empty()) {
+    std::vector<int> indices;
+    indices.swap(queued_);
+    Send(indices);
+  }
+}
+
+void UpdateRetrier::Send(const std::vector<int>& indices) {
+  WriteRequest request;
+  request.set_device_id(write_request_.device_id());
+  request.set_role_id(write_request_.role_id());
+  request.set_role(write_request_.role());
+  *request.mutable_election_id() = write_request_.election_id();
+  request.set_atomicity(write_request_.atomicity());
+  for (int index : indices) {
+    auto* update = request.add_updates();
+    *update = write_request_.updates(index);
+    update->set_type(types_[index]);
+  }
+  HandleResult(indices, write_(request));
+}
+
+bool UpdateRetrier::Resolve(int index, ::absl::Status status) {
+  auto& type = types_[index];
+  if (type == Update::INSERT &&
+      status.code() == ::absl::StatusCode::kAlreadyExists) {
+    // Only done once: a MODIFY that fails is not retried.
+    type = Update::MODIFY;
+    return true;
+  }
+  if (type == Update::DELETE &&
+      status.code() == ::absl::StatusCode::kNotFound) {
+    status = ::absl::OkStatus();
+  }
+  update_status_[index] = std::move(status);
+  return false;
+}
+
+}  // namespace
+
+::absl::Status RetryFailedUpdates(const WriteRpc& write,
+                                  const WriteRequest& write_request,
+                                  const ::grpc::Status& status,
+                                  std::vector<::absl::Status>* update_status) {
+  const int num_updates = write_request.updates_size();
+  update_status->assign(num_updates, ::absl::OkStatus());
+
+  std::vector<int> indices(num_updates);
+  for (int i = 0; i < num_updates; i++) {
+    indices[i] = i;
+  }
+
+  UpdateRetrier retrier(write, write_request, update_status);
+  retrier.HandleResult(indices, status);
+  retrier.ResendQueued();
+
+  for (const auto& update : *update_status) {
+    if (!update.ok()) return update;
+  }
+  return ::absl::OkStatus();
+}
+
+}  // namespace ovsp4rt
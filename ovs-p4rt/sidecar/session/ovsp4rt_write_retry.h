@@ -0,0 +1,43 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_WRITE_RETRY_H_
+#define OVSP4RT_WRITE_RETRY_H_
+
+#include <grpcpp/grpcpp.h>
+
+#include <functional>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "p4/v1/p4runtime.pb.h"
+
+namespace ovsp4rt {
+
+// Sends a WriteRequest and returns the result of the RPC.
+using WriteRpc =
+    std::function<::grpc::Status(const p4::v1::WriteRequest& write_request)>;
+
+// Completes a multi-update WriteRequest that failed, by resending only
+// the updates that did not take effect.
+//
+// - An INSERT that failed with ALREADY_EXISTS is resent as a MODIFY.
+// - A DELETE that failed with NOT_FOUND is treated as a success.
+// - Other per-update errors are final.
+//
+// If the server did not return a p4.v1.Error for each update, the
+// updates are split in half and each half is resent, recursively,
+// until the updates that fail have been isolated. This is not done if
+// the RPC itself failed (e.g., the server is unavailable).
+//
+// status is the result of the first attempt. update_status receives
+// the final status of each update. Returns OK if every update took
+// effect, or else the status of the first update that did not.
+::absl::Status RetryFailedUpdates(const WriteRpc& write,
+                                  const p4::v1::WriteRequest& write_request,
+                                  const ::grpc::Status& status,
+                                  std::vector<::absl::Status>* update_status);
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_WRITE_RETRY_H_
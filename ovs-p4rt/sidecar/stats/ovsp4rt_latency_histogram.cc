@@ -0,0 +1,57 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ovsp4rt_latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ovsp4rt {
+
+void LatencyHistogram::AddTo(LatencyHistogram* sum) const {
+  for (int i = 0; i < kNumBuckets; i++) {
+    uint64_t n = buckets_[i].load(std::memory_order_relaxed);
+    if (n) {
+      Increment(sum->buckets_[i], n);
+    }
+  }
+  Increment(sum->count_, count());
+  Increment(sum->total_ns_, total_ns());
+  if (max_ns() > sum->max_ns()) {
+    sum->max_ns_.store(max_ns(), std::memory_order_relaxed);
+  }
+}
+
+uint64_t LatencyHistogram::ValueAtPercentile(double percentile) const {
+  // The buckets are read after the count, so a concurrent Record() can
+  // only make them add up to more than the rank.
+  uint64_t total = count();
+  if (!total) {
+    return 0;
+  }
+
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100 * total));
+  rank = std::max<uint64_t>(rank, 1);
+
+  uint64_t seen = 0;
+  for (int i = 0; i < kNumBuckets; i++) {
+    seen += buckets_[i].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      return std::min(BucketLimit(i), max_ns());
+    }
+  }
+  return max_ns();
+}
+
+uint64_t LatencyHistogram::BucketLimit(int index) {
+  if (index < kSubBuckets) {
+    return index;
+  }
+  int shift = index / kSubBuckets - 1;
+  uint64_t lower = static_cast<uint64_t>(kSubBuckets + index % kSubBuckets)
+                   << shift;
+  return lower + ((uint64_t{1} << shift) - 1);
+}
+
+}  // namespace ovsp4rt
@@ -0,0 +1,92 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_LATENCY_HISTOGRAM_H_
+#define OVSP4RT_LATENCY_HISTOGRAM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+namespace ovsp4rt {
+
+// Log-linear histogram of latencies in nanoseconds, in the style of
+// HdrHistogram.
+//
+// Each power of two is divided into kSubBuckets linear buckets, so a
+// value is recorded with a relative error of at most 1/kSubBuckets,
+// and the histogram covers the full range of uint64_t in a fixed
+// array of counters.
+//
+// Record() may be called by only one thread, the owner, and costs a
+// few relaxed loads and stores. Other threads may read the histogram
+// at any time with AddTo().
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  static constexpr int kNumBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+  LatencyHistogram() = default;
+
+  // Disable copy semantics.
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+  // Records a latency. Must only be called by the owner.
+  void Record(uint64_t ns) {
+    Increment(buckets_[BucketIndex(ns)], 1);
+    Increment(count_, 1);
+    Increment(total_ns_, ns);
+    if (ns > max_ns_.load(std::memory_order_relaxed)) {
+      max_ns_.store(ns, std::memory_order_relaxed);
+    }
+  }
+
+  // Adds the counts of this histogram to another, owned by the caller.
+  void AddTo(LatencyHistogram* sum) const;
+
+  uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+  uint64_t total_ns() const {
+    return total_ns_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t max_ns() const { return max_ns_.load(std::memory_order_relaxed); }
+
+  // Returns the latency below which the given percentage of the
+  // recorded latencies fall, rounded up to the limit of its bucket.
+  // Returns zero if the histogram is empty.
+  uint64_t ValueAtPercentile(double percentile) const;
+
+  // Returns the index of the bucket that holds a value.
+  static int BucketIndex(uint64_t value) {
+    if (value < kSubBuckets) {
+      return static_cast<int>(value);
+    }
+    int shift = 63 - __builtin_clzll(value) - kSubBucketBits;
+    return (shift + 1) * kSubBuckets +
+           static_cast<int>((value >> shift) & (kSubBuckets - 1));
+  }
+
+  // Returns the largest value in a bucket.
+  static uint64_t BucketLimit(int index);
+
+ private:
+  // Single-writer increment: cheaper than fetch_add, and safe because
+  // only the owner writes.
+  static void Increment(std::atomic<uint64_t>& counter, uint64_t delta) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta,
+                  std::memory_order_relaxed);
+  }
+
+  std::atomic<uint64_t> buckets_[kNumBuckets] = {};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> total_ns_{0};
+  std::atomic<uint64_t> max_ns_{0};
+};
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_LATENCY_HISTOGRAM_H_
@@ -0,0 +1,90 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_PROBES_H_
+#define OVSP4RT_PROBES_H_
+
+// USDT (user-level statically defined tracing) probes.
+//
+// If libovsp4rt is built with BUILD_USDT_PROBES, each probe is a nop
+// instruction plus a note in the ELF file that tells bpftrace or perf
+// where it is and where its arguments are. An attached tool replaces
+// the nop with a breakpoint; otherwise the probe costs nothing but
+// the evaluation of its arguments. Without BUILD_USDT_PROBES the
+// probes compile to nothing.
+//
+// The provider is "ovsp4rt". The probes are:
+//
+//   api__entry(const char* function, bool insert_entry)
+//   api__return(const char* function)
+//       An ovsp4rt_config_* function was called or returns. The
+//       function name omits the "ovsp4rt_" prefix.
+//
+//   session__create__entry(uint32_t device_id)
+//   session__create__return(int status_code)
+//       OvsP4rtSession::Create() opens a session with the switch.
+//
+//   pipeline__fetch__entry(uint32_t device_id)
+//   pipeline__fetch__return(int status_code)
+//       GetForwardingPipelineConfig() fetches the P4Info.
+//
+//   read__entry(int num_entities)
+//   read__return(int status_code)
+//       A Read RPC, from the request to the last entity.
+//
+//   write__entry(int num_updates)
+//   write__return(int status_code)
+//       A synchronous Write RPC, including the retries of the
+//       asynchronous write channel.
+//
+//   write__start(uint64_t call, int num_updates)
+//   write__done(uint64_t call, int status_code)
+//       An asynchronous Write RPC. The call ID pairs the two.
+//
+//   table__update(int table_id, bool ok)
+//       The outcome of an update to a table identified by a LogTableId
+//       (see logging/ovsp4rt_diag_detail.h).
+//
+// Sample bpftrace scripts are in stats/bpftrace.
+
+#if defined(OVSP4RT_USDT_PROBES)
+
+#include <sys/sdt.h>
+
+#define OVSP4RT_PROBE1(name, a) DTRACE_PROBE1(ovsp4rt, name, a)
+#define OVSP4RT_PROBE2(name, a, b) DTRACE_PROBE2(ovsp4rt, name, a, b)
+
+#else
+
+#define OVSP4RT_PROBE1(name, a) \
+  do {                          \
+  } while (0)
+#define OVSP4RT_PROBE2(name, a, b) \
+  do {                             \
+  } while (0)
+
+#endif  // OVSP4RT_USDT_PROBES
+
+namespace ovsp4rt {
+
+// Fires the api__entry probe when it is constructed and the api__return
+// probe when it is destroyed.
+class ApiProbe {
+ public:
+  ApiProbe(const char* function, bool insert_entry) : function_(function) {
+    OVSP4RT_PROBE2(api__entry, function_, insert_entry);
+  }
+
+  ~ApiProbe() { OVSP4RT_PROBE1(api__return, function_); }
+
+  // Disable copy semantics.
+  ApiProbe(const ApiProbe&) = delete;
+  ApiProbe& operator=(const ApiProbe&) = delete;
+
+ private:
+  const char* const function_;
+};
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_PROBES_H_
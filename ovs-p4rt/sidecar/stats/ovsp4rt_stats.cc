@@ -0,0 +1,106 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ovsp4rt_stats.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "ovsp4rt_probes.h"
+
+namespace ovsp4rt {
+
+static_assert(LOG_NUM_TABLES <= OVSP4RT_NUM_TABLE_STATS,
+              "OVSP4RT_NUM_TABLE_STATS is too small");
+
+namespace {
+
+// Adds to a counter that only the calling thread writes.
+void Add(std::atomic<uint64_t>& counter, uint64_t delta) {
+  counter.store(counter.load(std::memory_order_relaxed) + delta,
+                std::memory_order_relaxed);
+}
+
+}  // namespace
+
+Stats& Stats::Instance() {
+  static Stats* instance = new Stats;
+  return *instance;
+}
+
+Stats::ThreadSlot::~ThreadSlot() {
+  if (owner && stats) {
+    owner->Retire(std::move(stats));
+  }
+}
+
+Stats::ThreadStats& Stats::Local() {
+  thread_local ThreadSlot slot;
+  if (!slot.stats) {
+    slot.owner = this;
+    slot.stats = std::make_unique<ThreadStats>();
+    std::lock_guard<std::mutex> lock(mutex_);
+    threads_.push_back(slot.stats.get());
+  }
+  return *slot.stats;
+}
+
+void Stats::Retire(std::unique_ptr<ThreadStats> stats) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  AddTo(*stats, &retired_);
+  threads_.erase(std::remove(threads_.begin(), threads_.end(), stats.get()),
+                 threads_.end());
+}
+
+void Stats::RecordLatency(enum ovsp4rt_latency_type type, uint64_t ns) {
+  Local().latency[type].Record(ns);
+}
+
+void Stats::CountUpdate(LogTableId table_id, bool ok) {
+  OVSP4RT_PROBE2(table__update, static_cast<int>(table_id), ok);
+  auto& local = Local();
+  Add(ok ? local.succeeded[table_id] : local.failed[table_id], 1);
+}
+
+void Stats::AddTo(const ThreadStats& from, ThreadStats* to) {
+  for (int i = 0; i < OVSP4RT_NUM_LATENCY_TYPES; i++) {
+    from.latency[i].AddTo(&to->latency[i]);
+  }
+  for (int i = 0; i < OVSP4RT_NUM_TABLE_STATS; i++) {
+    Add(to->succeeded[i], from.succeeded[i].load(std::memory_order_relaxed));
+    Add(to->failed[i], from.failed[i].load(std::memory_order_relaxed));
+  }
+}
+
+void Stats::GetStats(struct ovsp4rt_stats* stats) {
+  // Too large for the stack of some callers.
+  auto sum = std::make_unique<ThreadStats>();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    AddTo(retired_, sum.get());
+    for (const auto* thread_stats : threads_) {
+      AddTo(*thread_stats, sum.get());
+    }
+  }
+
+  memset(stats, 0, sizeof(*stats));
+  for (int i = 0; i < OVSP4RT_NUM_LATENCY_TYPES; i++) {
+    const auto& histogram = sum->latency[i];
+    auto& latency = stats->latency[i];
+    latency.count = histogram.count();
+    latency.total_ns = histogram.total_ns();
+    latency.max_ns = histogram.max_ns();
+    latency.p50_ns = histogram.ValueAtPercentile(50);
+    latency.p90_ns = histogram.ValueAtPercentile(90);
+    latency.p99_ns = histogram.ValueAtPercentile(99);
+    latency.p999_ns = histogram.ValueAtPercentile(99.9);
+  }
+  for (int i = 0; i < OVSP4RT_NUM_TABLE_STATS; i++) {
+    stats->tables[i].succeeded = sum->succeeded[i].load();
+    stats->tables[i].failed = sum->failed[i].load();
+  }
+}
+
+}  // namespace ovsp4rt
@@ -0,0 +1,104 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OVSP4RT_STATS_H_
+#define OVSP4RT_STATS_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "logging/ovsp4rt_diag_detail.h"
+#include "ovsp4rt/ovs-p4rt.h"
+#include "ovsp4rt_latency_histogram.h"
+
+namespace ovsp4rt {
+
+// Always-on latency histograms and write counters.
+//
+// Each thread records into its own block of histograms and counters,
+// which only it writes, so recording takes no locks and no atomic
+// read-modify-write operations. GetStats() adds up the blocks of all
+// threads. When a thread exits, its counts are folded into a block
+// that belongs to no thread.
+class Stats {
+ public:
+  // Returns the process-wide instance, the only one there can be: a
+  // thread has one block, whichever instance it records to.
+  static Stats& Instance();
+
+  // Disable copy semantics.
+  Stats(const Stats&) = delete;
+  Stats& operator=(const Stats&) = delete;
+
+  // Records a latency on the calling thread.
+  void RecordLatency(enum ovsp4rt_latency_type type, uint64_t ns);
+
+  // Counts the outcome of a table update on the calling thread.
+  void CountUpdate(LogTableId table_id, bool ok);
+
+  // Returns the totals of all threads.
+  void GetStats(struct ovsp4rt_stats* stats);
+
+  // Returns the current time for latency measurements.
+  static uint64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+ private:
+  Stats() = default;
+
+  struct ThreadStats {
+    LatencyHistogram latency[OVSP4RT_NUM_LATENCY_TYPES];
+    std::atomic<uint64_t> succeeded[OVSP4RT_NUM_TABLE_STATS] = {};
+    std::atomic<uint64_t> failed[OVSP4RT_NUM_TABLE_STATS] = {};
+  };
+
+  // Owns the block of a thread, and retires it when the thread exits.
+  struct ThreadSlot {
+    ~ThreadSlot();
+    Stats* owner = nullptr;
+    std::unique_ptr<ThreadStats> stats;
+  };
+
+  // Returns the block of the calling thread.
+  ThreadStats& Local();
+
+  // Folds the counts of an exiting thread into retired_.
+  void Retire(std::unique_ptr<ThreadStats> stats);
+
+  static void AddTo(const ThreadStats& from, ThreadStats* to);
+
+  std::mutex mutex_;
+  std::vector<ThreadStats*> threads_;
+  ThreadStats retired_;
+};
+
+// Records the time from its construction to its destruction.
+class ScopedLatency {
+ public:
+  explicit ScopedLatency(enum ovsp4rt_latency_type type)
+      : type_(type), start_ns_(Stats::NowNs()) {}
+
+  ~ScopedLatency() {
+    Stats::Instance().RecordLatency(type_, Stats::NowNs() - start_ns_);
+  }
+
+  // Disable copy semantics.
+  ScopedLatency(const ScopedLatency&) = delete;
+  ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+ private:
+  const enum ovsp4rt_latency_type type_;
+  const uint64_t start_ns_;
+};
+
+}  // namespace ovsp4rt
+
+#endif  // OVSP4RT_STATS_H_
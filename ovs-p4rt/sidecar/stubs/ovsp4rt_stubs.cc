@@ -5,6 +5,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "ovsp4rt/ovs-p4rt.h"
 
@@ -17,6 +18,15 @@ void ovsp4rt_config_fdb_entry(struct mac_learning_info learn_info,
   return;
 }
 
+int ovsp4rt_config_fdb_entries(const struct mac_learning_info* learn_info,
+                               size_t num_entries, bool insert_entry,
+                               const char* grpc_addr, int* status) {
+  if (status) {
+    memset(status, 0, num_entries * sizeof(*status));
+  }
+  return 0;
+}
+
 void ovsp4rt_config_ip_mac_map_entry(struct ip_mac_map_info learn_info,
                                      bool insert_entry, const char* grpc_addr) {
 }
@@ -52,6 +62,72 @@ enum ovs_tunnel_type ovsp4rt_str_to_tunnel_type(const char* tnl_type) {
   return OVS_TUNNEL_UNKNOWN;
 }
 
+void ovsp4rt_async_enable(uint32_t queue_limit) { return; }
+
+void ovsp4rt_async_disable(void) { return; }
+
+void ovsp4rt_async_flush(void) { return; }
+
+void ovsp4rt_async_get_stats(struct ovsp4rt_async_stats* stats) {
+  memset(stats, 0, sizeof(*stats));
+}
+
+uint32_t ovsp4rt_async_num_shards(void) { return 1; }
+
+bool ovsp4rt_async_get_shard_stats(uint32_t shard,
+                                   struct ovsp4rt_async_stats* stats) {
+  memset(stats, 0, sizeof(*stats));
+  return shard == 0;
+}
+
+void ovsp4rt_resync_get_stats(struct ovsp4rt_resync_stats* stats) {
+  memset(stats, 0, sizeof(*stats));
+}
+
+int ovsp4rt_audit_begin_epoch(const char* grpc_addr) { return 0; }
+
+int ovsp4rt_audit_end_epoch(const char* grpc_addr, uint64_t* num_deleted) {
+  if (num_deleted) {
+    *num_deleted = 0;
+  }
+  return 0;
+}
+
+void ovsp4rt_fdb_aging_enable(uint32_t idle_timeout_ms,
+                              ovsp4rt_fdb_aged_cb callback, void* aux) {
+  return;
+}
+
+void ovsp4rt_fdb_aging_disable(void) { return; }
+
+bool ovsp4rt_fdb_aging_supported(const char* grpc_addr) { return false; }
+
+int ovsp4rt_journal_open(const char* path, uint64_t capacity) { return 0; }
+
+void ovsp4rt_journal_close(void) { return; }
+
+void ovsp4rt_get_stats(struct ovsp4rt_stats* stats) {
+  memset(stats, 0, sizeof(*stats));
+}
+
+const char* ovsp4rt_stats_latency_name(enum ovsp4rt_latency_type type) {
+  return nullptr;
+}
+
+const char* ovsp4rt_stats_table_name(uint32_t table) { return nullptr; }
+
+void ovsp4rt_log_set_level(enum ovsp4rt_log_level level) { return; }
+
+enum ovsp4rt_log_level ovsp4rt_log_get_level(void) {
+  return OVSP4RT_LEVEL_DEBUG;
+}
+
+void ovsp4rt_log_set_rate_limit(uint32_t messages_per_second) { return; }
+
+void ovsp4rt_log_set_sink(ovsp4rt_log_sink_cb sink, void* aux) { return; }
+
+void ovsp4rt_log_flush(void) { return; }
+
 #ifdef __cplusplus
 }  // "C"
 #endif
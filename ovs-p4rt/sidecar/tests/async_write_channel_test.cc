@@ -0,0 +1,269 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "session/ovsp4rt_async_write_channel.h"
+
+#include <grpcpp/grpcpp.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "google/rpc/status.pb.h"
+#include "gtest/gtest.h"
+#include "p4/v1/p4runtime.grpc.pb.h"
+#include "p4/v1/p4runtime.pb.h"
+
+namespace ovsp4rt {
+
+
+// P4Runtime server whose Write RPCs wait until the test releases them.
+class FakeP4RuntimeService : public ::p4::v1::P4Runtime::Service {
+ public:
+  ::grpc::Status Write(::grpc::ServerContext* context,
+                       const ::p4::v1::WriteRequest* request,
+                       ::p4::v1::WriteResponse* response) override {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      ++active_;
+      max_active_ = std::max(max_active_, active_);
+      cv_.notify_all();
+      while (!released_ && !context->IsCancelled()) {
+        cv_.wait_for(lock, std::chrono::milliseconds(5));
+      }
+      --active_;
+    }
+
+    // Fail every DELETE, reporting the status of each update.
+    bool has_delete = false;
+    ::google::rpc::Status details;
+    for (const auto& update : request->updates()) {
+      ::p4::v1::Error error;
+      if (update.type() == ::p4::v1::Update::DELETE) {
+        error.set_canonical_code(::grpc::StatusCode::NOT_FOUND);
+        has_delete = true;
+      }
+      details.add_details()->PackFrom(error);
+    }
+    if (has_delete) {
+      details.set_code(::grpc::StatusCode::UNKNOWN);
+      return ::grpc::Status(::grpc::StatusCode::UNKNOWN, "Write failed",
+                            details.SerializeAsString());
+    }
+    return ::grpc::Status::OK;
+  }
+
+  void Release() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    released_ = true;
+    cv_.notify_all();
+  }
+
+  void WaitForActive(int count) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&]() { return active_ >= count; });
+  }
+
+  int max_active() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return max_active_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool released_ = false;
+  int active_ = 0;
+  int max_active_ = 0;
+};
+
+class AsyncWriteChannelTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ::grpc::ServerBuilder builder;
+    builder.RegisterService(&service_);
+    server_ = builder.BuildAndStart();
+    stub_ = ::p4::v1::P4Runtime::NewStub(
+        server_->InProcessChannel(::grpc::ChannelArguments()));
+  }
+
+  void TearDown() override {
+    service_.Release();
+    server_->Shutdown();
+  }
+
+  static ::p4::v1::WriteRequest MakeRequest(
+      const std::vector<::p4::v1::Update::Type>& types) {
+    ::p4::v1::WriteRequest request;
+    for (auto type : types) {
+      auto* update = request.add_updates();
+      update->set_type(type);
+      update->mutable_entity()->mutable_table_entry()->set_table_id(1);
+    }
+    return request;
+  }
+
+  // Starts a one-update write that counts its completion, on a channel
+  // or in a group.
+  template <typename Writes>
+  void StartInsert(Writes& channel) {
+    channel.StartWrite(MakeRequest({::p4::v1::Update::INSERT}),
+                       [this](const ::absl::Status& status,
+                              const std::vector<::absl::Status>&) {
+                         if (status.ok()) completed_++;
+                       });
+  }
+
+  FakeP4RuntimeService service_;
+  std::unique_ptr<::grpc::Server> server_;
+  std::unique_ptr<::p4::v1::P4Runtime::Stub> stub_;
+  std::atomic<int> completed_{0};
+};
+
+TEST_F(AsyncWriteChannelTest, writes_are_pipelined_up_to_limit) {
+  AsyncWriteChannel channel(*stub_, nullptr, 2);
+
+  StartInsert(channel);
+  StartInsert(channel);
+  service_.WaitForActive(2);
+  EXPECT_EQ(channel.in_flight(), 2);
+
+  // The third write waits for a free slot.
+  std::atomic<bool> started{false};
+  std::thread writer([&]() {
+    StartInsert(channel);
+    started = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(started);
+
+  service_.Release();
+  writer.join();
+  channel.Drain();
+
+  EXPECT_EQ(completed_, 3);
+  EXPECT_EQ(channel.in_flight(), 0);
+  EXPECT_EQ(service_.max_active(), 2);
+}
+
+TEST_F(AsyncWriteChannelTest, limit_applies_to_each_group) {
+  AsyncWriteChannel channel(*stub_, nullptr, 1);
+  AsyncWriteChannel::Group first(channel);
+  AsyncWriteChannel::Group second(channel);
+
+  // Each group has its own slot.
+  StartInsert(first);
+  StartInsert(second);
+  service_.WaitForActive(2);
+  EXPECT_EQ(channel.in_flight(), 2);
+
+  service_.Release();
+  first.Drain();
+  second.Drain();
+
+  EXPECT_EQ(completed_, 2);
+  EXPECT_EQ(channel.in_flight(), 0);
+}
+
+TEST_F(AsyncWriteChannelTest, reports_update_status) {
+  AsyncWriteChannel channel(*stub_, nullptr, 4);
+  service_.Release();
+
+  ::absl::Status write_status;
+  std::vector<::absl::Status> update_status;
+  channel.StartWrite(
+      MakeRequest({::p4::v1::Update::INSERT, ::p4::v1::Update::DELETE}),
+      [&](const ::absl::Status& status,
+          const std::vector<::absl::Status>& statuses) {
+        write_status = status;
+        update_status = statuses;
+      });
+  channel.Drain();
+
+  EXPECT_EQ(write_status.code(), ::absl::StatusCode::kUnknown);
+  ASSERT_EQ(update_status.size(), 2);
+  EXPECT_TRUE(update_status[0].ok());
+  EXPECT_EQ(update_status[1].code(), ::absl::StatusCode::kNotFound);
+}
+
+TEST_F(AsyncWriteChannelTest, retries_failed_updates) {
+  AsyncWriteChannel channel(*stub_, nullptr, 4, ::absl::ZeroDuration(),
+                            /*retry_failed_updates=*/true);
+  service_.Release();
+
+  ::absl::Status write_status;
+  std::vector<::absl::Status> update_status;
+  channel.StartWrite(
+      MakeRequest({::p4::v1::Update::INSERT, ::p4::v1::Update::DELETE}),
+      [&](const ::absl::Status& status,
+          const std::vector<::absl::Status>& statuses) {
+        write_status = status;
+        update_status = statuses;
+      });
+  channel.Drain();
+
+  // A DELETE of an entry that does not exist counts as a success.
+  EXPECT_TRUE(write_status.ok());
+  ASSERT_EQ(update_status.size(), 2);
+  EXPECT_TRUE(update_status[0].ok());
+  EXPECT_TRUE(update_status[1].ok());
+}
+
+TEST_F(AsyncWriteChannelTest, retries_are_off_completion_thread) {
+  AsyncWriteChannel channel(*stub_, nullptr, 4, ::absl::ZeroDuration(),
+                            /*retry_failed_updates=*/true);
+  service_.Release();
+
+  // The write that fails is retried, and its callback invoked, on a
+  // thread other than the one that completes the writes that succeed.
+  std::thread::id completed_on;
+  std::thread::id retried_on;
+  channel.StartWrite(MakeRequest({::p4::v1::Update::INSERT}),
+                     [&](const ::absl::Status&,
+                         const std::vector<::absl::Status>&) {
+                       completed_on = std::this_thread::get_id();
+                     });
+  channel.StartWrite(MakeRequest({::p4::v1::Update::DELETE}),
+                     [&](const ::absl::Status&,
+                         const std::vector<::absl::Status>&) {
+                       retried_on = std::this_thread::get_id();
+                     });
+  channel.Drain();
+
+  EXPECT_NE(completed_on, std::thread::id());
+  EXPECT_NE(retried_on, std::thread::id());
+  EXPECT_NE(completed_on, retried_on);
+}
+
+TEST_F(AsyncWriteChannelTest, write_deadline) {
+  AsyncWriteChannel channel(*stub_, nullptr, 4, ::absl::Milliseconds(20));
+
+  ::absl::Status write_status;
+  channel.StartWrite(MakeRequest({::p4::v1::Update::INSERT}),
+                     [&](const ::absl::Status& status,
+                         const std::vector<::absl::Status>&) {
+                       write_status = status;
+                     });
+  channel.Drain();
+
+  EXPECT_EQ(write_status.code(), ::absl::StatusCode::kDeadlineExceeded);
+}
+
+TEST_F(AsyncWriteChannelTest, destructor_waits_for_writes) {
+  {
+    AsyncWriteChannel channel(*stub_, nullptr, 4);
+    StartInsert(channel);
+    StartInsert(channel);
+    service_.WaitForActive(2);
+    service_.Release();
+  }
+  EXPECT_EQ(completed_, 2);
+}
+
+}  // namespace ovsp4rt
@@ -0,0 +1,249 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "async/ovsp4rt_async_writer.h"
+
+#include <stdint.h>
+
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "async/ovsp4rt_mpsc_queue.h"
+#include "gtest/gtest.h"
+#include "ovsp4rt/ovs-p4rt.h"
+
+namespace ovsp4rt {
+
+constexpr char GRPC_ADDR[] = "localhost:9559";
+
+//----------------------------------------------------------------------
+// MpscQueue
+//----------------------------------------------------------------------
+
+TEST(MpscQueueTest, pop_from_empty_queue) {
+  MpscQueue<int> queue;
+  int value;
+
+  EXPECT_FALSE(queue.Pop(&value));
+}
+
+TEST(MpscQueueTest, items_are_fifo) {
+  MpscQueue<int> queue;
+  for (int i = 0; i < 10; i++) {
+    queue.Push(i);
+  }
+
+  for (int i = 0; i < 10; i++) {
+    int value = -1;
+    ASSERT_TRUE(queue.Pop(&value));
+    EXPECT_EQ(value, i);
+  }
+
+  int value;
+  EXPECT_FALSE(queue.Pop(&value));
+}
+
+TEST(MpscQueueTest, multiple_producers) {
+  constexpr int NUM_PRODUCERS = 4;
+  constexpr int NUM_ITEMS = 10000;
+
+  MpscQueue<int> queue;
+  std::vector<std::thread> producers;
+  for (int p = 0; p < NUM_PRODUCERS; p++) {
+    producers.emplace_back([&queue, p]() {
+      for (int i = 0; i < NUM_ITEMS; i++) {
+        queue.Push(p * NUM_ITEMS + i);
+      }
+    });
+  }
+
+  // Each producer's items must arrive in the order they were pushed.
+  std::vector<int> next(NUM_PRODUCERS, 0);
+  int received = 0;
+  while (received < NUM_PRODUCERS * NUM_ITEMS) {
+    int value;
+    if (!queue.Pop(&value)) {
+      std::this_thread::yield();
+      continue;
+    }
+    int p = value / NUM_ITEMS;
+    ASSERT_EQ(value % NUM_ITEMS, next[p]);
+    next[p]++;
+    received++;
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+}
+
+//----------------------------------------------------------------------
+// AsyncWriter
+//----------------------------------------------------------------------
+
+class AsyncWriterTest : public ::testing::Test {
+ protected:
+  // Records the VLAN IDs of the requests the executor processes.
+  void Execute(std::vector<AsyncOp>& ops) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& op : ops) {
+      vlans_.push_back(op.vlan_id);
+    }
+  }
+
+  bool EnqueueVlan(AsyncWriter& writer, uint16_t vlan_id) {
+    return writer.Enqueue(AsyncOp::CONFIG_VLAN_ENTRY, vlan_id, true,
+                          GRPC_ADDR);
+  }
+
+  std::vector<uint16_t> vlans() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return vlans_;
+  }
+
+  std::mutex mutex_;
+  std::vector<uint16_t> vlans_;
+};
+
+TEST_F(AsyncWriterTest, disabled_by_default) {
+  AsyncWriter writer([this](std::vector<AsyncOp>& ops) { Execute(ops); });
+
+  EXPECT_FALSE(EnqueueVlan(writer, 1));
+
+  struct ovsp4rt_async_stats stats;
+  writer.GetStats(&stats);
+  EXPECT_EQ(stats.enqueued, 0);
+}
+
+TEST_F(AsyncWriterTest, flush_waits_for_queued_requests) {
+  AsyncWriter writer([this](std::vector<AsyncOp>& ops) { Execute(ops); });
+  writer.Enable(0);
+
+  for (uint16_t vlan_id = 1; vlan_id <= 100; vlan_id++) {
+    ASSERT_TRUE(EnqueueVlan(writer, vlan_id));
+  }
+  writer.Flush();
+
+  auto result = vlans();
+  ASSERT_EQ(result.size(), 100);
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(result[i], i + 1);
+  }
+
+  struct ovsp4rt_async_stats stats;
+  writer.GetStats(&stats);
+  EXPECT_EQ(stats.enqueued, 100);
+  EXPECT_EQ(stats.completed, 100);
+  EXPECT_EQ(stats.dropped, 0);
+  EXPECT_EQ(stats.queue_depth, 0);
+  EXPECT_GE(stats.batches, 1);
+  EXPECT_LE(stats.batches, 100);
+}
+
+TEST_F(AsyncWriterTest, requests_dropped_when_queue_full) {
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+
+  AsyncWriter writer([this, released](std::vector<AsyncOp>& ops) {
+    released.wait();
+    Execute(ops);
+  });
+  writer.Enable(10);
+
+  // The writer thread takes the first request and blocks. The rest
+  // stay in the queue until it is full.
+  ASSERT_TRUE(EnqueueVlan(writer, 0));
+  while (true) {
+    struct ovsp4rt_async_stats stats;
+    writer.GetStats(&stats);
+    if (stats.queue_depth == 0) break;
+    std::this_thread::yield();
+  }
+  for (uint16_t vlan_id = 1; vlan_id <= 20; vlan_id++) {
+    EXPECT_TRUE(EnqueueVlan(writer, vlan_id));
+  }
+
+  release.set_value();
+  writer.Flush();
+
+  struct ovsp4rt_async_stats stats;
+  writer.GetStats(&stats);
+  EXPECT_EQ(stats.enqueued, 11);
+  EXPECT_EQ(stats.dropped, 10);
+  EXPECT_EQ(stats.completed, 11);
+  EXPECT_EQ(stats.max_queue_depth, 10);
+  EXPECT_EQ(vlans().size(), 11);
+}
+
+TEST_F(AsyncWriterTest, deletes_not_dropped_when_queue_full) {
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+
+  AsyncWriter writer([this, released](std::vector<AsyncOp>& ops) {
+    released.wait();
+    Execute(ops);
+  });
+  writer.Enable(1);
+
+  // The writer thread takes the first request and blocks. The second
+  // fills the queue.
+  ASSERT_TRUE(EnqueueVlan(writer, 0));
+  while (true) {
+    struct ovsp4rt_async_stats stats;
+    writer.GetStats(&stats);
+    if (stats.queue_depth == 0) break;
+    std::this_thread::yield();
+  }
+  ASSERT_TRUE(EnqueueVlan(writer, 1));
+
+  // The delete waits for the queued requests, then is left to the
+  // caller.
+  auto queued = std::async(std::launch::async, [&writer]() {
+    return writer.Enqueue(AsyncOp::CONFIG_VLAN_ENTRY, uint16_t(2), false,
+                          GRPC_ADDR);
+  });
+  EXPECT_EQ(queued.wait_for(std::chrono::milliseconds(50)),
+            std::future_status::timeout);
+  release.set_value();
+  EXPECT_FALSE(queued.get());
+  EXPECT_EQ(vlans().size(), 2);
+
+  struct ovsp4rt_async_stats stats;
+  writer.GetStats(&stats);
+  EXPECT_EQ(stats.enqueued, 2);
+  EXPECT_EQ(stats.dropped, 0);
+}
+
+TEST_F(AsyncWriterTest, writer_thread_does_not_requeue) {
+  AsyncWriter* writer_ptr = nullptr;
+  bool requeued = true;
+
+  AsyncWriter writer([&](std::vector<AsyncOp>& ops) {
+    requeued = EnqueueVlan(*writer_ptr, 2);
+  });
+  writer_ptr = &writer;
+  writer.Enable(0);
+
+  ASSERT_TRUE(EnqueueVlan(writer, 1));
+  writer.Flush();
+
+  EXPECT_FALSE(requeued);
+}
+
+TEST_F(AsyncWriterTest, disable_drains_queue) {
+  AsyncWriter writer([this](std::vector<AsyncOp>& ops) { Execute(ops); });
+  writer.Enable(0);
+
+  for (uint16_t vlan_id = 1; vlan_id <= 10; vlan_id++) {
+    ASSERT_TRUE(EnqueueVlan(writer, vlan_id));
+  }
+  writer.Disable();
+
+  EXPECT_EQ(vlans().size(), 10);
+  EXPECT_FALSE(EnqueueVlan(writer, 11));
+}
+
+}  // namespace ovsp4rt
@@ -0,0 +1,263 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "async/ovsp4rt_dependency_scheduler.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "async/ovsp4rt_async_writer.h"
+#include "gtest/gtest.h"
+#include "ovsp4rt/ovs-p4rt.h"
+
+namespace ovsp4rt {
+
+constexpr char GRPC_ADDR[] = "localhost:9559";
+constexpr uint32_t VNI = 0x1234;
+
+// Time at which the requests are queued.
+constexpr int64_t START_NS = 1000000000;
+
+class DependencySchedulerTest : public ::testing::Test {
+ protected:
+  DependencySchedulerTest() : scheduler_(absl::Milliseconds(100)) {}
+
+  // Returns a request to program the FDB entry for a MAC address that
+  // is reached through the VXLAN tunnel for VNI.
+  static AsyncOp TunnelFdbOp(uint8_t mac, bool insert_entry) {
+    struct mac_learning_info learn_info = {0};
+    learn_info.is_tunnel = true;
+    learn_info.mac_addr[5] = mac;
+    learn_info.tnl_info.vni = VNI;
+    return FdbOp(learn_info, insert_entry);
+  }
+
+  static AsyncOp FdbOp(const struct mac_learning_info& learn_info,
+                       bool insert_entry) {
+    AsyncOp op;
+    op.type = AsyncOp::CONFIG_FDB_ENTRY;
+    op.learn_info = learn_info;
+    op.insert_entry = insert_entry;
+    op.grpc_addr = GRPC_ADDR;
+    op.enqueue_ns = START_NS;
+    return op;
+  }
+
+  void AddTunnel() {
+    scheduler_.Record(GRPC_ADDR, TunnelPrerequisite(VNI), true,
+                      absl::OkStatus());
+  }
+
+  // Returns the MAC addresses and operations of a series of requests.
+  static std::vector<std::pair<int, bool>> Summarize(
+      const std::vector<AsyncOp>& ops) {
+    std::vector<std::pair<int, bool>> summary;
+    for (const auto& op : ops) {
+      summary.emplace_back(op.learn_info.mac_addr[5], op.insert_entry);
+    }
+    return summary;
+  }
+
+  DependencyScheduler scheduler_;
+};
+
+//----------------------------------------------------------------------
+// Test case: insert_waits_for_tunnel
+//----------------------------------------------------------------------
+TEST_F(DependencySchedulerTest, insert_waits_for_tunnel) {
+  auto op = TunnelFdbOp(1, true);
+
+  EXPECT_FALSE(scheduler_.Admit(op, START_NS));
+  EXPECT_EQ(scheduler_.held(), 1);
+  EXPECT_TRUE(scheduler_.Release(START_NS, false).empty());
+
+  AddTunnel();
+
+  auto ready = scheduler_.Release(START_NS, false);
+  ASSERT_EQ(ready.size(), 1);
+  EXPECT_EQ(ready[0].learn_info.mac_addr[5], 1);
+  EXPECT_EQ(ready[0].grpc_addr, GRPC_ADDR);
+  EXPECT_EQ(scheduler_.held(), 0);
+  EXPECT_EQ(scheduler_.num_held(), 1);
+  EXPECT_EQ(scheduler_.num_expired(), 0);
+}
+
+//----------------------------------------------------------------------
+// Test case: insert_with_tunnel_in_place
+//----------------------------------------------------------------------
+TEST_F(DependencySchedulerTest, insert_with_tunnel_in_place) {
+  AddTunnel();
+  auto op = TunnelFdbOp(1, true);
+
+  EXPECT_TRUE(scheduler_.Admit(op, START_NS));
+  EXPECT_EQ(scheduler_.held(), 0);
+}
+
+//----------------------------------------------------------------------
+// Test case: tunnel_already_exists
+//
+// Verify that a tunnel counts as in place if it was already there.
+//----------------------------------------------------------------------
+TEST_F(DependencySchedulerTest, tunnel_already_exists) {
+  scheduler_.Record(GRPC_ADDR, TunnelPrerequisite(VNI), true,
+                    absl::AlreadyExistsError("Entry exists"));
+
+  EXPECT_TRUE(scheduler_.IsInPlace(GRPC_ADDR, TunnelPrerequisite(VNI)));
+}
+
+//----------------------------------------------------------------------
+// Test case: failed_tunnel_not_in_place
+//----------------------------------------------------------------------
+TEST_F(DependencySchedulerTest, failed_tunnel_not_in_place) {
+  scheduler_.Record(GRPC_ADDR, TunnelPrerequisite(VNI), true,
+                    absl::InvalidArgumentError("Bad entry"));
+
+  EXPECT_FALSE(scheduler_.IsInPlace(GRPC_ADDR, TunnelPrerequisite(VNI)));
+}
+
+//----------------------------------------------------------------------
+// Test case: removed_tunnel
+//
+// Verify that inserts wait again once the tunnel has been removed.
+//----------------------------------------------------------------------
+TEST_F(DependencySchedulerTest, removed_tunnel) {
+  AddTunnel();
+  scheduler_.Record(GRPC_ADDR, TunnelPrerequisite(VNI), false,
+                    absl::OkStatus());
+  auto op = TunnelFdbOp(1, true);
+
+  EXPECT_FALSE(scheduler_.Admit(op, START_NS));
+}
+
+//----------------------------------------------------------------------
+// Test case: other_server
+//
+// Verify that a tunnel on one server is not a prerequisite on another.
+//----------------------------------------------------------------------
+TEST_F(DependencySchedulerTest, other_server) {
+  scheduler_.Record("otherhost:9559", TunnelPrerequisite(VNI), true,
+                    absl::OkStatus());
+  auto op = TunnelFdbOp(1, true);
+
+  EXPECT_FALSE(scheduler_.Admit(op, START_NS));
+}
+
+//----------------------------------------------------------------------
+// Test case: delete_not_held
+//----------------------------------------------------------------------
+TEST_F(DependencySchedulerTest, delete_not_held) {
+  auto op = TunnelFdbOp(1, false);
+
+  EXPECT_TRUE(scheduler_.Admit(op, START_NS));
+}
+
+//----------------------------------------------------------------------
+// Test case: requests_for_mac_stay_in_order
+//
+// Verify that a request for a MAC address with a held request is held
+// behind it, even if it could run, and that both are released in
+// order. Requests for other MAC addresses are not affected.
+//----------------------------------------------------------------------
+TEST_F(DependencySchedulerTest, requests_for_mac_stay_in_order) {
+  auto insert1 = TunnelFdbOp(1, true);
+  auto delete1 = TunnelFdbOp(1, false);
+  auto delete2 = TunnelFdbOp(2, false);
+
+  EXPECT_FALSE(scheduler_.Admit(insert1, START_NS));
+  EXPECT_FALSE(scheduler_.Admit(delete1, START_NS));
+  EXPECT_TRUE(scheduler_.Admit(delete2, START_NS));
+
+  AddTunnel();
+
+  auto ready = scheduler_.Release(START_NS, false);
+  std::vector<std::pair<int, bool>> expected = {{1, true}, {1, false}};
+  EXPECT_EQ(Summarize(ready), expected);
+}
+
+//----------------------------------------------------------------------
+// Test case: hold_time_expires
+//
+// Verify that a held insert is released when it has waited for the
+// hold time, along with the requests held behind it.
+//----------------------------------------------------------------------
+TEST_F(DependencySchedulerTest, hold_time_expires) {
+  auto insert1 = TunnelFdbOp(1, true);
+  auto delete1 = TunnelFdbOp(1, false);
+  delete1.enqueue_ns = START_NS + absl::ToInt64Nanoseconds(absl::Seconds(1));
+
+  EXPECT_FALSE(scheduler_.Admit(insert1, START_NS));
+  EXPECT_FALSE(scheduler_.Admit(delete1, START_NS));
+
+  int64_t later = START_NS + absl::ToInt64Nanoseconds(absl::Milliseconds(99));
+  EXPECT_TRUE(scheduler_.Release(later, false).empty());
+
+  later = START_NS + absl::ToInt64Nanoseconds(absl::Milliseconds(100));
+  auto ready = scheduler_.Release(later, false);
+  std::vector<std::pair<int, bool>> expected = {{1, true}, {1, false}};
+  EXPECT_EQ(Summarize(ready), expected);
+  EXPECT_EQ(scheduler_.num_expired(), 1);
+}
+
+//----------------------------------------------------------------------
+// Test case: release_all
+//----------------------------------------------------------------------
+TEST_F(DependencySchedulerTest, release_all) {
+  auto insert1 = TunnelFdbOp(1, true);
+  auto insert2 = TunnelFdbOp(2, true);
+  EXPECT_FALSE(scheduler_.Admit(insert1, START_NS));
+  EXPECT_FALSE(scheduler_.Admit(insert2, START_NS));
+
+  auto ready = scheduler_.Release(START_NS, true);
+
+  std::vector<std::pair<int, bool>> expected = {{1, true}, {2, true}};
+  EXPECT_EQ(Summarize(ready), expected);
+  EXPECT_EQ(scheduler_.held(), 0);
+}
+
+//----------------------------------------------------------------------
+// Test case: release_selected
+//----------------------------------------------------------------------
+TEST_F(DependencySchedulerTest, release_selected) {
+  auto insert1 = TunnelFdbOp(1, true);
+  auto insert2 = TunnelFdbOp(2, true);
+  insert2.learn_info.bridge_id = 1;
+  EXPECT_FALSE(scheduler_.Admit(insert1, START_NS));
+  EXPECT_FALSE(scheduler_.Admit(insert2, START_NS));
+
+  // Only the requests of the selected bridge are released.
+  auto ready = scheduler_.Release(START_NS, true, [](const AsyncOp& op) {
+    return op.learn_info.bridge_id == 1;
+  });
+
+  std::vector<std::pair<int, bool>> expected = {{2, true}};
+  EXPECT_EQ(Summarize(ready), expected);
+  EXPECT_EQ(scheduler_.held(), 1);
+}
+
+//----------------------------------------------------------------------
+// Test case: vlan_prerequisites
+//----------------------------------------------------------------------
+TEST_F(DependencySchedulerTest, vlan_prerequisites) {
+  struct mac_learning_info learn_info = {0};
+  learn_info.is_vlan = true;
+  learn_info.vlan_info.port_vlan_mode = P4_PORT_VLAN_NATIVE_UNTAGGED;
+  learn_info.vlan_info.port_vlan = 10;
+
+  auto prerequisites = FdbPrerequisites(learn_info);
+
+#if defined(ES2K_TARGET)
+  // remove_vlan_and_fwd refers to the vlan_pop mod entry.
+  ASSERT_EQ(prerequisites.size(), 1);
+  EXPECT_EQ(prerequisites[0], VlanPrerequisite(10));
+#else
+  EXPECT_TRUE(prerequisites.empty());
+#endif
+
+  learn_info.vlan_info.port_vlan_mode = P4_PORT_VLAN_NATIVE_TAGGED;
+  EXPECT_TRUE(FdbPrerequisites(learn_info).empty());
+}
+
+}  // namespace ovsp4rt
@@ -139,7 +139,7 @@ TEST_F(DpdkFdbRxVlanTest, remove_entry) {
   InitFdbInfo();
 
   // Act
-  PrepareFdbRxVlanTableEntry(&table_entry, fdb_info, p4info, REMOVE_ENTRY,
+  PrepareFdbRxVlanTableEntry(&table_entry, fdb_info, *resolver, REMOVE_ENTRY,
                              detail);
   DumpTableEntry();
 
@@ -156,7 +156,7 @@ TEST_F(DpdkFdbRxVlanTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareFdbRxVlanTableEntry(&table_entry, fdb_info, p4info, INSERT_ENTRY,
+  PrepareFdbRxVlanTableEntry(&table_entry, fdb_info, *resolver, INSERT_ENTRY,
                              detail);
   DumpTableEntry();
 
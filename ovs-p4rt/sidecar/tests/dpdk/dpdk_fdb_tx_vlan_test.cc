@@ -136,7 +136,7 @@ TEST_F(DpdkFdbTxVlanTest, remove_entry) {
   InitFdbInfo();
 
   // Act
-  PrepareFdbTxVlanTableEntry(&table_entry, fdb_info, p4info, REMOVE_ENTRY,
+  PrepareFdbTxVlanTableEntry(&table_entry, fdb_info, *resolver, REMOVE_ENTRY,
                              detail);
 
   // Assert
@@ -152,7 +152,7 @@ TEST_F(DpdkFdbTxVlanTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareFdbTxVlanTableEntry(&table_entry, fdb_info, p4info, INSERT_ENTRY,
+  PrepareFdbTxVlanTableEntry(&table_entry, fdb_info, *resolver, INSERT_ENTRY,
                              detail);
 
   // Assert
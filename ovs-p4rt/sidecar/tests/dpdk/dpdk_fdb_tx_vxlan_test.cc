@@ -171,7 +171,7 @@ TEST_F(DpdkFdbTxVxlanTest, remove_entry) {
   InitFdbInfo(OVS_TUNNEL_VXLAN);
 
   // Act
-  PrepareFdbTableEntryforV4VxlanTunnel(&table_entry, fdb_info, p4info,
+  PrepareFdbTableEntryforV4VxlanTunnel(&table_entry, fdb_info, *resolver,
                                        REMOVE_ENTRY, detail);
 
   // Assert
@@ -187,7 +187,7 @@ TEST_F(DpdkFdbTxVxlanTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareFdbTableEntryforV4VxlanTunnel(&table_entry, fdb_info, p4info,
+  PrepareFdbTableEntryforV4VxlanTunnel(&table_entry, fdb_info, *resolver,
                                        INSERT_ENTRY, detail);
 
   // Assert
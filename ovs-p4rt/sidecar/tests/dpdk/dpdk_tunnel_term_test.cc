@@ -182,7 +182,8 @@ TEST_F(DpdkTunnelTermTest, vxlan_remove_entry) {
   InitTunnelInfo();
 
   // Act
-  PrepareTunnelTermTableEntry(&table_entry, tunnel_info, p4info, REMOVE_ENTRY);
+  PrepareTunnelTermTableEntry(&table_entry, tunnel_info, *resolver,
+                              REMOVE_ENTRY);
 
   // Assert
   CheckTableEntry();
@@ -196,7 +197,8 @@ TEST_F(DpdkTunnelTermTest, vxlan_insert_entry) {
   InitAction();
 
   // Act
-  PrepareTunnelTermTableEntry(&table_entry, tunnel_info, p4info, INSERT_ENTRY);
+  PrepareTunnelTermTableEntry(&table_entry, tunnel_info, *resolver,
+                              INSERT_ENTRY);
   DumpTableEntry();
 
   // Assert
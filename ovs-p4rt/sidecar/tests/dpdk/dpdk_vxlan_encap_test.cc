@@ -189,7 +189,8 @@ TEST_F(DpdkVxlanEncapTest, remove_entry) {
   InitTunnelInfo(OVS_TUNNEL_VXLAN);
 
   // Act
-  PrepareVxlanEncapTableEntry(&table_entry, tunnel_info, p4info, REMOVE_ENTRY);
+  PrepareVxlanEncapTableEntry(&table_entry, tunnel_info, *resolver,
+                              REMOVE_ENTRY);
   DumpTableEntry();
 
   // Assert
@@ -204,7 +205,8 @@ TEST_F(DpdkVxlanEncapTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareVxlanEncapTableEntry(&table_entry, tunnel_info, p4info, INSERT_ENTRY);
+  PrepareVxlanEncapTableEntry(&table_entry, tunnel_info, *resolver,
+                              INSERT_ENTRY);
   DumpTableEntry();
 
   // Assert
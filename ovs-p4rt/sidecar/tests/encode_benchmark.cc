@@ -0,0 +1,150 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Microbenchmark for the fixed-width encoders.
+//
+// Measures the cost of encoding a value and storing it in a FieldMatch,
+// with EncodeByteValue() and with the encoder that replaced it.
+
+#include <arpa/inet.h>
+#include <stdarg.h>
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "ovsp4rt_field_encoding.h"
+#include "p4/v1/p4runtime.pb.h"
+
+namespace ovsp4rt {
+namespace {
+
+constexpr uint8_t kMac[6] = {0x00, 0x1a, 0x2b, 0x3c, 0x4d, 0x5e};
+
+// The variadic encoder the fixed-width encoders replaced.
+std::string EncodeByteValue(int arg_count...) {
+  std::string byte_value;
+  va_list args;
+  va_start(args, arg_count);
+
+  for (int arg = 0; arg < arg_count; ++arg) {
+    uint8_t byte = va_arg(args, int);
+    byte_value.push_back(byte);
+  }
+
+  va_end(args);
+  return byte_value;
+}
+
+void BM_BridgeIdByteValue(benchmark::State& state) {
+  ::p4::v1::FieldMatch match;
+  uint8_t bridge_id = 0;
+  for (auto _ : state) {
+    match.mutable_exact()->set_value(EncodeByteValue(1, bridge_id++));
+    benchmark::DoNotOptimize(match);
+  }
+}
+BENCHMARK(BM_BridgeIdByteValue);
+
+void BM_BridgeIdBits(benchmark::State& state) {
+  ::p4::v1::FieldMatch match;
+  uint8_t bridge_id = 0;
+  for (auto _ : state) {
+    match.mutable_exact()->set_value(EncodeBits<8>(bridge_id++));
+    benchmark::DoNotOptimize(match);
+  }
+}
+BENCHMARK(BM_BridgeIdBits);
+
+void BM_VlanIdByteValue(benchmark::State& state) {
+  ::p4::v1::FieldMatch match;
+  uint16_t vlan_id = 0;
+  for (auto _ : state) {
+    match.mutable_exact()->set_value(
+        EncodeByteValue(2, (vlan_id >> 8) & 0x0f, vlan_id & 0xff));
+    vlan_id++;
+    benchmark::DoNotOptimize(match);
+  }
+}
+BENCHMARK(BM_VlanIdByteValue);
+
+void BM_VlanIdBits(benchmark::State& state) {
+  ::p4::v1::FieldMatch match;
+  uint16_t vlan_id = 0;
+  for (auto _ : state) {
+    match.mutable_exact()->set_value(EncodeBits<12>(vlan_id++));
+    benchmark::DoNotOptimize(match);
+  }
+}
+BENCHMARK(BM_VlanIdBits);
+
+void BM_VniByteValue(benchmark::State& state) {
+  ::p4::v1::FieldMatch match;
+  uint32_t vni = 0;
+  for (auto _ : state) {
+    match.mutable_exact()->set_value(EncodeByteValue(
+        3, (vni >> 16) & 0xff, (vni >> 8) & 0xff, vni & 0xff));
+    vni++;
+    benchmark::DoNotOptimize(match);
+  }
+}
+BENCHMARK(BM_VniByteValue);
+
+void BM_VniBits(benchmark::State& state) {
+  ::p4::v1::FieldMatch match;
+  uint32_t vni = 0;
+  for (auto _ : state) {
+    match.mutable_exact()->set_value(EncodeVniValue(vni++));
+    benchmark::DoNotOptimize(match);
+  }
+}
+BENCHMARK(BM_VniBits);
+
+void BM_MacByteValue(benchmark::State& state) {
+  ::p4::v1::FieldMatch match;
+  for (auto _ : state) {
+    match.mutable_exact()->set_value(EncodeByteValue(
+        6, kMac[0], kMac[1], kMac[2], kMac[3], kMac[4], kMac[5]));
+    benchmark::DoNotOptimize(match);
+  }
+}
+BENCHMARK(BM_MacByteValue);
+
+void BM_MacBytes(benchmark::State& state) {
+  ::p4::v1::FieldMatch match;
+  for (auto _ : state) {
+    match.mutable_exact()->set_value(CanonicalizeMac(kMac));
+    benchmark::DoNotOptimize(match);
+  }
+}
+BENCHMARK(BM_MacBytes);
+
+void BM_Ipv6ByteValue(benchmark::State& state) {
+  ::p4::v1::FieldMatch match;
+  struct in6_addr addr = {};
+  inet_pton(AF_INET6, "fe80::1a2b:3c4d", &addr);
+  for (auto _ : state) {
+    std::string value;
+    for (int i = 0; i < 16; i++) {
+      value += EncodeByteValue(1, addr.s6_addr[i]);
+    }
+    match.mutable_exact()->set_value(value);
+    benchmark::DoNotOptimize(match);
+  }
+}
+BENCHMARK(BM_Ipv6ByteValue);
+
+void BM_Ipv6Bytes(benchmark::State& state) {
+  ::p4::v1::FieldMatch match;
+  struct in6_addr addr = {};
+  inet_pton(AF_INET6, "fe80::1a2b:3c4d", &addr);
+  for (auto _ : state) {
+    match.mutable_exact()->set_value(CanonicalizeIpv6(addr));
+    benchmark::DoNotOptimize(match);
+  }
+}
+BENCHMARK(BM_Ipv6Bytes);
+
+}  // namespace
+}  // namespace ovsp4rt
+
+BENCHMARK_MAIN();
@@ -2,25 +2,15 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <arpa/inet.h>
-#include <stdarg.h>
 
 #include <string>
 
 #include "gtest/gtest.h"
 #include "ovsp4rt/ovs-p4rt.h"
-#include "ovsp4rt_private.h"
+#include "ovsp4rt_field_encoding.h"
 
 namespace ovsp4rt {
 
-//----------------------------------------------------------------------
-// Proposed new function (UUT)
-//----------------------------------------------------------------------
-inline std::string EncodeHostPortValue(uint16_t port_value) {
-  port_value = htons(port_value);
-  return EncodeByteValue(2, (((port_value * 2) >> 8) & 0xff),
-                         ((port_value * 2) & 0xff));
-}
-
 //----------------------------------------------------------------------
 // Test case: port_encodings_are_identical
 //
@@ -40,10 +30,11 @@ TEST(EncodeHostPortTestValue, port_encodings_are_identical) {
   // 1. control value: logic extracted from ovsp4rt.cc
   uint16_t dst_port = htons(tunnel_info.dst_port);
 
-  const std::string control_value = EncodeByteValue(
-      2, (((dst_port * 2) >> 8) & 0xff), ((dst_port * 2) & 0xff));
+  const std::string control_value = {
+      static_cast<char>(((dst_port * 2) >> 8) & 0xff),
+      static_cast<char>((dst_port * 2) & 0xff)};
 
-  // 2. experimental value: proposed replacement logic
+  // 2. experimental value: replacement logic
   const std::string experimental_value =
       EncodeHostPortValue(tunnel_info.dst_port);
 
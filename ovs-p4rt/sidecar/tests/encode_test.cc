@@ -0,0 +1,150 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Unit test for the fixed-width encoders. Each encoder is compared
+// with the byte-by-byte encoding of the code it replaced.
+
+#include "ovsp4rt_field_encoding.h"
+
+#include <arpa/inet.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "ovsp4rt/ovs-p4rt.h"
+
+namespace ovsp4rt {
+
+//----------------------------------------------------------------------
+// Encodings produced by the original code
+//----------------------------------------------------------------------
+
+// Returns a string of the low-order bytes of the arguments.
+template <typename... Args>
+std::string Bytes(Args... bytes) {
+  return std::string{static_cast<char>(bytes & 0xff)...};
+}
+
+std::string OldTunnelId(uint32_t vni) {
+  return Bytes((vni >> 16) & 0x0F, (vni >> 8) & 0xFF, vni & 0xFF);
+}
+
+std::string OldVniValue(uint32_t vni) {
+  return Bytes((vni >> 16) & 0xFF, (vni >> 8) & 0xFF, vni & 0xFF);
+}
+
+std::string OldIp(const uint32_t ipv4addr) {
+  return Bytes((ipv4addr & 0xff), ((ipv4addr >> 8) & 0xff),
+               ((ipv4addr >> 16) & 0xff), ((ipv4addr >> 24) & 0xff));
+}
+
+std::string OldIpv6(const struct in6_addr& ipv6addr) {
+  std::string value;
+  for (int i = 0; i < 16; i++) {
+    value += Bytes(ipv6addr.s6_addr[i]);
+  }
+  return value;
+}
+
+std::string OldMac(const uint8_t mac[6]) {
+  return Bytes((mac[0] & 0xff), (mac[1] & 0xff), (mac[2] & 0xff),
+               (mac[3] & 0xff), (mac[4] & 0xff), (mac[5] & 0xff));
+}
+
+// Values that exercise every byte and the bits above each width.
+const uint32_t kValues[] = {0,          1,          0x7f,       0x80,
+                            0xff,       0x100,      0xfff,      0x1000,
+                            0xabcd,     0xffff,     0x12345,    0xfffff,
+                            0x123456,   0xffffff,   0x1234567,  0x89abcdef,
+                            0xfffffffe, 0xffffffff};
+
+//----------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------
+
+TEST(EncodeTest, bits_match_byte_values) {
+  for (uint32_t value : kValues) {
+    SCOPED_TRACE(value);
+    EXPECT_EQ(EncodeBits<8>(value).str(), Bytes(value));
+    EXPECT_EQ(EncodeBits<16>(value).str(),
+              Bytes((value >> 8) & 0xff, value & 0xff));
+    EXPECT_EQ(EncodeBits<12>(value).str(),
+              Bytes((value >> 8) & 0x0f, value & 0xff));
+    EXPECT_EQ(EncodeBits<32>(value).str(),
+              Bytes(value >> 24, (value >> 16) & 0xff,
+                    (value >> 8) & 0xff, value & 0xff));
+  }
+}
+
+TEST(EncodeTest, tunnel_id_matches) {
+  for (uint32_t vni : kValues) {
+    SCOPED_TRACE(vni);
+    EXPECT_EQ(EncodeTunnelId(vni).str(), OldTunnelId(vni));
+  }
+}
+
+TEST(EncodeTest, vni_value_matches) {
+  for (uint32_t vni : kValues) {
+    SCOPED_TRACE(vni);
+    EXPECT_EQ(EncodeVniValue(vni).str(), OldVniValue(vni));
+  }
+}
+
+TEST(EncodeTest, ipv4_address_matches) {
+  for (uint32_t addr : kValues) {
+    SCOPED_TRACE(addr);
+    EXPECT_EQ(CanonicalizeIp(addr).str(), OldIp(addr));
+  }
+  EXPECT_EQ(CanonicalizeIp(htonl(0x0a000001)).str(),
+            std::string("\x0a\x00\x00\x01", 4));
+}
+
+TEST(EncodeTest, ipv6_address_matches) {
+  struct in6_addr addr;
+  ASSERT_EQ(inet_pton(AF_INET6, "fe80::1:2:3:4", &addr), 1);
+  EXPECT_EQ(CanonicalizeIpv6(addr).str(), OldIpv6(addr));
+  EXPECT_EQ(CanonicalizeIpv6(addr).size(), 16);
+}
+
+TEST(EncodeTest, mac_address_matches) {
+  const uint8_t mac[6] = {0x00, 0x1b, 0x21, 0xff, 0x80, 0x7f};
+  EXPECT_EQ(CanonicalizeMac(mac).str(), OldMac(mac));
+}
+
+TEST(EncodeTest, host_port_matches) {
+  for (uint32_t value : kValues) {
+    uint16_t port = value;
+    SCOPED_TRACE(port);
+    uint16_t dst_port = htons(port);
+    EXPECT_EQ(EncodeHostPortValue(port).str(),
+              Bytes((((dst_port * 2) >> 8) & 0xff),
+                    ((dst_port * 2) & 0xff)));
+  }
+}
+
+TEST(EncodeTest, encodes_into_buffer) {
+  char buffer[8] = {};
+  char* end = EncodeBitsTo<24>(0x12345678, buffer);
+  end = EncodeBitsTo<12>(0xabcd, end);
+  EXPECT_EQ(end - buffer, 5);
+  EXPECT_EQ(std::string(buffer, 5), std::string("\x34\x56\x78\x0b\xcd", 5));
+}
+
+TEST(EncodeTest, converts_to_string_view) {
+  auto value = EncodeBits<16>(0x4142);
+  absl::string_view view = value;
+  EXPECT_EQ(view, "AB");
+  std::string str = value;
+  EXPECT_EQ(str, "AB");
+}
+
+TEST(EncodeTest, is_constexpr) {
+  constexpr auto value = EncodeBits<24>(0x123456);
+  static_assert(value[0] == 0x12 && value[1] == 0x34 && value[2] == 0x56,
+                "EncodeBits is not constexpr");
+  static_assert(EncodeTunnelId(0xffffff)[0] == 0x0f,
+                "EncodeTunnelId is not bit<20>");
+  static_assert(EncodedSize<48>() == 6, "bit<48> is 6 bytes");
+}
+
+}  // namespace ovsp4rt
@@ -0,0 +1,256 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "session/ovsp4rt_epoch_audit.h"
+
+#include <grpcpp/grpcpp.h>
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "gtest/gtest.h"
+#include "p4/v1/p4runtime.grpc.pb.h"
+#include "p4/v1/p4runtime.pb.h"
+#include "session/ovsp4rt_shadow_table.h"
+
+namespace ovsp4rt {
+
+constexpr uint64_t SESSION_ID = 1;
+constexpr uint64_t OTHER_SESSION_ID = 2;
+constexpr uint32_t DEVICE_ID = 1;
+constexpr uint32_t TABLE_ID = 100;
+constexpr uint32_t OTHER_TABLE_ID = 200;
+
+::p4::v1::TableEntry ExactEntry(uint32_t table_id, uint32_t value) {
+  ::p4::v1::TableEntry table_entry;
+  table_entry.set_table_id(table_id);
+  auto* match = table_entry.add_match();
+  match->set_field_id(1);
+  match->mutable_exact()->set_value(std::to_string(value));
+  table_entry.mutable_action()->mutable_action()->set_action_id(7);
+  return table_entry;
+}
+
+// P4Runtime server that holds the entries of its tables. Read returns
+// the entries of a table, and Write applies DELETEs.
+class FakeP4RuntimeService : public ::p4::v1::P4Runtime::Service {
+ public:
+  ::grpc::Status Read(
+      ::grpc::ServerContext* context, const ::p4::v1::ReadRequest* request,
+      ::grpc::ServerWriter<::p4::v1::ReadResponse>* writer) override {
+    ::p4::v1::ReadResponse response;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      uint32_t table_id = request->entities(0).table_entry().table_id();
+      for (const auto& [key, entry] : entries_) {
+        if (entry.table_id() == table_id) {
+          *response.add_entities()->mutable_table_entry() = entry;
+        }
+      }
+    }
+    writer->Write(response);
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status Write(::grpc::ServerContext* context,
+                       const ::p4::v1::WriteRequest* request,
+                       ::p4::v1::WriteResponse* response) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    writes_++;
+    for (const auto& update : request->updates()) {
+      const auto& table_entry = update.entity().table_entry();
+      if (update.type() != ::p4::v1::Update::DELETE ||
+          table_entry.has_action() || request->device_id() != DEVICE_ID) {
+        return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT,
+                              "Unexpected update");
+      }
+      entries_.erase(Key(table_entry));
+    }
+    return ::grpc::Status::OK;
+  }
+
+  void Add(const ::p4::v1::TableEntry& table_entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[Key(table_entry)] = table_entry;
+  }
+
+  bool Has(const ::p4::v1::TableEntry& table_entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.count(Key(table_entry)) != 0;
+  }
+
+  size_t size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+  }
+
+  int writes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return writes_;
+  }
+
+ private:
+  static std::string Key(const ::p4::v1::TableEntry& table_entry) {
+    return std::to_string(table_entry.table_id()) + "/" +
+           ShadowTable::MatchKey(table_entry);
+  }
+
+  std::mutex mutex_;
+  std::map<std::string, ::p4::v1::TableEntry> entries_;
+  int writes_ = 0;
+};
+
+class EpochAuditTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ::grpc::ServerBuilder builder;
+    builder.RegisterService(&service_);
+    server_ = builder.BuildAndStart();
+    stub_ = ::p4::v1::P4Runtime::NewStub(
+        server_->InProcessChannel(::grpc::ChannelArguments()));
+    channel_ = std::make_unique<AsyncWriteChannel>(*stub_, nullptr, 4);
+    write_header_.set_device_id(DEVICE_ID);
+  }
+
+  void TearDown() override {
+    channel_.reset();
+    server_->Shutdown();
+  }
+
+  void Write(::p4::v1::Update::Type type,
+             const ::p4::v1::TableEntry& table_entry,
+             const ::absl::Status& status,
+             uint64_t session_id = SESSION_ID) {
+    ::p4::v1::WriteRequest write_request;
+    auto* update = write_request.add_updates();
+    update->set_type(type);
+    *update->mutable_entity()->mutable_table_entry() = table_entry;
+    audit_.RecordWrite(session_id, write_request, {status});
+  }
+
+  ::absl::StatusOr<uint64_t> Sweep(const std::vector<uint32_t>& table_ids) {
+    return audit_.Sweep(*stub_, *channel_, write_header_, table_ids);
+  }
+
+  FakeP4RuntimeService service_;
+  std::unique_ptr<::grpc::Server> server_;
+  std::unique_ptr<::p4::v1::P4Runtime::Stub> stub_;
+  std::unique_ptr<AsyncWriteChannel> channel_;
+  ::p4::v1::WriteRequest write_header_;
+  EpochAudit audit_;
+};
+
+TEST_F(EpochAuditTest, nothing_is_marked_outside_an_epoch) {
+  Write(::p4::v1::Update::INSERT, ExactEntry(TABLE_ID, 1),
+        ::absl::OkStatus());
+  audit_.Mark(SESSION_ID, ExactEntry(TABLE_ID, 2));
+  EXPECT_FALSE(audit_.IsActive(SESSION_ID));
+  EXPECT_EQ(audit_.num_marked(), 0);
+}
+
+TEST_F(EpochAuditTest, written_entries_are_marked) {
+  audit_.Begin(SESSION_ID);
+  Write(::p4::v1::Update::INSERT, ExactEntry(TABLE_ID, 1),
+        ::absl::OkStatus());
+  Write(::p4::v1::Update::INSERT, ExactEntry(TABLE_ID, 2),
+        ::absl::AlreadyExistsError("exists"));
+  Write(::p4::v1::Update::MODIFY, ExactEntry(TABLE_ID, 3),
+        ::absl::OkStatus());
+  Write(::p4::v1::Update::INSERT, ExactEntry(TABLE_ID, 4),
+        ::absl::ResourceExhaustedError("table full"));
+
+  EXPECT_TRUE(audit_.IsMarked(ExactEntry(TABLE_ID, 1)));
+  EXPECT_TRUE(audit_.IsMarked(ExactEntry(TABLE_ID, 2)));
+  EXPECT_TRUE(audit_.IsMarked(ExactEntry(TABLE_ID, 3)));
+  EXPECT_FALSE(audit_.IsMarked(ExactEntry(TABLE_ID, 4)));
+  EXPECT_FALSE(audit_.IsMarked(ExactEntry(OTHER_TABLE_ID, 1)));
+}
+
+TEST_F(EpochAuditTest, deleted_entries_are_unmarked) {
+  audit_.Begin(SESSION_ID);
+  audit_.Mark(SESSION_ID, ExactEntry(TABLE_ID, 1));
+  audit_.Mark(SESSION_ID, ExactEntry(TABLE_ID, 2));
+  audit_.Mark(SESSION_ID, ExactEntry(TABLE_ID, 3));
+  Write(::p4::v1::Update::DELETE, ExactEntry(TABLE_ID, 1),
+        ::absl::OkStatus());
+  Write(::p4::v1::Update::DELETE, ExactEntry(TABLE_ID, 2),
+        ::absl::NotFoundError("not found"));
+  Write(::p4::v1::Update::DELETE, ExactEntry(TABLE_ID, 3),
+        ::absl::UnavailableError("unavailable"));
+
+  EXPECT_FALSE(audit_.IsMarked(ExactEntry(TABLE_ID, 1)));
+  EXPECT_FALSE(audit_.IsMarked(ExactEntry(TABLE_ID, 2)));
+  EXPECT_TRUE(audit_.IsMarked(ExactEntry(TABLE_ID, 3)));
+}
+
+TEST_F(EpochAuditTest, other_sessions_are_ignored) {
+  audit_.Begin(SESSION_ID);
+  Write(::p4::v1::Update::INSERT, ExactEntry(TABLE_ID, 1),
+        ::absl::OkStatus(), OTHER_SESSION_ID);
+  audit_.Mark(OTHER_SESSION_ID, ExactEntry(TABLE_ID, 2));
+  EXPECT_FALSE(audit_.IsActive(OTHER_SESSION_ID));
+  EXPECT_EQ(audit_.num_marked(), 0);
+}
+
+TEST_F(EpochAuditTest, begin_discards_marks) {
+  audit_.Begin(SESSION_ID);
+  audit_.Mark(SESSION_ID, ExactEntry(TABLE_ID, 1));
+  audit_.Begin(SESSION_ID);
+  EXPECT_FALSE(audit_.IsMarked(ExactEntry(TABLE_ID, 1)));
+}
+
+TEST_F(EpochAuditTest, sweep_deletes_unmarked_entries) {
+  for (uint32_t i = 0; i < 5; i++) {
+    service_.Add(ExactEntry(TABLE_ID, i));
+    service_.Add(ExactEntry(OTHER_TABLE_ID, i));
+  }
+
+  audit_.Begin(SESSION_ID);
+  audit_.Mark(SESSION_ID, ExactEntry(TABLE_ID, 1));
+  Write(::p4::v1::Update::INSERT, ExactEntry(TABLE_ID, 3),
+        ::absl::OkStatus());
+  Write(::p4::v1::Update::INSERT, ExactEntry(OTHER_TABLE_ID, 0),
+        ::absl::AlreadyExistsError("exists"));
+
+  auto status_or_deleted = Sweep({TABLE_ID, OTHER_TABLE_ID});
+  ASSERT_TRUE(status_or_deleted.ok());
+  EXPECT_EQ(*status_or_deleted, 7);
+
+  EXPECT_EQ(service_.size(), 3);
+  EXPECT_TRUE(service_.Has(ExactEntry(TABLE_ID, 1)));
+  EXPECT_TRUE(service_.Has(ExactEntry(TABLE_ID, 3)));
+  EXPECT_TRUE(service_.Has(ExactEntry(OTHER_TABLE_ID, 0)));
+}
+
+TEST_F(EpochAuditTest, sweep_leaves_other_tables_alone) {
+  service_.Add(ExactEntry(TABLE_ID, 1));
+  service_.Add(ExactEntry(OTHER_TABLE_ID, 1));
+
+  audit_.Begin(SESSION_ID);
+  auto status_or_deleted = Sweep({TABLE_ID});
+  ASSERT_TRUE(status_or_deleted.ok());
+  EXPECT_EQ(*status_or_deleted, 1);
+  EXPECT_TRUE(service_.Has(ExactEntry(OTHER_TABLE_ID, 1)));
+}
+
+TEST_F(EpochAuditTest, sweep_deletes_in_batches) {
+  const uint32_t num_entries = 2 * EpochAudit::kSweepBatchSize + 1;
+  for (uint32_t i = 0; i < num_entries; i++) {
+    service_.Add(ExactEntry(TABLE_ID, i));
+  }
+
+  audit_.Begin(SESSION_ID);
+  auto status_or_deleted = Sweep({TABLE_ID});
+  ASSERT_TRUE(status_or_deleted.ok());
+  EXPECT_EQ(*status_or_deleted, num_entries);
+  EXPECT_EQ(service_.size(), 0);
+  EXPECT_EQ(service_.writes(), 3);
+}
+
+}  // namespace ovsp4rt
@@ -12,6 +12,7 @@
 #include <stdint.h>
 
 #include <iostream>
+#include <memory>
 #include <string>
 
 #ifdef DUMP_JSON
@@ -23,6 +24,7 @@
 #include "p4/v1/p4runtime.pb.h"
 #include "p4info_helper.h"
 #include "p4info_text.h"
+#include "session/ovsp4rt_p4info_resolver.h"
 #include "stratum/lib/utils.h"
 
 #ifdef DUMP_JSON
@@ -46,6 +48,9 @@ constexpr bool REMOVE_ENTRY = false;
 // P4Info object describing the pipeline configuration.
 static ::p4::config::v1::P4Info p4info;
 
+// Name-to-ID resolver for the p4info object. Input to the UUT.
+static std::unique_ptr<P4InfoResolver> resolver;
+
 class BaseTableTest : public ::testing::Test {
  protected:
   BaseTableTest() : helper(p4info) {
@@ -54,12 +59,13 @@ class BaseTableTest : public ::testing::Test {
 #endif
   }
 
-  // Initializes the p4info object.
+  // Initializes the p4info and resolver objects.
   static void SetUpTestSuite() {
     ::util::Status status = ParseProtoFromString(P4INFO_TEXT, &p4info);
     if (!status.ok()) {
       std::exit(EXIT_FAILURE);
     }
+    resolver = std::make_unique<P4InfoResolver>(p4info);
   }
 
   //----------------------------
@@ -159,7 +159,7 @@ TEST_F(DstIpMacMapTableTest, remove_entry) {
   InitMapInfo();
 
   // Act
-  PrepareDstIpMacMapTableEntry(&table_entry, map_info, p4info, REMOVE_ENTRY,
+  PrepareDstIpMacMapTableEntry(&table_entry, map_info, *resolver, REMOVE_ENTRY,
                                detail);
   DumpTableEntry();
 
@@ -176,7 +176,7 @@ TEST_F(DstIpMacMapTableTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareDstIpMacMapTableEntry(&table_entry, map_info, p4info, INSERT_ENTRY,
+  PrepareDstIpMacMapTableEntry(&table_entry, map_info, *resolver, INSERT_ENTRY,
                                detail);
   DumpTableEntry();
 
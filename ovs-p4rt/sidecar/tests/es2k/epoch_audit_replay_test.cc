@@ -0,0 +1,245 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Unit test for replaying tunnels and VLANs during an audit epoch.
+
+#include <arpa/inet.h>
+#include <grpcpp/grpcpp.h>
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "ovsp4rt/ovs-p4rt.h"
+#include "ovsp4rt_private.h"
+#include "p4/config/v1/p4info.pb.h"
+#include "p4/v1/p4runtime.grpc.pb.h"
+#include "p4/v1/p4runtime.pb.h"
+#include "p4info_text.h"
+#include "session/ovsp4rt_session_manager.h"
+#include "session/ovsp4rt_shadow_table.h"
+#include "stratum/lib/utils.h"
+
+namespace ovsp4rt {
+
+constexpr uint64_t PIPELINE_COOKIE = 1;
+constexpr uint16_t VLAN_ID = 42;
+
+// P4Runtime server that holds the entries written to it. INSERT fails
+// with ALREADY_EXISTS if the entry is present, and Read returns the
+// entries of a table.
+class FakeP4RuntimeService : public ::p4::v1::P4Runtime::Service {
+ public:
+  FakeP4RuntimeService() {
+    EXPECT_TRUE(stratum::ParseProtoFromString(P4INFO_TEXT, &p4info_).ok());
+  }
+
+  ::grpc::Status StreamChannel(
+      ::grpc::ServerContext* context,
+      ::grpc::ServerReaderWriter<::p4::v1::StreamMessageResponse,
+                                 ::p4::v1::StreamMessageRequest>* stream)
+      override {
+    ::p4::v1::StreamMessageRequest request;
+    if (!stream->Read(&request) || !request.has_arbitration()) {
+      return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT,
+                            "Expected arbitration");
+    }
+
+    // Every client is primary.
+    ::p4::v1::StreamMessageResponse response;
+    *response.mutable_arbitration() = request.arbitration();
+    response.mutable_arbitration()->mutable_status()->set_code(
+        ::grpc::StatusCode::OK);
+    stream->Write(response);
+
+    // Keep the stream open until the client closes it.
+    while (stream->Read(&request)) {
+    }
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status GetForwardingPipelineConfig(
+      ::grpc::ServerContext* context,
+      const ::p4::v1::GetForwardingPipelineConfigRequest* request,
+      ::p4::v1::GetForwardingPipelineConfigResponse* response) override {
+    auto* config = response->mutable_config();
+    if (request->response_type() !=
+        ::p4::v1::GetForwardingPipelineConfigRequest::COOKIE_ONLY) {
+      *config->mutable_p4info() = p4info_;
+    }
+    config->mutable_cookie()->set_cookie(PIPELINE_COOKIE);
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status Read(
+      ::grpc::ServerContext* context, const ::p4::v1::ReadRequest* request,
+      ::grpc::ServerWriter<::p4::v1::ReadResponse>* writer) override {
+    ::p4::v1::ReadResponse response;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (const auto& entity : request->entities()) {
+        uint32_t table_id = entity.table_entry().table_id();
+        for (const auto& [key, entry] : entries_) {
+          if (table_id == 0 || entry.table_id() == table_id) {
+            *response.add_entities()->mutable_table_entry() = entry;
+          }
+        }
+      }
+    }
+    writer->Write(response);
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status Write(::grpc::ServerContext* context,
+                       const ::p4::v1::WriteRequest* request,
+                       ::p4::v1::WriteResponse* response) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& update : request->updates()) {
+      const auto& table_entry = update.entity().table_entry();
+      std::string key = Key(table_entry);
+      switch (update.type()) {
+        case ::p4::v1::Update::INSERT:
+          if (entries_.count(key) != 0) {
+            return ::grpc::Status(::grpc::StatusCode::ALREADY_EXISTS,
+                                  "Entry already exists");
+          }
+          entries_[key] = table_entry;
+          break;
+        case ::p4::v1::Update::MODIFY:
+          entries_[key] = table_entry;
+          break;
+        case ::p4::v1::Update::DELETE:
+          entries_.erase(key);
+          break;
+        default:
+          return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT,
+                                "Unexpected update");
+      }
+    }
+    return ::grpc::Status::OK;
+  }
+
+  size_t size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+  }
+
+ private:
+  static std::string Key(const ::p4::v1::TableEntry& table_entry) {
+    return std::to_string(table_entry.table_id()) + "/" +
+           ShadowTable::MatchKey(table_entry);
+  }
+
+  ::p4::config::v1::P4Info p4info_;
+  std::mutex mutex_;
+  std::map<std::string, ::p4::v1::TableEntry> entries_;
+};
+
+class EpochAuditReplayTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    int port = 0;
+    ::grpc::ServerBuilder builder;
+    builder.AddListeningPort("localhost:0",
+                             ::grpc::InsecureServerCredentials(), &port);
+    builder.RegisterService(&service_);
+    server_ = builder.BuildAndStart();
+    ASSERT_NE(port, 0);
+    grpc_addr_ = "localhost:" + std::to_string(port);
+
+    InitTunnelInfo();
+  }
+
+  void TearDown() override {
+    // Close the session, so the server can end its stream channel.
+    SessionManager::Instance().Reset();
+    server_->Shutdown();
+  }
+
+  void InitTunnelInfo() {
+    ASSERT_EQ(inet_pton(AF_INET, "10.20.30.40",
+                        &tunnel_info_.local_ip.ip.v4addr.s_addr),
+              1);
+    tunnel_info_.local_ip.prefix_len = 24;
+    tunnel_info_.local_ip.family = AF_INET;
+
+    ASSERT_EQ(inet_pton(AF_INET, "192.168.17.5",
+                        &tunnel_info_.remote_ip.ip.v4addr.s_addr),
+              1);
+    tunnel_info_.remote_ip.prefix_len = 24;
+    tunnel_info_.remote_ip.family = AF_INET;
+
+    tunnel_info_.src_port = 0x1066;
+    tunnel_info_.dst_port = 4789;
+    tunnel_info_.vni = 0x1776;
+    tunnel_info_.tunnel_type = OVS_TUNNEL_VXLAN;
+  }
+
+  FakeP4RuntimeService service_;
+  std::unique_ptr<::grpc::Server> server_;
+  std::string grpc_addr_;
+  struct tunnel_info tunnel_info_ = {0};
+};
+
+//----------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------
+
+TEST_F(EpochAuditReplayTest, replayed_entries_are_kept) {
+  // Arrange
+  ASSERT_TRUE(ConfigTunnelEntry(tunnel_info_, true, grpc_addr_.c_str()).ok());
+  ASSERT_TRUE(ConfigVlanEntry(VLAN_ID, true, grpc_addr_.c_str()).ok());
+  size_t num_entries = service_.size();
+  ASSERT_GT(num_entries, 2);
+
+  // Act
+  ASSERT_EQ(ovsp4rt_audit_begin_epoch(grpc_addr_.c_str()), 0);
+  EXPECT_TRUE(ConfigTunnelEntry(tunnel_info_, true, grpc_addr_.c_str()).ok());
+  EXPECT_TRUE(ConfigVlanEntry(VLAN_ID, true, grpc_addr_.c_str()).ok());
+
+  uint64_t num_deleted = 0;
+  ASSERT_EQ(ovsp4rt_audit_end_epoch(grpc_addr_.c_str(), &num_deleted), 0);
+
+  // Assert
+  EXPECT_EQ(num_deleted, 0);
+  EXPECT_EQ(service_.size(), num_entries);
+}
+
+TEST_F(EpochAuditReplayTest, entries_not_replayed_are_deleted) {
+  // Arrange
+  ASSERT_TRUE(ConfigTunnelEntry(tunnel_info_, true, grpc_addr_.c_str()).ok());
+  size_t num_tunnel_entries = service_.size();
+  ASSERT_TRUE(ConfigVlanEntry(VLAN_ID, true, grpc_addr_.c_str()).ok());
+  size_t num_vlan_entries = service_.size() - num_tunnel_entries;
+
+  // Act
+  ASSERT_EQ(ovsp4rt_audit_begin_epoch(grpc_addr_.c_str()), 0);
+  EXPECT_TRUE(ConfigTunnelEntry(tunnel_info_, true, grpc_addr_.c_str()).ok());
+
+  uint64_t num_deleted = 0;
+  ASSERT_EQ(ovsp4rt_audit_end_epoch(grpc_addr_.c_str(), &num_deleted), 0);
+
+  // Assert
+  EXPECT_EQ(num_deleted, num_vlan_entries);
+  EXPECT_EQ(service_.size(), num_tunnel_entries);
+}
+
+TEST_F(EpochAuditReplayTest, has_programmed_entries) {
+  // Arrange
+  auto status_or_found = HasProgrammedEntries(grpc_addr_.c_str());
+  ASSERT_TRUE(status_or_found.ok()) << status_or_found.status();
+  EXPECT_FALSE(*status_or_found);
+
+  // Act
+  ASSERT_TRUE(ConfigVlanEntry(VLAN_ID, true, grpc_addr_.c_str()).ok());
+  status_or_found = HasProgrammedEntries(grpc_addr_.c_str());
+
+  // Assert
+  ASSERT_TRUE(status_or_found.ok()) << status_or_found.status();
+  EXPECT_TRUE(*status_or_found);
+}
+
+}  // namespace ovsp4rt
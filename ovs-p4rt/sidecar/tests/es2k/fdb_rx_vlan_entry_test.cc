@@ -151,7 +151,7 @@ TEST_F(FdbRxVlanEntryTest, remove_entry) {
   InitFdbInfo();
 
   // Act
-  PrepareFdbRxVlanTableEntry(&table_entry, fdb_info, p4info, REMOVE_ENTRY,
+  PrepareFdbRxVlanTableEntry(&table_entry, fdb_info, *resolver, REMOVE_ENTRY,
                              detail);
   DumpTableEntry();
 
@@ -168,7 +168,7 @@ TEST_F(FdbRxVlanEntryTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareFdbRxVlanTableEntry(&table_entry, fdb_info, p4info, INSERT_ENTRY,
+  PrepareFdbRxVlanTableEntry(&table_entry, fdb_info, *resolver, INSERT_ENTRY,
                              detail);
   DumpTableEntry();
 
@@ -14,6 +14,7 @@
 #include "logging/ovsp4rt_diag_detail.h"
 #include "ovsp4rt/ovs-p4rt.h"
 #include "ovsp4rt_private.h"
+#include "session/ovsp4rt_fdb_aging.h"
 
 namespace ovsp4rt {
 
@@ -125,7 +126,7 @@ TEST_F(FdbSmacEntryTest, remove_entry) {
   InitFdbInfo();
 
   // Act
-  PrepareFdbSmacTableEntry(&table_entry, fdb_info, p4info, REMOVE_ENTRY,
+  PrepareFdbSmacTableEntry(&table_entry, fdb_info, *resolver, REMOVE_ENTRY,
                            detail);
 
   // Assert
@@ -140,11 +141,82 @@ TEST_F(FdbSmacEntryTest, insert_entry) {
   InitFdbInfo();
 
   // Act
-  PrepareFdbSmacTableEntry(&table_entry, fdb_info, p4info, INSERT_ENTRY,
+  PrepareFdbSmacTableEntry(&table_entry, fdb_info, *resolver, INSERT_ENTRY,
                            detail);
 
   // Assert
   CheckAction();
 }
 
+TEST_F(FdbSmacEntryTest, no_idle_timeout_if_unsupported) {
+  // Arrange
+  InitFdbInfo();
+  FdbAging::Instance().Enable(absl::Seconds(300), nullptr, nullptr);
+
+  // Act
+  PrepareFdbSmacTableEntry(&table_entry, fdb_info, *resolver, INSERT_ENTRY,
+                           detail);
+  FdbAging::Instance().Disable();
+
+  // Assert
+  EXPECT_EQ(table_entry.idle_timeout_ns(), 0);
+}
+
+TEST_F(FdbSmacEntryTest, idle_timeout_if_aging_enabled) {
+  // Arrange
+  InitFdbInfo();
+  ::p4::config::v1::P4Info notify_p4info = p4info;
+  for (auto& table : *notify_p4info.mutable_tables()) {
+    if (table.preamble().id() == TableId()) {
+      table.set_idle_timeout_behavior(::p4::config::v1::Table::NOTIFY_CONTROL);
+    }
+  }
+  P4InfoResolver notify_resolver(notify_p4info);
+  FdbAging::Instance().Enable(absl::Seconds(300), nullptr, nullptr);
+
+  // Act
+  PrepareFdbSmacTableEntry(&table_entry, fdb_info, notify_resolver,
+                           INSERT_ENTRY, detail);
+  FdbAging::Instance().Disable();
+
+  // Assert
+  EXPECT_EQ(table_entry.idle_timeout_ns(), 300000000000);
+}
+
+TEST_F(FdbSmacEntryTest, decode_aged_entry) {
+  // Arrange
+  InitFdbInfo();
+  fdb_info.mac_addr[0] = 0;
+  PrepareFdbSmacTableEntry(&table_entry, fdb_info, *resolver, REMOVE_ENTRY,
+                           detail);
+
+  // The switch may omit the leading zero byte of the MAC address.
+  auto* mac_value = table_entry.mutable_match(0)->mutable_exact();
+  mac_value->set_value(mac_value->value().substr(1));
+
+  // Act
+  struct ovsp4rt_aged_mac aged_mac;
+  bool decoded = DecodeFdbAgingTableEntry(table_entry, *resolver, &aged_mac);
+
+  // Assert
+  ASSERT_TRUE(decoded);
+  EXPECT_EQ(aged_mac.bridge_id, fdb_info.bridge_id);
+  EXPECT_EQ(memcmp(aged_mac.mac_addr, fdb_info.mac_addr, 6), 0);
+}
+
+TEST_F(FdbSmacEntryTest, decode_rejects_other_tables) {
+  // Arrange
+  InitFdbInfo();
+  PrepareFdbSmacTableEntry(&table_entry, fdb_info, *resolver, REMOVE_ENTRY,
+                           detail);
+  table_entry.set_table_id(table_entry.table_id() + 1);
+
+  // Act
+  struct ovsp4rt_aged_mac aged_mac;
+  bool decoded = DecodeFdbAgingTableEntry(table_entry, *resolver, &aged_mac);
+
+  // Assert
+  EXPECT_FALSE(decoded);
+}
+
 }  // namespace ovsp4rt
@@ -192,7 +192,7 @@ TEST_F(FdbTxGeneveEntryTest, remove_v4_tagged_entry) {
   InitV4NativeTagged(SET_GENEVE_UNDERLAY_V4);
 
   // Act
-  PrepareFdbTableEntryforV4GeneveTunnel(&table_entry, learn_info, p4info,
+  PrepareFdbTableEntryforV4GeneveTunnel(&table_entry, learn_info, *resolver,
                                         REMOVE_ENTRY, detail);
 
   // Assert
@@ -208,7 +208,7 @@ TEST_F(FdbTxGeneveEntryTest, insert_v4_tagged_entry) {
   InitV4NativeTagged(SET_GENEVE_UNDERLAY_V4);
 
   // Act
-  PrepareFdbTableEntryforV4GeneveTunnel(&table_entry, learn_info, p4info,
+  PrepareFdbTableEntryforV4GeneveTunnel(&table_entry, learn_info, *resolver,
                                         INSERT_ENTRY, detail);
 
   // Assert
@@ -222,7 +222,7 @@ TEST_F(FdbTxGeneveEntryTest, insert_v4_untagged_entry) {
   InitV4NativeUntagged(POP_VLAN_SET_GENEVE_UNDERLAY_V4);
 
   // Act
-  PrepareFdbTableEntryforV4GeneveTunnel(&table_entry, learn_info, p4info,
+  PrepareFdbTableEntryforV4GeneveTunnel(&table_entry, learn_info, *resolver,
                                         INSERT_ENTRY, detail);
 
   // Assert
@@ -236,7 +236,7 @@ TEST_F(FdbTxGeneveEntryTest, insert_v6_tagged_entry) {
   InitV6NativeTagged(SET_GENEVE_UNDERLAY_V6);
 
   // Act
-  PrepareFdbTableEntryforV4GeneveTunnel(&table_entry, learn_info, p4info,
+  PrepareFdbTableEntryforV4GeneveTunnel(&table_entry, learn_info, *resolver,
                                         INSERT_ENTRY, detail);
 
   // Assert
@@ -250,7 +250,7 @@ TEST_F(FdbTxGeneveEntryTest, insert_v6_untagged_entry) {
   InitV6NativeUntagged(POP_VLAN_SET_GENEVE_UNDERLAY_V6);
 
   // Act
-  PrepareFdbTableEntryforV4GeneveTunnel(&table_entry, learn_info, p4info,
+  PrepareFdbTableEntryforV4GeneveTunnel(&table_entry, learn_info, *resolver,
                                         INSERT_ENTRY, detail);
 
   // Assert
@@ -267,7 +267,7 @@ TEST_F(FdbTxGeneveEntryTest, insert_v6_untagged_entry_20_bit_vni) {
   learn_info.tnl_info.vni = 0xFACED;
 
   // Act
-  PrepareFdbTableEntryforV4GeneveTunnel(&table_entry, learn_info, p4info,
+  PrepareFdbTableEntryforV4GeneveTunnel(&table_entry, learn_info, *resolver,
                                         INSERT_ENTRY, detail);
 
   // Assert
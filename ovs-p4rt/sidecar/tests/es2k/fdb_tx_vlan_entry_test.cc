@@ -213,7 +213,7 @@ TEST_F(FdbTxVlanEntryTest, remove_entry) {
   InitFdbInfo();
 
   // Act
-  PrepareFdbTxVlanTableEntry(&table_entry, fdb_info, p4info, REMOVE_ENTRY,
+  PrepareFdbTxVlanTableEntry(&table_entry, fdb_info, *resolver, REMOVE_ENTRY,
                              detail);
 
   // Assert
@@ -229,7 +229,7 @@ TEST_F(FdbTxVlanEntryTest, insert_untagged_entry) {
   InitUntagged();
 
   // Act
-  PrepareFdbTxVlanTableEntry(&table_entry, fdb_info, p4info, INSERT_ENTRY,
+  PrepareFdbTxVlanTableEntry(&table_entry, fdb_info, *resolver, INSERT_ENTRY,
                              detail);
 
   // Assert
@@ -243,7 +243,7 @@ TEST_F(FdbTxVlanEntryTest, insert_tagged_entry) {
   InitTagged();
 
   // Act
-  PrepareFdbTxVlanTableEntry(&table_entry, fdb_info, p4info, INSERT_ENTRY,
+  PrepareFdbTxVlanTableEntry(&table_entry, fdb_info, *resolver, INSERT_ENTRY,
                              detail);
 
   // Assert
@@ -193,7 +193,7 @@ TEST_F(FdbTxVxlanEntryTest, remove_v4_tagged_entry) {
   InitV4NativeTagged(SET_VXLAN_UNDERLAY_V4);
 
   // Act
-  PrepareFdbTableEntryforV4VxlanTunnel(&table_entry, fdb_info, p4info,
+  PrepareFdbTableEntryforV4VxlanTunnel(&table_entry, fdb_info, *resolver,
                                        REMOVE_ENTRY, detail);
 
   // Assert
@@ -209,7 +209,7 @@ TEST_F(FdbTxVxlanEntryTest, insert_v4_tagged_entry) {
   InitV4NativeTagged(SET_VXLAN_UNDERLAY_V4);
 
   // Act
-  PrepareFdbTableEntryforV4VxlanTunnel(&table_entry, fdb_info, p4info,
+  PrepareFdbTableEntryforV4VxlanTunnel(&table_entry, fdb_info, *resolver,
                                        INSERT_ENTRY, detail);
 
   // Assert
@@ -223,7 +223,7 @@ TEST_F(FdbTxVxlanEntryTest, insert_v4_untagged_entry) {
   InitV4NativeUntagged(POP_VLAN_SET_VXLAN_UNDERLAY_V4);
 
   // Act
-  PrepareFdbTableEntryforV4VxlanTunnel(&table_entry, fdb_info, p4info,
+  PrepareFdbTableEntryforV4VxlanTunnel(&table_entry, fdb_info, *resolver,
                                        INSERT_ENTRY, detail);
 
   // Assert
@@ -237,7 +237,7 @@ TEST_F(FdbTxVxlanEntryTest, insert_v6_tagged_entry) {
   InitV6NativeTagged(SET_VXLAN_UNDERLAY_V6);
 
   // Act
-  PrepareFdbTableEntryforV4VxlanTunnel(&table_entry, fdb_info, p4info,
+  PrepareFdbTableEntryforV4VxlanTunnel(&table_entry, fdb_info, *resolver,
                                        INSERT_ENTRY, detail);
 
   // Assert
@@ -251,7 +251,7 @@ TEST_F(FdbTxVxlanEntryTest, insert_v6_untagged_entry) {
   InitV6NativeUntagged(POP_VLAN_SET_VXLAN_UNDERLAY_V6);
 
   // Act
-  PrepareFdbTableEntryforV4VxlanTunnel(&table_entry, fdb_info, p4info,
+  PrepareFdbTableEntryforV4VxlanTunnel(&table_entry, fdb_info, *resolver,
                                        INSERT_ENTRY, detail);
 
   // Assert
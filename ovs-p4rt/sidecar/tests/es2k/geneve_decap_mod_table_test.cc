@@ -99,7 +99,7 @@ TEST_F(GeneveDecapModTableTest, remove_entry) {
   InitTunnelInfo();
 
   // Act
-  PrepareGeneveDecapModTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareGeneveDecapModTableEntry(&table_entry, tunnel_info, *resolver,
                                   REMOVE_ENTRY);
 
   // Assert
@@ -114,7 +114,7 @@ TEST_F(GeneveDecapModTableTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareGeneveDecapModTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareGeneveDecapModTableEntry(&table_entry, tunnel_info, *resolver,
                                   INSERT_ENTRY);
 
   // Assert
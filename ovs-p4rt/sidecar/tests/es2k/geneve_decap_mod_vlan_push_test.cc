@@ -159,8 +159,8 @@ TEST_F(GeneveDecapModVlanPushTest, remove_entry) {
   InitTunnelInfo();
 
   // Act
-  PrepareGeneveDecapModAndVlanPushTableEntry(&table_entry, tunnel_info, p4info,
-                                             REMOVE_ENTRY);
+  PrepareGeneveDecapModAndVlanPushTableEntry(&table_entry, tunnel_info,
+                                             *resolver, REMOVE_ENTRY);
 
   // Assert
   CheckTableEntry();
@@ -174,8 +174,8 @@ TEST_F(GeneveDecapModVlanPushTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareGeneveDecapModAndVlanPushTableEntry(&table_entry, tunnel_info, p4info,
-                                             INSERT_ENTRY);
+  PrepareGeneveDecapModAndVlanPushTableEntry(&table_entry, tunnel_info,
+                                             *resolver, INSERT_ENTRY);
 
   // Assert
   CheckTableEntry();
@@ -189,8 +189,8 @@ TEST_F(GeneveDecapModVlanPushTest, insert_entry_with_24_bit_vni) {
   InitAction();
 
   // Act
-  PrepareGeneveDecapModAndVlanPushTableEntry(&table_entry, tunnel_info, p4info,
-                                             INSERT_ENTRY);
+  PrepareGeneveDecapModAndVlanPushTableEntry(&table_entry, tunnel_info,
+                                             *resolver, INSERT_ENTRY);
 
   // Assert
   CheckTableEntry();
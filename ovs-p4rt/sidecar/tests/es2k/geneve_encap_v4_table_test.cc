@@ -159,7 +159,8 @@ TEST_F(GeneveEncapV4TableTest, remove_entry) {
   InitV4TunnelInfo(OVS_TUNNEL_GENEVE);
 
   // Act
-  PrepareGeneveEncapTableEntry(&table_entry, tunnel_info, p4info, REMOVE_ENTRY);
+  PrepareGeneveEncapTableEntry(&table_entry, tunnel_info, *resolver,
+                               REMOVE_ENTRY);
   DumpTableEntry();
 
   // Assert
@@ -174,7 +175,8 @@ TEST_F(GeneveEncapV4TableTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareGeneveEncapTableEntry(&table_entry, tunnel_info, p4info, INSERT_ENTRY);
+  PrepareGeneveEncapTableEntry(&table_entry, tunnel_info, *resolver,
+                               INSERT_ENTRY);
   DumpTableEntry();
 
   // Assert
@@ -191,7 +193,8 @@ TEST_F(GeneveEncapV4TableTest, insert_entry_with_24_bit_vni) {
   InitAction();
 
   // Act
-  PrepareGeneveEncapTableEntry(&table_entry, tunnel_info, p4info, INSERT_ENTRY);
+  PrepareGeneveEncapTableEntry(&table_entry, tunnel_info, *resolver,
+                               INSERT_ENTRY);
   DumpTableEntry();
 
   // Assert
@@ -168,7 +168,7 @@ TEST_F(GeneveEncapV4VlanPopTest, remove_entry) {
   InitV4TunnelInfo(OVS_TUNNEL_GENEVE);
 
   // Act
-  PrepareGeneveEncapAndVlanPopTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareGeneveEncapAndVlanPopTableEntry(&table_entry, tunnel_info, *resolver,
                                          REMOVE_ENTRY);
   DumpTableEntry();
 
@@ -184,7 +184,7 @@ TEST_F(GeneveEncapV4VlanPopTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareGeneveEncapAndVlanPopTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareGeneveEncapAndVlanPopTableEntry(&table_entry, tunnel_info, *resolver,
                                          INSERT_ENTRY);
   DumpTableEntry();
 
@@ -174,7 +174,7 @@ TEST_F(GeneveEncapV6TableTest, remove_entry) {
   InitV6TunnelInfo(OVS_TUNNEL_GENEVE);
 
   // Act
-  PrepareV6GeneveEncapTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareV6GeneveEncapTableEntry(&table_entry, tunnel_info, *resolver,
                                  REMOVE_ENTRY);
   DumpTableEntry();
 
@@ -190,7 +190,7 @@ TEST_F(GeneveEncapV6TableTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareV6GeneveEncapTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareV6GeneveEncapTableEntry(&table_entry, tunnel_info, *resolver,
                                  INSERT_ENTRY);
   DumpTableEntry();
 
@@ -191,7 +191,7 @@ TEST_F(GeneveEncapV6VlanPopTest, remove_entry) {
   InitV6TunnelInfo(OVS_TUNNEL_GENEVE);
 
   // Act
-  PrepareV6GeneveEncapAndVlanPopTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareV6GeneveEncapAndVlanPopTableEntry(&table_entry, tunnel_info, *resolver,
                                            REMOVE_ENTRY);
 
   // Assert
@@ -206,7 +206,7 @@ TEST_F(GeneveEncapV6VlanPopTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareV6GeneveEncapAndVlanPopTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareV6GeneveEncapAndVlanPopTableEntry(&table_entry, tunnel_info, *resolver,
                                            INSERT_ENTRY);
 
   // Assert
@@ -223,7 +223,7 @@ TEST_F(GeneveEncapV6VlanPopTest, insert_entry_with_24_bit_vni) {
   InitAction();
 
   // Act
-  PrepareV6GeneveEncapAndVlanPopTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareV6GeneveEncapAndVlanPopTableEntry(&table_entry, tunnel_info, *resolver,
                                            INSERT_ENTRY);
   DumpTableEntry();
 
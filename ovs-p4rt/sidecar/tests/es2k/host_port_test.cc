@@ -0,0 +1,235 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Unit test for resolving the host port of a VSI from the tx_acc_vsi
+// table, as ConfigSrcPortEntry() does.
+
+#include <grpcpp/grpcpp.h>
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "es2k/p4_name_mapping.h"
+#include "gtest/gtest.h"
+#include "ovsp4rt/ovs-p4rt.h"
+#include "ovsp4rt_private.h"
+#include "p4/config/v1/p4info.pb.h"
+#include "p4/v1/p4runtime.grpc.pb.h"
+#include "p4/v1/p4runtime.pb.h"
+#include "p4info_text.h"
+#include "session/ovsp4rt_p4info_resolver.h"
+#include "session/ovsp4rt_session_manager.h"
+#include "session/ovsp4rt_shadow_table.h"
+#include "stratum/lib/utils.h"
+
+namespace ovsp4rt {
+
+constexpr uint32_t SRC_PORT = 42;
+constexpr uint32_t HOST_PORT = 0x809a;
+
+// P4Runtime server that holds the entries written to it. Read returns
+// the entries of a table.
+class FakeP4RuntimeService : public ::p4::v1::P4Runtime::Service {
+ public:
+  explicit FakeP4RuntimeService(const ::p4::config::v1::P4Info& p4info)
+      : p4info_(p4info) {}
+
+  ::grpc::Status StreamChannel(
+      ::grpc::ServerContext* context,
+      ::grpc::ServerReaderWriter<::p4::v1::StreamMessageResponse,
+                                 ::p4::v1::StreamMessageRequest>* stream)
+      override {
+    ::p4::v1::StreamMessageRequest request;
+    if (!stream->Read(&request) || !request.has_arbitration()) {
+      return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT,
+                            "Expected arbitration");
+    }
+
+    // Every client is primary.
+    ::p4::v1::StreamMessageResponse response;
+    *response.mutable_arbitration() = request.arbitration();
+    response.mutable_arbitration()->mutable_status()->set_code(
+        ::grpc::StatusCode::OK);
+    stream->Write(response);
+
+    // Keep the stream open until the client closes it.
+    while (stream->Read(&request)) {
+    }
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status GetForwardingPipelineConfig(
+      ::grpc::ServerContext* context,
+      const ::p4::v1::GetForwardingPipelineConfigRequest* request,
+      ::p4::v1::GetForwardingPipelineConfigResponse* response) override {
+    auto* config = response->mutable_config();
+    if (request->response_type() !=
+        ::p4::v1::GetForwardingPipelineConfigRequest::COOKIE_ONLY) {
+      *config->mutable_p4info() = p4info_;
+    }
+    config->mutable_cookie()->set_cookie(1);
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status Read(
+      ::grpc::ServerContext* context, const ::p4::v1::ReadRequest* request,
+      ::grpc::ServerWriter<::p4::v1::ReadResponse>* writer) override {
+    uint32_t table_id = request->entities(0).table_entry().table_id();
+    ::p4::v1::ReadResponse response;
+    for (const auto& entry : Entries(table_id)) {
+      *response.add_entities()->mutable_table_entry() = entry;
+    }
+    writer->Write(response);
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status Write(::grpc::ServerContext* context,
+                       const ::p4::v1::WriteRequest* request,
+                       ::p4::v1::WriteResponse* response) override {
+    for (const auto& update : request->updates()) {
+      if (update.type() != ::p4::v1::Update::INSERT) {
+        return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT,
+                              "Unexpected update");
+      }
+      Add(update.entity().table_entry());
+    }
+    return ::grpc::Status::OK;
+  }
+
+  void Add(const ::p4::v1::TableEntry& table_entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[std::to_string(table_entry.table_id()) + "/" +
+             ShadowTable::MatchKey(table_entry)] = table_entry;
+  }
+
+  std::vector<::p4::v1::TableEntry> Entries(uint32_t table_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<::p4::v1::TableEntry> entries;
+    for (const auto& [key, entry] : entries_) {
+      if (entry.table_id() == table_id) {
+        entries.push_back(entry);
+      }
+    }
+    return entries;
+  }
+
+ private:
+  const ::p4::config::v1::P4Info& p4info_;
+  std::mutex mutex_;
+  std::map<std::string, ::p4::v1::TableEntry> entries_;
+};
+
+class HostPortTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    ASSERT_TRUE(stratum::ParseProtoFromString(P4INFO_TEXT, &p4info_).ok());
+    resolver_ = std::make_unique<P4InfoResolver>(p4info_);
+  }
+
+  static void TearDownTestSuite() { resolver_.reset(); }
+
+  void SetUp() override {
+    int port = 0;
+    ::grpc::ServerBuilder builder;
+    builder.AddListeningPort("localhost:0",
+                             ::grpc::InsecureServerCredentials(), &port);
+    builder.RegisterService(&service_);
+    server_ = builder.BuildAndStart();
+    ASSERT_NE(port, 0);
+    grpc_addr_ = "localhost:" + std::to_string(port);
+  }
+
+  void TearDown() override {
+    // Close the session, so the server can end its stream channel.
+    SessionManager::Instance().Reset();
+    server_->Shutdown();
+  }
+
+  // Adds a tx_acc_vsi entry to the server, with both of its keys, as
+  // the switch returns it.
+  void AddTxAccVsiEntry(uint32_t sp, uint32_t host_port) {
+    ::p4::v1::TableEntry table_entry;
+    table_entry.set_table_id(resolver_->GetTableId(TX_ACC_VSI_TABLE));
+
+    auto* match = table_entry.add_match();
+    match->set_field_id(resolver_->GetMatchFieldId(TX_ACC_VSI_TABLE,
+                                                   TX_ACC_VSI_TABLE_KEY_VSI));
+    match->mutable_exact()->set_value(
+        std::string(1, static_cast<char>(TxAccVsiKey(sp))));
+
+    match = table_entry.add_match();
+    match->set_field_id(resolver_->GetMatchFieldId(
+        TX_ACC_VSI_TABLE, TX_ACC_VSI_TABLE_KEY_ZERO_PADDING));
+    match->mutable_exact()->set_value(std::string(1, '\0'));
+
+    constexpr char ACTION[] = TX_ACC_VSI_TABLE_ACTION_L2_FWD_AND_BYPASS_BRIDGE;
+    auto* action = table_entry.mutable_action()->mutable_action();
+    action->set_action_id(resolver_->GetActionId(ACTION));
+    auto* param = action->add_params();
+    param->set_param_id(resolver_->GetParamId(
+        ACTION, ACTION_L2_FWD_AND_BYPASS_BRIDGE_PARAM_PORT));
+    param->set_value(std::string("\x00\x00", 2) +
+                     static_cast<char>(host_port >> 8) +
+                     static_cast<char>(host_port & 0xff));
+
+    service_.Add(table_entry);
+  }
+
+  std::vector<::p4::v1::TableEntry> SrcPortEntries() {
+    return service_.Entries(
+        resolver_->GetTableId(SOURCE_PORT_TO_BRIDGE_MAP_TABLE));
+  }
+
+  static ::p4::config::v1::P4Info p4info_;
+  static std::unique_ptr<P4InfoResolver> resolver_;
+
+  FakeP4RuntimeService service_{p4info_};
+  std::unique_ptr<::grpc::Server> server_;
+  std::string grpc_addr_;
+};
+
+::p4::config::v1::P4Info HostPortTest::p4info_;
+std::unique_ptr<P4InfoResolver> HostPortTest::resolver_;
+
+//----------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------
+
+TEST_F(HostPortTest, host_port_from_tx_acc_vsi) {
+  // Arrange
+  AddTxAccVsiEntry(SRC_PORT, HOST_PORT);
+  struct src_port_info vsi_sp = {0};
+  vsi_sp.src_port = SRC_PORT;
+
+  // Act
+  auto status = ConfigSrcPortEntry(vsi_sp, true, grpc_addr_.c_str());
+
+  // Assert
+  ASSERT_TRUE(status.ok()) << status;
+  auto entries = SrcPortEntries();
+  ASSERT_EQ(entries.size(), 1);
+  EXPECT_EQ(entries[0].match(0).ternary().value(),
+            std::string("\x80\x9a", 2));
+}
+
+// The host port used to default to 0 when the VSI had no tx_acc_vsi
+// entry. The source port entry is now not programmed at all.
+TEST_F(HostPortTest, no_tx_acc_vsi_entry) {
+  // Arrange
+  struct src_port_info vsi_sp = {0};
+  vsi_sp.src_port = SRC_PORT;
+
+  // Act
+  auto status = ConfigSrcPortEntry(vsi_sp, true, grpc_addr_.c_str());
+
+  // Assert
+  EXPECT_EQ(status.code(), absl::StatusCode::kNotFound);
+  EXPECT_TRUE(SrcPortEntries().empty());
+}
+
+}  // namespace ovsp4rt
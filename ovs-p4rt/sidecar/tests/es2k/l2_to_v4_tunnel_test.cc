@@ -154,7 +154,7 @@ TEST_F(L2ToV4TunnelTest, remove_entry) {
   InitTunnelInfo();
 
   // Act
-  PrepareL2ToTunnelV4(&table_entry, fdb_info, p4info, REMOVE_ENTRY, detail);
+  PrepareL2ToTunnelV4(&table_entry, fdb_info, *resolver, REMOVE_ENTRY, detail);
   DumpTableEntry();
 
   // Assert
@@ -170,7 +170,7 @@ TEST_F(L2ToV4TunnelTest, insert_entry) {
   InitTunnelInfo();
 
   // Act
-  PrepareL2ToTunnelV4(&table_entry, fdb_info, p4info, INSERT_ENTRY, detail);
+  PrepareL2ToTunnelV4(&table_entry, fdb_info, *resolver, INSERT_ENTRY, detail);
   DumpTableEntry();
 
   // Assert
@@ -115,7 +115,7 @@ TEST_F(L2ToV6TunnelTest, remove_entry) {
   InitFdbInfo();
 
   // Act
-  PrepareL2ToTunnelV6(&table_entry, fdb_info, p4info, REMOVE_ENTRY, detail);
+  PrepareL2ToTunnelV6(&table_entry, fdb_info, *resolver, REMOVE_ENTRY, detail);
   DumpTableEntry();
 
   // Assert
@@ -130,7 +130,7 @@ TEST_F(L2ToV6TunnelTest, insert_entry) {
   InitFdbInfo();
 
   // Act
-  PrepareL2ToTunnelV6(&table_entry, fdb_info, p4info, INSERT_ENTRY, detail);
+  PrepareL2ToTunnelV6(&table_entry, fdb_info, *resolver, INSERT_ENTRY, detail);
   DumpTableEntry();
 
   // Assert
@@ -0,0 +1,75 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Unit test for the compile-time P4 object IDs generated by
+// p4ids/mkp4idshdr.py.
+
+#include <string>
+
+#include "base_table_test.h"
+#include "gtest/gtest.h"
+#include "ovsp4rt_p4ids_gen.h"
+#include "session/ovsp4rt_p4info_resolver.h"
+
+namespace ovsp4rt {
+
+// The lookups can be evaluated at compile time.
+static_assert(p4ids::TableId("no_such_table") == -1, "TableId");
+static_assert(p4ids::ActionId("no_such_action") == -1, "ActionId");
+
+class P4IdsTest : public BaseTableTest {
+ protected:
+  P4IdsTest() {}
+};
+
+//----------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------
+
+TEST_F(P4IdsTest, fingerprint_matches_runtime_fingerprint) {
+  EXPECT_EQ(P4InfoFingerprint(p4info), p4ids::kFingerprint);
+  EXPECT_EQ(resolver->fingerprint(), p4ids::kFingerprint);
+}
+
+TEST_F(P4IdsTest, fingerprint_changes_if_id_changes) {
+  ::p4::config::v1::P4Info modified(p4info);
+  auto* table = modified.mutable_tables(0);
+  table->mutable_preamble()->set_id(table->preamble().id() + 1);
+
+  EXPECT_NE(P4InfoFingerprint(modified), p4ids::kFingerprint);
+}
+
+TEST_F(P4IdsTest, table_ids_match_resolver) {
+  for (const auto& entry : p4ids::kTableIds) {
+    EXPECT_EQ(entry.id, resolver->GetTableId(entry.name))
+        << "table '" << entry.name << "'";
+    EXPECT_EQ(p4ids::TableId(entry.name), entry.id);
+  }
+}
+
+TEST_F(P4IdsTest, action_ids_match_resolver) {
+  for (const auto& entry : p4ids::kActionIds) {
+    EXPECT_EQ(entry.id, resolver->GetActionId(entry.name))
+        << "action '" << entry.name << "'";
+    EXPECT_EQ(p4ids::ActionId(entry.name), entry.id);
+  }
+}
+
+TEST_F(P4IdsTest, match_field_ids_match_resolver) {
+  for (const auto& entry : p4ids::kMatchFieldIds) {
+    EXPECT_EQ(entry.id, resolver->GetMatchFieldId(entry.scope, entry.name))
+        << "match field '" << entry.name << "' in table '" << entry.scope
+        << "'";
+    EXPECT_EQ(p4ids::MatchFieldId(entry.scope, entry.name), entry.id);
+  }
+}
+
+TEST_F(P4IdsTest, param_ids_match_resolver) {
+  for (const auto& entry : p4ids::kParamIds) {
+    EXPECT_EQ(entry.id, resolver->GetParamId(entry.scope, entry.name))
+        << "param '" << entry.name << "' in action '" << entry.scope << "'";
+    EXPECT_EQ(p4ids::ParamId(entry.scope, entry.name), entry.id);
+  }
+}
+
+}  // namespace ovsp4rt
@@ -0,0 +1,150 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Microbenchmark for P4InfoResolver.
+//
+// Compares the cost of resolving the IDs needed to build an l2_fwd_tx
+// table entry by scanning the P4Info (the original implementation)
+// with the cost of resolving them with a P4InfoResolver, and measures
+// the per-entry cost of PrepareFdbTxVlanTableEntry().
+
+#include <cstdlib>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "es2k/p4_name_mapping.h"
+#include "logging/ovsp4rt_diag_detail.h"
+#include "ovsp4rt/ovs-p4rt.h"
+#include "ovsp4rt_private.h"
+#include "p4/config/v1/p4info.pb.h"
+#include "p4info_text.h"
+#include "session/ovsp4rt_p4info_resolver.h"
+#include "stratum/lib/utils.h"
+
+namespace ovsp4rt {
+namespace {
+
+const ::p4::config::v1::P4Info& GetP4Info() {
+  static const ::p4::config::v1::P4Info* p4info = [] {
+    auto* info = new ::p4::config::v1::P4Info;
+    if (!stratum::ParseProtoFromString(P4INFO_TEXT, info).ok()) {
+      std::exit(EXIT_FAILURE);
+    }
+    return info;
+  }();
+  return *p4info;
+}
+
+//----------------------------------------------------------------------
+// Linear scans, as implemented before the resolver was introduced.
+//----------------------------------------------------------------------
+
+int ScanTableId(const ::p4::config::v1::P4Info& p4info,
+                const std::string& t_name) {
+  for (const auto& table : p4info.tables()) {
+    const auto& pre = table.preamble();
+    if (pre.name() == t_name) return pre.id();
+  }
+  return -1;
+}
+
+int ScanActionId(const ::p4::config::v1::P4Info& p4info,
+                 const std::string& a_name) {
+  for (const auto& action : p4info.actions()) {
+    const auto& pre = action.preamble();
+    if (pre.name() == a_name) return pre.id();
+  }
+  return -1;
+}
+
+int ScanParamId(const ::p4::config::v1::P4Info& p4info,
+                const std::string& a_name, const std::string& param_name) {
+  for (const auto& action : p4info.actions()) {
+    const auto& pre = action.preamble();
+    if (pre.name() != a_name) continue;
+    for (const auto& param : action.params())
+      if (param.name() == param_name) return param.id();
+  }
+  return -1;
+}
+
+int ScanMatchFieldId(const ::p4::config::v1::P4Info& p4info,
+                     const std::string& t_name, const std::string& mf_name) {
+  for (const auto& table : p4info.tables()) {
+    const auto& pre = table.preamble();
+    if (pre.name() != t_name) continue;
+    for (const auto& mf : table.match_fields())
+      if (mf.name() == mf_name) return mf.id();
+  }
+  return -1;
+}
+
+//----------------------------------------------------------------------
+// Benchmarks
+//----------------------------------------------------------------------
+
+// IDs looked up by PrepareFdbTxVlanTableEntry() for a tagged entry.
+void BM_FdbTxIdsLinearScan(benchmark::State& state) {
+  const auto& p4info = GetP4Info();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ScanTableId(p4info, L2_FWD_TX_TABLE));
+    benchmark::DoNotOptimize(ScanMatchFieldId(p4info, L2_FWD_TX_TABLE,
+                                              L2_FWD_TX_TABLE_KEY_DST_MAC));
+    benchmark::DoNotOptimize(ScanMatchFieldId(p4info, L2_FWD_TX_TABLE,
+                                              L2_FWD_TX_TABLE_KEY_BRIDGE_ID));
+    benchmark::DoNotOptimize(
+        ScanActionId(p4info, L2_FWD_TX_TABLE_ACTION_L2_FWD));
+    benchmark::DoNotOptimize(ScanParamId(p4info, L2_FWD_TX_TABLE_ACTION_L2_FWD,
+                                         ACTION_L2_FWD_PARAM_PORT));
+  }
+}
+BENCHMARK(BM_FdbTxIdsLinearScan);
+
+void BM_FdbTxIdsResolver(benchmark::State& state) {
+  const P4InfoResolver resolver(GetP4Info());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(GetTableId(resolver, L2_FWD_TX_TABLE));
+    benchmark::DoNotOptimize(GetMatchFieldId(resolver, L2_FWD_TX_TABLE,
+                                             L2_FWD_TX_TABLE_KEY_DST_MAC));
+    benchmark::DoNotOptimize(GetMatchFieldId(resolver, L2_FWD_TX_TABLE,
+                                             L2_FWD_TX_TABLE_KEY_BRIDGE_ID));
+    benchmark::DoNotOptimize(
+        GetActionId(resolver, L2_FWD_TX_TABLE_ACTION_L2_FWD));
+    benchmark::DoNotOptimize(GetParamId(resolver, L2_FWD_TX_TABLE_ACTION_L2_FWD,
+                                        ACTION_L2_FWD_PARAM_PORT));
+  }
+}
+BENCHMARK(BM_FdbTxIdsResolver);
+
+// Per-entry cost of building a tagged l2_fwd_tx table entry.
+void BM_PrepareFdbTxVlanTableEntry(benchmark::State& state) {
+  const P4InfoResolver resolver(GetP4Info());
+  struct mac_learning_info learn_info = {0};
+  learn_info.bridge_id = 42;
+  learn_info.src_port = 17;
+  learn_info.vlan_info.port_vlan_mode = P4_PORT_VLAN_NATIVE_TAGGED;
+  DiagDetail detail;
+
+  for (auto _ : state) {
+    ::p4::v1::TableEntry table_entry;
+    PrepareFdbTxVlanTableEntry(&table_entry, learn_info, resolver, true,
+                               detail);
+    benchmark::DoNotOptimize(table_entry);
+  }
+}
+BENCHMARK(BM_PrepareFdbTxVlanTableEntry);
+
+// One-time cost of building the resolver for a new P4Info snapshot.
+void BM_BuildResolver(benchmark::State& state) {
+  const auto& p4info = GetP4Info();
+  for (auto _ : state) {
+    P4InfoResolver resolver(p4info);
+    benchmark::DoNotOptimize(resolver);
+  }
+}
+BENCHMARK(BM_BuildResolver);
+
+}  // namespace
+}  // namespace ovsp4rt
+
+BENCHMARK_MAIN();
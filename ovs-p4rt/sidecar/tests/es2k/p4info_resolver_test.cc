@@ -0,0 +1,107 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Unit test for P4InfoResolver
+
+#include <string>
+
+#include "base_table_test.h"
+#include "gtest/gtest.h"
+#include "session/ovsp4rt_p4info_resolver.h"
+
+namespace ovsp4rt {
+
+class P4InfoResolverTest : public BaseTableTest {
+ protected:
+  P4InfoResolverTest() {}
+};
+
+//----------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------
+
+TEST_F(P4InfoResolverTest, resolves_all_tables) {
+  ASSERT_GT(p4info.tables_size(), 0);
+  EXPECT_EQ(resolver->num_tables(), p4info.tables_size());
+
+  for (const auto& table : p4info.tables()) {
+    const auto& table_name = table.preamble().name();
+    EXPECT_EQ(resolver->GetTableId(table_name), table.preamble().id())
+        << "table '" << table_name << "'";
+
+    // Some tables have more than one match field with the same name.
+    // Lookups return the first one, as the linear scan did.
+    for (const auto& mf : table.match_fields()) {
+      int expected_id = -1;
+      for (const auto& first : table.match_fields()) {
+        if (first.name() == mf.name()) {
+          expected_id = first.id();
+          break;
+        }
+      }
+      EXPECT_EQ(resolver->GetMatchFieldId(table_name, mf.name()), expected_id)
+          << "match field '" << mf.name() << "' in table '" << table_name
+          << "'";
+    }
+  }
+}
+
+TEST_F(P4InfoResolverTest, resolves_all_actions) {
+  ASSERT_GT(p4info.actions_size(), 0);
+  EXPECT_EQ(resolver->num_actions(), p4info.actions_size());
+
+  for (const auto& action : p4info.actions()) {
+    const auto& action_name = action.preamble().name();
+    EXPECT_EQ(resolver->GetActionId(action_name), action.preamble().id())
+        << "action '" << action_name << "'";
+
+    for (const auto& param : action.params()) {
+      EXPECT_EQ(resolver->GetParamId(action_name, param.name()), param.id())
+          << "param '" << param.name() << "' in action '" << action_name
+          << "'";
+    }
+  }
+}
+
+TEST_F(P4InfoResolverTest, unknown_names_return_minus_one) {
+  const auto& table = p4info.tables(0);
+  const auto& action = p4info.actions(0);
+
+  EXPECT_EQ(resolver->GetTableId("no_such_table"), -1);
+  EXPECT_EQ(resolver->GetActionId("no_such_action"), -1);
+
+  EXPECT_EQ(resolver->GetMatchFieldId("no_such_table", "no_such_field"), -1);
+  EXPECT_EQ(resolver->GetMatchFieldId(table.preamble().name(), "no_such_field"),
+            -1);
+
+  EXPECT_EQ(resolver->GetParamId("no_such_action", "no_such_param"), -1);
+  EXPECT_EQ(resolver->GetParamId(action.preamble().name(), "no_such_param"),
+            -1);
+}
+
+TEST_F(P4InfoResolverTest, aliases_are_not_resolved) {
+  // Lookups are by fully-qualified name only, as they were before the
+  // resolver was introduced.
+  for (const auto& table : p4info.tables()) {
+    const auto& pre = table.preamble();
+    if (!pre.alias().empty() && pre.alias() != pre.name()) {
+      EXPECT_EQ(resolver->GetTableId(pre.alias()), -1)
+          << "alias '" << pre.alias() << "'";
+    }
+  }
+}
+
+TEST_F(P4InfoResolverTest, idle_timeout_follows_table_behavior) {
+  // The ES2K pipeline does not notify the controller of idle entries.
+  const auto& table = p4info.tables(0);
+  EXPECT_FALSE(resolver->SupportsIdleTimeout(table.preamble().name()));
+  EXPECT_FALSE(resolver->SupportsIdleTimeout("no_such_table"));
+
+  ::p4::config::v1::P4Info notify_p4info = p4info;
+  notify_p4info.mutable_tables(0)->set_idle_timeout_behavior(
+      ::p4::config::v1::Table::NOTIFY_CONTROL);
+  P4InfoResolver notify_resolver(notify_p4info);
+  EXPECT_TRUE(notify_resolver.SupportsIdleTimeout(table.preamble().name()));
+}
+
+}  // namespace ovsp4rt
@@ -0,0 +1,182 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Microbenchmark for the Prepare functions.
+//
+// Measures the per-entry cost of building an insert for each table
+// whose entries are filled in from a TableTemplate. The l2_fwd_tx
+// entry is also built field by field, as it was before templates were
+// introduced, for comparison.
+
+#include <arpa/inet.h>
+
+#include <cstdlib>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "es2k/p4_name_mapping.h"
+#include "logging/ovsp4rt_diag_detail.h"
+#include "ovsp4rt/ovs-p4rt.h"
+#include "ovsp4rt_field_encoding.h"
+#include "ovsp4rt_private.h"
+#include "p4/config/v1/p4info.pb.h"
+#include "p4info_text.h"
+#include "session/ovsp4rt_p4info_resolver.h"
+#include "stratum/lib/utils.h"
+
+namespace ovsp4rt {
+namespace {
+
+const P4InfoResolver& GetResolver() {
+  static const P4InfoResolver* resolver = [] {
+    ::p4::config::v1::P4Info p4info;
+    if (!stratum::ParseProtoFromString(P4INFO_TEXT, &p4info).ok()) {
+      std::exit(EXIT_FAILURE);
+    }
+    return new P4InfoResolver(p4info);
+  }();
+  return *resolver;
+}
+
+struct mac_learning_info MakeLearnInfo() {
+  struct mac_learning_info learn_info = {0};
+  for (int i = 0; i < 6; i++) {
+    learn_info.mac_addr[i] = 0x10 + i;
+  }
+  learn_info.bridge_id = 42;
+  learn_info.src_port = 17;
+  learn_info.rx_src_port = 18;
+  learn_info.vlan_info.port_vlan_mode = P4_PORT_VLAN_NATIVE_TAGGED;
+  learn_info.tnl_info.vni = 0x1234;
+  learn_info.tnl_info.local_ip.family = AF_INET;
+  learn_info.tnl_info.remote_ip.family = AF_INET;
+  learn_info.tnl_info.remote_ip.ip.v4addr.s_addr = htonl(0x0a000001);
+  return learn_info;
+}
+
+struct ip_mac_map_info MakeIpMacMapInfo() {
+  struct ip_mac_map_info ip_info = {0};
+  for (int i = 0; i < 6; i++) {
+    ip_info.src_mac_addr[i] = 0x20 + i;
+    ip_info.dst_mac_addr[i] = 0x30 + i;
+  }
+  ip_info.src_ip_addr.ip.v4addr.s_addr = htonl(0x0a000001);
+  ip_info.dst_ip_addr.ip.v4addr.s_addr = htonl(0x0a000002);
+  return ip_info;
+}
+
+//----------------------------------------------------------------------
+// Field-by-field construction of a tagged l2_fwd_tx entry.
+//----------------------------------------------------------------------
+
+void BuildFdbTxVlanFieldByField(p4::v1::TableEntry* table_entry,
+                                const struct mac_learning_info& learn_info,
+                                const P4InfoResolver& p4info) {
+  table_entry->set_table_id(GetTableId(p4info, L2_FWD_TX_TABLE));
+
+  auto match = table_entry->add_match();
+  match->set_field_id(
+      GetMatchFieldId(p4info, L2_FWD_TX_TABLE, L2_FWD_TX_TABLE_KEY_DST_MAC));
+  match->mutable_exact()->set_value(CanonicalizeMac(learn_info.mac_addr));
+
+  auto match1 = table_entry->add_match();
+  match1->set_field_id(
+      GetMatchFieldId(p4info, L2_FWD_TX_TABLE, L2_FWD_TX_TABLE_KEY_BRIDGE_ID));
+  match1->mutable_exact()->set_value(EncodeBits<8>(learn_info.bridge_id));
+
+  auto action = table_entry->mutable_action()->mutable_action();
+  action->set_action_id(GetActionId(p4info, L2_FWD_TX_TABLE_ACTION_L2_FWD));
+  auto param = action->add_params();
+  param->set_param_id(GetParamId(p4info, L2_FWD_TX_TABLE_ACTION_L2_FWD,
+                                 ACTION_L2_FWD_PARAM_PORT));
+  param->set_value(EncodeBits<8>(learn_info.src_port));
+}
+
+//----------------------------------------------------------------------
+// Benchmarks
+//----------------------------------------------------------------------
+
+void BM_FdbTxVlanFieldByField(benchmark::State& state) {
+  const auto& resolver = GetResolver();
+  const auto learn_info = MakeLearnInfo();
+  for (auto _ : state) {
+    ::p4::v1::TableEntry table_entry;
+    BuildFdbTxVlanFieldByField(&table_entry, learn_info, resolver);
+    benchmark::DoNotOptimize(table_entry);
+  }
+}
+BENCHMARK(BM_FdbTxVlanFieldByField);
+
+// Defines a benchmark for a Prepare function that takes a
+// mac_learning_info.
+#define LEARN_INFO_BENCHMARK(name, prepare)                             \
+  void BM_##name(benchmark::State& state) {                             \
+    const auto& resolver = GetResolver();                               \
+    const auto learn_info = MakeLearnInfo();                            \
+    DiagDetail detail;                                                  \
+    for (auto _ : state) {                                              \
+      ::p4::v1::TableEntry table_entry;                                 \
+      prepare(&table_entry, learn_info, resolver, true, detail);        \
+      benchmark::DoNotOptimize(table_entry);                            \
+    }                                                                   \
+  }                                                                     \
+  BENCHMARK(BM_##name)
+
+LEARN_INFO_BENCHMARK(FdbTxVlan, PrepareFdbTxVlanTableEntry);
+LEARN_INFO_BENCHMARK(FdbRxVlan, PrepareFdbRxVlanTableEntry);
+LEARN_INFO_BENCHMARK(FdbSmac, PrepareFdbSmacTableEntry);
+LEARN_INFO_BENCHMARK(FdbTxVxlan, PrepareFdbTableEntryforV4VxlanTunnel);
+LEARN_INFO_BENCHMARK(FdbTxGeneve, PrepareFdbTableEntryforV4GeneveTunnel);
+LEARN_INFO_BENCHMARK(L2ToTunnelV4, PrepareL2ToTunnelV4);
+LEARN_INFO_BENCHMARK(L2ToTunnelV6, PrepareL2ToTunnelV6);
+
+void BM_SrcIpMacMap(benchmark::State& state) {
+  const auto& resolver = GetResolver();
+  auto ip_info = MakeIpMacMapInfo();
+  DiagDetail detail;
+  for (auto _ : state) {
+    ::p4::v1::TableEntry table_entry;
+    PrepareSrcIpMacMapTableEntry(&table_entry, ip_info, resolver, true,
+                                 detail);
+    benchmark::DoNotOptimize(table_entry);
+  }
+}
+BENCHMARK(BM_SrcIpMacMap);
+
+void BM_DstIpMacMap(benchmark::State& state) {
+  const auto& resolver = GetResolver();
+  auto ip_info = MakeIpMacMapInfo();
+  DiagDetail detail;
+  for (auto _ : state) {
+    ::p4::v1::TableEntry table_entry;
+    PrepareDstIpMacMapTableEntry(&table_entry, ip_info, resolver, true,
+                                 detail);
+    benchmark::DoNotOptimize(table_entry);
+  }
+}
+BENCHMARK(BM_DstIpMacMap);
+
+void BM_VlanPush(benchmark::State& state) {
+  const auto& resolver = GetResolver();
+  for (auto _ : state) {
+    ::p4::v1::TableEntry table_entry;
+    PrepareVlanPushTableEntry(&table_entry, 10, resolver, true);
+    benchmark::DoNotOptimize(table_entry);
+  }
+}
+BENCHMARK(BM_VlanPush);
+
+void BM_TxAccVsi(benchmark::State& state) {
+  const auto& resolver = GetResolver();
+  for (auto _ : state) {
+    ::p4::v1::TableEntry table_entry;
+    PrepareTxAccVsiTableEntry(&table_entry, 24, resolver);
+    benchmark::DoNotOptimize(table_entry);
+  }
+}
+BENCHMARK(BM_TxAccVsi);
+
+}  // namespace
+}  // namespace ovsp4rt
+
+BENCHMARK_MAIN();
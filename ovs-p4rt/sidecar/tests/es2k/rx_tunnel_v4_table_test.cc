@@ -142,7 +142,7 @@ TEST_F(RxTunnelPortV4TableTest, remove_entry) {
   InitTunnelInfo();
 
   // Act
-  PrepareRxTunnelTableEntry(&table_entry, tunnel_info, p4info, REMOVE_ENTRY);
+  PrepareRxTunnelTableEntry(&table_entry, tunnel_info, *resolver, REMOVE_ENTRY);
 
   // Assert
   CheckTableEntry();
@@ -156,7 +156,7 @@ TEST_F(RxTunnelPortV4TableTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareRxTunnelTableEntry(&table_entry, tunnel_info, p4info, INSERT_ENTRY);
+  PrepareRxTunnelTableEntry(&table_entry, tunnel_info, *resolver, INSERT_ENTRY);
 
   // Assert
   CheckAction();
@@ -174,7 +174,8 @@ TEST_F(RxTunnelPortV6TableTest, remove_entry) {
   InitTunnelInfo();
 
   // Act
-  PrepareV6RxTunnelTableEntry(&table_entry, tunnel_info, p4info, REMOVE_ENTRY);
+  PrepareV6RxTunnelTableEntry(&table_entry, tunnel_info, *resolver,
+                              REMOVE_ENTRY);
 
   // Assert
   CheckTableEntry();
@@ -188,7 +189,8 @@ TEST_F(RxTunnelPortV6TableTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareV6RxTunnelTableEntry(&table_entry, tunnel_info, p4info, INSERT_ENTRY);
+  PrepareV6RxTunnelTableEntry(&table_entry, tunnel_info, *resolver,
+                              INSERT_ENTRY);
 
   // Assert
   CheckAction();
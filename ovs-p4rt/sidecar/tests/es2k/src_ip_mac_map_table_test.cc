@@ -157,7 +157,7 @@ TEST_F(SrcIpMacMapTableTest, remove_entry) {
   InitMapInfo();
 
   // Act
-  PrepareSrcIpMacMapTableEntry(&table_entry, map_info, p4info, REMOVE_ENTRY,
+  PrepareSrcIpMacMapTableEntry(&table_entry, map_info, *resolver, REMOVE_ENTRY,
                                detail);
 
   // Assert
@@ -173,7 +173,7 @@ TEST_F(SrcIpMacMapTableTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareSrcIpMacMapTableEntry(&table_entry, map_info, p4info, INSERT_ENTRY,
+  PrepareSrcIpMacMapTableEntry(&table_entry, map_info, *resolver, INSERT_ENTRY,
                                detail);
 
   // Assert
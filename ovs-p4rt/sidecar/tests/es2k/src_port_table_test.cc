@@ -143,7 +143,7 @@ TEST_F(SrcPortTableTest, remove_entry) {
   InitMapInfo();
 
   // Act
-  PrepareSrcPortTableEntry(&table_entry, port_info, p4info, REMOVE_ENTRY);
+  PrepareSrcPortTableEntry(&table_entry, port_info, *resolver, REMOVE_ENTRY);
 
   // Assert
   CheckTableEntry();
@@ -157,7 +157,7 @@ TEST_F(SrcPortTableTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareSrcPortTableEntry(&table_entry, port_info, p4info, INSERT_ENTRY);
+  PrepareSrcPortTableEntry(&table_entry, port_info, *resolver, INSERT_ENTRY);
   DumpTableEntry();
 
   // Assert
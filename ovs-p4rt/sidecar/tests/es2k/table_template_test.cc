@@ -0,0 +1,114 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Unit test for TableDescriptor and TableTemplate
+
+#include "session/ovsp4rt_table_template.h"
+
+#include <string>
+
+#include "base_table_test.h"
+#include "es2k/p4_name_mapping.h"
+#include "gtest/gtest.h"
+
+namespace ovsp4rt {
+
+const TableDescriptor kTestL2FwdTx(
+    L2_FWD_TX_TABLE,
+    {L2_FWD_TX_TABLE_KEY_DST_MAC, L2_FWD_TX_TABLE_KEY_BRIDGE_ID},
+    L2_FWD_TX_TABLE_ACTION_REMOVE_VLAN_AND_FWD,
+    {ACTION_REMOVE_VLAN_AND_FWD_PARAM_PORT_ID,
+     ACTION_REMOVE_VLAN_AND_FWD_PARAM_VLAN_PTR});
+
+const TableDescriptor kTestUnknownNames("no_such_table", {"no_such_field"},
+                                        "no_such_action", {"no_such_param"});
+
+class TableTemplateTest : public BaseTableTest {
+ protected:
+  TableTemplateTest() {}
+};
+
+//----------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------
+
+TEST_F(TableTemplateTest, descriptors_are_registered) {
+  const auto& registry = TableDescriptor::Registry();
+  ASSERT_LT(kTestL2FwdTx.index(), registry.size());
+  EXPECT_EQ(registry[kTestL2FwdTx.index()], &kTestL2FwdTx);
+  EXPECT_EQ(registry[kTestUnknownNames.index()], &kTestUnknownNames);
+}
+
+TEST_F(TableTemplateTest, fill_with_action) {
+  ::p4::v1::TableEntry table_entry;
+  resolver->GetTemplate(kTestL2FwdTx).Fill(&table_entry, true);
+
+  EXPECT_EQ(table_entry.table_id(), resolver->GetTableId(L2_FWD_TX_TABLE));
+  ASSERT_EQ(table_entry.match_size(), 2);
+  EXPECT_EQ(table_entry.match(0).field_id(),
+            resolver->GetMatchFieldId(L2_FWD_TX_TABLE,
+                                      L2_FWD_TX_TABLE_KEY_DST_MAC));
+  EXPECT_EQ(table_entry.match(1).field_id(),
+            resolver->GetMatchFieldId(L2_FWD_TX_TABLE,
+                                      L2_FWD_TX_TABLE_KEY_BRIDGE_ID));
+  EXPECT_TRUE(table_entry.match(0).has_exact());
+
+  const auto& action = table_entry.action().action();
+  EXPECT_EQ(action.action_id(),
+            resolver->GetActionId(L2_FWD_TX_TABLE_ACTION_REMOVE_VLAN_AND_FWD));
+  ASSERT_EQ(action.params_size(), 2);
+  EXPECT_EQ(action.params(1).param_id(),
+            resolver->GetParamId(L2_FWD_TX_TABLE_ACTION_REMOVE_VLAN_AND_FWD,
+                                 ACTION_REMOVE_VLAN_AND_FWD_PARAM_VLAN_PTR));
+}
+
+TEST_F(TableTemplateTest, fill_without_action) {
+  ::p4::v1::TableEntry table_entry;
+  resolver->GetTemplate(kTestL2FwdTx).Fill(&table_entry, false);
+
+  EXPECT_EQ(table_entry.match_size(), 2);
+  EXPECT_FALSE(table_entry.has_action());
+}
+
+TEST_F(TableTemplateTest, fill_replaces_entry) {
+  ::p4::v1::TableEntry table_entry;
+  table_entry.add_match()->set_field_id(99);
+  table_entry.set_priority(1);
+
+  resolver->GetTemplate(kTestL2FwdTx).Fill(&table_entry, false);
+
+  EXPECT_EQ(table_entry.match_size(), 2);
+  EXPECT_EQ(table_entry.priority(), 0);
+}
+
+TEST_F(TableTemplateTest, set_values) {
+  ::p4::v1::TableEntry table_entry;
+  const auto& tmpl = resolver->GetTemplate(kTestL2FwdTx);
+  tmpl.Fill(&table_entry, true);
+  SetMatchValue(&table_entry, 1, std::string(1, 5));
+  SetParamValue(&table_entry, 0, std::string(1, 17));
+
+  EXPECT_EQ(table_entry.match(0).exact().value(), "");
+  EXPECT_EQ(table_entry.match(1).exact().value(), std::string(1, 5));
+  EXPECT_EQ(table_entry.action().action().params(0).value(),
+            std::string(1, 17));
+
+  // Values do not leak into the template.
+  tmpl.Fill(&table_entry, true);
+  EXPECT_EQ(table_entry.match(1).exact().value(), "");
+  EXPECT_EQ(table_entry.action().action().params(0).value(), "");
+}
+
+TEST_F(TableTemplateTest, unknown_names_resolve_to_minus_one) {
+  ::p4::v1::TableEntry table_entry;
+  resolver->GetTemplate(kTestUnknownNames).Fill(&table_entry, true);
+
+  EXPECT_EQ(table_entry.table_id(), static_cast<uint32_t>(-1));
+  EXPECT_EQ(table_entry.match(0).field_id(), static_cast<uint32_t>(-1));
+  EXPECT_EQ(table_entry.action().action().action_id(),
+            static_cast<uint32_t>(-1));
+  EXPECT_EQ(table_entry.action().action().params(0).param_id(),
+            static_cast<uint32_t>(-1));
+}
+
+}  // namespace ovsp4rt
@@ -191,7 +191,8 @@ TEST_F(TunnelTermV4TableTest, vxlan_remove_untagged_entry) {
   InitVxlanUntagged();
 
   // Act
-  PrepareTunnelTermTableEntry(&table_entry, tunnel_info, p4info, REMOVE_ENTRY);
+  PrepareTunnelTermTableEntry(&table_entry, tunnel_info, *resolver,
+                              REMOVE_ENTRY);
 
   // Assert
   CheckTableEntry();
@@ -205,7 +206,8 @@ TEST_F(TunnelTermV4TableTest, vxlan_insert_untagged_entry) {
   InitVxlanUntagged();
 
   // Act
-  PrepareTunnelTermTableEntry(&table_entry, tunnel_info, p4info, INSERT_ENTRY);
+  PrepareTunnelTermTableEntry(&table_entry, tunnel_info, *resolver,
+                              INSERT_ENTRY);
   DumpTableEntry();
 
   // Assert
@@ -218,7 +220,8 @@ TEST_F(TunnelTermV4TableTest, vxlan_remove_tagged_entry) {
   InitVxlanTagged();
 
   // Act
-  PrepareTunnelTermTableEntry(&table_entry, tunnel_info, p4info, REMOVE_ENTRY);
+  PrepareTunnelTermTableEntry(&table_entry, tunnel_info, *resolver,
+                              REMOVE_ENTRY);
 
   // Assert
   CheckTableEntry();
@@ -232,7 +235,8 @@ TEST_F(TunnelTermV4TableTest, vxlan_insert_tagged_entry) {
   InitVxlanTagged();
 
   // Act
-  PrepareTunnelTermTableEntry(&table_entry, tunnel_info, p4info, INSERT_ENTRY);
+  PrepareTunnelTermTableEntry(&table_entry, tunnel_info, *resolver,
+                              INSERT_ENTRY);
   DumpTableEntry();
 
   // Assert
@@ -249,7 +253,8 @@ TEST_F(TunnelTermV4TableTest, geneve_remove_untagged_entry) {
   InitGeneveUntagged();
 
   // Act
-  PrepareTunnelTermTableEntry(&table_entry, tunnel_info, p4info, REMOVE_ENTRY);
+  PrepareTunnelTermTableEntry(&table_entry, tunnel_info, *resolver,
+                              REMOVE_ENTRY);
 
   // Assert
   CheckTableEntry();
@@ -263,7 +268,8 @@ TEST_F(TunnelTermV4TableTest, geneve_insert_untagged_entry) {
   InitGeneveUntagged();
 
   // Act
-  PrepareTunnelTermTableEntry(&table_entry, tunnel_info, p4info, INSERT_ENTRY);
+  PrepareTunnelTermTableEntry(&table_entry, tunnel_info, *resolver,
+                              INSERT_ENTRY);
 
   // Assert
   CheckAction();
@@ -275,7 +281,8 @@ TEST_F(TunnelTermV4TableTest, geneve_remove_tagged_entry) {
   InitGeneveTagged();
 
   // Act
-  PrepareTunnelTermTableEntry(&table_entry, tunnel_info, p4info, REMOVE_ENTRY);
+  PrepareTunnelTermTableEntry(&table_entry, tunnel_info, *resolver,
+                              REMOVE_ENTRY);
 
   // Assert
   CheckTableEntry();
@@ -289,7 +296,8 @@ TEST_F(TunnelTermV4TableTest, geneve_insert_tagged_entry) {
   InitGeneveTagged();
 
   // Act
-  PrepareTunnelTermTableEntry(&table_entry, tunnel_info, p4info, INSERT_ENTRY);
+  PrepareTunnelTermTableEntry(&table_entry, tunnel_info, *resolver,
+                              INSERT_ENTRY);
 
   // Assert
   CheckAction();
@@ -302,7 +310,8 @@ TEST_F(TunnelTermV4TableTest, geneve_insert_untagged_entry_with_20_bit_vni) {
   tunnel_info.vni = 0x95054;
 
   // Act
-  PrepareTunnelTermTableEntry(&table_entry, tunnel_info, p4info, INSERT_ENTRY);
+  PrepareTunnelTermTableEntry(&table_entry, tunnel_info, *resolver,
+                              INSERT_ENTRY);
 
   // Assert
   CheckTableEntry();
@@ -229,7 +229,7 @@ TEST_F(TunnelTermV6TableTest, remove_vxlan_untagged_entry) {
   InitVxlanUntagged();
 
   // Act
-  PrepareV6TunnelTermTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareV6TunnelTermTableEntry(&table_entry, tunnel_info, *resolver,
                                 REMOVE_ENTRY);
 
   // Assert
@@ -244,7 +244,7 @@ TEST_F(TunnelTermV6TableTest, insert_vxlan_untagged_entry) {
   InitVxlanUntagged();
 
   // Act
-  PrepareV6TunnelTermTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareV6TunnelTermTableEntry(&table_entry, tunnel_info, *resolver,
                                 INSERT_ENTRY);
 
   // Assert
@@ -257,7 +257,7 @@ TEST_F(TunnelTermV6TableTest, remove_vxlan_tagged_entry) {
   InitVxlanTagged();
 
   // Act
-  PrepareV6TunnelTermTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareV6TunnelTermTableEntry(&table_entry, tunnel_info, *resolver,
                                 REMOVE_ENTRY);
 
   // Assert
@@ -272,7 +272,7 @@ TEST_F(TunnelTermV6TableTest, insert_vxlan_tagged_entry) {
   InitVxlanTagged();
 
   // Act
-  PrepareV6TunnelTermTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareV6TunnelTermTableEntry(&table_entry, tunnel_info, *resolver,
                                 INSERT_ENTRY);
 
   // Assert
@@ -289,7 +289,7 @@ TEST_F(TunnelTermV6TableTest, remove_geneve_untagged_entry) {
   InitGeneveUntagged();
 
   // Act
-  PrepareV6TunnelTermTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareV6TunnelTermTableEntry(&table_entry, tunnel_info, *resolver,
                                 REMOVE_ENTRY);
 
   // Assert
@@ -304,7 +304,7 @@ TEST_F(TunnelTermV6TableTest, insert_geneve_untagged_entry) {
   InitGeneveUntagged();
 
   // Act
-  PrepareV6TunnelTermTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareV6TunnelTermTableEntry(&table_entry, tunnel_info, *resolver,
                                 INSERT_ENTRY);
 
   // Assert
@@ -317,7 +317,7 @@ TEST_F(TunnelTermV6TableTest, remove_geneve_tagged_entry) {
   InitGeneveTagged();
 
   // Act
-  PrepareV6TunnelTermTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareV6TunnelTermTableEntry(&table_entry, tunnel_info, *resolver,
                                 REMOVE_ENTRY);
 
   // Assert
@@ -332,7 +332,7 @@ TEST_F(TunnelTermV6TableTest, insert_geneve_tagged_entry) {
   InitGeneveTagged();
 
   // Act
-  PrepareV6TunnelTermTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareV6TunnelTermTableEntry(&table_entry, tunnel_info, *resolver,
                                 INSERT_ENTRY);
   DumpTableEntry();
 
@@ -1,7 +1,7 @@
 // Copyright 2024 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
-// Unit test for PrepareTxAccVsiTableEntry()
+// Unit test for PrepareTxAccVsiTableEntry() and DecodeTxAccVsiTableEntry()
 
 #include <stdint.h>
 
@@ -68,6 +68,32 @@ class TxAccVsiTableTest : public BaseTableTest {
     EXPECT_EQ(table_entry.table_id(), TableId());
   }
 
+  //----------------------------
+  // AddPaddingMatch()
+  //----------------------------
+
+  // Adds the zero_padding key, which the switch returns with the VSI
+  // when the entry is read.
+  void AddPaddingMatch() {
+    auto* match = table_entry.add_match();
+    match->set_field_id(GetMatchFieldId("zero_padding"));
+    match->mutable_exact()->set_value(std::string("\x00", 1));
+  }
+
+  //----------------------------
+  // AddPortAction()
+  //----------------------------
+
+  // Adds the action the switch returns when the entry is read.
+  void AddPortAction(const std::string& port_value) {
+    SelectAction("l2_fwd_and_bypass_bridge");
+    auto* action = table_entry.mutable_action()->mutable_action();
+    action->set_action_id(ActionId());
+    auto* param = action->add_params();
+    param->set_param_id(GetParamId("port"));
+    param->set_value(port_value);
+  }
+
   //----------------------------
   // Protected member data
   //----------------------------
@@ -84,7 +110,7 @@ TEST_F(TxAccVsiTableTest, sp_8_bits) {
   info_sp = 42;
 
   // Act
-  PrepareTxAccVsiTableEntry(&table_entry, info_sp, p4info);
+  PrepareTxAccVsiTableEntry(&table_entry, info_sp, *resolver);
 
   // Assert
   CheckTableEntry();
@@ -92,6 +118,95 @@ TEST_F(TxAccVsiTableTest, sp_8_bits) {
   CheckNoAction();
 }
 
+TEST_F(TxAccVsiTableTest, decode_read_entry) {
+  // Arrange
+  info_sp = 42;
+  PrepareTxAccVsiTableEntry(&table_entry, info_sp, *resolver);
+  AddPaddingMatch();
+  AddPortAction(std::string("\x00\x00\x80\x9a", 4));
+
+  // Act
+  uint32_t vsi = 0;
+  uint32_t host_port = 0;
+  bool decoded =
+      DecodeTxAccVsiTableEntry(table_entry, *resolver, &vsi, &host_port);
+
+  // Assert
+  ASSERT_TRUE(decoded);
+  EXPECT_EQ(vsi, TxAccVsiKey(info_sp));
+  EXPECT_EQ(host_port, 0x809a);
+}
+
+TEST_F(TxAccVsiTableTest, decode_canonical_port_value) {
+  // Arrange
+  info_sp = 42;
+  PrepareTxAccVsiTableEntry(&table_entry, info_sp, *resolver);
+  AddPaddingMatch();
+  AddPortAction("\x05");
+
+  // Act
+  uint32_t vsi = 0;
+  uint32_t host_port = 0;
+  bool decoded =
+      DecodeTxAccVsiTableEntry(table_entry, *resolver, &vsi, &host_port);
+
+  // Assert
+  ASSERT_TRUE(decoded);
+  EXPECT_EQ(host_port, 5);
+}
+
+TEST_F(TxAccVsiTableTest, decode_padding_before_vsi) {
+  // Arrange
+  info_sp = 42;
+  PrepareTxAccVsiTableEntry(&table_entry, info_sp, *resolver);
+  AddPaddingMatch();
+  table_entry.mutable_match()->SwapElements(0, 1);
+  AddPortAction("\x05");
+
+  // Act
+  uint32_t vsi = 0;
+  uint32_t host_port = 0;
+  bool decoded =
+      DecodeTxAccVsiTableEntry(table_entry, *resolver, &vsi, &host_port);
+
+  // Assert
+  ASSERT_TRUE(decoded);
+  EXPECT_EQ(vsi, TxAccVsiKey(info_sp));
+  EXPECT_EQ(host_port, 5);
+}
+
+TEST_F(TxAccVsiTableTest, decode_entry_without_vsi) {
+  // Arrange
+  table_entry.set_table_id(TableId());
+  AddPaddingMatch();
+  AddPortAction("\x05");
+
+  // Act
+  uint32_t vsi = 0;
+  uint32_t host_port = 0;
+  bool decoded =
+      DecodeTxAccVsiTableEntry(table_entry, *resolver, &vsi, &host_port);
+
+  // Assert
+  EXPECT_FALSE(decoded);
+}
+
+TEST_F(TxAccVsiTableTest, decode_entry_without_action) {
+  // Arrange
+  info_sp = 42;
+  PrepareTxAccVsiTableEntry(&table_entry, info_sp, *resolver);
+  AddPaddingMatch();
+
+  // Act
+  uint32_t vsi = 0;
+  uint32_t host_port = 0;
+  bool decoded =
+      DecodeTxAccVsiTableEntry(table_entry, *resolver, &vsi, &host_port);
+
+  // Assert
+  EXPECT_FALSE(decoded);
+}
+
 #if 0
 
 TEST_F(TxAccVsiTableTest, sp_11_bits) {
@@ -99,7 +214,7 @@ TEST_F(TxAccVsiTableTest, sp_11_bits) {
   info_sp = 0x765;
 
   // Act
-  PrepareTxAccVsiTableEntry(&table_entry, info_sp, p4info);
+  PrepareTxAccVsiTableEntry(&table_entry, info_sp, *resolver);
 
   // Assert
   CheckTableEntry();
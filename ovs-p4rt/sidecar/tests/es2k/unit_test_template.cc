@@ -90,7 +90,7 @@ TEST_F(TemplateTest, remove_entry) {
   InitInputInfo();
 
   // Act
-  PrepareTemplateTableEntry(&table_entry, input_info, p4info, REMOVE_ENTRY
+  PrepareTemplateTableEntry(&table_entry, input_info, *resolver, REMOVE_ENTRY
 #ifdef DIAG_DETAIL
                             ,
                             detail
@@ -112,7 +112,7 @@ TEST_F(TemplateTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareTemplateTableEntry(&table_entry, input_info, p4info, INSERT_ENTRY
+  PrepareTemplateTableEntry(&table_entry, input_info, *resolver, INSERT_ENTRY
 #ifdef DIAG_DETAIL
                             ,
                             detail
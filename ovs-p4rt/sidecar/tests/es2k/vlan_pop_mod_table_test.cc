@@ -93,7 +93,7 @@ TEST_F(VlanPopTableTest, remove_entry) {
   InitVlanInfo();
 
   // Act
-  PrepareVlanPopTableEntry(&table_entry, vlan_id, p4info, REMOVE_ENTRY);
+  PrepareVlanPopTableEntry(&table_entry, vlan_id, *resolver, REMOVE_ENTRY);
 
   // Assert
   CheckTableEntry();
@@ -107,7 +107,7 @@ TEST_F(VlanPopTableTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareVlanPopTableEntry(&table_entry, vlan_id, p4info, INSERT_ENTRY);
+  PrepareVlanPopTableEntry(&table_entry, vlan_id, *resolver, INSERT_ENTRY);
 
   // Assert
   CheckTableEntry();
@@ -163,7 +163,7 @@ TEST_F(VlanPushModTableTest, remove_entry) {
   InitPushInfo();
 
   // Act
-  PrepareVlanPushTableEntry(&table_entry, push_info.vlan_id, p4info,
+  PrepareVlanPushTableEntry(&table_entry, push_info.vlan_id, *resolver,
                             REMOVE_ENTRY);
 
   // Assert
@@ -178,7 +178,7 @@ TEST_F(VlanPushModTableTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareVlanPushTableEntry(&table_entry, push_info.vlan_id, p4info,
+  PrepareVlanPushTableEntry(&table_entry, push_info.vlan_id, *resolver,
                             INSERT_ENTRY);
 
   // Assert
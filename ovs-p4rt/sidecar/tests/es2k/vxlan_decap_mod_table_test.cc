@@ -99,7 +99,7 @@ TEST_F(VxlanDecapModTableTest, remove_entry) {
   InitTunnelInfo();
 
   // Act
-  PrepareVxlanDecapModTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareVxlanDecapModTableEntry(&table_entry, tunnel_info, *resolver,
                                  REMOVE_ENTRY);
 
   // Assert
@@ -114,7 +114,7 @@ TEST_F(VxlanDecapModTableTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareVxlanDecapModTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareVxlanDecapModTableEntry(&table_entry, tunnel_info, *resolver,
                                  INSERT_ENTRY);
 
   // Assert
@@ -128,7 +128,7 @@ TEST_F(VxlanDecapModTableTest, insert_entry_with_20_bit_vni) {
   tunnel_info.vni = 0x87124;  // 20-bit value
 
   // Act
-  PrepareVxlanDecapModTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareVxlanDecapModTableEntry(&table_entry, tunnel_info, *resolver,
                                  INSERT_ENTRY);
 
   // Assert
@@ -144,7 +144,7 @@ TEST_F(VxlanDecapModTableTest, insert_entry_with_24_bit_vni) {
   tunnel_info.vni = 0x871244;  // 24-bit value
 
   // Act
-  PrepareVxlanDecapModTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareVxlanDecapModTableEntry(&table_entry, tunnel_info, *resolver,
                                  INSERT_ENTRY);
 
   // Assert
@@ -159,8 +159,8 @@ TEST_F(VxlanDecapModVlanPushTest, remove_entry) {
   InitTunnelInfo();
 
   // Act
-  PrepareVxlanDecapModAndVlanPushTableEntry(&table_entry, tunnel_info, p4info,
-                                            REMOVE_ENTRY);
+  PrepareVxlanDecapModAndVlanPushTableEntry(&table_entry, tunnel_info,
+                                            *resolver, REMOVE_ENTRY);
 
   // Assert
   CheckTableEntry();
@@ -174,8 +174,8 @@ TEST_F(VxlanDecapModVlanPushTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareVxlanDecapModAndVlanPushTableEntry(&table_entry, tunnel_info, p4info,
-                                            INSERT_ENTRY);
+  PrepareVxlanDecapModAndVlanPushTableEntry(&table_entry, tunnel_info,
+                                            *resolver, INSERT_ENTRY);
 
   // Assert
   CheckTableEntry();
@@ -189,8 +189,8 @@ TEST_F(VxlanDecapModVlanPushTest, insert_entry_with_24_bit_vni) {
   InitAction();
 
   // Act
-  PrepareVxlanDecapModAndVlanPushTableEntry(&table_entry, tunnel_info, p4info,
-                                            INSERT_ENTRY);
+  PrepareVxlanDecapModAndVlanPushTableEntry(&table_entry, tunnel_info,
+                                            *resolver, INSERT_ENTRY);
 
   // Assert
   CheckTableEntry();
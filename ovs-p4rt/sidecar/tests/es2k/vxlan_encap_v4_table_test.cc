@@ -168,7 +168,8 @@ TEST_F(VxlanEncapV4TableTest, remove_entry) {
   InitV4TunnelInfo(OVS_TUNNEL_VXLAN);
 
   // Act
-  PrepareVxlanEncapTableEntry(&table_entry, tunnel_info, p4info, REMOVE_ENTRY);
+  PrepareVxlanEncapTableEntry(&table_entry, tunnel_info, *resolver,
+                              REMOVE_ENTRY);
   DumpTableEntry();
 
   // Assert
@@ -183,7 +184,8 @@ TEST_F(VxlanEncapV4TableTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareVxlanEncapTableEntry(&table_entry, tunnel_info, p4info, INSERT_ENTRY);
+  PrepareVxlanEncapTableEntry(&table_entry, tunnel_info, *resolver,
+                              INSERT_ENTRY);
   DumpTableEntry();
 
   // Assert
@@ -168,7 +168,7 @@ TEST_F(VxlanEncapV4VlanPopTest, remove_entry) {
   InitV4TunnelInfo(OVS_TUNNEL_VXLAN);
 
   // Act
-  PrepareVxlanEncapAndVlanPopTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareVxlanEncapAndVlanPopTableEntry(&table_entry, tunnel_info, *resolver,
                                         REMOVE_ENTRY);
   DumpTableEntry();
 
@@ -184,7 +184,7 @@ TEST_F(VxlanEncapV4VlanPopTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareVxlanEncapAndVlanPopTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareVxlanEncapAndVlanPopTableEntry(&table_entry, tunnel_info, *resolver,
                                         INSERT_ENTRY);
   DumpTableEntry();
 
@@ -200,7 +200,7 @@ TEST_F(VxlanEncapV4VlanPopTest, insert_entry_24_bit_vni) {
   tunnel_info.vni = 0x95054;
 
   // Act
-  PrepareVxlanEncapAndVlanPopTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareVxlanEncapAndVlanPopTableEntry(&table_entry, tunnel_info, *resolver,
                                         INSERT_ENTRY);
   DumpTableEntry();
 
@@ -173,7 +173,7 @@ TEST_F(VxlanEncapV6TableTest, remove_entry) {
   InitV6TunnelInfo(OVS_TUNNEL_VXLAN);
 
   // Act
-  PrepareV6VxlanEncapTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareV6VxlanEncapTableEntry(&table_entry, tunnel_info, *resolver,
                                 REMOVE_ENTRY);
   DumpTableEntry();
 
@@ -189,7 +189,7 @@ TEST_F(VxlanEncapV6TableTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareV6VxlanEncapTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareV6VxlanEncapTableEntry(&table_entry, tunnel_info, *resolver,
                                 INSERT_ENTRY);
   DumpTableEntry();
 
@@ -173,7 +173,7 @@ TEST_F(VxlanEncapV6VlanPopTest, remove_entry) {
   InitV6TunnelInfo(OVS_TUNNEL_VXLAN);
 
   // Act
-  PrepareV6VxlanEncapAndVlanPopTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareV6VxlanEncapAndVlanPopTableEntry(&table_entry, tunnel_info, *resolver,
                                           REMOVE_ENTRY);
   DumpTableEntry();
 
@@ -189,7 +189,7 @@ TEST_F(VxlanEncapV6VlanPopTest, insert_entry) {
   InitAction();
 
   // Act
-  PrepareV6VxlanEncapAndVlanPopTableEntry(&table_entry, tunnel_info, p4info,
+  PrepareV6VxlanEncapAndVlanPopTableEntry(&table_entry, tunnel_info, *resolver,
                                           INSERT_ENTRY);
   DumpTableEntry();
 
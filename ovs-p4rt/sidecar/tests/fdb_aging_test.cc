@@ -0,0 +1,143 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "session/ovsp4rt_fdb_aging.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+#include "absl/time/time.h"
+#include "gtest/gtest.h"
+#include "ovsp4rt/ovs-p4rt.h"
+#include "p4/v1/p4runtime.pb.h"
+
+namespace ovsp4rt {
+
+class FdbAgingTest : public ::testing::Test {
+ protected:
+  void TearDown() override { aging.Disable(); }
+
+  // Decodes entries whose only match value is the last byte of the MAC
+  // address. Entries without a match do not decode.
+  static bool Decode(OvsP4rtSession* session,
+                     const ::p4::v1::TableEntry& table_entry,
+                     struct ovsp4rt_aged_mac* aged_mac) {
+    if (table_entry.match_size() == 0) {
+      return false;
+    }
+    aged_mac->bridge_id = 1;
+    aged_mac->mac_addr[5] = table_entry.match(0).exact().value()[0];
+    return true;
+  }
+
+  void Enable() {
+    aging.Enable(absl::Seconds(10), Decode,
+                 [this](const struct ovsp4rt_aged_mac* macs, size_t num_macs) {
+                   batches.emplace_back(macs, macs + num_macs);
+                 });
+  }
+
+  static void AddEntry(::p4::v1::IdleTimeoutNotification* notification,
+                       uint8_t mac) {
+    auto* table_entry = notification->add_table_entry();
+    if (mac) {
+      table_entry->add_match()->mutable_exact()->set_value(
+          std::string(1, mac));
+    }
+  }
+
+  FdbAging aging;
+  std::vector<std::vector<struct ovsp4rt_aged_mac>> batches;
+};
+
+TEST_F(FdbAgingTest, disabled_by_default) {
+  ::p4::v1::IdleTimeoutNotification notification;
+  AddEntry(&notification, 0x11);
+
+  aging.HandleNotification(nullptr, notification);
+
+  EXPECT_EQ(aging.idle_timeout_ns(), 0);
+  EXPECT_EQ(aging.num_aged(), 0);
+}
+
+TEST_F(FdbAgingTest, enable_sets_idle_timeout) {
+  Enable();
+  EXPECT_EQ(aging.idle_timeout_ns(), 10000000000);
+
+  aging.Disable();
+  EXPECT_EQ(aging.idle_timeout_ns(), 0);
+}
+
+TEST_F(FdbAgingTest, notification_is_delivered_in_one_batch) {
+  Enable();
+  ::p4::v1::IdleTimeoutNotification notification;
+  AddEntry(&notification, 0x11);
+  AddEntry(&notification, 0x22);
+  AddEntry(&notification, 0x33);
+
+  aging.HandleNotification(nullptr, notification);
+
+  ASSERT_EQ(batches.size(), 1);
+  ASSERT_EQ(batches[0].size(), 3);
+  EXPECT_EQ(batches[0][0].mac_addr[5], 0x11);
+  EXPECT_EQ(batches[0][1].mac_addr[5], 0x22);
+  EXPECT_EQ(batches[0][2].mac_addr[5], 0x33);
+  EXPECT_EQ(batches[0][2].bridge_id, 1);
+  EXPECT_EQ(aging.num_aged(), 3);
+}
+
+TEST_F(FdbAgingTest, undecoded_entries_are_skipped) {
+  Enable();
+  ::p4::v1::IdleTimeoutNotification notification;
+  AddEntry(&notification, 0);
+  AddEntry(&notification, 0x22);
+
+  aging.HandleNotification(nullptr, notification);
+
+  ASSERT_EQ(batches.size(), 1);
+  ASSERT_EQ(batches[0].size(), 1);
+  EXPECT_EQ(batches[0][0].mac_addr[5], 0x22);
+  EXPECT_EQ(aging.num_undecoded(), 1);
+}
+
+TEST_F(FdbAgingTest, no_callback_without_decoded_entries) {
+  Enable();
+  ::p4::v1::IdleTimeoutNotification notification;
+  AddEntry(&notification, 0);
+
+  aging.HandleNotification(nullptr, notification);
+
+  EXPECT_TRUE(batches.empty());
+  EXPECT_EQ(aging.num_undecoded(), 1);
+}
+
+TEST_F(FdbAgingTest, no_callback_after_disable) {
+  Enable();
+  aging.Disable();
+  ::p4::v1::IdleTimeoutNotification notification;
+  AddEntry(&notification, 0x11);
+
+  aging.HandleNotification(nullptr, notification);
+
+  EXPECT_TRUE(batches.empty());
+}
+
+TEST_F(FdbAgingTest, callback_can_disable) {
+  aging.Enable(absl::Seconds(10), Decode,
+               [this](const struct ovsp4rt_aged_mac* macs, size_t num_macs) {
+                 batches.emplace_back(macs, macs + num_macs);
+                 aging.Disable();
+               });
+  ::p4::v1::IdleTimeoutNotification notification;
+  AddEntry(&notification, 0x11);
+
+  aging.HandleNotification(nullptr, notification);
+  aging.HandleNotification(nullptr, notification);
+
+  EXPECT_EQ(batches.size(), 1);
+  EXPECT_EQ(aging.idle_timeout_ns(), 0);
+}
+
+}  // namespace ovsp4rt
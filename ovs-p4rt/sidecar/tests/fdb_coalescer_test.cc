@@ -0,0 +1,148 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "async/ovsp4rt_fdb_coalescer.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "async/ovsp4rt_async_writer.h"
+#include "gtest/gtest.h"
+#include "ovsp4rt/ovs-p4rt.h"
+
+namespace ovsp4rt {
+
+constexpr char GRPC_ADDR[] = "localhost:9559";
+
+class FdbCoalescerTest : public ::testing::Test {
+ protected:
+  void AddFdbOp(uint8_t mac, bool insert_entry, uint32_t src_port = 1) {
+    struct mac_learning_info learn_info = {0};
+    learn_info.is_vlan = true;
+    learn_info.bridge_id = 1;
+    learn_info.mac_addr[5] = mac;
+    learn_info.src_port = src_port;
+    AddOp(AsyncOp::CONFIG_FDB_ENTRY, learn_info, insert_entry);
+  }
+
+  void AddVlanOp(uint16_t vlan_id) {
+    AddOp(AsyncOp::CONFIG_VLAN_ENTRY, vlan_id, true);
+  }
+
+  template <typename Info>
+  void AddOp(AsyncOp::Type type, const Info& info, bool insert_entry) {
+    AsyncOp op;
+    op.type = type;
+    op.SetInput(info);
+    op.insert_entry = insert_entry;
+    op.grpc_addr = GRPC_ADDR;
+    ops_.push_back(std::move(op));
+  }
+
+  // Returns the MAC address and operation of each remaining request,
+  // as +mac for insert and -mac for delete. VLAN requests are 1000+id.
+  std::vector<int> Remaining() const {
+    std::vector<int> result;
+    for (const auto& op : ops_) {
+      if (op.type == AsyncOp::CONFIG_VLAN_ENTRY) {
+        result.push_back(1000 + op.vlan_id);
+      } else {
+        int mac = op.learn_info.mac_addr[5];
+        result.push_back(op.insert_entry ? mac : -mac);
+      }
+    }
+    return result;
+  }
+
+  std::vector<AsyncOp> ops_;
+};
+
+TEST_F(FdbCoalescerTest, insert_then_delete_keeps_delete) {
+  // The entry may have been in place before the insert.
+  AddFdbOp(1, true);
+  AddFdbOp(1, false);
+
+  EXPECT_EQ(CoalesceFdbOps(ops_), 1);
+  EXPECT_EQ(Remaining(), std::vector<int>({-1}));
+}
+
+TEST_F(FdbCoalescerTest, repeated_inserts_collapse) {
+  AddFdbOp(1, true);
+  AddFdbOp(1, true);
+  AddFdbOp(1, true);
+
+  EXPECT_EQ(CoalesceFdbOps(ops_), 2);
+  EXPECT_EQ(Remaining(), std::vector<int>({1}));
+}
+
+TEST_F(FdbCoalescerTest, repeated_deletes_collapse) {
+  AddFdbOp(1, false);
+  AddFdbOp(1, false);
+
+  EXPECT_EQ(CoalesceFdbOps(ops_), 1);
+  EXPECT_EQ(Remaining(), std::vector<int>({-1}));
+}
+
+TEST_F(FdbCoalescerTest, delete_then_insert_is_kept) {
+  AddFdbOp(1, false);
+  AddFdbOp(1, true, 2);
+
+  EXPECT_EQ(CoalesceFdbOps(ops_), 0);
+  EXPECT_EQ(Remaining(), std::vector<int>({-1, 1}));
+}
+
+TEST_F(FdbCoalescerTest, flapping_mac) {
+  AddFdbOp(1, true);
+  AddFdbOp(1, false);
+  AddFdbOp(1, true);
+  AddFdbOp(1, false);
+  AddFdbOp(1, true);
+
+  EXPECT_EQ(CoalesceFdbOps(ops_), 3);
+  EXPECT_EQ(Remaining(), std::vector<int>({-1, 1}));
+}
+
+TEST_F(FdbCoalescerTest, move_then_delete) {
+  // Delete, insert, delete: the net effect is a delete.
+  AddFdbOp(1, false);
+  AddFdbOp(1, true, 2);
+  AddFdbOp(1, false);
+
+  EXPECT_EQ(CoalesceFdbOps(ops_), 2);
+  EXPECT_EQ(Remaining(), std::vector<int>({-1}));
+}
+
+TEST_F(FdbCoalescerTest, different_inserts_are_kept) {
+  // The second insert would find the first one in place, so the
+  // delete does not cancel it.
+  AddFdbOp(1, true, 1);
+  AddFdbOp(1, true, 2);
+  AddFdbOp(1, false);
+
+  EXPECT_EQ(CoalesceFdbOps(ops_), 0);
+  EXPECT_EQ(Remaining(), std::vector<int>({1, 1, -1}));
+}
+
+TEST_F(FdbCoalescerTest, keys_are_independent) {
+  AddFdbOp(1, true);
+  AddFdbOp(2, true);
+  AddFdbOp(1, false);
+  AddFdbOp(3, false);
+
+  EXPECT_EQ(CoalesceFdbOps(ops_), 1);
+  EXPECT_EQ(Remaining(), std::vector<int>({2, -1, -3}));
+}
+
+TEST_F(FdbCoalescerTest, other_requests_are_kept_in_order) {
+  AddVlanOp(10);
+  AddFdbOp(1, true);
+  AddVlanOp(20);
+  AddFdbOp(1, false);
+  AddVlanOp(10);
+
+  EXPECT_EQ(CoalesceFdbOps(ops_), 1);
+  EXPECT_EQ(Remaining(), std::vector<int>({1010, 1020, -1, 1010}));
+}
+
+}  // namespace ovsp4rt
@@ -0,0 +1,181 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "resync/ovsp4rt_intent_store.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "async/ovsp4rt_async_writer.h"
+#include "gtest/gtest.h"
+#include "ovsp4rt/ovs-p4rt.h"
+
+namespace ovsp4rt {
+
+constexpr char GRPC_ADDR[] = "localhost:9559";
+
+class IntentStoreTest : public ::testing::Test {
+ protected:
+  static AsyncOp FdbOp(uint8_t mac, bool insert_entry, uint32_t src_port = 1,
+                       const char* grpc_addr = GRPC_ADDR) {
+    AsyncOp op;
+    op.type = AsyncOp::CONFIG_FDB_ENTRY;
+    op.learn_info.mac_addr[5] = mac;
+    op.learn_info.src_port = src_port;
+    op.insert_entry = insert_entry;
+    op.grpc_addr = grpc_addr;
+    return op;
+  }
+
+  static AsyncOp TunnelOp(uint32_t vni, bool insert_entry) {
+    AsyncOp op;
+    op.type = AsyncOp::CONFIG_TUNNEL_ENTRY;
+    op.tnl_info = {0};
+    op.tnl_info.vni = vni;
+    op.insert_entry = insert_entry;
+    op.grpc_addr = GRPC_ADDR;
+    return op;
+  }
+
+  static AsyncOp VlanOp(uint16_t vlan_id, bool insert_entry) {
+    AsyncOp op;
+    op.type = AsyncOp::CONFIG_VLAN_ENTRY;
+    op.vlan_id = vlan_id;
+    op.insert_entry = insert_entry;
+    op.grpc_addr = GRPC_ADDR;
+    return op;
+  }
+
+  static std::vector<AsyncOp::Type> Types(const std::vector<Intent>& intents) {
+    std::vector<AsyncOp::Type> types;
+    for (const auto& intent : intents) {
+      types.push_back(intent.op.type);
+    }
+    return types;
+  }
+
+  IntentStore store_;
+};
+
+//----------------------------------------------------------------------
+// Test case: insert_replaces_intent
+//----------------------------------------------------------------------
+TEST_F(IntentStoreTest, insert_replaces_intent) {
+  store_.Record(FdbOp(1, true, 10));
+  store_.Record(FdbOp(1, true, 20));
+
+  auto intents = store_.Snapshot(GRPC_ADDR);
+  ASSERT_EQ(intents.size(), 1);
+  EXPECT_EQ(intents[0].op.learn_info.src_port, 20);
+  EXPECT_EQ(store_.size(), 1);
+}
+
+//----------------------------------------------------------------------
+// Test case: delete_removes_intent
+//----------------------------------------------------------------------
+TEST_F(IntentStoreTest, delete_removes_intent) {
+  store_.Record(FdbOp(1, true));
+  store_.Record(FdbOp(2, true));
+  store_.Record(FdbOp(1, false));
+
+  auto intents = store_.Snapshot(GRPC_ADDR);
+  ASSERT_EQ(intents.size(), 1);
+  EXPECT_EQ(intents[0].op.learn_info.mac_addr[5], 2);
+  EXPECT_EQ(store_.size(), 1);
+
+  // Deleting an entry with no intent is not an error.
+  store_.Record(FdbOp(3, false));
+  EXPECT_EQ(store_.size(), 1);
+}
+
+//----------------------------------------------------------------------
+// Test case: dependency_order
+//
+// Verify that VLANs and tunnels come before the FDB entries that
+// refer to them, whatever the order they were recorded in.
+//----------------------------------------------------------------------
+TEST_F(IntentStoreTest, dependency_order) {
+  store_.Record(FdbOp(1, true));
+  store_.Record(TunnelOp(100, true));
+  store_.Record(FdbOp(2, true));
+  store_.Record(VlanOp(10, true));
+
+  auto intents = store_.Snapshot(GRPC_ADDR);
+
+  std::vector<AsyncOp::Type> expected = {
+      AsyncOp::CONFIG_VLAN_ENTRY, AsyncOp::CONFIG_TUNNEL_ENTRY,
+      AsyncOp::CONFIG_FDB_ENTRY, AsyncOp::CONFIG_FDB_ENTRY};
+  EXPECT_EQ(Types(intents), expected);
+
+  // Intents of the same kind stay in the order they were recorded.
+  EXPECT_EQ(intents[2].op.learn_info.mac_addr[5], 1);
+  EXPECT_EQ(intents[3].op.learn_info.mac_addr[5], 2);
+}
+
+//----------------------------------------------------------------------
+// Test case: kinds_do_not_collide
+//----------------------------------------------------------------------
+TEST_F(IntentStoreTest, kinds_do_not_collide) {
+  store_.Record(TunnelOp(10, true));
+  store_.Record(VlanOp(10, true));
+
+  EXPECT_EQ(store_.size(), 2);
+}
+
+//----------------------------------------------------------------------
+// Test case: servers_are_separate
+//----------------------------------------------------------------------
+TEST_F(IntentStoreTest, servers_are_separate) {
+  store_.Record(FdbOp(1, true));
+  store_.Record(FdbOp(1, true, 1, "otherhost:9559"));
+
+  EXPECT_EQ(store_.Snapshot(GRPC_ADDR).size(), 1);
+  EXPECT_EQ(store_.Snapshot("otherhost:9559").size(), 1);
+  EXPECT_EQ(store_.Addresses().size(), 2);
+  EXPECT_TRUE(store_.Snapshot("nohost:9559").empty());
+}
+
+//----------------------------------------------------------------------
+// Test case: changes_since_snapshot
+//
+// Verify that the changes undo the removed entries, in reverse
+// dependency order, before they apply the updated ones.
+//----------------------------------------------------------------------
+TEST_F(IntentStoreTest, changes_since_snapshot) {
+  store_.Record(TunnelOp(100, true));
+  store_.Record(FdbOp(1, true, 10));
+  store_.Record(FdbOp(2, true));
+  store_.Record(FdbOp(3, true));
+  auto snapshot = store_.Snapshot(GRPC_ADDR);
+
+  store_.Record(FdbOp(1, true, 20));
+  store_.Record(FdbOp(2, false));
+  store_.Record(TunnelOp(100, false));
+  store_.Record(FdbOp(4, true));
+
+  auto changes = store_.Changes(GRPC_ADDR, snapshot);
+
+  ASSERT_EQ(changes.size(), 3);
+  EXPECT_EQ(changes[0].op.type, AsyncOp::CONFIG_FDB_ENTRY);
+  EXPECT_EQ(changes[0].op.learn_info.mac_addr[5], 2);
+  EXPECT_FALSE(changes[0].op.insert_entry);
+  EXPECT_EQ(changes[1].op.type, AsyncOp::CONFIG_TUNNEL_ENTRY);
+  EXPECT_FALSE(changes[1].op.insert_entry);
+  EXPECT_EQ(changes[2].op.learn_info.mac_addr[5], 1);
+  EXPECT_EQ(changes[2].op.learn_info.src_port, 20);
+  EXPECT_TRUE(changes[2].op.insert_entry);
+}
+
+//----------------------------------------------------------------------
+// Test case: no_changes
+//----------------------------------------------------------------------
+TEST_F(IntentStoreTest, no_changes) {
+  store_.Record(FdbOp(1, true));
+  auto snapshot = store_.Snapshot(GRPC_ADDR);
+
+  EXPECT_TRUE(store_.Changes(GRPC_ADDR, snapshot).empty());
+}
+
+}  // namespace ovsp4rt
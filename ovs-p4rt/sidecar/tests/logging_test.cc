@@ -0,0 +1,173 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "logging/ovsp4rt_logging.h"
+
+#include <stdint.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "logging/ovsp4rt_log_backend.h"
+#include "ovsp4rt/ovs-p4rt.h"
+
+namespace ovsp4rt {
+
+class LoggingTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ovsp4rt_log_set_sink(&LoggingTest::Sink, this);
+    ovsp4rt_log_set_level(OVSP4RT_LEVEL_DEBUG);
+    ovsp4rt_log_set_rate_limit(0);
+  }
+
+  void TearDown() override {
+    Unblock();
+    ovsp4rt_log_set_sink(nullptr, nullptr);
+    ovsp4rt_log_set_level(OVSP4RT_LEVEL_DEBUG);
+  }
+
+  static void Sink(enum ovsp4rt_log_level level, const char* message,
+                   void* aux) {
+    auto* test = static_cast<LoggingTest*>(aux);
+    std::unique_lock<std::mutex> lock(test->mutex_);
+    test->messages_.emplace_back(level, message);
+    test->cv_.notify_all();
+    test->cv_.wait(lock, [test]() { return !test->blocked_; });
+  }
+
+  // Returns the messages written to the sink so far.
+  std::vector<std::pair<int, std::string>> Messages() {
+    ovsp4rt_log_flush();
+    std::lock_guard<std::mutex> lock(mutex_);
+    return messages_;
+  }
+
+  void Unblock() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    blocked_ = false;
+    cv_.notify_all();
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<std::pair<int, std::string>> messages_;
+  bool blocked_ = false;
+};
+
+TEST_F(LoggingTest, sink_receives_messages) {
+  ovsp4rt_log_error("Error adding to %s", "l2_fwd_smac_table");
+  ovsp4rt_log_message(OVSP4RT_LEVEL_INFO, "%d entries", 3);
+
+  auto messages = Messages();
+  ASSERT_EQ(messages.size(), 2);
+  EXPECT_EQ(messages[0].first, OVSP4RT_LEVEL_ERROR);
+  EXPECT_EQ(messages[0].second, "Error adding to l2_fwd_smac_table");
+  EXPECT_EQ(messages[1].first, OVSP4RT_LEVEL_INFO);
+  EXPECT_EQ(messages[1].second, "3 entries");
+}
+
+TEST_F(LoggingTest, level_filters_messages) {
+  ovsp4rt_log_set_level(OVSP4RT_LEVEL_WARN);
+  EXPECT_EQ(ovsp4rt_log_get_level(), OVSP4RT_LEVEL_WARN);
+
+  int evaluated = 0;
+  ovsp4rt_log_debug("debug %d", ++evaluated);
+  ovsp4rt_log_info("info %d", ++evaluated);
+  ovsp4rt_log_warn("warn %d", ++evaluated);
+  ovsp4rt_log_message(OVSP4RT_LEVEL_INFO, "info");
+
+  // The arguments of filtered messages are not evaluated.
+  EXPECT_EQ(evaluated, 1);
+  auto messages = Messages();
+  ASSERT_EQ(messages.size(), 1);
+  EXPECT_EQ(messages[0].second, "warn 1");
+}
+
+TEST_F(LoggingTest, rate_limit_suppresses_messages) {
+  ovsp4rt_log_set_rate_limit(2);
+
+  struct ovsp4rt_log_site site = {};
+  for (int i = 0; i < 5; i++) {
+    ovsp4rt_log_site_message(&site, OVSP4RT_LEVEL_ERROR, "message %d", i);
+  }
+  EXPECT_EQ(Messages().size(), 2);
+
+  // The next message admitted reports the ones suppressed.
+  site.window = 0;
+  ovsp4rt_log_site_message(&site, OVSP4RT_LEVEL_ERROR, "message %d", 5);
+
+  auto messages = Messages();
+  ASSERT_EQ(messages.size(), 3);
+  EXPECT_EQ(messages[2].second,
+            "message 5 (3 similar messages suppressed)");
+}
+
+TEST_F(LoggingTest, long_messages_are_truncated) {
+  std::string text(2 * LogRecord::kMaxLength, 'x');
+  ovsp4rt_log_message(OVSP4RT_LEVEL_INFO, "%s", text.c_str());
+
+  auto messages = Messages();
+  ASSERT_EQ(messages.size(), 1);
+  EXPECT_EQ(messages[0].second.size(), LogRecord::kMaxLength);
+}
+
+TEST_F(LoggingTest, full_ring_drops_messages) {
+  // Hold the drain thread in the sink while the ring fills.
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    blocked_ = true;
+  }
+  ovsp4rt_log_message(OVSP4RT_LEVEL_INFO, "first");
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return !messages_.empty(); });
+  }
+
+  constexpr int kExtra = 10;
+  for (uint32_t i = 0; i < LogRing::kCapacity + kExtra; i++) {
+    ovsp4rt_log_message(OVSP4RT_LEVEL_INFO, "message %u", i);
+  }
+  Unblock();
+
+  // The first message holds its slot until the sink returns.
+  auto messages = Messages();
+  ASSERT_EQ(messages.size(), 1 + (LogRing::kCapacity - 1) + 1);
+  EXPECT_EQ(messages.back().first, OVSP4RT_LEVEL_WARN);
+  EXPECT_EQ(messages.back().second, "11 log messages dropped");
+}
+
+TEST_F(LoggingTest, messages_from_exited_threads_are_written) {
+  constexpr int kNumThreads = 4;
+  constexpr int kPerThread = 50;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([t]() {
+      for (int i = 0; i < kPerThread; i++) {
+        ovsp4rt_log_info("thread %d message %d", t, i);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto messages = Messages();
+  ASSERT_EQ(messages.size(), kNumThreads * kPerThread);
+
+  // Each thread's messages are in order.
+  std::vector<int> next(kNumThreads);
+  for (const auto& message : messages) {
+    int t, i;
+    ASSERT_EQ(sscanf(message.second.c_str(), "thread %d message %d", &t, &i),
+              2);
+    EXPECT_EQ(i, next[t]++);
+  }
+}
+
+}  // namespace ovsp4rt
@@ -0,0 +1,236 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "session/ovsp4rt_p4info_cache.h"
+
+#include <grpcpp/grpcpp.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "absl/flags/declare.h"
+#include "absl/flags/flag.h"
+#include "absl/status/status.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "gtest/gtest.h"
+#include "p4/config/v1/p4info.pb.h"
+#include "p4/v1/p4runtime.grpc.pb.h"
+#include "p4/v1/p4runtime.pb.h"
+
+ABSL_DECLARE_FLAG(int32_t, p4info_revalidate_ms);
+
+namespace ovsp4rt {
+
+constexpr uint32_t DEVICE_ID = 1;
+
+// P4Runtime server that reports a configurable forwarding pipeline.
+class FakeP4RuntimeService : public ::p4::v1::P4Runtime::Service {
+ public:
+  ::grpc::Status GetForwardingPipelineConfig(
+      ::grpc::ServerContext* context,
+      const ::p4::v1::GetForwardingPipelineConfigRequest* request,
+      ::p4::v1::GetForwardingPipelineConfigResponse* response) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!available_) {
+      failed_requests_++;
+      return ::grpc::Status(::grpc::StatusCode::UNAVAILABLE,
+                            "Server unavailable");
+    }
+    auto* config = response->mutable_config();
+    config->mutable_cookie()->set_cookie(cookie_);
+    if (request->response_type() ==
+        ::p4::v1::GetForwardingPipelineConfigRequest::COOKIE_ONLY) {
+      cookie_requests_++;
+    } else {
+      *config->mutable_p4info() = p4info_;
+      p4info_requests_++;
+    }
+    return ::grpc::Status::OK;
+  }
+
+  // Replaces the pipeline with one that has a single table.
+  void SetPipeline(const std::string& table_name, uint64_t cookie) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    p4info_.Clear();
+    if (!table_name.empty()) {
+      auto* preamble = p4info_.add_tables()->mutable_preamble();
+      preamble->set_id(1);
+      preamble->set_name(table_name);
+    }
+    cookie_ = cookie;
+  }
+
+  // Makes requests fail with UNAVAILABLE, as if the server were down.
+  void SetAvailable(bool available) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    available_ = available;
+  }
+
+  std::atomic<int> cookie_requests_{0};
+  std::atomic<int> p4info_requests_{0};
+  std::atomic<int> failed_requests_{0};
+
+ private:
+  std::mutex mutex_;
+  bool available_ = true;
+  ::p4::config::v1::P4Info p4info_;
+  uint64_t cookie_ = 0;
+};
+
+class P4InfoCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    saved_interval_ms_ = absl::GetFlag(FLAGS_p4info_revalidate_ms);
+    ::grpc::ServerBuilder builder;
+    builder.RegisterService(&service_);
+    server_ = builder.BuildAndStart();
+    stub_ = ::p4::v1::P4Runtime::NewStub(
+        server_->InProcessChannel(::grpc::ChannelArguments()));
+    cache_ = std::make_unique<P4InfoCache>(*stub_, DEVICE_ID);
+  }
+
+  void TearDown() override {
+    cache_.reset();
+    server_->Shutdown();
+    absl::SetFlag(&FLAGS_p4info_revalidate_ms, saved_interval_ms_);
+  }
+
+  std::shared_ptr<const P4InfoSnapshot> GetSnapshot() {
+    auto status_or_snapshot = cache_->GetSnapshot();
+    EXPECT_TRUE(status_or_snapshot.ok()) << status_or_snapshot.status();
+    return status_or_snapshot.ok() ? *status_or_snapshot : nullptr;
+  }
+
+  FakeP4RuntimeService service_;
+  std::unique_ptr<::grpc::Server> server_;
+  std::unique_ptr<::p4::v1::P4Runtime::Stub> stub_;
+  std::unique_ptr<P4InfoCache> cache_;
+  int32_t saved_interval_ms_;
+};
+
+TEST_F(P4InfoCacheTest, snapshot_is_cached) {
+  service_.SetPipeline("table_a", 7);
+
+  auto snapshot = GetSnapshot();
+  ASSERT_TRUE(snapshot);
+  EXPECT_EQ(snapshot->device_id(), DEVICE_ID);
+  EXPECT_EQ(snapshot->cookie(), 7);
+  EXPECT_EQ(snapshot->p4info().tables(0).preamble().name(), "table_a");
+
+  EXPECT_EQ(GetSnapshot(), snapshot);
+  EXPECT_EQ(cache_->FetchCount(), 1);
+  EXPECT_EQ(service_.p4info_requests_, 1);
+  EXPECT_EQ(service_.cookie_requests_, 0);
+}
+
+TEST_F(P4InfoCacheTest, cookie_change_replaces_snapshot) {
+  absl::SetFlag(&FLAGS_p4info_revalidate_ms, 0);
+  service_.SetPipeline("table_a", 7);
+
+  auto snapshot = GetSnapshot();
+
+  // Only the cookie is fetched while it is unchanged.
+  EXPECT_EQ(GetSnapshot(), snapshot);
+  EXPECT_EQ(service_.cookie_requests_, 1);
+  EXPECT_EQ(cache_->FetchCount(), 1);
+
+  service_.SetPipeline("table_b", 8);
+  auto new_snapshot = GetSnapshot();
+  ASSERT_TRUE(new_snapshot);
+  EXPECT_NE(new_snapshot, snapshot);
+  EXPECT_EQ(new_snapshot->cookie(), 8);
+  EXPECT_EQ(new_snapshot->p4info().tables(0).preamble().name(), "table_b");
+  EXPECT_EQ(cache_->FetchCount(), 2);
+}
+
+TEST_F(P4InfoCacheTest, pipeline_without_cookie_is_compared) {
+  absl::SetFlag(&FLAGS_p4info_revalidate_ms, 0);
+  service_.SetPipeline("table_a", 0);
+
+  auto snapshot = GetSnapshot();
+
+  // The P4Info is fetched again, but the snapshot is kept.
+  EXPECT_EQ(GetSnapshot(), snapshot);
+  EXPECT_EQ(cache_->FetchCount(), 2);
+  EXPECT_EQ(service_.cookie_requests_, 0);
+
+  service_.SetPipeline("table_b", 0);
+  auto new_snapshot = GetSnapshot();
+  ASSERT_TRUE(new_snapshot);
+  EXPECT_NE(new_snapshot, snapshot);
+  EXPECT_EQ(new_snapshot->p4info().tables(0).preamble().name(), "table_b");
+}
+
+TEST_F(P4InfoCacheTest, pipeline_without_cookie_backs_off) {
+  absl::SetFlag(&FLAGS_p4info_revalidate_ms, 10);
+  service_.SetPipeline("table_a", 0);
+
+  auto snapshot = GetSnapshot();
+
+  // Revalidating every 10 ms would fetch the P4Info about 30 times.
+  absl::Time deadline = absl::Now() + absl::Milliseconds(300);
+  while (absl::Now() < deadline) {
+    EXPECT_EQ(GetSnapshot(), snapshot);
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+
+  EXPECT_GE(cache_->FetchCount(), 3);
+  EXPECT_LE(cache_->FetchCount(), 8);
+}
+
+TEST_F(P4InfoCacheTest, pipeline_not_configured) {
+  service_.SetPipeline("", 0);
+
+  auto status_or_snapshot = cache_->GetSnapshot();
+
+  ASSERT_FALSE(status_or_snapshot.ok());
+  EXPECT_EQ(status_or_snapshot.status().code(),
+            absl::StatusCode::kFailedPrecondition);
+}
+
+TEST_F(P4InfoCacheTest, pipeline_unavailable) {
+  service_.SetPipeline("table_a", 7);
+  service_.SetAvailable(false);
+
+  auto status_or_snapshot = cache_->GetSnapshot();
+
+  ASSERT_FALSE(status_or_snapshot.ok());
+  EXPECT_EQ(status_or_snapshot.status().code(),
+            absl::StatusCode::kUnavailable);
+}
+
+TEST_F(P4InfoCacheTest, failed_revalidation_keeps_snapshot) {
+  absl::SetFlag(&FLAGS_p4info_revalidate_ms, 10);
+  service_.SetPipeline("table_a", 7);
+
+  auto snapshot = GetSnapshot();
+  service_.SetAvailable(false);
+
+  // Retrying every 10 ms would ask the server about 30 times.
+  absl::Time deadline = absl::Now() + absl::Milliseconds(300);
+  while (absl::Now() < deadline) {
+    EXPECT_EQ(GetSnapshot(), snapshot);
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+
+  EXPECT_GE(service_.failed_requests_, 3);
+  EXPECT_LE(service_.failed_requests_, 8);
+  EXPECT_EQ(cache_->FetchCount(), 1);
+}
+
+TEST_F(P4InfoCacheTest, invalidate_fetches_p4info) {
+  service_.SetPipeline("table_a", 7);
+
+  auto snapshot = GetSnapshot();
+  cache_->Invalidate();
+
+  auto new_snapshot = GetSnapshot();
+  ASSERT_TRUE(new_snapshot);
+  EXPECT_NE(new_snapshot, snapshot);
+  EXPECT_EQ(cache_->FetchCount(), 2);
+}
+
+}  // namespace ovsp4rt
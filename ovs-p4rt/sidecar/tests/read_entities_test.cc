@@ -0,0 +1,111 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <grpcpp/grpcpp.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "gtest/gtest.h"
+#include "p4/v1/p4runtime.grpc.pb.h"
+#include "p4/v1/p4runtime.pb.h"
+#include "session/ovsp4rt_session.h"
+
+namespace ovsp4rt {
+
+constexpr int NUM_MESSAGES = 10;
+constexpr int ENTITIES_PER_MESSAGE = 100;
+
+// P4Runtime server whose Read RPCs stream numbered table entries.
+class FakeP4RuntimeService : public ::p4::v1::P4Runtime::Service {
+ public:
+  ::grpc::Status Read(
+      ::grpc::ServerContext* context, const ::p4::v1::ReadRequest* request,
+      ::grpc::ServerWriter<::p4::v1::ReadResponse>* writer) override {
+    for (int i = 0; i < NUM_MESSAGES; i++) {
+      ::p4::v1::ReadResponse response;
+      for (int j = 0; j < ENTITIES_PER_MESSAGE; j++) {
+        auto* table_entry = response.add_entities()->mutable_table_entry();
+        table_entry->set_table_id(request->device_id());
+        table_entry->set_priority(i * ENTITIES_PER_MESSAGE + j);
+      }
+      if (!writer->Write(response)) {
+        break;
+      }
+      messages_sent_++;
+    }
+    if (fail_) {
+      return ::grpc::Status(::grpc::StatusCode::UNAVAILABLE, "Read failed");
+    }
+    return ::grpc::Status::OK;
+  }
+
+  std::atomic<int> messages_sent_{0};
+  bool fail_ = false;
+};
+
+class ReadEntitiesTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ::grpc::ServerBuilder builder;
+    builder.RegisterService(&service_);
+    server_ = builder.BuildAndStart();
+    stub_ = ::p4::v1::P4Runtime::NewStub(
+        server_->InProcessChannel(::grpc::ChannelArguments()));
+    read_request_.set_device_id(1);
+  }
+
+  void TearDown() override { server_->Shutdown(); }
+
+  FakeP4RuntimeService service_;
+  std::unique_ptr<::grpc::Server> server_;
+  std::unique_ptr<::p4::v1::P4Runtime::Stub> stub_;
+  ::p4::v1::ReadRequest read_request_;
+};
+
+TEST_F(ReadEntitiesTest, visits_every_entity_in_order) {
+  std::vector<int> priorities;
+
+  auto status = ReadEntities(*stub_, read_request_,
+                             [&](const ::p4::v1::Entity& entity) {
+                               priorities.push_back(
+                                   entity.table_entry().priority());
+                               return true;
+                             });
+
+  ASSERT_TRUE(status.ok()) << status;
+  ASSERT_EQ(priorities.size(), NUM_MESSAGES * ENTITIES_PER_MESSAGE);
+  for (int i = 0; i < priorities.size(); i++) {
+    EXPECT_EQ(priorities[i], i);
+  }
+}
+
+TEST_F(ReadEntitiesTest, visitor_stops_read) {
+  int visited = 0;
+
+  auto status = ReadEntities(*stub_, read_request_,
+                             [&](const ::p4::v1::Entity& entity) {
+                               return ++visited < ENTITIES_PER_MESSAGE + 1;
+                             });
+
+  EXPECT_TRUE(status.ok()) << status;
+  EXPECT_EQ(visited, ENTITIES_PER_MESSAGE + 1);
+}
+
+TEST_F(ReadEntitiesTest, read_error) {
+  service_.fail_ = true;
+  int visited = 0;
+
+  auto status = ReadEntities(*stub_, read_request_,
+                             [&](const ::p4::v1::Entity& entity) {
+                               visited++;
+                               return true;
+                             });
+
+  EXPECT_EQ(status.code(), ::absl::StatusCode::kUnavailable);
+  EXPECT_EQ(visited, NUM_MESSAGES * ENTITIES_PER_MESSAGE);
+}
+
+}  // namespace ovsp4rt
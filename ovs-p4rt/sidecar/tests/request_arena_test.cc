@@ -0,0 +1,81 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "session/ovsp4rt_request_arena.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "p4/v1/p4runtime.pb.h"
+
+namespace ovsp4rt {
+
+// Builds a WriteRequest with table entry updates.
+void BuildRequest(::p4::v1::WriteRequest* write_request,
+                  int num_updates = 1) {
+  for (int i = 0; i < num_updates; i++) {
+    auto* update = write_request->add_updates();
+    update->set_type(::p4::v1::Update::INSERT);
+    auto* table_entry = update->mutable_entity()->mutable_table_entry();
+    table_entry->set_table_id(1);
+    auto* match = table_entry->add_match();
+    match->set_field_id(1);
+    match->mutable_exact()->set_value(std::string(6, 'x'));
+  }
+}
+
+TEST(RequestArenaTest, reuses_initial_block) {
+  {
+    // Warm up the thread's arena.
+    RequestArena arena;
+    BuildRequest(arena.Create<::p4::v1::WriteRequest>());
+  }
+  auto before = RequestArena::GetStats();
+
+  for (int i = 0; i < 1000; i++) {
+    RequestArena arena;
+    auto* write_request = arena.Create<::p4::v1::WriteRequest>();
+    EXPECT_EQ(write_request->GetArena(), arena.arena());
+    BuildRequest(write_request);
+    EXPECT_EQ(write_request->updates_size(), 1);
+  }
+
+  auto after = RequestArena::GetStats();
+  EXPECT_EQ(after.scopes - before.scopes, 1000);
+  EXPECT_EQ(after.blocks_allocated, before.blocks_allocated);
+  EXPECT_GT(after.max_bytes_used, 0);
+}
+
+TEST(RequestArenaTest, nested_scopes_share_arena) {
+  auto before = RequestArena::GetStats();
+  {
+    RequestArena outer;
+    auto* write_request = outer.Create<::p4::v1::WriteRequest>();
+    {
+      RequestArena inner;
+      EXPECT_EQ(inner.arena(), outer.arena());
+      BuildRequest(inner.Create<::p4::v1::WriteRequest>());
+    }
+    // The inner scope did not reset the arena.
+    EXPECT_EQ(RequestArena::GetStats().scopes, before.scopes);
+    BuildRequest(write_request);
+    EXPECT_EQ(write_request->updates(0).entity().table_entry().table_id(), 1);
+  }
+  EXPECT_EQ(RequestArena::GetStats().scopes, before.scopes + 1);
+}
+
+TEST(RequestArenaTest, large_request_allocates_block) {
+  auto before = RequestArena::GetStats();
+  {
+    RequestArena arena;
+    // More updates than fit in the initial block.
+    BuildRequest(arena.Create<::p4::v1::WriteRequest>(), 1000);
+  }
+  auto after = RequestArena::GetStats();
+  EXPECT_GT(after.blocks_allocated, before.blocks_allocated);
+  EXPECT_GE(after.bytes_allocated - before.bytes_allocated,
+            RequestArena::kInitialBlockSize);
+  EXPECT_GE(after.max_bytes_used, RequestArena::kInitialBlockSize);
+}
+
+}  // namespace ovsp4rt
@@ -0,0 +1,237 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "resync/ovsp4rt_resync.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "async/ovsp4rt_async_writer.h"
+#include "gtest/gtest.h"
+#include "ovsp4rt/ovs-p4rt.h"
+#include "resync/ovsp4rt_intent_store.h"
+
+namespace ovsp4rt {
+
+constexpr char GRPC_ADDR[] = "localhost:9559";
+
+class ResyncTest : public ::testing::Test {
+ protected:
+  ResyncTest()
+      : resyncer_(
+            store_,
+            [this](const std::string& grpc_addr) -> absl::StatusOr<SyncState> {
+              if (!server_up_) {
+                return absl::UnavailableError("Server down");
+              }
+              return state_;
+            },
+            [this](const std::vector<Intent>& intents) {
+              replays_.push_back(intents);
+              if (during_replay_) {
+                during_replay_();
+                during_replay_ = nullptr;
+              }
+              return num_failed_;
+            },
+            absl::Seconds(1),
+            [this](const std::string& grpc_addr) {
+              entry_checks_++;
+              return entries_kept_;
+            }) {
+    state_.session_id = 1;
+    state_.cookie = 1234;
+  }
+
+  static AsyncOp FdbOp(uint8_t mac, bool insert_entry) {
+    AsyncOp op;
+    op.type = AsyncOp::CONFIG_FDB_ENTRY;
+    op.learn_info.mac_addr[5] = mac;
+    op.insert_entry = insert_entry;
+    op.grpc_addr = GRPC_ADDR;
+    return op;
+  }
+
+  static AsyncOp TunnelOp(uint32_t vni) {
+    AsyncOp op;
+    op.type = AsyncOp::CONFIG_TUNNEL_ENTRY;
+    op.tnl_info = {0};
+    op.tnl_info.vni = vni;
+    op.insert_entry = true;
+    op.grpc_addr = GRPC_ADDR;
+    return op;
+  }
+
+  IntentStore store_;
+  SyncState state_;
+  bool server_up_ = true;
+  size_t num_failed_ = 0;
+  bool entries_kept_ = false;
+  int entry_checks_ = 0;
+  std::function<void()> during_replay_;
+  std::vector<std::vector<Intent>> replays_;
+  Resyncer resyncer_;
+};
+
+//----------------------------------------------------------------------
+// Test case: first_state_not_replayed
+//----------------------------------------------------------------------
+TEST_F(ResyncTest, first_state_not_replayed) {
+  store_.Record(FdbOp(1, true));
+
+  EXPECT_EQ(resyncer_.Poll(), 0);
+  EXPECT_EQ(resyncer_.Poll(), 0);
+  EXPECT_TRUE(replays_.empty());
+}
+
+//----------------------------------------------------------------------
+// Test case: new_session_replays
+//
+// Verify that the intents are replayed in dependency order after a
+// reconnect, and only once.
+//----------------------------------------------------------------------
+TEST_F(ResyncTest, new_session_replays) {
+  store_.Record(FdbOp(1, true));
+  store_.Record(TunnelOp(100));
+  resyncer_.Poll();
+
+  state_.session_id = 2;
+  EXPECT_EQ(resyncer_.Poll(), 1);
+  EXPECT_EQ(resyncer_.Poll(), 0);
+
+  ASSERT_EQ(replays_.size(), 1);
+  ASSERT_EQ(replays_[0].size(), 2);
+  EXPECT_EQ(replays_[0][0].op.type, AsyncOp::CONFIG_TUNNEL_ENTRY);
+  EXPECT_EQ(replays_[0][1].op.type, AsyncOp::CONFIG_FDB_ENTRY);
+  EXPECT_EQ(replays_[0][1].op.grpc_addr, GRPC_ADDR);
+}
+
+//----------------------------------------------------------------------
+// Test case: new_pipeline_replays
+//----------------------------------------------------------------------
+TEST_F(ResyncTest, new_pipeline_replays) {
+  store_.Record(FdbOp(1, true));
+  resyncer_.Poll();
+
+  state_.cookie = 5678;
+  EXPECT_EQ(resyncer_.Poll(), 1);
+  EXPECT_EQ(replays_.size(), 1);
+}
+
+//----------------------------------------------------------------------
+// Test case: reconnect_with_entries_kept
+//
+// Verify that a new session with the same pipeline is not replayed if
+// the switch still holds the entries, e.g., after the sidecar took
+// mastership back.
+//----------------------------------------------------------------------
+TEST_F(ResyncTest, reconnect_with_entries_kept) {
+  store_.Record(FdbOp(1, true));
+  resyncer_.Poll();
+
+  entries_kept_ = true;
+  state_.session_id = 2;
+  EXPECT_EQ(resyncer_.Poll(), 0);
+  EXPECT_EQ(resyncer_.Poll(), 0);
+  EXPECT_TRUE(replays_.empty());
+  EXPECT_EQ(entry_checks_, 1);
+
+  // The entries are gone after the next reconnect.
+  entries_kept_ = false;
+  state_.session_id = 3;
+  EXPECT_EQ(resyncer_.Poll(), 1);
+  EXPECT_EQ(replays_.size(), 1);
+}
+
+//----------------------------------------------------------------------
+// Test case: new_pipeline_replays_with_entries
+//
+// Verify that the entries are not checked when the pipeline changed.
+//----------------------------------------------------------------------
+TEST_F(ResyncTest, new_pipeline_replays_with_entries) {
+  store_.Record(FdbOp(1, true));
+  resyncer_.Poll();
+
+  entries_kept_ = true;
+  state_.session_id = 2;
+  state_.cookie = 5678;
+  EXPECT_EQ(resyncer_.Poll(), 1);
+  EXPECT_EQ(replays_.size(), 1);
+  EXPECT_EQ(entry_checks_, 0);
+}
+
+//----------------------------------------------------------------------
+// Test case: waits_for_server
+//
+// Verify that nothing is replayed while the server is down, and that
+// the intents are replayed once it is back.
+//----------------------------------------------------------------------
+TEST_F(ResyncTest, waits_for_server) {
+  store_.Record(FdbOp(1, true));
+  resyncer_.Poll();
+
+  server_up_ = false;
+  EXPECT_EQ(resyncer_.Poll(), 0);
+  EXPECT_TRUE(replays_.empty());
+
+  server_up_ = true;
+  state_.session_id = 2;
+  EXPECT_EQ(resyncer_.Poll(), 1);
+}
+
+//----------------------------------------------------------------------
+// Test case: reconciles_changes_during_replay
+//----------------------------------------------------------------------
+TEST_F(ResyncTest, reconciles_changes_during_replay) {
+  store_.Record(FdbOp(1, true));
+  store_.Record(FdbOp(2, true));
+  resyncer_.Poll();
+
+  // OVS deletes an entry while the replay is programming it.
+  during_replay_ = [this]() { store_.Record(FdbOp(1, false)); };
+  state_.session_id = 2;
+  resyncer_.Poll();
+
+  ASSERT_EQ(replays_.size(), 2);
+  ASSERT_EQ(replays_[1].size(), 1);
+  EXPECT_EQ(replays_[1][0].op.learn_info.mac_addr[5], 1);
+  EXPECT_FALSE(replays_[1][0].op.insert_entry);
+}
+
+//----------------------------------------------------------------------
+// Test case: stats
+//----------------------------------------------------------------------
+TEST_F(ResyncTest, stats) {
+  store_.Record(FdbOp(1, true));
+  store_.Record(FdbOp(2, true));
+  resyncer_.Poll();
+
+  num_failed_ = 1;
+  state_.session_id = 2;
+  resyncer_.Poll();
+
+  struct ovsp4rt_resync_stats stats;
+  resyncer_.GetStats(&stats);
+  EXPECT_EQ(stats.resyncs, 1);
+  EXPECT_EQ(stats.entries_replayed, 2);
+  EXPECT_EQ(stats.entries_failed, 1);
+  EXPECT_EQ(stats.last_duration_us, stats.max_duration_us);
+}
+
+//----------------------------------------------------------------------
+// Test case: disabled
+//----------------------------------------------------------------------
+TEST(ResyncDisabledTest, disabled) {
+  IntentStore store;
+  Resyncer resyncer(store, nullptr, nullptr, absl::ZeroDuration());
+
+  EXPECT_FALSE(resyncer.enabled());
+  resyncer.Start();
+}
+
+}  // namespace ovsp4rt
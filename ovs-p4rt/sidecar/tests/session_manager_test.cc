@@ -0,0 +1,297 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "session/ovsp4rt_session_manager.h"
+
+#include <grpcpp/grpcpp.h>
+
+#include <stdint.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "absl/numeric/int128.h"
+#include "absl/status/status.h"
+#include "gtest/gtest.h"
+#include "p4/v1/p4runtime.grpc.pb.h"
+#include "p4/v1/p4runtime.pb.h"
+
+namespace ovsp4rt {
+
+constexpr char ADDRESS[] = "localhost:9559";
+constexpr char BLOCKED_ADDRESS[] = "localhost:9560";
+constexpr uint32_t DEVICE_ID = 1;
+constexpr uint32_t OTHER_DEVICE_ID = 2;
+constexpr char ROLE_NAME[] = "ovs-p4rt";
+
+::absl::uint128 ToUint128(const ::p4::v1::Uint128& value) {
+  return ::absl::MakeUint128(value.high(), value.low());
+}
+
+// Returns true if condition becomes true within a few seconds.
+bool WaitFor(const std::function<bool()>& condition) {
+  for (int i = 0; i < 500; ++i) {
+    if (condition()) return true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return condition();
+}
+
+// P4Runtime server that arbitrates between the clients on its stream
+// channel. A client is made primary if its election ID is higher than
+// that of the last primary client for the device.
+class FakeP4RuntimeService : public ::p4::v1::P4Runtime::Service {
+ public:
+  ::grpc::Status StreamChannel(
+      ::grpc::ServerContext* context,
+      ::grpc::ServerReaderWriter<::p4::v1::StreamMessageResponse,
+                                 ::p4::v1::StreamMessageRequest>* stream)
+      override {
+    ::p4::v1::StreamMessageRequest request;
+    if (!stream->Read(&request) || !request.has_arbitration()) {
+      return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT,
+                            "Expected arbitration");
+    }
+    const auto& arbitration = request.arbitration();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto& primary_id = primary_ids_[arbitration.device_id()];
+    bool primary = ToUint128(arbitration.election_id()) > primary_id;
+    if (primary) {
+      primary_id = ToUint128(arbitration.election_id());
+    }
+    stream->Write(Arbitration(arbitration, primary));
+    ++num_open_;
+
+    int num_closes = num_closes_;
+    int num_demotions = num_demotions_;
+    while (!context->IsCancelled() && num_closes_ == num_closes) {
+      if (num_demotions_ != num_demotions) {
+        num_demotions = num_demotions_;
+        stream->Write(Arbitration(arbitration, false));
+      }
+      cv_.wait_for(lock, std::chrono::milliseconds(10));
+    }
+
+    --num_open_;
+    return ::grpc::Status(::grpc::StatusCode::UNAVAILABLE, "Stream closed");
+  }
+
+  // Closes the open streams, as if the server had restarted.
+  void CloseStreams() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++num_closes_;
+    cv_.notify_all();
+  }
+
+  // Tells the open streams that they are no longer primary, as if
+  // another client had taken over and then gone away.
+  void Demote() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++num_demotions_;
+    cv_.notify_all();
+  }
+
+  // Makes clients of a device with a lower election ID backups.
+  void SetPrimaryId(uint32_t device_id, ::absl::uint128 election_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    primary_ids_[device_id] = election_id;
+  }
+
+  int num_open() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_open_;
+  }
+
+ private:
+  static ::p4::v1::StreamMessageResponse Arbitration(
+      const ::p4::v1::MasterArbitrationUpdate& request, bool primary) {
+    ::p4::v1::StreamMessageResponse response;
+    auto* arbitration = response.mutable_arbitration();
+    *arbitration = request;
+    arbitration->mutable_status()->set_code(
+        primary ? ::grpc::StatusCode::OK
+                : ::grpc::StatusCode::ALREADY_EXISTS);
+    return response;
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::map<uint32_t, ::absl::uint128> primary_ids_;
+  int num_open_ = 0;
+  int num_closes_ = 0;
+  int num_demotions_ = 0;
+};
+
+class SessionManagerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ::grpc::ServerBuilder builder;
+    builder.RegisterService(&service_);
+    server_ = builder.BuildAndStart();
+  }
+
+  void TearDown() override {
+    ReleaseFactory();
+    manager_.Reset();
+    server_->Shutdown();
+  }
+
+  // Opens a session with the fake server. Sessions for BLOCKED_ADDRESS
+  // are not opened until the test calls ReleaseFactory().
+  ::absl::StatusOr<std::unique_ptr<OvsP4rtSession>> CreateSession(
+      const std::string& address, uint32_t device_id,
+      const std::string& role_name, ::absl::uint128 election_id) {
+    if (address == BLOCKED_ADDRESS) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      ++num_blocked_;
+      cv_.notify_all();
+      cv_.wait(lock, [this]() { return released_; });
+    }
+    return OvsP4rtSession::Create(
+        ::p4::v1::P4Runtime::NewStub(
+            server_->InProcessChannel(::grpc::ChannelArguments())),
+        device_id, role_name, election_id);
+  }
+
+  void WaitForBlocked(int num_blocked) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this, num_blocked]() {
+      return num_blocked_ >= num_blocked;
+    });
+  }
+
+  void ReleaseFactory() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    released_ = true;
+    cv_.notify_all();
+  }
+
+  ::absl::StatusOr<std::shared_ptr<OvsP4rtSession>> GetSession(
+      const std::string& address = ADDRESS, uint32_t device_id = DEVICE_ID) {
+    return manager_.GetSession(address, device_id, ROLE_NAME);
+  }
+
+  FakeP4RuntimeService service_;
+  std::unique_ptr<::grpc::Server> server_;
+  SessionManager manager_{
+      [this](const std::string& address, uint32_t device_id,
+             const std::string& role_name, ::absl::uint128 election_id) {
+        return CreateSession(address, device_id, role_name, election_id);
+      }};
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  int num_blocked_ = 0;
+  bool released_ = false;
+};
+
+TEST_F(SessionManagerTest, callers_share_the_session) {
+  auto session1 = GetSession();
+  ASSERT_TRUE(session1.ok()) << session1.status();
+  EXPECT_TRUE((*session1)->IsPrimary());
+
+  auto session2 = GetSession();
+  ASSERT_TRUE(session2.ok()) << session2.status();
+  EXPECT_EQ(*session1, *session2);
+  EXPECT_EQ(manager_.SessionsCreated(), 1);
+}
+
+TEST_F(SessionManagerTest, reconnects_after_stream_closes) {
+  auto session1 = GetSession();
+  ASSERT_TRUE(session1.ok()) << session1.status();
+
+  service_.CloseStreams();
+  ASSERT_TRUE(WaitFor([&]() { return !(*session1)->IsConnected(); }));
+
+  auto session2 = GetSession();
+  ASSERT_TRUE(session2.ok()) << session2.status();
+  EXPECT_NE((*session2)->SessionId(), (*session1)->SessionId());
+  EXPECT_TRUE((*session2)->IsPrimary());
+  EXPECT_GT(ToUint128((*session2)->ElectionId()),
+            ToUint128((*session1)->ElectionId()));
+  EXPECT_EQ(manager_.SessionsCreated(), 2);
+}
+
+TEST_F(SessionManagerTest, reconnects_after_mastership_loss) {
+  auto session1 = GetSession();
+  ASSERT_TRUE(session1.ok()) << session1.status();
+
+  service_.Demote();
+  ASSERT_TRUE(WaitFor([&]() { return !(*session1)->IsPrimary(); }));
+  EXPECT_TRUE((*session1)->IsConnected());
+
+  // The old session is closed before the new one arbitrates.
+  auto session2 = GetSession();
+  ASSERT_TRUE(session2.ok()) << session2.status();
+  EXPECT_FALSE((*session1)->IsConnected());
+  EXPECT_NE((*session2)->SessionId(), (*session1)->SessionId());
+  EXPECT_TRUE((*session2)->IsPrimary());
+  EXPECT_GT(ToUint128((*session2)->ElectionId()),
+            ToUint128((*session1)->ElectionId()));
+  EXPECT_TRUE(WaitFor([this]() { return service_.num_open() == 1; }));
+}
+
+TEST_F(SessionManagerTest, backup_session_is_an_error) {
+  service_.SetPrimaryId(
+      DEVICE_ID, ::absl::MakeUint128(std::numeric_limits<uint64_t>::max(), 0));
+
+  auto session = GetSession();
+  EXPECT_EQ(session.status().code(), ::absl::StatusCode::kPermissionDenied);
+
+  // Each request tries again with a new session.
+  session = GetSession();
+  EXPECT_EQ(session.status().code(), ::absl::StatusCode::kPermissionDenied);
+  EXPECT_EQ(manager_.SessionsCreated(), 2);
+}
+
+TEST_F(SessionManagerTest, reset_closes_sessions_in_use) {
+  auto session1 = GetSession();
+  ASSERT_TRUE(session1.ok()) << session1.status();
+
+  manager_.Reset();
+  EXPECT_FALSE((*session1)->IsConnected());
+  EXPECT_FALSE((*session1)->IsPrimary());
+  EXPECT_TRUE(WaitFor([this]() { return service_.num_open() == 0; }));
+
+  auto session2 = GetSession();
+  ASSERT_TRUE(session2.ok()) << session2.status();
+  EXPECT_NE(*session2, *session1);
+  EXPECT_GT(ToUint128((*session2)->ElectionId()),
+            ToUint128((*session1)->ElectionId()));
+}
+
+TEST_F(SessionManagerTest, sessions_are_created_without_the_lock) {
+  ::absl::StatusOr<std::shared_ptr<OvsP4rtSession>> blocked1;
+  std::thread thread1(
+      [&]() { blocked1 = GetSession(BLOCKED_ADDRESS, OTHER_DEVICE_ID); });
+  WaitForBlocked(1);
+
+  // Another target is not held up by the slow connect.
+  auto session = GetSession();
+  ASSERT_TRUE(session.ok()) << session.status();
+
+  // Another request for the same target waits for it.
+  ::absl::StatusOr<std::shared_ptr<OvsP4rtSession>> blocked2;
+  std::thread thread2(
+      [&]() { blocked2 = GetSession(BLOCKED_ADDRESS, OTHER_DEVICE_ID); });
+
+  ReleaseFactory();
+  thread1.join();
+  thread2.join();
+
+  ASSERT_TRUE(blocked1.ok()) << blocked1.status();
+  ASSERT_TRUE(blocked2.ok()) << blocked2.status();
+  EXPECT_EQ(*blocked1, *blocked2);
+  EXPECT_NE(*blocked1, *session);
+  EXPECT_EQ(manager_.SessionsCreated(), 2);
+}
+
+}  // namespace ovsp4rt
@@ -0,0 +1,279 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "session/ovsp4rt_shadow_table.h"
+
+#include <grpcpp/grpcpp.h>
+
+#include <stdint.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "gtest/gtest.h"
+#include "p4/v1/p4runtime.grpc.pb.h"
+#include "p4/v1/p4runtime.pb.h"
+
+namespace ovsp4rt {
+
+constexpr uint32_t DEVICE_ID = 1;
+constexpr uint32_t TABLE_ID = 100;
+constexpr uint32_t OTHER_TABLE_ID = 200;
+
+class ShadowTableTest : public ::testing::Test {
+ protected:
+  static ::p4::v1::TableEntry ExactEntry(uint32_t table_id,
+                                         const std::string& value) {
+    ::p4::v1::TableEntry table_entry;
+    table_entry.set_table_id(table_id);
+    auto* match = table_entry.add_match();
+    match->set_field_id(1);
+    match->mutable_exact()->set_value(value);
+    return table_entry;
+  }
+
+  // Mirrors TABLE_ID with the given entries.
+  void LoadTable(const std::vector<::p4::v1::TableEntry>& entries) {
+    ::p4::v1::ReadResponse response;
+    for (const auto& entry : entries) {
+      *response.add_entities()->mutable_table_entry() = entry;
+    }
+    shadow_.LoadTable(TABLE_ID, response);
+  }
+
+  void Write(::p4::v1::Update::Type type,
+             const ::p4::v1::TableEntry& table_entry,
+             const ::absl::Status& status) {
+    ::p4::v1::WriteRequest write_request;
+    auto* update = write_request.add_updates();
+    update->set_type(type);
+    *update->mutable_entity()->mutable_table_entry() = table_entry;
+    shadow_.RecordWrite(write_request, {status});
+  }
+
+  ShadowTable shadow_;
+};
+
+TEST_F(ShadowTableTest, match_key_ignores_leading_zeros) {
+  const std::string padded("\0\x0a", 2);
+  EXPECT_EQ(ShadowTable::MatchKey(ExactEntry(TABLE_ID, padded)),
+            ShadowTable::MatchKey(ExactEntry(TABLE_ID, "\x0a")));
+  EXPECT_NE(ShadowTable::MatchKey(ExactEntry(TABLE_ID, "\x0a")),
+            ShadowTable::MatchKey(ExactEntry(TABLE_ID, "\x0b")));
+}
+
+TEST_F(ShadowTableTest, match_key_ignores_field_order) {
+  ::p4::v1::TableEntry entry1;
+  auto* match = entry1.add_match();
+  match->set_field_id(1);
+  match->mutable_exact()->set_value("\x01");
+  match = entry1.add_match();
+  match->set_field_id(2);
+  match->mutable_lpm()->set_value("\x0a");
+  match->mutable_lpm()->set_prefix_len(8);
+
+  ::p4::v1::TableEntry entry2;
+  *entry2.add_match() = entry1.match(1);
+  *entry2.add_match() = entry1.match(0);
+
+  EXPECT_EQ(ShadowTable::MatchKey(entry1), ShadowTable::MatchKey(entry2));
+
+  entry2.mutable_match(0)->mutable_lpm()->set_prefix_len(16);
+  EXPECT_NE(ShadowTable::MatchKey(entry1), ShadowTable::MatchKey(entry2));
+}
+
+TEST_F(ShadowTableTest, unsynced_table_is_unknown) {
+  EXPECT_FALSE(shadow_.Find(ExactEntry(TABLE_ID, "\x01")));
+
+  LoadTable({});
+  EXPECT_FALSE(shadow_.Find(ExactEntry(OTHER_TABLE_ID, "\x01")));
+}
+
+TEST_F(ShadowTableTest, load_table) {
+  LoadTable({ExactEntry(TABLE_ID, "\x01"), ExactEntry(TABLE_ID, "\x02")});
+
+  EXPECT_EQ(shadow_.Find(ExactEntry(TABLE_ID, "\x01")), true);
+  EXPECT_EQ(shadow_.Find(ExactEntry(TABLE_ID, "\x02")), true);
+  EXPECT_EQ(shadow_.Find(ExactEntry(TABLE_ID, "\x03")), false);
+  EXPECT_EQ(shadow_.size(), 2);
+  EXPECT_EQ(shadow_.SyncCount(), 1);
+}
+
+TEST_F(ShadowTableTest, successful_writes_are_applied) {
+  LoadTable({ExactEntry(TABLE_ID, "\x01")});
+
+  Write(::p4::v1::Update::INSERT, ExactEntry(TABLE_ID, "\x02"),
+        ::absl::OkStatus());
+  Write(::p4::v1::Update::DELETE, ExactEntry(TABLE_ID, "\x01"),
+        ::absl::OkStatus());
+
+  EXPECT_EQ(shadow_.Find(ExactEntry(TABLE_ID, "\x01")), false);
+  EXPECT_EQ(shadow_.Find(ExactEntry(TABLE_ID, "\x02")), true);
+}
+
+TEST_F(ShadowTableTest, failed_writes_are_ignored) {
+  LoadTable({ExactEntry(TABLE_ID, "\x01")});
+
+  Write(::p4::v1::Update::INSERT, ExactEntry(TABLE_ID, "\x02"),
+        ::absl::ResourceExhaustedError("Table full"));
+  Write(::p4::v1::Update::DELETE, ExactEntry(TABLE_ID, "\x01"),
+        ::absl::UnknownError("Write failed"));
+
+  EXPECT_EQ(shadow_.Find(ExactEntry(TABLE_ID, "\x01")), true);
+  EXPECT_EQ(shadow_.Find(ExactEntry(TABLE_ID, "\x02")), false);
+}
+
+TEST_F(ShadowTableTest, write_errors_that_reveal_state_are_applied) {
+  LoadTable({ExactEntry(TABLE_ID, "\x01")});
+
+  Write(::p4::v1::Update::INSERT, ExactEntry(TABLE_ID, "\x02"),
+        ::absl::AlreadyExistsError("Entry exists"));
+  Write(::p4::v1::Update::DELETE, ExactEntry(TABLE_ID, "\x01"),
+        ::absl::NotFoundError("No such entry"));
+
+  EXPECT_EQ(shadow_.Find(ExactEntry(TABLE_ID, "\x01")), false);
+  EXPECT_EQ(shadow_.Find(ExactEntry(TABLE_ID, "\x02")), true);
+}
+
+TEST_F(ShadowTableTest, writes_to_unsynced_tables_are_ignored) {
+  LoadTable({});
+
+  Write(::p4::v1::Update::INSERT, ExactEntry(OTHER_TABLE_ID, "\x01"),
+        ::absl::OkStatus());
+
+  EXPECT_FALSE(shadow_.Find(ExactEntry(OTHER_TABLE_ID, "\x01")));
+  EXPECT_EQ(shadow_.size(), 0);
+}
+
+TEST_F(ShadowTableTest, invalidate) {
+  LoadTable({ExactEntry(TABLE_ID, "\x01")});
+  shadow_.Invalidate();
+
+  EXPECT_FALSE(shadow_.Find(ExactEntry(TABLE_ID, "\x01")));
+  EXPECT_EQ(shadow_.size(), 0);
+}
+
+//----------------------------------------------------------------------
+// Reading a table from the switch
+//----------------------------------------------------------------------
+
+// P4Runtime server whose Read RPCs return the given entries, or fail,
+// once the test releases them.
+class FakeP4RuntimeService : public ::p4::v1::P4Runtime::Service {
+ public:
+  ::grpc::Status Read(
+      ::grpc::ServerContext* context, const ::p4::v1::ReadRequest* request,
+      ::grpc::ServerWriter<::p4::v1::ReadResponse>* writer) override {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++reading_;
+    cv_.notify_all();
+    cv_.wait(lock, [this]() { return released_; });
+    if (!status_.ok()) {
+      return status_;
+    }
+    writer->Write(response_);
+    return ::grpc::Status::OK;
+  }
+
+  void Add(const ::p4::v1::TableEntry& table_entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    *response_.add_entities()->mutable_table_entry() = table_entry;
+  }
+
+  void Fail() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    status_ = ::grpc::Status(::grpc::StatusCode::UNAVAILABLE, "Read failed");
+  }
+
+  void WaitForRead() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return reading_ != 0; });
+  }
+
+  void Release() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    released_ = true;
+    cv_.notify_all();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  ::p4::v1::ReadResponse response_;
+  ::grpc::Status status_;
+  int reading_ = 0;
+  bool released_ = false;
+};
+
+class ShadowTableReadTest : public ShadowTableTest {
+ protected:
+  void SetUp() override {
+    ::grpc::ServerBuilder builder;
+    builder.RegisterService(&service_);
+    server_ = builder.BuildAndStart();
+    stub_ = ::p4::v1::P4Runtime::NewStub(
+        server_->InProcessChannel(::grpc::ChannelArguments()));
+  }
+
+  void TearDown() override {
+    service_.Release();
+    server_->Shutdown();
+  }
+
+  // Looks up an entry on another thread.
+  std::thread StartContains(const ::p4::v1::TableEntry& table_entry,
+                            ::absl::StatusOr<bool>* result) {
+    return std::thread([this, table_entry, result]() {
+      *result = shadow_.Contains(*stub_, DEVICE_ID, table_entry);
+    });
+  }
+
+  FakeP4RuntimeService service_;
+  std::unique_ptr<::grpc::Server> server_;
+  std::unique_ptr<::p4::v1::P4Runtime::Stub> stub_;
+};
+
+TEST_F(ShadowTableReadTest, writes_during_read_are_applied) {
+  service_.Add(ExactEntry(TABLE_ID, "\x01"));
+  service_.Add(ExactEntry(TABLE_ID, "\x02"));
+
+  ::absl::StatusOr<bool> result;
+  std::thread reader = StartContains(ExactEntry(TABLE_ID, "\x03"), &result);
+  service_.WaitForRead();
+
+  // The lock is not held during the read, so writes are recorded
+  // without waiting for it.
+  EXPECT_FALSE(shadow_.Find(ExactEntry(TABLE_ID, "\x01")));
+  Write(::p4::v1::Update::INSERT, ExactEntry(TABLE_ID, "\x03"),
+        ::absl::OkStatus());
+  Write(::p4::v1::Update::DELETE, ExactEntry(TABLE_ID, "\x01"),
+        ::absl::OkStatus());
+
+  service_.Release();
+  reader.join();
+
+  ASSERT_TRUE(result.ok());
+  EXPECT_TRUE(*result);
+  EXPECT_EQ(shadow_.Find(ExactEntry(TABLE_ID, "\x01")), false);
+  EXPECT_EQ(shadow_.Find(ExactEntry(TABLE_ID, "\x02")), true);
+  EXPECT_EQ(shadow_.SyncCount(), 1);
+}
+
+TEST_F(ShadowTableReadTest, failed_read_is_not_mirrored) {
+  service_.Fail();
+  service_.Release();
+
+  auto result =
+      shadow_.Contains(*stub_, DEVICE_ID, ExactEntry(TABLE_ID, "\x01"));
+
+  EXPECT_EQ(result.status().code(), ::absl::StatusCode::kUnavailable);
+  EXPECT_FALSE(shadow_.Find(ExactEntry(TABLE_ID, "\x01")));
+  EXPECT_EQ(shadow_.SyncCount(), 0);
+}
+
+}  // namespace ovsp4rt
@@ -0,0 +1,63 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Scaling benchmark for the sharded asynchronous writer.
+//
+// Queues FDB requests for 16 bridges and waits for them to be
+// processed, with 1 to 16 shards. The executor stands in for the
+// switch: each batch costs a round trip plus a fixed time per update,
+// so the throughput shows how well the shards overlap their writes.
+
+#include <stdint.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "async/ovsp4rt_async_writer.h"
+#include "async/ovsp4rt_sharded_writer.h"
+#include "benchmark/benchmark.h"
+#include "ovsp4rt/ovs-p4rt.h"
+
+namespace ovsp4rt {
+namespace {
+
+constexpr char kGrpcAddr[] = "localhost:9559";
+constexpr int kNumBridges = 16;
+constexpr int kNumRequests = 1024;
+constexpr auto kRoundTrip = std::chrono::microseconds(100);
+constexpr auto kPerUpdate = std::chrono::microseconds(5);
+
+std::unique_ptr<AsyncWriter> MakeWriter(uint32_t shard, uint32_t num_shards) {
+  return std::make_unique<AsyncWriter>([](std::vector<AsyncOp>& ops) {
+    std::this_thread::sleep_for(kRoundTrip + kPerUpdate * ops.size());
+  });
+}
+
+void BM_ShardedWriter(benchmark::State& state) {
+  ShardedWriter writer(state.range(0), MakeWriter);
+  writer.Enable(kNumRequests);
+
+  struct mac_learning_info learn_info = {0};
+  for (auto _ : state) {
+    for (int i = 0; i < kNumRequests; i++) {
+      learn_info.bridge_id = i % kNumBridges;
+      learn_info.mac_addr[4] = i >> 8;
+      learn_info.mac_addr[5] = i & 0xff;
+      writer.Enqueue(AsyncOp::CONFIG_FDB_ENTRY, learn_info, true, kGrpcAddr);
+    }
+    writer.Flush();
+  }
+  state.SetItemsProcessed(state.iterations() * kNumRequests);
+}
+BENCHMARK(BM_ShardedWriter)
+    ->RangeMultiplier(2)
+    ->Range(1, kNumBridges)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace ovsp4rt
+
+BENCHMARK_MAIN();
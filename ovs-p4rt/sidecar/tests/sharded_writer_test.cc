@@ -0,0 +1,222 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "async/ovsp4rt_sharded_writer.h"
+
+#include <stdint.h>
+
+#include <chrono>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "async/ovsp4rt_async_writer.h"
+#include "gtest/gtest.h"
+#include "ovsp4rt/ovs-p4rt.h"
+
+namespace ovsp4rt {
+
+constexpr char GRPC_ADDR[] = "localhost:9559";
+
+// A request processed by a shard.
+struct Processed {
+  uint32_t shard;
+  AsyncOp::Type type;
+  uint8_t bridge_id;
+  uint8_t mac;
+};
+
+class ShardedWriterTest : public ::testing::Test {
+ protected:
+  // Returns a factory for writers whose executors record the requests
+  // they process. The executor of a shard first calls before(shard).
+  ShardedWriter::WriterFactory Factory(
+      std::function<void(uint32_t shard)> before = nullptr) {
+    return [this, before](uint32_t shard, uint32_t num_shards) {
+      return std::make_unique<AsyncWriter>(
+          [this, before, shard](std::vector<AsyncOp>& ops) {
+            if (before) before(shard);
+            Execute(shard, ops);
+          });
+    };
+  }
+
+  void Execute(uint32_t shard, std::vector<AsyncOp>& ops) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& op : ops) {
+      if (op.type == AsyncOp::CONFIG_FDB_ENTRY) {
+        processed_.push_back({shard, op.type, op.learn_info.bridge_id,
+                              op.learn_info.mac_addr[5]});
+      } else {
+        processed_.push_back({shard, op.type, 0, 0});
+      }
+    }
+  }
+
+  static bool EnqueueFdb(ShardedWriter& writer, uint8_t bridge_id,
+                         uint8_t mac) {
+    struct mac_learning_info learn_info = {0};
+    learn_info.bridge_id = bridge_id;
+    learn_info.mac_addr[5] = mac;
+    return writer.Enqueue(AsyncOp::CONFIG_FDB_ENTRY, learn_info, true,
+                          GRPC_ADDR);
+  }
+
+  static bool EnqueueTunnel(ShardedWriter& writer, bool insert_entry) {
+    struct tunnel_info tunnel_info = {0};
+    tunnel_info.vni = 10;
+    return writer.Enqueue(AsyncOp::CONFIG_TUNNEL_ENTRY, tunnel_info,
+                          insert_entry, GRPC_ADDR);
+  }
+
+  static uint64_t Completed(const ShardedWriter& writer, uint32_t shard) {
+    struct ovsp4rt_async_stats stats;
+    EXPECT_TRUE(writer.GetShardStats(shard, &stats));
+    return stats.completed;
+  }
+
+  std::vector<Processed> processed() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return processed_;
+  }
+
+  std::mutex mutex_;
+  std::vector<Processed> processed_;
+};
+
+TEST_F(ShardedWriterTest, number_of_shards_is_limited) {
+  EXPECT_EQ(ShardedWriter(0, Factory()).num_shards(), 1);
+  EXPECT_EQ(ShardedWriter(4, Factory()).num_shards(), 4);
+  EXPECT_EQ(ShardedWriter(1000, Factory()).num_shards(),
+            ShardedWriter::kMaxShards);
+}
+
+TEST_F(ShardedWriterTest, fdb_requests_go_to_shard_of_bridge) {
+  ShardedWriter writer(4, Factory());
+  writer.Enable(0);
+
+  for (uint8_t mac = 0; mac < 10; mac++) {
+    for (uint8_t bridge_id = 0; bridge_id < 8; bridge_id++) {
+      ASSERT_TRUE(EnqueueFdb(writer, bridge_id, mac));
+    }
+  }
+  writer.Flush();
+
+  // The requests for each bridge are processed in order, by its shard.
+  auto result = processed();
+  ASSERT_EQ(result.size(), 80);
+  std::map<uint8_t, uint8_t> next_mac;
+  for (const auto& op : result) {
+    EXPECT_EQ(op.shard, op.bridge_id % 4);
+    EXPECT_EQ(op.mac, next_mac[op.bridge_id]++);
+  }
+}
+
+TEST_F(ShardedWriterTest, other_requests_go_to_shard_0) {
+  ShardedWriter writer(4, Factory());
+  writer.Enable(0);
+
+  ASSERT_TRUE(EnqueueTunnel(writer, true));
+  ASSERT_TRUE(writer.Enqueue(AsyncOp::CONFIG_VLAN_ENTRY, uint16_t{3}, true,
+                             GRPC_ADDR));
+  writer.Flush();
+
+  auto result = processed();
+  ASSERT_EQ(result.size(), 2);
+  EXPECT_EQ(result[0].shard, 0);
+  EXPECT_EQ(result[1].shard, 0);
+}
+
+TEST_F(ShardedWriterTest, shards_progress_independently) {
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+
+  ShardedWriter writer(2, Factory([released](uint32_t shard) {
+                         if (shard == 1) released.wait();
+                       }));
+  writer.Enable(0);
+
+  // Shard 1 is blocked, but shard 0 still processes its requests.
+  ASSERT_TRUE(EnqueueFdb(writer, 1, 1));
+  ASSERT_TRUE(EnqueueFdb(writer, 0, 1));
+  while (Completed(writer, 0) != 1) {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(Completed(writer, 1), 0);
+
+  release.set_value();
+  writer.Flush();
+  EXPECT_EQ(Completed(writer, 1), 1);
+}
+
+TEST_F(ShardedWriterTest, removal_waits_for_other_shards) {
+  ShardedWriter writer(2, Factory([](uint32_t shard) {
+                         if (shard == 1) {
+                           std::this_thread::sleep_for(
+                               std::chrono::milliseconds(20));
+                         }
+                       }));
+  writer.Enable(0);
+
+  ASSERT_TRUE(EnqueueFdb(writer, 1, 1));
+  ASSERT_TRUE(EnqueueTunnel(writer, false));
+  writer.Flush();
+
+  // The FDB entry on shard 1 is processed before the tunnel it may
+  // refer to is removed.
+  auto result = processed();
+  ASSERT_EQ(result.size(), 2);
+  EXPECT_EQ(result[0].type, AsyncOp::CONFIG_FDB_ENTRY);
+  EXPECT_EQ(result[1].type, AsyncOp::CONFIG_TUNNEL_ENTRY);
+}
+
+TEST_F(ShardedWriterTest, removal_does_not_block_caller) {
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+
+  ShardedWriter writer(2, Factory([released](uint32_t shard) {
+                         if (shard == 1) released.wait();
+                       }));
+  writer.Enable(0);
+
+  // Shard 1 is blocked. The removal is queued without waiting for it,
+  // and is processed once shard 1 has caught up.
+  ASSERT_TRUE(EnqueueFdb(writer, 1, 1));
+  ASSERT_TRUE(EnqueueTunnel(writer, false));
+  EXPECT_EQ(Completed(writer, 0), 0);
+
+  release.set_value();
+  writer.Flush();
+
+  auto result = processed();
+  ASSERT_EQ(result.size(), 2);
+  EXPECT_EQ(result[0].type, AsyncOp::CONFIG_FDB_ENTRY);
+  EXPECT_EQ(result[1].type, AsyncOp::CONFIG_TUNNEL_ENTRY);
+}
+
+TEST_F(ShardedWriterTest, statistics_are_combined) {
+  ShardedWriter writer(2, Factory());
+  writer.Enable(0);
+
+  for (uint8_t mac = 0; mac < 3; mac++) {
+    ASSERT_TRUE(EnqueueFdb(writer, 0, mac));
+  }
+  for (uint8_t mac = 0; mac < 5; mac++) {
+    ASSERT_TRUE(EnqueueFdb(writer, 1, mac));
+  }
+  writer.Flush();
+
+  struct ovsp4rt_async_stats stats;
+  writer.GetStats(&stats);
+  EXPECT_EQ(stats.enqueued, 8);
+  EXPECT_EQ(stats.completed, 8);
+  EXPECT_EQ(stats.queue_depth, 0);
+  EXPECT_EQ(Completed(writer, 0), 3);
+  EXPECT_EQ(Completed(writer, 1), 5);
+  EXPECT_FALSE(writer.GetShardStats(2, &stats));
+}
+
+}  // namespace ovsp4rt
@@ -0,0 +1,148 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "stats/ovsp4rt_stats.h"
+
+#include <stdint.h>
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "logging/ovsp4rt_diag_detail.h"
+#include "ovsp4rt/ovs-p4rt.h"
+#include "stats/ovsp4rt_latency_histogram.h"
+
+namespace ovsp4rt {
+
+using Histogram = LatencyHistogram;
+
+TEST(LatencyHistogramTest, small_values_have_own_buckets) {
+  for (uint64_t value = 0; value < Histogram::kSubBuckets; value++) {
+    EXPECT_EQ(Histogram::BucketIndex(value), value);
+    EXPECT_EQ(Histogram::BucketLimit(value), value);
+  }
+}
+
+TEST(LatencyHistogramTest, buckets_cover_all_values) {
+  // Every bucket begins just after the previous one ends.
+  for (int i = 1; i < Histogram::kNumBuckets; i++) {
+    uint64_t first = Histogram::BucketLimit(i - 1) + 1;
+    EXPECT_EQ(Histogram::BucketIndex(first), i) << "bucket " << i;
+    EXPECT_EQ(Histogram::BucketIndex(Histogram::BucketLimit(i)), i)
+        << "bucket " << i;
+  }
+  EXPECT_EQ(Histogram::BucketLimit(Histogram::kNumBuckets - 1), UINT64_MAX);
+}
+
+TEST(LatencyHistogramTest, relative_error_is_bounded) {
+  for (uint64_t value = 1; value < (uint64_t{1} << 40); value = value * 3 + 1) {
+    uint64_t limit = Histogram::BucketLimit(Histogram::BucketIndex(value));
+    EXPECT_GE(limit, value);
+    EXPECT_LE(limit - value, value / Histogram::kSubBuckets) << value;
+  }
+}
+
+TEST(LatencyHistogramTest, empty_histogram) {
+  Histogram histogram;
+  EXPECT_EQ(histogram.count(), 0);
+  EXPECT_EQ(histogram.ValueAtPercentile(50), 0);
+}
+
+TEST(LatencyHistogramTest, percentiles) {
+  Histogram histogram;
+  for (uint64_t ns = 1; ns <= 1000; ns++) {
+    histogram.Record(ns * 1000);
+  }
+
+  EXPECT_EQ(histogram.count(), 1000);
+  EXPECT_EQ(histogram.total_ns(), 500500000);
+  EXPECT_EQ(histogram.max_ns(), 1000000);
+
+  // Within the bucket precision of the exact values.
+  auto expect_near = [&histogram](double percentile, uint64_t exact) {
+    uint64_t value = histogram.ValueAtPercentile(percentile);
+    EXPECT_GE(value, exact) << percentile;
+    EXPECT_LE(value, exact + exact / Histogram::kSubBuckets) << percentile;
+  };
+  expect_near(50, 500000);
+  expect_near(90, 900000);
+  expect_near(99, 990000);
+  EXPECT_EQ(histogram.ValueAtPercentile(100), 1000000);
+}
+
+TEST(LatencyHistogramTest, add_to) {
+  Histogram a, b, sum;
+  a.Record(10);
+  a.Record(20);
+  b.Record(3000);
+
+  a.AddTo(&sum);
+  b.AddTo(&sum);
+
+  EXPECT_EQ(sum.count(), 3);
+  EXPECT_EQ(sum.total_ns(), 3030);
+  EXPECT_EQ(sum.max_ns(), 3000);
+  EXPECT_EQ(sum.ValueAtPercentile(50), Histogram::BucketLimit(
+                                           Histogram::BucketIndex(20)));
+}
+
+TEST(StatsTest, sums_threads_including_exited_ones) {
+  auto& stats = Stats::Instance();
+  struct ovsp4rt_stats before;
+  stats.GetStats(&before);
+
+  constexpr int kNumThreads = 4;
+  constexpr int kPerThread = 1000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&stats]() {
+      for (int i = 0; i < kPerThread; i++) {
+        stats.RecordLatency(OVSP4RT_LATENCY_READ_RPC, 100);
+        stats.CountUpdate(LOG_L2_FWD_TX_TABLE, i % 10 != 0);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  struct ovsp4rt_stats after;
+  stats.GetStats(&after);
+
+  const auto& latency = after.latency[OVSP4RT_LATENCY_READ_RPC];
+  EXPECT_EQ(latency.count - before.latency[OVSP4RT_LATENCY_READ_RPC].count,
+            kNumThreads * kPerThread);
+  EXPECT_GE(latency.p50_ns, 100);
+
+  const auto& table = after.tables[LOG_L2_FWD_TX_TABLE];
+  EXPECT_EQ(table.succeeded - before.tables[LOG_L2_FWD_TX_TABLE].succeeded,
+            kNumThreads * kPerThread * 9 / 10);
+  EXPECT_EQ(table.failed - before.tables[LOG_L2_FWD_TX_TABLE].failed,
+            kNumThreads * kPerThread / 10);
+}
+
+TEST(StatsTest, scoped_latency) {
+  auto& stats = Stats::Instance();
+  struct ovsp4rt_stats before;
+  stats.GetStats(&before);
+
+  { ScopedLatency latency(OVSP4RT_LATENCY_API); }
+
+  struct ovsp4rt_stats after;
+  stats.GetStats(&after);
+  EXPECT_EQ(after.latency[OVSP4RT_LATENCY_API].count,
+            before.latency[OVSP4RT_LATENCY_API].count + 1);
+}
+
+TEST(StatsTest, names) {
+  for (int i = 0; i < OVSP4RT_NUM_LATENCY_TYPES; i++) {
+    EXPECT_NE(ovsp4rt_stats_latency_name(static_cast<ovsp4rt_latency_type>(i)),
+              nullptr);
+  }
+  EXPECT_STREQ(ovsp4rt_stats_table_name(LOG_L2_FWD_SMAC_TABLE),
+               "l2_fwd_smac_table");
+  EXPECT_EQ(ovsp4rt_stats_table_name(LOG_NUM_TABLES), nullptr);
+}
+
+}  // namespace ovsp4rt
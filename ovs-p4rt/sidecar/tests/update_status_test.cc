@@ -0,0 +1,124 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <grpcpp/grpcpp.h>
+
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "google/rpc/status.pb.h"
+#include "gtest/gtest.h"
+#include "p4/v1/p4runtime.pb.h"
+#include "session/ovsp4rt_session.h"
+
+namespace ovsp4rt {
+
+class UpdateStatusTest : public ::testing::Test {
+ protected:
+  // Adds a p4.v1.Error for one update to the error details.
+  void AddError(int canonical_code, const std::string& message) {
+    ::p4::v1::Error error;
+    error.set_canonical_code(canonical_code);
+    error.set_message(message);
+    details_.add_details()->PackFrom(error);
+  }
+
+  // Returns a grpc::Status that carries the error details.
+  ::grpc::Status WriteStatus() {
+    details_.set_code(::grpc::StatusCode::UNKNOWN);
+    return ::grpc::Status(::grpc::StatusCode::UNKNOWN, "Write failed",
+                          details_.SerializeAsString());
+  }
+
+  ::google::rpc::Status details_;
+};
+
+//----------------------------------------------------------------------
+// Test case: all_updates_ok
+//----------------------------------------------------------------------
+TEST_F(UpdateStatusTest, all_updates_ok) {
+  auto update_status = GetUpdateStatus(::grpc::Status::OK, 3);
+
+  ASSERT_EQ(update_status.size(), 3);
+  for (const auto& status : update_status) {
+    EXPECT_TRUE(status.ok());
+  }
+}
+
+//----------------------------------------------------------------------
+// Test case: per_update_errors
+//
+// Verify that each update gets the status from its p4.v1.Error.
+//----------------------------------------------------------------------
+TEST_F(UpdateStatusTest, per_update_errors) {
+  AddError(::grpc::StatusCode::OK, "");
+  AddError(::grpc::StatusCode::ALREADY_EXISTS, "Entry exists");
+  AddError(::grpc::StatusCode::OK, "");
+
+  auto update_status = GetUpdateStatus(WriteStatus(), 3);
+
+  ASSERT_EQ(update_status.size(), 3);
+  EXPECT_TRUE(update_status[0].ok());
+  EXPECT_EQ(update_status[1].code(), absl::StatusCode::kAlreadyExists);
+  EXPECT_EQ(update_status[1].message(), "Entry exists");
+  EXPECT_TRUE(update_status[2].ok());
+}
+
+//----------------------------------------------------------------------
+// Test case: missing_details
+//
+// Verify that every update gets the overall status if the server
+// did not return per-update errors.
+//----------------------------------------------------------------------
+TEST_F(UpdateStatusTest, missing_details) {
+  ::grpc::Status status(::grpc::StatusCode::UNAVAILABLE, "Not connected");
+
+  auto update_status = GetUpdateStatus(status, 2);
+
+  ASSERT_EQ(update_status.size(), 2);
+  for (const auto& update : update_status) {
+    EXPECT_EQ(update.code(), absl::StatusCode::kUnavailable);
+  }
+}
+
+//----------------------------------------------------------------------
+// Test case: detail_count_mismatch
+//
+// Verify that the details are ignored if there is not one per update.
+//----------------------------------------------------------------------
+TEST_F(UpdateStatusTest, detail_count_mismatch) {
+  AddError(::grpc::StatusCode::NOT_FOUND, "No such entry");
+
+  auto update_status = GetUpdateStatus(WriteStatus(), 2);
+
+  ASSERT_EQ(update_status.size(), 2);
+  for (const auto& update : update_status) {
+    EXPECT_EQ(update.code(), absl::StatusCode::kUnknown);
+  }
+}
+
+//----------------------------------------------------------------------
+// Test case: reports_missing_details
+//
+// Verify that ParseUpdateStatus() tells whether the server returned
+// per-update errors.
+//----------------------------------------------------------------------
+TEST_F(UpdateStatusTest, reports_missing_details) {
+  std::vector<absl::Status> update_status;
+
+  EXPECT_TRUE(ParseUpdateStatus(::grpc::Status::OK, 2, &update_status));
+  EXPECT_EQ(update_status.size(), 2);
+
+  AddError(::grpc::StatusCode::OK, "");
+  AddError(::grpc::StatusCode::NOT_FOUND, "No such entry");
+  EXPECT_TRUE(ParseUpdateStatus(WriteStatus(), 2, &update_status));
+  EXPECT_EQ(update_status[1].code(), absl::StatusCode::kNotFound);
+
+  ::grpc::Status status(::grpc::StatusCode::UNKNOWN, "Write failed");
+  EXPECT_FALSE(ParseUpdateStatus(status, 2, &update_status));
+  ASSERT_EQ(update_status.size(), 2);
+  EXPECT_EQ(update_status[0].code(), absl::StatusCode::kUnknown);
+}
+
+}  // namespace ovsp4rt
@@ -0,0 +1,67 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "session/ovsp4rt_vsi_port_map.h"
+
+#include <stdint.h>
+
+#include "gtest/gtest.h"
+
+namespace ovsp4rt {
+
+class VsiPortMapTest : public ::testing::Test {
+ protected:
+  void Load() {
+    port_map_.Load({{10, 100}, {11, 101}});
+  }
+
+  VsiPortMap port_map_;
+};
+
+TEST_F(VsiPortMapTest, not_loaded) {
+  EXPECT_FALSE(port_map_.IsLoaded());
+  EXPECT_FALSE(port_map_.Find(10));
+
+  // Mappings are not kept until the map is loaded.
+  port_map_.Insert(10, 100);
+  EXPECT_EQ(port_map_.size(), 0);
+}
+
+TEST_F(VsiPortMapTest, find_loaded_mapping) {
+  Load();
+
+  EXPECT_TRUE(port_map_.IsLoaded());
+  EXPECT_EQ(port_map_.Find(10), 100);
+  EXPECT_EQ(port_map_.Find(11), 101);
+  EXPECT_FALSE(port_map_.Find(12));
+}
+
+TEST_F(VsiPortMapTest, insert_and_erase) {
+  Load();
+
+  port_map_.Insert(12, 102);
+  port_map_.Erase(10);
+
+  EXPECT_FALSE(port_map_.Find(10));
+  EXPECT_EQ(port_map_.Find(12), 102);
+  EXPECT_EQ(port_map_.size(), 2);
+}
+
+TEST_F(VsiPortMapTest, load_replaces_map) {
+  Load();
+  port_map_.Load({{20, 200}});
+
+  EXPECT_TRUE(port_map_.IsLoaded());
+  EXPECT_FALSE(port_map_.Find(10));
+  EXPECT_EQ(port_map_.Find(20), 200);
+}
+
+TEST_F(VsiPortMapTest, invalidate) {
+  Load();
+  port_map_.Invalidate();
+
+  EXPECT_FALSE(port_map_.IsLoaded());
+  EXPECT_EQ(port_map_.size(), 0);
+}
+
+}  // namespace ovsp4rt
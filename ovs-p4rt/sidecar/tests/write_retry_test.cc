@@ -0,0 +1,248 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "session/ovsp4rt_write_retry.h"
+
+#include <grpcpp/grpcpp.h>
+
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "google/rpc/status.pb.h"
+#include "gtest/gtest.h"
+#include "p4/v1/p4runtime.pb.h"
+
+namespace ovsp4rt {
+
+using ::p4::v1::Update;
+using ::p4::v1::WriteRequest;
+
+// Table of entries, identified by their match value, that applies
+// WriteRequests the way the switch does.
+class FakeTable {
+ public:
+  // Applies the updates in a request, and returns the result. Updates
+  // whose key is "bad" fail with INVALID_ARGUMENT. Without details,
+  // a failed request that has one update returns its error, and one
+  // that has several returns UNKNOWN.
+  ::grpc::Status Write(const WriteRequest& request) {
+    ++num_writes_;
+    ::google::rpc::Status details;
+    auto code = ::grpc::StatusCode::OK;
+    for (const auto& update : request.updates()) {
+      ::p4::v1::Error error;
+      error.set_canonical_code(Apply(update));
+      if (error.canonical_code() != ::grpc::StatusCode::OK) {
+        code = static_cast<::grpc::StatusCode>(error.canonical_code());
+      }
+      details.add_details()->PackFrom(error);
+    }
+    if (code == ::grpc::StatusCode::OK) {
+      return ::grpc::Status::OK;
+    }
+    if (!with_details_) {
+      if (request.updates_size() > 1) {
+        code = ::grpc::StatusCode::UNKNOWN;
+      }
+      return ::grpc::Status(code, "Write failed");
+    }
+    details.set_code(::grpc::StatusCode::UNKNOWN);
+    return ::grpc::Status(::grpc::StatusCode::UNKNOWN, "Write failed",
+                          details.SerializeAsString());
+  }
+
+  WriteRpc Rpc() {
+    return [this](const WriteRequest& request) { return Write(request); };
+  }
+
+  void set_with_details(bool with_details) { with_details_ = with_details; }
+
+  void Insert(const std::string& key) { entries_.insert(key); }
+  bool Contains(const std::string& key) const {
+    return entries_.contains(key);
+  }
+
+  int num_writes() const { return num_writes_; }
+
+ private:
+  ::grpc::StatusCode Apply(const Update& update) {
+    const auto& key =
+        update.entity().table_entry().match(0).exact().value();
+    if (key == "bad") {
+      return ::grpc::StatusCode::INVALID_ARGUMENT;
+    }
+    switch (update.type()) {
+      case Update::INSERT:
+        if (!entries_.insert(key).second) {
+          return ::grpc::StatusCode::ALREADY_EXISTS;
+        }
+        break;
+      case Update::MODIFY:
+        if (!entries_.contains(key)) {
+          return ::grpc::StatusCode::NOT_FOUND;
+        }
+        break;
+      case Update::DELETE:
+        if (!entries_.erase(key)) {
+          return ::grpc::StatusCode::NOT_FOUND;
+        }
+        break;
+      default:
+        return ::grpc::StatusCode::INVALID_ARGUMENT;
+    }
+    return ::grpc::StatusCode::OK;
+  }
+
+  absl::flat_hash_set<std::string> entries_;
+  bool with_details_ = true;
+  int num_writes_ = 0;
+};
+
+class WriteRetryTest : public ::testing::Test {
+ protected:
+  void AddUpdate(Update::Type type, const std::string& key) {
+    auto* update = request_.add_updates();
+    update->set_type(type);
+    auto* table_entry = update->mutable_entity()->mutable_table_entry();
+    table_entry->set_table_id(1);
+    auto* match = table_entry->add_match();
+    match->set_field_id(1);
+    match->mutable_exact()->set_value(key);
+  }
+
+  // Sends the request and retries the updates that fail.
+  ::absl::Status WriteWithRetry() {
+    auto status = table_.Write(request_);
+    return RetryFailedUpdates(table_.Rpc(), request_, status,
+                              &update_status_);
+  }
+
+  FakeTable table_;
+  WriteRequest request_;
+  std::vector<::absl::Status> update_status_;
+};
+
+//----------------------------------------------------------------------
+// Test case: insert_becomes_modify
+//
+// Verify that an INSERT of an existing entry is resent as a MODIFY,
+// and that the updates that succeeded are not resent.
+//----------------------------------------------------------------------
+TEST_F(WriteRetryTest, insert_becomes_modify) {
+  table_.Insert("b");
+  AddUpdate(Update::INSERT, "a");
+  AddUpdate(Update::INSERT, "b");
+  AddUpdate(Update::INSERT, "c");
+
+  EXPECT_TRUE(WriteWithRetry().ok());
+
+  ASSERT_EQ(update_status_.size(), 3);
+  for (const auto& status : update_status_) {
+    EXPECT_TRUE(status.ok());
+  }
+  EXPECT_EQ(table_.num_writes(), 2);
+  EXPECT_TRUE(table_.Contains("a"));
+  EXPECT_TRUE(table_.Contains("c"));
+}
+
+//----------------------------------------------------------------------
+// Test case: delete_not_found
+//
+// Verify that a DELETE of a missing entry counts as a success, without
+// being resent.
+//----------------------------------------------------------------------
+TEST_F(WriteRetryTest, delete_not_found) {
+  table_.Insert("a");
+  AddUpdate(Update::DELETE, "a");
+  AddUpdate(Update::DELETE, "b");
+
+  EXPECT_TRUE(WriteWithRetry().ok());
+
+  ASSERT_EQ(update_status_.size(), 2);
+  EXPECT_TRUE(update_status_[0].ok());
+  EXPECT_TRUE(update_status_[1].ok());
+  EXPECT_EQ(table_.num_writes(), 1);
+  EXPECT_FALSE(table_.Contains("a"));
+}
+
+//----------------------------------------------------------------------
+// Test case: other_errors_are_final
+//
+// Verify that an update that fails for another reason is not resent,
+// and that its error is returned.
+//----------------------------------------------------------------------
+TEST_F(WriteRetryTest, other_errors_are_final) {
+  AddUpdate(Update::INSERT, "a");
+  AddUpdate(Update::INSERT, "bad");
+  AddUpdate(Update::INSERT, "c");
+
+  auto status = WriteWithRetry();
+
+  EXPECT_EQ(status.code(), ::absl::StatusCode::kInvalidArgument);
+  ASSERT_EQ(update_status_.size(), 3);
+  EXPECT_TRUE(update_status_[0].ok());
+  EXPECT_EQ(update_status_[1].code(), ::absl::StatusCode::kInvalidArgument);
+  EXPECT_TRUE(update_status_[2].ok());
+  EXPECT_EQ(table_.num_writes(), 1);
+}
+
+//----------------------------------------------------------------------
+// Test case: bisects_without_details
+//
+// Verify that the failed update is isolated when the server does not
+// report per-update errors, and that the updates that took effect in
+// the first attempt are not reported as failures.
+//----------------------------------------------------------------------
+TEST_F(WriteRetryTest, bisects_without_details) {
+  table_.set_with_details(false);
+  for (int i = 0; i < 8; i++) {
+    AddUpdate(Update::INSERT, std::to_string(i));
+  }
+  request_.mutable_updates(5)
+      ->mutable_entity()
+      ->mutable_table_entry()
+      ->mutable_match(0)
+      ->mutable_exact()
+      ->set_value("bad");
+
+  auto status = WriteWithRetry();
+
+  EXPECT_EQ(status.code(), ::absl::StatusCode::kInvalidArgument);
+  ASSERT_EQ(update_status_.size(), 8);
+  for (int i = 0; i < 8; i++) {
+    if (i == 5) {
+      EXPECT_FALSE(update_status_[i].ok());
+    } else {
+      EXPECT_TRUE(update_status_[i].ok()) << "update " << i;
+      EXPECT_TRUE(table_.Contains(std::to_string(i)));
+    }
+  }
+  // The updates that took effect in the first attempt fail again as
+  // duplicates, so every half is split down to single updates, but
+  // the MODIFYs they need are sent together: 15 writes, plus one.
+  EXPECT_EQ(table_.num_writes(), 16);
+}
+
+//----------------------------------------------------------------------
+// Test case: rpc_failure_not_retried
+//
+// Verify that nothing is resent if the RPC as a whole failed.
+//----------------------------------------------------------------------
+TEST_F(WriteRetryTest, rpc_failure_not_retried) {
+  AddUpdate(Update::INSERT, "a");
+  AddUpdate(Update::INSERT, "b");
+
+  ::grpc::Status unavailable(::grpc::StatusCode::UNAVAILABLE, "No server");
+  auto status = RetryFailedUpdates(table_.Rpc(), request_, unavailable,
+                                   &update_status_);
+
+  EXPECT_EQ(status.code(), ::absl::StatusCode::kUnavailable);
+  ASSERT_EQ(update_status_.size(), 2);
+  EXPECT_EQ(update_status_[0].code(), ::absl::StatusCode::kUnavailable);
+  EXPECT_EQ(update_status_[1].code(), ::absl::StatusCode::kUnavailable);
+  EXPECT_EQ(table_.num_writes(), 0);
+}
+
+}  // namespace ovsp4rt